@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "AppStateManagerImpl"
+#include "app_state_manager_impl.h"
+
+#include <vector>
+
+#include "app_mgr_client.h"
+#include "log_print.h"
+
+namespace OHOS::DistributedData {
+__attribute__((used)) static bool g_init =
+    AppStateManager::RegisterInstance(std::make_shared<AppStateManagerImpl>());
+
+bool AppStateManagerImpl::IsForeground(uint32_t tokenId)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    if (!Refresh()) {
+        return true;
+    }
+    return tokens_.count(tokenId) != 0;
+}
+
+bool AppStateManagerImpl::IsForeground(const std::string &bundleName, int32_t user)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    if (!Refresh()) {
+        return true;
+    }
+    return bundles_.count({ bundleName, user }) != 0;
+}
+
+bool AppStateManagerImpl::Refresh()
+{
+    auto now = Clock::now();
+    if (now < expire_) {
+        return true;
+    }
+    AppExecFwk::AppMgrClient client;
+    std::vector<AppExecFwk::AppStateData> apps;
+    auto ret = client.GetForegroundApplications(apps);
+    if (ret != ERR_OK) {
+        // unknown state must not demote anyone
+        ZLOGW("get foreground applications failed, ret:%{public}d", static_cast<int32_t>(ret));
+        return false;
+    }
+    tokens_.clear();
+    bundles_.clear();
+    for (const auto &app : apps) {
+        tokens_.insert(app.accessTokenId);
+        bundles_.insert({ app.bundleName, app.uid / UID_BASE });
+    }
+    expire_ = now + REFRESH_INTERVAL;
+    return true;
+}
+} // namespace OHOS::DistributedData
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_DISTRIBUTED_DATA_ADAPTER_APP_STATE_MANAGER_IMPL_H
+#define OHOS_DISTRIBUTED_DATA_ADAPTER_APP_STATE_MANAGER_IMPL_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "app_state/app_state_manager.h"
+
+namespace OHOS::DistributedData {
+class AppStateManagerImpl final : public AppStateManager {
+public:
+    bool IsForeground(uint32_t tokenId) override;
+    bool IsForeground(const std::string &bundleName, int32_t user) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // the foreground list is fetched over IPC, so it is reused for this long
+    static constexpr std::chrono::milliseconds REFRESH_INTERVAL = std::chrono::milliseconds(1000);
+    static constexpr int32_t UID_BASE = 200000;
+
+    bool Refresh();
+
+    std::mutex mutex_;
+    Clock::time_point expire_;
+    std::set<uint32_t> tokens_;
+    std::set<std::pair<std::string, int32_t>> bundles_;
+};
+} // namespace OHOS::DistributedData
+
+#endif // OHOS_DISTRIBUTED_DATA_ADAPTER_APP_STATE_MANAGER_IMPL_H
@@ -16,9 +16,13 @@
 #define LOG_TAG "DeviceManagerAdapter"
 
 #include "device_manager_adapter.h"
+
+#include <algorithm>
+
 #include "device_manager.h"
 #include "device_manager_callback.h"
 #include "dm_device_info.h"
+#include "dump/dump_manager.h"
 #include "kvstore_utils.h"
 #include "log_print.h"
 #include "serializable/serializable.h"
@@ -204,6 +208,8 @@ void DeviceManagerAdapter::Init(std::shared_ptr<ExecutorPool> executors)
     if (executors_ == nullptr) {
         executors_ = std::move(executors);
     }
+    DumpManager::GetInstance().AddFeatureHandler(uintptr_t(this),
+        [this](int fd, std::map<std::string, std::vector<std::string>> &params) { DumpDeviceInfo(fd, params); });
     RegDevCallback()();
 }
 
@@ -341,6 +347,10 @@ void DeviceManagerAdapter::OnChanged(const DeviceInfo &dvInfo)
     ZLOGI("[OnChanged] uuid:%{public}s, name:%{public}s, type:%{public}d, authForm:%{public}d osType:%{public}d",
         KvStoreUtils::ToBeAnonymous(dvInfo.uuid).c_str(), KvStoreUtils::ToBeAnonymous(dvInfo.deviceName).c_str(),
         dvInfo.deviceType, static_cast<int32_t>(dvInfo.authForm), dvInfo.osType);
+    DeviceInfo oldInfo;
+    if (dvInfo.networkId != cloudDeviceInfo.networkId && deviceInfos_.Get(dvInfo.udid, oldInfo)) {
+        deviceInfos_.Set(dvInfo);
+    }
 }
 
 void DeviceManagerAdapter::OnReady(const DeviceInfo &dvInfo)
@@ -370,9 +380,10 @@ void DeviceManagerAdapter::SaveDeviceInfo(const DeviceInfo &dvInfo, const Device
     }
     switch (type) {
         case DeviceChangeType::DEVICE_ONLINE: {
-            deviceInfos_.Set(dvInfo.networkId, dvInfo);
-            deviceInfos_.Set(dvInfo.uuid, dvInfo);
-            deviceInfos_.Set(dvInfo.udid, dvInfo);
+            deviceInfos_.Set(dvInfo);
+            unknownIds_.Delete(dvInfo.networkId);
+            unknownIds_.Delete(dvInfo.uuid);
+            unknownIds_.Delete(dvInfo.udid);
             readyDevices_.InsertOrAssign(dvInfo.uuid, std::make_pair(DeviceState::DEVICE_ONLINE, dvInfo));
             if (dvInfo.osType != OH_OS_TYPE) {
                 otherDeviceInfos_.Set(dvInfo.networkId, dvInfo);
@@ -382,9 +393,7 @@ void DeviceManagerAdapter::SaveDeviceInfo(const DeviceInfo &dvInfo, const Device
             break;
         }
         case DeviceChangeType::DEVICE_OFFLINE: {
-            deviceInfos_.Delete(dvInfo.networkId);
-            deviceInfos_.Delete(dvInfo.uuid);
-            deviceInfos_.Delete(dvInfo.udid);
+            deviceInfos_.Delete(dvInfo);
             readyDevices_.Erase(dvInfo.uuid);
             if (dvInfo.osType != OH_OS_TYPE) {
                 otherDeviceInfos_.Delete(dvInfo.networkId);
@@ -410,6 +419,23 @@ DeviceInfo DeviceManagerAdapter::GetLocalDevice()
     return localInfo_;
 }
 
+DeviceInfo DeviceManagerAdapter::WaitLocalDevice(std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<decltype(devInfoMutex_)> lock(devInfoMutex_);
+    while (localInfo_.uuid.empty()) {
+        localInfo_ = GetLocalDeviceInfo();
+        auto now = std::chrono::steady_clock::now();
+        if (!localInfo_.uuid.empty() || now >= deadline) {
+            break;
+        }
+        // woken up as soon as the device manager is initialized or the local device changed
+        localCond_.wait_until(lock, std::min(deadline, now + LOCAL_DEVICE_RECHECK),
+            [this]() { return !localInfo_.uuid.empty(); });
+    }
+    return localInfo_;
+}
+
 std::vector<DeviceInfo> DeviceManagerAdapter::GetRemoteDevices()
 {
     std::vector<DmDeviceInfo> dmInfos;
@@ -457,19 +483,15 @@ bool DeviceManagerAdapter::IsDeviceReady(const std::string& id)
 bool DeviceManagerAdapter::IsOHOSType(const std::string &id)
 {
     DeviceInfo dvInfo;
-    if (!deviceInfos_.Get(id, dvInfo)) {
-        InitDeviceInfo();
-        deviceInfos_.Get(id, dvInfo);
-    }
+    FindDeviceInfo(id, dvInfo);
     return dvInfo.osType == OH_OS_TYPE;
 }
 
 int32_t DeviceManagerAdapter::GetAuthType(const std::string &id)
 {
     DeviceInfo dvInfo;
-    if (!otherDeviceInfos_.Get(id, dvInfo) && !deviceInfos_.Get(id, dvInfo)) {
-        InitDeviceInfo();
-        deviceInfos_.Get(id, dvInfo);
+    if (!otherDeviceInfos_.Get(id, dvInfo)) {
+        FindDeviceInfo(id, dvInfo);
     }
     return static_cast<int32_t>(dvInfo.authForm);
 }
@@ -487,16 +509,67 @@ DeviceInfo DeviceManagerAdapter::GetDeviceInfo(const std::string &id)
 DeviceInfo DeviceManagerAdapter::GetDeviceInfoFromCache(const std::string &id)
 {
     DeviceInfo dvInfo;
-    if (!deviceInfos_.Get(id, dvInfo)) {
-        InitDeviceInfo();
-        deviceInfos_.Get(id, dvInfo);
-    }
+    FindDeviceInfo(id, dvInfo);
     if (dvInfo.uuid.empty()) {
         ZLOGE("invalid id:%{public}s", KvStoreUtils::ToBeAnonymous(id).c_str());
     }
     return dvInfo;
 }
 
+bool DeviceManagerAdapter::FindDeviceInfo(const std::string &id, DeviceInfo &dvInfo)
+{
+    if (deviceInfos_.Get(id, dvInfo)) {
+        return true;
+    }
+    Time expireTime;
+    if (unknownIds_.Get(id, expireTime)) {
+        if (std::chrono::steady_clock::now() < expireTime) {
+            unknownHits_++;
+            return false;
+        }
+        unknownIds_.Delete(id);
+    }
+    RefreshDeviceInfo();
+    if (deviceInfos_.Get(id, dvInfo)) {
+        return true;
+    }
+    unknownIds_.Set(id, std::chrono::steady_clock::now() + UNKNOWN_EXPIRE);
+    return false;
+}
+
+void DeviceManagerAdapter::RefreshDeviceInfo()
+{
+    std::unique_lock<decltype(refreshMutex_)> lock(refreshMutex_);
+    if (refreshing_) {
+        // join the refresh in flight instead of enumerating the trusted devices again
+        auto round = refreshRound_;
+        refreshCond_.wait(lock, [this, round]() { return refreshRound_ != round; });
+        coalescedRefreshes_++;
+        return;
+    }
+    refreshing_ = true;
+    lock.unlock();
+    InitDeviceInfo();
+    lock.lock();
+    refreshing_ = false;
+    refreshRound_++;
+    refreshes_++;
+    refreshCond_.notify_all();
+}
+
+void DeviceManagerAdapter::DumpDeviceInfo(int fd, std::map<std::string, std::vector<std::string>> &params)
+{
+    (void)params;
+    std::string info;
+    info.append("devices:").append(std::to_string(deviceInfos_.Size()))
+        .append(" online:").append(std::to_string(readyDevices_.Size()))
+        .append(" refreshes:").append(std::to_string(refreshes_.load()))
+        .append(" coalesced:").append(std::to_string(coalescedRefreshes_.load()))
+        .append(" unknown hits:").append(std::to_string(unknownHits_.load()));
+    dprintf(fd, "-------------------------------------DeviceManagerInfo------------------------------\n%s\n",
+        info.c_str());
+}
+
 void DeviceManagerAdapter::InitDeviceInfo(bool onlyCache)
 {
     std::vector<DeviceInfo> dvInfos = GetRemoteDevices();
@@ -512,17 +585,21 @@ void DeviceManagerAdapter::InitDeviceInfo(bool onlyCache)
                 KvStoreUtils::ToBeAnonymous(info.networkId).c_str(), info.uuid.empty(), info.udid.empty());
             continue;
         }
-        deviceInfos_.Set(info.networkId, info);
-        deviceInfos_.Set(info.uuid, info);
-        deviceInfos_.Set(info.udid, info);
+        deviceInfos_.Set(info);
         if (!onlyCache) {
             readyDevices_.InsertOrAssign(info.uuid, std::make_pair(DeviceState::DEVICE_ONREADY, info));
         }
     }
     auto local = GetLocalDeviceInfo();
-    deviceInfos_.Set(local.networkId, local);
-    deviceInfos_.Set(local.uuid, local);
-    deviceInfos_.Set(local.udid, local);
+    deviceInfos_.Set(local);
+    if (local.uuid.empty()) {
+        return;
+    }
+    std::lock_guard<decltype(devInfoMutex_)> lock(devInfoMutex_);
+    if (localInfo_.uuid.empty() || localInfo_.udid.empty()) {
+        localInfo_ = local;
+    }
+    localCond_.notify_all();
 }
 
 DeviceInfo DeviceManagerAdapter::GetLocalDeviceInfo()
@@ -708,13 +785,69 @@ void DeviceManagerAdapter::ResetLocalDeviceInfo()
     {
         std::lock_guard<decltype(devInfoMutex_)> lock(devInfoMutex_);
         localInfo_ = local;
+        localCond_.notify_all();
     }
-    DeviceInfo dvInfo;
-    if (deviceInfos_.Get(local.udid, dvInfo)) {
-        deviceInfos_.Delete(dvInfo.networkId);
+    // the entry of the old networkId is replaced together with the other ids of the local device
+    deviceInfos_.Set(local);
+}
+
+bool DeviceManagerAdapter::DeviceIndex::Get(const std::string &id, DeviceInfo &dvInfo) const
+{
+    std::shared_lock<decltype(mutex_)> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return false;
+    }
+    dvInfo = *it->second;
+    return true;
+}
+
+void DeviceManagerAdapter::DeviceIndex::Set(const DeviceInfo &dvInfo)
+{
+    const std::string *ids[] = { &dvInfo.networkId, &dvInfo.uuid, &dvInfo.udid };
+    auto entry = std::make_shared<const DeviceInfo>(dvInfo);
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    for (auto id : ids) {
+        auto it = entries_.find(*id);
+        if (it != entries_.end()) {
+            EraseLocked(it->second);
+        }
+    }
+    bool inserted = false;
+    for (auto id : ids) {
+        if (!id->empty()) {
+            entries_[*id] = entry;
+            inserted = true;
+        }
+    }
+    devices_ += inserted ? 1 : 0;
+}
+
+void DeviceManagerAdapter::DeviceIndex::Delete(const DeviceInfo &dvInfo)
+{
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    for (auto id : { &dvInfo.networkId, &dvInfo.uuid, &dvInfo.udid }) {
+        auto it = entries_.find(*id);
+        if (it != entries_.end()) {
+            EraseLocked(it->second);
+        }
+    }
+}
+
+size_t DeviceManagerAdapter::DeviceIndex::Size() const
+{
+    std::shared_lock<decltype(mutex_)> lock(mutex_);
+    return devices_;
+}
+
+void DeviceManagerAdapter::DeviceIndex::EraseLocked(std::shared_ptr<const DeviceInfo> entry)
+{
+    for (auto id : { &entry->networkId, &entry->uuid, &entry->udid }) {
+        auto it = entries_.find(*id);
+        if (it != entries_.end() && it->second == entry) {
+            entries_.erase(it);
+        }
     }
-    deviceInfos_.Set(local.uuid, local);
-    deviceInfos_.Set(local.udid, local);
-    deviceInfos_.Set(local.networkId, local);
+    devices_--;
 }
 } // namespace OHOS::DistributedData
@@ -139,6 +139,12 @@ DeviceInfo DeviceManagerAdapter::GetLocalDevice()
     return {"localuuid", "localudid", "localnetworkId", "localdeviceName"};
 }
 
+DeviceInfo DeviceManagerAdapter::WaitLocalDevice(std::chrono::milliseconds timeout)
+{
+    (void)timeout;
+    return GetLocalDevice();
+}
+
 std::vector<DeviceInfo> DeviceManagerAdapter::GetRemoteDevices()
 {
     return {};
@@ -21,6 +21,7 @@
 #include "nativetoken_kit.h"
 #include "token_setproc.h"
 #include "types.h"
+#include <thread>
 namespace {
 using namespace testing::ext;
 using namespace OHOS::AppDistributedKv;
@@ -606,4 +607,103 @@ HWTEST_F(DeviceManagerAdapterTest, RegisterDelegateInstance, TestSize.Level0)
     DeviceManagerDelegate::RegisterInstance(&DeviceManagerAdapter::GetInstance());
     EXPECT_NE(nullptr, DeviceManagerDelegate::GetInstance());
 }
+/**
+* @tc.name: DeviceIndex
+* @tc.desc: one entry per device, a reconnected device replaces the keys of its old entry
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DeviceManagerAdapterTest, DeviceIndex, TestSize.Level0)
+{
+    DeviceManagerAdapter::DeviceIndex index;
+    DeviceInfo info;
+    info.uuid = "uuid";
+    info.udid = "udid";
+    info.networkId = "networkId";
+    index.Set(info);
+    EXPECT_EQ(index.Size(), 1);
+    DeviceInfo result;
+    ASSERT_TRUE(index.Get("udid", result));
+    EXPECT_EQ(result.networkId, "networkId");
+
+    info.networkId = "newNetworkId";
+    index.Set(info);
+    EXPECT_EQ(index.Size(), 1);
+    EXPECT_FALSE(index.Get("networkId", result));
+    ASSERT_TRUE(index.Get("uuid", result));
+    EXPECT_EQ(result.networkId, "newNetworkId");
+
+    index.Delete(info);
+    EXPECT_EQ(index.Size(), 0);
+    EXPECT_FALSE(index.Get("uuid", result));
+    EXPECT_FALSE(index.Get("newNetworkId", result));
+}
+
+/**
+* @tc.name: UnknownIdCached
+* @tc.desc: an unknown id refreshes the trusted devices once until it expires
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DeviceManagerAdapterTest, UnknownIdCached, TestSize.Level0)
+{
+    auto &adapter = DeviceManagerAdapter::GetInstance();
+    std::string id = "unknownIdCached";
+    auto refreshes = adapter.refreshes_.load() + adapter.coalescedRefreshes_.load();
+    auto hits = adapter.unknownHits_.load();
+    EXPECT_TRUE(adapter.ToUUID(id).empty());
+    EXPECT_TRUE(adapter.ToNetworkID(id).empty());
+    EXPECT_FALSE(adapter.IsOHOSType(id));
+    EXPECT_EQ(adapter.refreshes_.load() + adapter.coalescedRefreshes_.load(), refreshes + 1);
+    EXPECT_EQ(adapter.unknownHits_.load(), hits + 2);
+
+    DeviceInfo info;
+    info.uuid = id;
+    info.udid = "unknownIdCachedUdid";
+    info.networkId = "unknownIdCachedNetworkId";
+    adapter.SaveDeviceInfo(info, DeviceChangeType::DEVICE_ONLINE);
+    EXPECT_EQ(adapter.ToNetworkID(id), info.networkId);
+    adapter.SaveDeviceInfo(info, DeviceChangeType::DEVICE_OFFLINE);
+}
+
+/**
+* @tc.name: RefreshSingleFlight
+* @tc.desc: concurrent misses during a refresh join it instead of refreshing the trusted devices again
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DeviceManagerAdapterTest, RefreshSingleFlight, TestSize.Level0)
+{
+    auto &adapter = DeviceManagerAdapter::GetInstance();
+    ASSERT_FALSE(adapter.GetLocalDevice().uuid.empty());
+    constexpr int threadNum = 8;
+    const std::string id = "singleFlight";
+    adapter.unknownIds_.Delete(id);
+    auto refreshes = adapter.refreshes_.load();
+    auto coalesced = adapter.coalescedRefreshes_.load();
+    auto unknownHits = adapter.unknownHits_.load();
+    std::vector<std::thread> threads;
+    {
+        // the first refresh stays blocked on the local device until all the callers are fired
+        std::unique_lock<decltype(adapter.devInfoMutex_)> blocker(adapter.devInfoMutex_);
+        threads.emplace_back([&adapter, id]() { adapter.ToUUID(id); });
+        bool refreshing = false;
+        while (!refreshing) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<decltype(adapter.refreshMutex_)> lock(adapter.refreshMutex_);
+            refreshing = adapter.refreshing_;
+        }
+        for (int i = 1; i < threadNum; i++) {
+            threads.emplace_back([&adapter, id]() { adapter.ToUUID(id); });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(adapter.refreshes_.load() - refreshes, 1);
+    // a caller too late for the refresh finds the id in the unknown ids instead
+    EXPECT_EQ(adapter.coalescedRefreshes_.load() - coalesced + adapter.unknownHits_.load() - unknownHits,
+        threadNum - 1);
+}
 } // namespace
\ No newline at end of file
@@ -16,8 +16,16 @@
 #ifndef DISTRIBUTEDDATAMGR_DATAMGR_DEVICE_MANAGER_ADAPTER_H
 #define DISTRIBUTEDDATAMGR_DATAMGR_DEVICE_MANAGER_ADAPTER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "app_device_change_listener.h"
 #include "commu_types.h"
@@ -59,6 +67,8 @@ public:
     Status StartWatchDeviceChange(const AppDeviceChangeListener *observer, const PipeInfo &pipeInfo);
     Status StopWatchDeviceChange(const AppDeviceChangeListener *observer, const PipeInfo &pipeInfo);
     DeviceInfo GetLocalDevice() override;
+    // Returns once the uuid of the local device is known, or with an empty uuid after the timeout.
+    DeviceInfo WaitLocalDevice(std::chrono::milliseconds timeout);
     std::vector<DeviceInfo> GetRemoteDevices();
     std::vector<DeviceInfo> GetOnlineDevices();
     bool IsDeviceReady(const std::string &id);
@@ -86,6 +96,26 @@ public:
     friend class NetConnCallbackObserver;
 
 private:
+    // One entry per device, reachable by its networkId, uuid and udid.
+    class DeviceIndex {
+    public:
+        bool Get(const std::string &id, DeviceInfo &dvInfo) const;
+        void Set(const DeviceInfo &dvInfo);
+        void Delete(const DeviceInfo &dvInfo);
+        size_t Size() const;
+
+    private:
+        void EraseLocked(std::shared_ptr<const DeviceInfo> entry);
+
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string, std::shared_ptr<const DeviceInfo>> entries_;
+        size_t devices_ = 0;
+    };
+    static constexpr std::chrono::seconds UNKNOWN_EXPIRE = std::chrono::seconds(3);
+    static constexpr size_t MAX_UNKNOWN_IDS = 64;
+    // the device manager may know the local device before any of its callbacks reached us
+    static constexpr std::chrono::milliseconds LOCAL_DEVICE_RECHECK = std::chrono::milliseconds(1000);
+
     DeviceManagerAdapter();
     ~DeviceManagerAdapter();
     std::function<void()> RegDevCallback();
@@ -93,6 +123,9 @@ private:
     void InitDeviceInfo(bool onlyCache = true);
     DeviceInfo GetLocalDeviceInfo();
     DeviceInfo GetDeviceInfoFromCache(const std::string &id);
+    bool FindDeviceInfo(const std::string &id, DeviceInfo &dvInfo);
+    void RefreshDeviceInfo();
+    void DumpDeviceInfo(int fd, std::map<std::string, std::vector<std::string>> &params);
     void Online(const DeviceInfo &dvInfo);
     void OnChanged(const DeviceInfo &dvInfo);
     std::vector<const AppDeviceChangeListener *> GetObservers();
@@ -106,9 +139,19 @@ private:
 
     std::mutex devInfoMutex_ {};
     DeviceInfo localInfo_ {};
+    std::condition_variable localCond_ {};
     const DeviceInfo cloudDeviceInfo;
     ConcurrentMap<const AppDeviceChangeListener *, const AppDeviceChangeListener *> observers_ {};
-    LRUBucket<std::string, DeviceInfo> deviceInfos_ {64};
+    DeviceIndex deviceInfos_ {};
+    // ids the trusted device list did not know, they are not refreshed again before the expiry time
+    LRUBucket<std::string, Time> unknownIds_ {MAX_UNKNOWN_IDS};
+    std::mutex refreshMutex_ {};
+    std::condition_variable refreshCond_ {};
+    bool refreshing_ = false;
+    uint64_t refreshRound_ = 0;
+    std::atomic<uint64_t> refreshes_ = 0;
+    std::atomic<uint64_t> coalescedRefreshes_ = 0;
+    std::atomic<uint64_t> unknownHits_ = 0;
     LRUBucket<std::string, DeviceInfo> otherDeviceInfos_ {64};
     ConcurrentMap<std::string, std::string> syncTask_ {};
     std::shared_ptr<ExecutorPool> executors_;
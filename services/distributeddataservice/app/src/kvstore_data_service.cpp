@@ -31,6 +31,7 @@
 #include "auth_delegate.h"
 #include "auto_launch_export.h"
 #include "bootstrap.h"
+#include "changeevent/remote_change_event.h"
 #include "checker/checker_manager.h"
 #include "communication_provider.h"
 #include "communicator_context.h"
@@ -48,6 +49,7 @@
 #include "installer/installer.h"
 #include "iservice_registry.h"
 #include "kvstore_account_observer.h"
+#include "kvstore_memory_observer.h"
 #include "kvstore_screen_observer.h"
 #include "log_print.h"
 #include "mem_mgr_client.h"
@@ -74,7 +76,6 @@
 #include "user_delegate.h"
 #include "utils/anonymous.h"
 #include "utils/base64_utils.h"
-#include "utils/block_integer.h"
 #include "utils/constant.h"
 #include "utils/crypto.h"
 namespace OHOS::DistributedKv {
@@ -94,6 +95,8 @@ constexpr char FOUNDATION_PROCESS_NAME[] = "foundation";
 constexpr int MAX_DOWNLOAD_ASSETS_COUNT = 50;
 constexpr int MAX_DOWNLOAD_TASK = 5;
 constexpr int MAX_CLIENT_DEATH_OBSERVER_SIZE = 16;
+constexpr std::chrono::milliseconds LOCAL_DEVICE_TIMEOUT = std::chrono::milliseconds(25000);
+constexpr uint32_t MAX_OPEN_STORES = 64;
 
 KvStoreDataService::KvStoreDataService(bool runOnCreate)
     : SystemAbility(runOnCreate), clients_()
@@ -344,24 +347,36 @@ void KvStoreDataService::InitExecutor()
 void KvStoreDataService::OnStart()
 {
     ZLOGI("distributeddata service onStart");
-    LoadConfigs();
+    Bootstrap::GetInstance().LoadThread();
+    InitExecutor();
     EventCenter::Defer defer;
-    Reporter::GetInstance()->SetThreadPool(executors_);
-    AccountDelegate::GetInstance()->BindExecutor(executors_);
-    ScreenManager::GetInstance()->BindExecutor(executors_);
-    AccountDelegate::GetInstance()->RegisterHashFunc(Crypto::Sha256);
-    DmAdapter::GetInstance().Init(executors_);
-    AutoCache::GetInstance().Bind(executors_);
-    NetworkDelegate::GetInstance()->BindExecutor(executors_);
-    static constexpr int32_t RETRY_TIMES = 50;
-    static constexpr int32_t RETRY_INTERVAL = 500 * 1000; // unit is ms
-    for (BlockInteger retry(RETRY_INTERVAL); retry < RETRY_TIMES; ++retry) {
-        if (!DmAdapter::GetInstance().GetLocalDevice().uuid.empty()) {
-            break;
+    LoadConfigs();
+    // the events posted while binding are held by the defer of this thread
+    startup_.AddStage("bind_executors", [this]() {
+        Reporter::GetInstance()->SetThreadPool(executors_);
+        AccountDelegate::GetInstance()->BindExecutor(executors_);
+        ScreenManager::GetInstance()->BindExecutor(executors_);
+        AccountDelegate::GetInstance()->RegisterHashFunc(Crypto::Sha256);
+        DmAdapter::GetInstance().Init(executors_);
+        AutoCache::GetInstance().Bind(executors_);
+        AutoCache::GetInstance().SetEvictionPolicy(std::make_shared<AutoCache::LfuPolicy>(), MAX_OPEN_STORES);
+        EventCenter::GetInstance().BindExecutor(executors_);
+        EventCenter::GetInstance().RegisterMerger(RemoteChangeEvent::DATA_CHANGE, RemoteChangeEvent::Merge);
+        NetworkDelegate::GetInstance()->BindExecutor(executors_);
+    }, { "components" }, StartupGraph::CALLER_THREAD);
+    startup_.AddStage("local_device", []() {
+        if (DmAdapter::GetInstance().WaitLocalDevice(LOCAL_DEVICE_TIMEOUT).uuid.empty()) {
+            ZLOGW("GetLocalDeviceId failed in %{public}lld ms", static_cast<long long>(LOCAL_DEVICE_TIMEOUT.count()));
         }
-        ZLOGW("GetLocalDeviceId failed, retry count:%{public}d", static_cast<int>(retry));
-    }
-    Initialize();
+    }, { "bind_executors" });
+    startup_.Run(executors_);
+    DumpManager::GetInstance().AddFeatureHandler(uintptr_t(&startup_),
+        [this](int fd, std::map<std::string, std::vector<std::string>> &params) {
+            (void)params;
+            dprintf(fd, "-------------------------------------StartupInfo------------------------------------\n%s",
+                startup_.Dump().c_str());
+        });
+    startup_.Measure("initialize", [this]() { Initialize(); });
     auto samgr = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
     if (samgr != nullptr) {
         ZLOGI("samgr exist.");
@@ -385,24 +400,27 @@ void KvStoreDataService::OnStart()
     Handler handlerBundleInfo = std::bind(&KvStoreDataService::DumpBundleInfo, this, std::placeholders::_1,
         std::placeholders::_2);
     DumpManager::GetInstance().AddHandler("BUNDLE_INFO", uintptr_t(this), handlerBundleInfo);
-    StartService();
+    startup_.Measure("start_service", [this]() { StartService(); });
 }
 
+// Adds the config stages to the startup graph, only the plugins of the components come before the others.
 void KvStoreDataService::LoadConfigs()
 {
     ZLOGI("Bootstrap configs and plugins.");
-    Bootstrap::GetInstance().LoadThread();
-    InitExecutor();
-    Bootstrap::GetInstance().LoadComponents();
-    Bootstrap::GetInstance().LoadDirectory();
-    Bootstrap::GetInstance().LoadCheckers();
-    Bootstrap::GetInstance().LoadNetworks();
-    Bootstrap::GetInstance().LoadBackup(executors_);
-    Bootstrap::GetInstance().LoadCloud();
-    Bootstrap::GetInstance().LoadAppIdMappings();
-    Bootstrap::GetInstance().LoadAutoSyncApps();
-    Bootstrap::GetInstance().LoadSyncTrustedApp();
-    Bootstrap::GetInstance().LoadDoubleSyncConfig();
+    auto &bootstrap = Bootstrap::GetInstance();
+    startup_.AddStage("components", [&bootstrap]() { bootstrap.LoadComponents(); });
+    startup_.AddStage("directory", [&bootstrap]() { bootstrap.LoadDirectory(); });
+    startup_.AddStage("checkers", [&bootstrap]() { bootstrap.LoadCheckers(); }, { "components" });
+    startup_.AddStage("networks", [&bootstrap]() { bootstrap.LoadNetworks(); }, { "components" });
+    startup_.AddStage("backup", [&bootstrap, this]() { bootstrap.LoadBackup(executors_); },
+        { "components", "directory" });
+    startup_.AddStage("cloud", [&bootstrap]() { bootstrap.LoadCloud(); });
+    startup_.AddStage("app_id_mappings", [&bootstrap]() { bootstrap.LoadAppIdMappings(); });
+    startup_.AddStage("auto_sync_apps", [&bootstrap]() { bootstrap.LoadAutoSyncApps(); });
+    startup_.AddStage("sync_trusted_apps", [&bootstrap]() { bootstrap.LoadSyncTrustedApp(); });
+    // both fill the sync manager
+    startup_.AddStage("double_sync_config", [&bootstrap]() { bootstrap.LoadDoubleSyncConfig(); },
+        { "auto_sync_apps" });
 }
 
 void KvStoreDataService::OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
@@ -428,6 +446,10 @@ void KvStoreDataService::OnAddSystemAbility(int32_t systemAbilityId, const std::
         Memory::MemMgrClient::GetInstance().NotifyProcessStatus(getpid(), 1, 1, DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID);
         // process set critical true
         Memory::MemMgrClient::GetInstance().SetCritical(getpid(), true, DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID);
+        if (memoryObserver_ == nullptr) {
+            memoryObserver_ = std::make_shared<KvStoreMemoryObserver>(executors_);
+            Memory::MemMgrClient::GetInstance().SubscribeAppState(*memoryObserver_);
+        }
     } else if (systemAbilityId == COMM_NET_CONN_MANAGER_SYS_ABILITY_ID) {
         NetworkDelegate::GetInstance()->RegOnNetworkChange();
     } else if (systemAbilityId == CONCURRENT_TASK_SERVICE_ID) {
@@ -580,6 +602,9 @@ void KvStoreDataService::OnStop()
     // process set critical false
     Memory::MemMgrClient::GetInstance().SetCritical(getpid(), false, DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID);
     Memory::MemMgrClient::GetInstance().NotifyProcessStatus(getpid(), 1, 0, DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID);
+    if (memoryObserver_ != nullptr) {
+        Memory::MemMgrClient::GetInstance().UnsubscribeAppState(*memoryObserver_);
+    }
 }
 
 KvStoreDataService::KvStoreClientDeathObserverImpl::KvStoreClientDeathObserverImpl(const AppId &appId,
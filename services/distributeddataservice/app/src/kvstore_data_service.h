@@ -36,6 +36,7 @@
 #include "screen/screen_manager.h"
 #include "security/security.h"
 #include "system_ability.h"
+#include "thread/startup_graph.h"
 #include "types.h"
 #include "unique_fd.h"
 
@@ -43,6 +44,7 @@ namespace OHOS::DistributedKv {
 using namespace DistributedData;
 class KvStoreAccountObserver;
 class KvStoreScreenObserver;
+class KvStoreMemoryObserver;
 class KvStoreDataService : public SystemAbility, public KvStoreDataServiceStub {
     DECLARE_SYSTEM_ABILITY(KvStoreDataService);
     using Handler = std::function<void(int, std::map<std::string, std::vector<std::string>> &)>;
@@ -204,11 +206,13 @@ private:
     ConcurrentMap<uint32_t, std::map<int32_t, KvStoreClientDeathObserverImpl>> clients_;
     std::shared_ptr<KvStoreAccountObserver> accountEventObserver_;
     std::shared_ptr<KvStoreScreenObserver> screenEventObserver_;
+    std::shared_ptr<KvStoreMemoryObserver> memoryObserver_;
 
     std::shared_ptr<Security> security_;
     ConcurrentMap<std::string, sptr<DistributedData::FeatureStubImpl>> features_;
     std::shared_ptr<KvStoreDeviceListener> deviceInnerListener_;
     std::shared_ptr<ExecutorPool> executors_;
+    DistributedData::StartupGraph startup_;
     static constexpr int VERSION_WIDTH = 11;
     static constexpr const char *INDENTATION = "    ";
     static constexpr int32_t FORMAT_BLANK_SIZE = 32;
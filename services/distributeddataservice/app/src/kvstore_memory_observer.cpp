@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "KvStoreMemoryObserver"
+
+#include "kvstore_memory_observer.h"
+
+#include "log_print.h"
+#include "store/auto_cache.h"
+
+namespace OHOS {
+namespace DistributedKv {
+using namespace DistributedData;
+void KvStoreMemoryObserver::OnConnected()
+{
+    ZLOGI("memory manager connected");
+}
+
+void KvStoreMemoryObserver::OnDisconnected()
+{
+    ZLOGI("memory manager disconnected");
+}
+
+void KvStoreMemoryObserver::OnAppStateChanged(int32_t pid, int32_t uid, int32_t state)
+{
+}
+
+void KvStoreMemoryObserver::ForceReclaim(int32_t pid, int32_t uid)
+{
+}
+
+void KvStoreMemoryObserver::OnTrim(Memory::SystemMemoryLevel level)
+{
+    int32_t pressure = AutoCache::MEMORY_LEVEL_MODERATE;
+    switch (level) {
+        case Memory::SystemMemoryLevel::MEMORY_LEVEL_MODERATE:
+            pressure = AutoCache::MEMORY_LEVEL_MODERATE;
+            break;
+        case Memory::SystemMemoryLevel::MEMORY_LEVEL_LOW:
+            pressure = AutoCache::MEMORY_LEVEL_LOW;
+            break;
+        case Memory::SystemMemoryLevel::MEMORY_LEVEL_CRITICAL:
+            pressure = AutoCache::MEMORY_LEVEL_CRITICAL;
+            break;
+        default:
+            return;
+    }
+    // closing the stores waits for their locks, so not on the binder thread
+    auto task = [pressure]() {
+        AutoCache::GetInstance().OnMemoryPressure(pressure);
+    };
+    if (executors_ == nullptr || executors_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+        task();
+    }
+}
+
+void KvStoreMemoryObserver::OnRemoteDied(const wptr<IRemoteObject> &object)
+{
+    ZLOGW("memory manager died");
+}
+} // namespace DistributedKv
+} // namespace OHOS
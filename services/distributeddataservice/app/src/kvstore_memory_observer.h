@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KVSTORE_MEMORY_OBSERVER_H
+#define KVSTORE_MEMORY_OBSERVER_H
+
+#include "app_state_subscriber.h"
+#include "executor_pool.h"
+
+namespace OHOS {
+namespace DistributedKv {
+// closes the cached stores when the memory manager asks the service to trim its memory.
+class KvStoreMemoryObserver : public Memory::AppStateSubscriber {
+public:
+    explicit KvStoreMemoryObserver(std::shared_ptr<ExecutorPool> executors) : executors_(std::move(executors))
+    {
+    }
+    ~KvStoreMemoryObserver() override = default;
+
+    void OnConnected() override;
+    void OnDisconnected() override;
+    void OnAppStateChanged(int32_t pid, int32_t uid, int32_t state) override;
+    void ForceReclaim(int32_t pid, int32_t uid) override;
+    void OnTrim(Memory::SystemMemoryLevel level) override;
+    void OnRemoteDied(const wptr<IRemoteObject> &object) override;
+
+private:
+    std::shared_ptr<ExecutorPool> executors_;
+};
+} // namespace DistributedKv
+} // namespace OHOS
+#endif // KVSTORE_MEMORY_OBSERVER_H
@@ -15,6 +15,9 @@
 
 #include "changeevent/remote_change_event.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace OHOS::DistributedData {
 RemoteChangeEvent::RemoteChangeEvent(int32_t evtId, DataInfo&& info)
     : Event(evtId), info_(std::move(info))
@@ -25,4 +28,31 @@ const RemoteChangeEvent::DataInfo& RemoteChangeEvent::GetDataInfo() const
 {
     return info_;
 }
+
+size_t RemoteChangeEvent::GetHash() const
+{
+    std::hash<std::string> hasher;
+    size_t hash = std::hash<int>()(info_.changeType);
+    for (auto *field : { &info_.userId, &info_.storeId, &info_.deviceId, &info_.bundleName }) {
+        hash ^= hasher(*field) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+bool RemoteChangeEvent::Merge(Event &queued, const Event &event)
+{
+    auto &target = static_cast<RemoteChangeEvent &>(queued).info_;
+    auto &source = static_cast<const RemoteChangeEvent &>(event).info_;
+    if (target.changeType != source.changeType || target.userId != source.userId ||
+        target.storeId != source.storeId || target.deviceId != source.deviceId ||
+        target.bundleName != source.bundleName || target.tables.empty() || source.tables.empty()) {
+        return false;
+    }
+    for (auto &table : source.tables) {
+        if (std::find(target.tables.begin(), target.tables.end(), table) == target.tables.end()) {
+            target.tables.push_back(table);
+        }
+    }
+    return true;
+}
 } // namespace OHOS::DistributedData
\ No newline at end of file
@@ -273,7 +273,7 @@ bool Field::operator==(const Field &field) const
            std::tie(field.colName, field.alias, field.type, field.primary, field.nullable, field.dupCheckCol);
 }
 
-Database SchemaMeta::GetDataBase(const std::string &storeId)
+Database SchemaMeta::GetDataBase(const std::string &storeId) const
 {
     for (const auto &database : databases) {
         if (database.name == storeId) {
@@ -288,7 +288,7 @@ bool SchemaMeta::IsValid() const
     return !bundleName.empty() && !databases.empty();
 }
 
-std::vector<std::string> SchemaMeta::GetStores()
+std::vector<std::string> SchemaMeta::GetStores() const
 {
     std::vector<std::string> stores;
     for (const auto &it : databases) {
@@ -15,6 +15,8 @@
 #include "dump/dump_manager.h"
 namespace OHOS {
 namespace DistributedData {
+static constexpr const char *FEATURE_INFO = "FEATURE_INFO";
+
 DumpManager &DumpManager::GetInstance()
 {
     static DumpManager instance;
@@ -54,6 +56,17 @@ void DumpManager::AddHandler(const std::string &infoName, uintptr_t ptr, const H
     });
 }
 
+void DumpManager::AddFeatureHandler(uintptr_t ptr, const Handler &handler)
+{
+    Config config;
+    config.fullCmd = "--feature-info";
+    config.abbrCmd = "-f";
+    config.dumpName = FEATURE_INFO;
+    config.dumpCaption = { "| Display all the service statistics" };
+    AddConfig(FEATURE_INFO, config);
+    AddHandler(FEATURE_INFO, ptr, handler);
+}
+
 std::vector<DumpManager::Handler> DumpManager::GetHandler(const std::string &infoName)
 {
     auto it = handlers_.Find(infoName);
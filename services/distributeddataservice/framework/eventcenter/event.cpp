@@ -31,5 +31,10 @@ bool Event::Equals(const Event &) const
 {
     return false;
 }
+
+size_t Event::GetHash() const
+{
+    return 0;
+}
 } // namespace DistributedData
 } // namespace OHOS
\ No newline at end of file
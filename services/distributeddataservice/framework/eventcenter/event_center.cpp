@@ -13,10 +13,18 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "EventCenter"
 #include "eventcenter/event_center.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "dump/dump_manager.h"
+#include "log_print.h"
 namespace OHOS {
 namespace DistributedData {
 thread_local EventCenter::AsyncQueue *EventCenter::asyncQueue_ = nullptr;
+thread_local const EventCenter::AsyncChannel *EventCenter::draining_ = nullptr;
 constexpr int32_t EventCenter::AsyncQueue::MAX_CAPABILITY;
 EventCenter &EventCenter::GetInstance()
 {
@@ -24,17 +32,94 @@ EventCenter &EventCenter::GetInstance()
     return eventCenter;
 }
 
-bool EventCenter::Subscribe(int32_t evtId, const std::function<void(const Event &)> &observer)
+bool EventCenter::Subscribe(int32_t evtId, const std::function<void(const Event &)> &observer, bool async,
+    uint32_t capacity)
 {
-    return observers_.Compute(evtId, [&observer](const auto &id, auto &list) -> bool {
-        list.push_back(observer);
+    if (async && capacity == 0) {
+        return false;
+    }
+    return observers_.Compute(evtId, [&observer, async, capacity](const auto &id, Channel &channel) -> bool {
+        if (channel.latency == nullptr) {
+            channel.latency = std::make_shared<Histogram>();
+        }
+        // the dispatching threads keep the old snapshot, so it is copied instead of modified.
+        auto observers = channel.observers == nullptr ? std::make_shared<Observers>()
+                                                      : std::make_shared<Observers>(*channel.observers);
+        observers->push_back({ observer,
+            async ? std::make_shared<AsyncChannel>(observer, channel.latency, capacity) : nullptr });
+        channel.observers = std::move(observers);
         return true;
     });
 }
 
 bool EventCenter::Unsubscribe(int32_t evtId)
 {
-    return observers_.Erase(evtId);
+    bool subscribed = false;
+    // the channel is kept for the latency of the event id.
+    observers_.ComputeIfPresent(evtId, [&subscribed](const auto &id, Channel &channel) -> bool {
+        subscribed = channel.observers != nullptr;
+        if (subscribed) {
+            for (auto &observer : *channel.observers) {
+                if (observer.channel == nullptr) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(observer.channel->mutex);
+                observer.channel->closed = true;
+                observer.channel->events.clear();
+                observer.channel->cond.notify_all();
+            }
+        }
+        channel.observers = nullptr;
+        return true;
+    });
+    return subscribed;
+}
+
+bool EventCenter::RegisterMerger(int32_t evtId, Merger merger)
+{
+    if (merger == nullptr) {
+        return mergers_.Erase(evtId);
+    }
+    mergers_.InsertOrAssign(evtId, std::move(merger));
+    return true;
+}
+
+EventCenter::Merger EventCenter::GetMerger(int32_t evtId) const
+{
+    auto [exist, merger] = mergers_.Find(evtId);
+    return exist ? merger : nullptr;
+}
+
+std::shared_ptr<ExecutorPool> EventCenter::GetExecutors() const
+{
+    std::lock_guard<std::mutex> lock(executorsMutex_);
+    return executors_;
+}
+
+void EventCenter::BindExecutor(std::shared_ptr<ExecutorPool> executors)
+{
+    {
+        std::lock_guard<std::mutex> lock(executorsMutex_);
+        if (executors == nullptr || executors_ != nullptr) {
+            return;
+        }
+        executors_ = std::move(executors);
+    }
+    DumpManager::GetInstance().AddFeatureHandler(uintptr_t(this),
+        [this](int fd, std::map<std::string, std::vector<std::string>> &params) { DumpEventInfo(fd, params); });
+}
+
+std::vector<uint64_t> EventCenter::GetLatency(int32_t evtId) const
+{
+    auto [exist, channel] = observers_.Find(evtId);
+    if (!exist || channel.latency == nullptr) {
+        return {};
+    }
+    std::vector<uint64_t> buckets;
+    for (auto &bucket : channel.latency->buckets) {
+        buckets.push_back(bucket.load(std::memory_order_relaxed));
+    }
+    return buckets;
 }
 
 int32_t EventCenter::PostEvent(std::unique_ptr<Event> evt) const
@@ -44,25 +129,177 @@ int32_t EventCenter::PostEvent(std::unique_ptr<Event> evt) const
     }
     if (asyncQueue_ == nullptr) {
         Defer defer;
-        Dispatch(*evt);
+        Dispatch(std::move(evt));
         return CODE_SYNC;
     }
     asyncQueue_->Post(std::move(evt));
     return CODE_ASYNC;
 }
 
-void EventCenter::Dispatch(const Event &evt) const
+void EventCenter::Dispatch(const std::shared_ptr<Event> &evt) const
 {
-    auto observers = observers_.Find(evt.GetEventId());
-    if (!observers.first) {
+    auto [exist, channel] = observers_.Find(evt->GetEventId());
+    if (!exist || channel.observers == nullptr) {
         return;
     }
 
-    for (const auto &observer : observers.second) {
-        observer(evt);
+    auto begin = Clock::now();
+    bool isSync = false;
+    for (const auto &observer : *channel.observers) {
+        if (observer.channel != nullptr) {
+            PostAsync(observer.channel, evt, begin);
+            continue;
+        }
+        observer.observer(*evt);
+        isSync = true;
+    }
+    if (isSync) {
+        channel.latency->Record(Clock::now() - begin);
+    }
+}
+
+void EventCenter::PostAsync(std::shared_ptr<AsyncChannel> channel, const std::shared_ptr<Event> &evt,
+    Clock::time_point begin) const
+{
+    auto executors = GetExecutors();
+    if (executors == nullptr) {
+        channel->observer(*evt);
+        channel->latency->Record(Clock::now() - begin);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(channel->mutex);
+    if (channel->closed) {
+        return;
+    }
+    if (Coalesce(*channel, *evt)) {
+        channel->merged++;
+        return;
+    }
+    // the poster is slowed down by a full queue, the observer posting into its own queue can not wait for itself.
+    auto hasRoom = [&channel]() { return channel->closed || channel->events.size() < channel->capacity; };
+    if (!hasRoom() && (draining_ == channel.get() || !channel->cond.wait_for(lock, BUSY_WAIT, hasRoom))) {
+        channel->dropped++;
+        ZLOGW("queue full, drop event:%{public}d, capacity:%{public}u, dropped:%{public}" PRIu64,
+            evt->GetEventId(), channel->capacity, channel->dropped);
+        return;
+    }
+    if (channel->closed) {
+        return;
+    }
+    channel->events.emplace_back(evt, begin);
+    if (channel->running) {
+        return;
+    }
+    channel->running = true;
+    lock.unlock();
+    auto taskId = executors->Execute([this, channel]() { Drain(channel); });
+    if (taskId == ExecutorPool::INVALID_TASK_ID) {
+        ZLOGW("schedule failed, event:%{public}d is dispatched on the posting thread", evt->GetEventId());
+        Drain(channel);
     }
 }
 
+bool EventCenter::Coalesce(AsyncChannel &channel, const Event &evt) const
+{
+    auto hash = evt.GetHash();
+    if (hash == 0) {
+        return false;
+    }
+    for (auto it = channel.events.rbegin(); it != channel.events.rend(); ++it) {
+        auto &queued = it->first;
+        if (queued->GetHash() != hash) {
+            continue;
+        }
+        if (queued->Equals(evt)) {
+            return true;
+        }
+        // the other observers may still hold the queued event, it is only changed when this channel owns it.
+        if (queued.use_count() != 1) {
+            return false;
+        }
+        auto merger = GetMerger(evt.GetEventId());
+        return merger != nullptr && merger(*queued, evt);
+    }
+    return false;
+}
+
+void EventCenter::Drain(std::shared_ptr<AsyncChannel> channel) const
+{
+    auto outer = draining_;
+    draining_ = channel.get();
+    while (DrainBatch(*channel)) {
+        // yields the worker to other tasks, running stays true so no other task drains this channel meanwhile.
+        auto executors = GetExecutors();
+        if (executors != nullptr && executors->Execute([this, channel]() { Drain(channel); }) !=
+            ExecutorPool::INVALID_TASK_ID) {
+            break;
+        }
+        // the pending events are not left behind for a later post, this thread keeps dispatching them.
+        ZLOGW("reschedule failed, keep draining on this thread");
+    }
+    draining_ = outer;
+}
+
+bool EventCenter::DrainBatch(AsyncChannel &channel) const
+{
+    for (int32_t count = 0; count < AsyncQueue::MAX_CAPABILITY; count++) {
+        std::unique_lock<std::mutex> lock(channel.mutex);
+        if (channel.events.empty()) {
+            channel.running = false;
+            return false;
+        }
+        auto item = std::move(channel.events.front());
+        channel.events.pop_front();
+        channel.cond.notify_one();
+        lock.unlock();
+        Defer defer;
+        channel.observer(*item.first);
+        channel.latency->Record(Clock::now() - item.second);
+    }
+    return true;
+}
+
+void EventCenter::Histogram::Record(Clock::duration latency)
+{
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    uint32_t index = 0;
+    while (micros > 1 && index < LATENCY_BUCKETS - 1) {
+        micros >>= 1;
+        index++;
+    }
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventCenter::DumpEventInfo(int fd, std::map<std::string, std::vector<std::string>> &params)
+{
+    (void)params;
+    std::string info;
+    observers_.ForEach([&info](const int32_t &evtId, Channel &channel) {
+        if (channel.latency == nullptr) {
+            return false;
+        }
+        info.append("event:").append(std::to_string(evtId)).append(" latency(us, log2 buckets):");
+        for (auto &bucket : channel.latency->buckets) {
+            info.append(" ").append(std::to_string(bucket.load(std::memory_order_relaxed)));
+        }
+        for (size_t i = 0; channel.observers != nullptr && i < channel.observers->size(); ++i) {
+            auto &async = (*channel.observers)[i].channel;
+            if (async == nullptr) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(async->mutex);
+            info.append(" async observer:").append(std::to_string(i))
+                .append(" pending:").append(std::to_string(async->events.size()))
+                .append(" merged:").append(std::to_string(async->merged))
+                .append(" dropped:").append(std::to_string(async->dropped));
+        }
+        info.append("\n");
+        return false;
+    });
+    dprintf(fd, "-------------------------------------EventCenterInfo------------------------------\n%s\n",
+        info.c_str());
+}
+
 EventCenter::Defer::Defer(std::function<void(const Event &)> handler, int32_t evtId)
 {
     if (asyncQueue_ == nullptr) {
@@ -103,9 +340,11 @@ EventCenter::AsyncQueue &EventCenter::AsyncQueue::operator--()
     }
     depth_ = 1;
     for (int32_t count = 0; !events_.empty() && count < MAX_CAPABILITY; count++) {
-        auto &evt = events_.front();
+        auto evt = events_.front();
+        // the handlers may post the same change again, it must be queued instead of merged into the dispatched one.
+        RemoveIndex(evt.get());
         // dispatch to resident handlers
-        GetInstance().Dispatch(*evt);
+        GetInstance().Dispatch(evt);
 
         // dispatch to temporary handlers
         auto handler = handlers_.find(evt->GetEventId());
@@ -125,16 +364,56 @@ bool EventCenter::AsyncQueue::operator<=(int32_t depth) const
 
 void EventCenter::AsyncQueue::Post(std::unique_ptr<Event> evt)
 {
-    for (auto &event : events_) {
-        if (event->GetEventId() != evt->GetEventId()) {
-            continue;
+    auto hash = evt->GetHash();
+    if (hash == 0) {
+        for (auto &event : events_) {
+            if (event->GetEventId() != evt->GetEventId()) {
+                continue;
+            }
+
+            if (event->Equals(*evt)) {
+                return;
+            }
         }
+        events_.push_back(std::move(evt));
+        return;
+    }
+    auto key = GetIndexKey(evt->GetEventId(), hash);
+    auto range = index_.equal_range(key);
+    if (range.first != range.second) {
+        auto merger = GetInstance().GetMerger(evt->GetEventId());
+        for (auto it = range.first; it != range.second; ++it) {
+            auto &event = *it->second;
+            if (event.GetEventId() != evt->GetEventId() || event.GetHash() != hash) {
+                continue;
+            }
+            if (event.Equals(*evt) || (merger != nullptr && merger(event, *evt))) {
+                return;
+            }
+        }
+    }
+    index_.emplace(key, evt.get());
+    events_.push_back(std::move(evt));
+}
 
-        if (event->Equals(*evt)) {
+size_t EventCenter::AsyncQueue::GetIndexKey(int32_t evtId, size_t hash)
+{
+    return hash ^ (std::hash<int32_t>()(evtId) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
+
+void EventCenter::AsyncQueue::RemoveIndex(const Event *event)
+{
+    auto hash = event->GetHash();
+    if (hash == 0) {
+        return;
+    }
+    auto range = index_.equal_range(GetIndexKey(event->GetEventId(), hash));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == event) {
+            index_.erase(it);
             return;
         }
     }
-    events_.push_back(std::move(evt));
 }
 
 void EventCenter::AsyncQueue::AddHandler(int32_t evtId, std::function<void(const Event &)> handler)
@@ -53,6 +53,11 @@ void StaticActs::SetThreadPool(std::shared_ptr<ExecutorPool> executors)
     executors_ = executors;
 }
 
+std::shared_ptr<ExecutorPool> StaticActs::GetThreadPool() const
+{
+    return executors_;
+}
+
 void StaticActs::Execute(Task task)
 {
     auto executor = executors_;
@@ -12,18 +12,28 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#define LOG_TAG "FlowControlManager"
 #include "flow_control_manager/flow_control_manager.h"
 
 #include <list>
 
+#include "log_print.h"
+
 namespace OHOS::DistributedData {
-FlowControlManager::FlowControlManager(std::shared_ptr<ExecutorPool> pool, std::shared_ptr<Strategy> strategy)
-    : pool_(std::move(pool)), strategy_(std::move(strategy))
+FlowControlManager::FlowControlManager(std::shared_ptr<ExecutorPool> pool, std::shared_ptr<Strategy> strategy,
+    uint32_t maxRunning, ExecutorPool::Duration maxHold)
+    : pool_(std::move(pool)), strategy_(std::move(strategy)), maxRunning_(maxRunning), maxHold_(maxHold),
+      gate_(std::make_shared<Gate>())
 {
+    gate_->owner = this;
 }
 
 FlowControlManager::~FlowControlManager()
 {
+    {
+        std::lock_guard<decltype(gate_->mutex)> lock(gate_->mutex);
+        gate_->owner = nullptr;
+    }
     isRunning_ = false;
     ExecutorPool::TaskId taskId = ExecutorPool::INVALID_TASK_ID;
     {
@@ -31,6 +41,7 @@ FlowControlManager::~FlowControlManager()
         taskId = taskId_;
         taskId_ = ExecutorPool::INVALID_TASK_ID;
         auto tasks = std::move(tasks_);
+        labels_.clear();
     }
     if (pool_ != nullptr) {
         pool_->Remove(taskId, true);
@@ -46,20 +57,37 @@ void FlowControlManager::Execute(Task task, uint32_t type)
 
 void FlowControlManager::Execute(Task task, TaskInfo info)
 {
-    if (!isRunning_ || pool_ == nullptr) {
+    if (!isRunning_ || pool_ == nullptr || task == nullptr) {
         return;
     }
     Tp executeTime = std::chrono::steady_clock::now();
     if (strategy_ != nullptr) {
         executeTime = strategy_->GetExecuteTime(task, info);
     }
-    auto id = GenTaskId();
-    InnerTask innerTask{ std::move(task), std::move(info), executeTime, id };
+    Push([task = std::move(task)](RefCount) { task(); }, std::move(info), executeTime);
+}
+
+void FlowControlManager::ExecuteHeld(HeldTask task, TaskInfo info)
+{
+    if (!isRunning_ || pool_ == nullptr || task == nullptr) {
+        return;
+    }
+    Tp executeTime = std::chrono::steady_clock::now();
+    if (strategy_ != nullptr) {
+        executeTime = strategy_->GetExecuteTime(nullptr, info);
+    }
+    Push(std::move(task), std::move(info), executeTime);
+}
+
+void FlowControlManager::Push(HeldTask task, TaskInfo info, Tp executeTime)
+{
+    TaskKey key{ executeTime, GenTaskId() };
     {
         std::lock_guard<decltype(mutex_)> lock(mutex_);
-        tasks_.push(std::move(innerTask));
+        labels_[info.label].insert(key);
+        tasks_.emplace(key, InnerTask(std::move(task), std::move(info)));
         // If the added task is not the first task or not the earliest task, return directly
-        if (tasks_.top().id != id) {
+        if (tasks_.begin()->first != key) {
             return;
         }
     }
@@ -71,32 +99,83 @@ void FlowControlManager::ExecuteTask()
     if (!isRunning_ || pool_ == nullptr) {
         return;
     }
-    std::list<Task> tasks;
+    std::list<HeldTask> tasks;
     std::lock_guard<decltype(mutex_)> lock(mutex_);
     Tp now = std::chrono::steady_clock::now();
     while (!tasks_.empty()) {
-        const InnerTask &task = tasks_.top();
-        if (task.task == nullptr || !isRunning_) {
-            tasks_.pop();
+        auto it = tasks_.begin();
+        if (it->second.task == nullptr || !isRunning_) {
+            EraseTask(it);
             continue;
         }
-        if (task.time <= now) {
-            tasks.push_back(task.task);
-            tasks_.pop();
+        // due tasks beyond the limit stay queued until a slot is released
+        if (it->first.first <= now && (maxRunning_ == 0 || running_ < maxRunning_)) {
+            tasks.push_back(std::move(it->second.task));
+            EraseTask(it);
+            running_++;
             continue;
         }
         break;
     }
     if (!tasks.empty() && isRunning_) {
-        pool_->Execute([executeTasks = std::move(tasks)]() {
+        auto count = tasks.size();
+        auto taskId = pool_->Execute([executeTasks = std::move(tasks), gate = gate_,
+                                         pool = std::weak_ptr<ExecutorPool>(pool_), maxHold = maxHold_]() {
             for (auto &task : executeTasks) {
-                task();
+                task(GenSlot(gate, pool, maxHold));
             }
         });
+        if (taskId == ExecutorPool::INVALID_TASK_ID) {
+            running_ -= count;
+        }
     }
     taskId_ = ExecutorPool::INVALID_TASK_ID;
 }
 
+RefCount FlowControlManager::GenSlot(std::shared_ptr<Gate> gate, std::weak_ptr<ExecutorPool> pool,
+    ExecutorPool::Duration maxHold)
+{
+    // the slot is released once, either by its last copy or by the watchdog
+    auto released = std::make_shared<std::atomic_bool>(false);
+    auto release = [gate, released]() {
+        if (released->exchange(true)) {
+            return false;
+        }
+        std::lock_guard<decltype(gate->mutex)> lock(gate->mutex);
+        if (gate->owner != nullptr) {
+            gate->owner->Release();
+        }
+        return true;
+    };
+    auto watchdog = ExecutorPool::INVALID_TASK_ID;
+    auto executor = pool.lock();
+    if (maxHold > ExecutorPool::Duration::zero() && executor != nullptr) {
+        watchdog = executor->Schedule(maxHold, [release]() {
+            if (release()) {
+                ZLOGW("slot held too long, released by force");
+            }
+        });
+    }
+    return RefCount([release, pool, watchdog]() {
+        auto executor = pool.lock();
+        if (watchdog != ExecutorPool::INVALID_TASK_ID && executor != nullptr) {
+            executor->Remove(watchdog);
+        }
+        release();
+    });
+}
+
+void FlowControlManager::Release()
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        if (running_ > 0) {
+            running_--;
+        }
+    }
+    Schedule();
+}
+
 void FlowControlManager::Schedule()
 {
     if (!isRunning_ || pool_ == nullptr) {
@@ -115,12 +194,13 @@ void FlowControlManager::Schedule()
         return;
     }
     std::lock_guard<decltype(mutex_)> lock(mutex_);
-    if (tasks_.empty() || !isRunning_) {
+    // a full manager is scheduled again when a slot is released
+    if (tasks_.empty() || !isRunning_ || (maxRunning_ != 0 && running_ >= maxRunning_)) {
         return;
     }
-    const InnerTask &task = tasks_.top();
+    Tp time = tasks_.begin()->first.first;
     Tp now = std::chrono::steady_clock::now();
-    auto duration = task.time < now ? std::chrono::steady_clock::duration(0) : task.time - now;
+    auto duration = time < now ? std::chrono::steady_clock::duration(0) : time - now;
     // If there is a task running, execute according to the earliest time
     if (taskId_ != ExecutorPool::INVALID_TASK_ID) {
         pool_->Reset(taskId_, duration);
@@ -143,17 +223,47 @@ void FlowControlManager::Remove(Filter filter)
 {
     {
         std::lock_guard<decltype(mutex_)> lock(mutex_);
-        auto tasks = std::move(tasks_);
-        while (!tasks.empty()) {
-            if (!filter || filter(tasks.top().info)) {
-                tasks.pop();
+        if (!filter) {
+            tasks_.clear();
+            labels_.clear();
+        }
+        for (auto it = tasks_.begin(); it != tasks_.end();) {
+            if (filter(it->second.info)) {
+                EraseTask(it++);
                 continue;
             }
-            tasks_.push(std::move(tasks.top()));
-            tasks.pop();
+            ++it;
         }
     }
     Schedule();
 }
 
+void FlowControlManager::RemoveByLabel(const std::string &label)
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        auto keys = labels_.find(label);
+        if (keys == labels_.end()) {
+            return;
+        }
+        for (auto &key : keys->second) {
+            tasks_.erase(key);
+        }
+        labels_.erase(keys);
+    }
+    Schedule();
+}
+
+void FlowControlManager::EraseTask(std::map<TaskKey, InnerTask>::iterator it)
+{
+    auto keys = labels_.find(it->second.info.label);
+    if (keys != labels_.end()) {
+        keys->second.erase(it->first);
+        if (keys->second.empty()) {
+            labels_.erase(keys);
+        }
+    }
+    tasks_.erase(it);
+}
+
 } // namespace OHOS::DistributedData
\ No newline at end of file
@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2025 Huawei Device Co., Ltd.
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "flow_control_manager/flow_control_strategy.h"
+
+#include <algorithm>
+
+namespace OHOS::DistributedData {
+namespace {
+FlowControlStrategy::Duration GetInterval(uint32_t rate, uint32_t period)
+{
+    if (rate == 0) {
+        return FlowControlStrategy::Duration::zero();
+    }
+    return std::chrono::duration_cast<FlowControlStrategy::Duration>(std::chrono::milliseconds(period)) / rate;
+}
+} // namespace
+
+FlowControlManager::Tp FlowControlStrategy::GetExecuteTime(FlowControlManager::Task task, const TaskInfo &info)
+{
+    return Reserve(info, std::chrono::steady_clock::now());
+}
+
+void FlowControlStrategy::Postpone(const TaskInfo &info, Tp executeTime)
+{
+}
+
+SlidingWindowStrategy::SlidingWindowStrategy(uint32_t limit, uint32_t period,
+    std::shared_ptr<FlowControlStrategy> inner)
+    : inner_(std::move(inner)), limit_(limit), period_(std::chrono::milliseconds(period))
+{
+}
+
+SlidingWindowStrategy::Tp SlidingWindowStrategy::Reserve(const TaskInfo &info, Tp now)
+{
+    auto reserved = inner_ == nullptr ? now : inner_->Reserve(info, now);
+    if (limit_ == 0) {
+        return reserved;
+    }
+    auto executeTime = reserved;
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        // no window reaching now or later holds these reservations.
+        reserved_.erase(reserved_.begin(), reserved_.upper_bound(now - period_));
+        // the window around the time only gets room when one of its reservations leaves it.
+        while (!HasRoom(executeTime)) {
+            executeTime = *reserved_.upper_bound(executeTime - period_) + period_;
+        }
+        reserved_.insert(executeTime);
+    }
+    if (executeTime != reserved && inner_ != nullptr) {
+        inner_->Postpone(info, executeTime);
+    }
+    return executeTime;
+}
+
+bool SlidingWindowStrategy::HasRoom(Tp time) const
+{
+    // every window [start, start + period) holding the time holds only the reservations in (time - period,
+    // time + period), it is full when limit of them span less than a period together with the time.
+    std::vector<Tp> nearby(reserved_.upper_bound(time - period_), reserved_.lower_bound(time + period_));
+    for (size_t i = 0; i + limit_ <= nearby.size(); ++i) {
+        if (std::max(nearby[i + limit_ - 1], time) - std::min(nearby[i], time) < period_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TokenBucketStrategy::TokenBucketStrategy(uint32_t rate, uint32_t period, uint32_t burst,
+    std::shared_ptr<FlowControlStrategy> inner)
+    : inner_(std::move(inner)), interval_(GetInterval(rate, period)),
+      tolerance_(interval_ * (std::max(burst, 1u) - 1))
+{
+}
+
+TokenBucketStrategy::Tp TokenBucketStrategy::Reserve(const TaskInfo &info, Tp now)
+{
+    auto reserved = inner_ == nullptr ? now : inner_->Reserve(info, now);
+    if (interval_ == Duration::zero()) {
+        return reserved;
+    }
+    Tp executeTime;
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        // the generic cell rate algorithm, a token is free once the bucket is no more than burst - 1 tokens behind.
+        executeTime = std::max(reserved, arrival_ - tolerance_);
+        arrival_ = std::max(arrival_, executeTime) + interval_;
+    }
+    if (executeTime != reserved && inner_ != nullptr) {
+        inner_->Postpone(info, executeTime);
+    }
+    return executeTime;
+}
+
+WeightedFairStrategy::WeightedFairStrategy(uint32_t rate, uint32_t period, uint32_t burst, Weigher weigher)
+    : interval_(GetInterval(rate, period)), period_(std::chrono::milliseconds(period)), burst_(std::max(burst, 1u)),
+      weigher_(std::move(weigher))
+{
+}
+
+WeightedFairStrategy::Tp WeightedFairStrategy::Reserve(const TaskInfo &info, Tp now)
+{
+    if (interval_ == Duration::zero()) {
+        return now;
+    }
+    int64_t weight = weigher_ == nullptr ? 1 : std::max(weigher_(info), 1u);
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    int64_t activeWeight = 0;
+    for (auto it = flows_.begin(); it != flows_.end();) {
+        // a label keeps its share for a period after its last task, so the labels submitting now and then
+        // find room between the tasks of the busy ones.
+        if (it->second.finish + period_ <= now) {
+            it = flows_.erase(it);
+            continue;
+        }
+        if (it->first != info.label) {
+            activeWeight += it->second.weight;
+        }
+        ++it;
+    }
+    activeWeight += weight;
+    auto &flow = flows_[info.label];
+    flow.weight = weight;
+    // the virtual clock of the label advances by its share of the rate among the active labels,
+    // and the label runs ahead of it by up to burst - 1 shares.
+    flow.share = interval_ * activeWeight / weight;
+    auto executeTime = std::max(now, flow.finish - flow.share * (burst_ - 1));
+    flow.finish = std::max(flow.finish, executeTime) + flow.share;
+    return executeTime;
+}
+
+void WeightedFairStrategy::Postpone(const TaskInfo &info, Tp executeTime)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto it = flows_.find(info.label);
+    if (it != flows_.end()) {
+        // the label stays active while its postponed tasks wait.
+        it->second.finish = std::max(it->second.finish, executeTime + it->second.share);
+    }
+}
+
+PriorityClassStrategy::PriorityClassStrategy(std::shared_ptr<FlowControlStrategy> inner, uint32_t classes,
+    uint32_t maxDelay)
+    : inner_(std::move(inner)), maxDelay_(std::chrono::milliseconds(maxDelay)), reserved_(std::max(classes, 1u))
+{
+}
+
+PriorityClassStrategy::Tp PriorityClassStrategy::Reserve(const TaskInfo &info, Tp now)
+{
+    auto reserved = inner_ == nullptr ? now : inner_->Reserve(info, now);
+    auto executeTime = reserved;
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        size_t level = std::min(static_cast<size_t>(info.priority), reserved_.size() - 1);
+        auto latest = executeTime + maxDelay_;
+        for (size_t i = 0; i < level; ++i) {
+            executeTime = std::max(executeTime, std::min(reserved_[i], latest));
+        }
+        reserved_[level] = std::max(reserved_[level], executeTime);
+    }
+    if (executeTime != reserved && inner_ != nullptr) {
+        inner_->Postpone(info, executeTime);
+    }
+    return executeTime;
+}
+
+void PriorityClassStrategy::Postpone(const TaskInfo &info, Tp executeTime)
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        size_t level = std::min(static_cast<size_t>(info.priority), reserved_.size() - 1);
+        reserved_[level] = std::max(reserved_[level], executeTime);
+    }
+    if (inner_ != nullptr) {
+        inner_->Postpone(info, executeTime);
+    }
+}
+} // namespace OHOS::DistributedData
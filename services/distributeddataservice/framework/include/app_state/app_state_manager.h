@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_DISTRIBUTED_DATA_FRAMEWORK_APP_STATE_MANAGER_H
+#define OHOS_DISTRIBUTED_DATA_FRAMEWORK_APP_STATE_MANAGER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "visibility.h"
+
+namespace OHOS::DistributedData {
+// Whether an app is in the foreground. Without a registered instance every app counts as foreground,
+// so nothing is demoted.
+class AppStateManager {
+public:
+    API_EXPORT static std::shared_ptr<AppStateManager> GetInstance();
+    API_EXPORT static bool RegisterInstance(std::shared_ptr<AppStateManager> instance);
+    AppStateManager() = default;
+    API_EXPORT virtual ~AppStateManager() = default;
+    API_EXPORT virtual bool IsForeground(uint32_t tokenId);
+    API_EXPORT virtual bool IsForeground(const std::string &bundleName, int32_t user);
+
+private:
+    static std::mutex mutex_;
+    static std::shared_ptr<AppStateManager> instance_;
+};
+} // namespace OHOS::DistributedData
+
+#endif // OHOS_DISTRIBUTED_DATA_FRAMEWORK_APP_STATE_MANAGER_H
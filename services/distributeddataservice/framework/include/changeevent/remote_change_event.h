@@ -43,6 +43,11 @@ public:
 
     const DataInfo& GetDataInfo() const;
 
+    size_t GetHash() const override;
+
+    // unions the tables of two queued changes of the same store, the empty table list is never merged.
+    static bool Merge(Event &queued, const Event &event);
+
 private:
     DataInfo info_;
 };
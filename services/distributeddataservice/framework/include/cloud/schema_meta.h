@@ -130,8 +130,8 @@ public:
     bool Marshal(json &node) const override;
     bool Unmarshal(const json &node) override;
     bool IsValid() const;
-    Database GetDataBase(const std::string &storeId);
-    std::vector<std::string> GetStores();
+    Database GetDataBase(const std::string &storeId) const;
+    std::vector<std::string> GetStores() const;
     bool operator==(const SchemaMeta &meta) const;
     bool operator!=(const SchemaMeta &meta) const;
 };
@@ -26,9 +26,8 @@
 namespace OHOS {
 namespace DistributedData {
 class DumpManager {
-    using Handler = std::function<void(int, std::map<std::string, std::vector<std::string>> &)>;
-
 public:
+    using Handler = std::function<void(int, std::map<std::string, std::vector<std::string>> &)>;
     struct Config {
         std::string dumpName;
         std::string fullCmd;
@@ -55,6 +54,8 @@ public:
     API_EXPORT void AddHandler(const std::string &infoName, uintptr_t ptr, const Handler &handler);
     API_EXPORT std::vector<Handler> GetHandler(const std::string &infoName);
     API_EXPORT void RemoveHandler(const std::string &infoName, uintptr_t ptr);
+    // adds the handler to the "--feature-info" dump shared by all components
+    API_EXPORT void AddFeatureHandler(uintptr_t ptr, const Handler &handler);
 
 private:
     ConcurrentMap<std::string, Config> factory_;
@@ -39,6 +39,9 @@ public:
     API_EXPORT Event &operator=(const Event &) = delete;
     API_EXPORT virtual ~Event();
     API_EXPORT virtual bool Equals(const Event &) const;
+    // the queued events with the same id and hash are the only ones compared for coalescing, 0 means not indexed.
+    // the hash must not change while the event is queued.
+    API_EXPORT virtual size_t GetHash() const;
     API_EXPORT int32_t GetEventId() const;
 
 private:
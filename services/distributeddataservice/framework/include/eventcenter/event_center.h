@@ -15,11 +15,19 @@
 
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_EVENTCENTER_EVENT_CENTER_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_EVENTCENTER_EVENT_CENTER_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <queue>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "concurrent_map.h"
 #include "eventcenter/event.h"
+#include "executor_pool.h"
 #include "visibility.h"
 namespace OHOS {
 namespace DistributedData {
@@ -30,6 +38,10 @@ public:
         CODE_ASYNC,
         CODE_INVALID_ARGS,
     };
+    // log2 buckets of microseconds, the last one holds everything longer.
+    static constexpr uint32_t LATENCY_BUCKETS = 20;
+    static constexpr uint32_t ASYNC_CAPACITY = 1024;
+    static constexpr std::chrono::milliseconds BUSY_WAIT = std::chrono::milliseconds(100);
 
     class Defer final {
     public:
@@ -40,12 +52,58 @@ public:
         void operator delete (void *) = delete;
         void operator delete[] (void *) = delete;
     };
+    // folds the new event into the queued one with the same id and hash, returns false to queue the new event.
+    using Merger = std::function<bool(Event &queued, const Event &event)>;
     API_EXPORT static EventCenter &GetInstance();
-    API_EXPORT bool Subscribe(int32_t evtId, const std::function<void(const Event &)> &observer);
+    // the async observer runs on the executors in posting order and queues up to capacity events. A post into the
+    // full queue waits BUSY_WAIT for room and then drops the event, the observer posting to itself never waits.
+    API_EXPORT bool Subscribe(int32_t evtId, const std::function<void(const Event &)> &observer, bool async = false,
+        uint32_t capacity = ASYNC_CAPACITY);
     API_EXPORT bool Unsubscribe(int32_t evtId);
     API_EXPORT int32_t PostEvent(std::unique_ptr<Event> evt) const;
+    API_EXPORT bool RegisterMerger(int32_t evtId, Merger merger);
+    API_EXPORT void BindExecutor(std::shared_ptr<ExecutorPool> executors);
+    API_EXPORT std::vector<uint64_t> GetLatency(int32_t evtId) const;
 private:
-    void Dispatch(const Event &evt) const;
+    using Clock = std::chrono::steady_clock;
+    struct Histogram {
+        std::atomic<uint64_t> buckets[LATENCY_BUCKETS] {};
+        void Record(Clock::duration latency);
+    };
+    struct AsyncChannel {
+        AsyncChannel(const std::function<void(const Event &)> &observer, std::shared_ptr<Histogram> latency,
+            uint32_t capacity) : observer(observer), latency(std::move(latency)), capacity(capacity) {}
+        const std::function<void(const Event &)> observer;
+        const std::shared_ptr<Histogram> latency;
+        const uint32_t capacity;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<std::pair<std::shared_ptr<Event>, Clock::time_point>> events;
+        bool running = false;
+        bool closed = false;
+        uint64_t merged = 0;
+        uint64_t dropped = 0;
+    };
+    struct Observer {
+        std::function<void(const Event &)> observer;
+        // null when the observer runs on the posting thread.
+        std::shared_ptr<AsyncChannel> channel;
+    };
+    using Observers = std::vector<Observer>;
+    struct Channel {
+        std::shared_ptr<const Observers> observers;
+        std::shared_ptr<Histogram> latency;
+    };
+    void Dispatch(const std::shared_ptr<Event> &evt) const;
+    Merger GetMerger(int32_t evtId) const;
+    std::shared_ptr<ExecutorPool> GetExecutors() const;
+    void PostAsync(std::shared_ptr<AsyncChannel> channel, const std::shared_ptr<Event> &evt,
+        Clock::time_point begin) const;
+    bool Coalesce(AsyncChannel &channel, const Event &evt) const;
+    void Drain(std::shared_ptr<AsyncChannel> channel) const;
+    // dispatches up to MAX_CAPABILITY events, returns whether more are pending.
+    bool DrainBatch(AsyncChannel &channel) const;
+    void DumpEventInfo(int fd, std::map<std::string, std::vector<std::string>> &params);
     class AsyncQueue final {
     public:
         static constexpr int32_t MAX_CAPABILITY = 100;
@@ -55,12 +113,19 @@ private:
         void Post(std::unique_ptr<Event> event);
         void AddHandler(int32_t evtId, std::function<void(const Event &)> handler);
     private:
+        static size_t GetIndexKey(int32_t evtId, size_t hash);
+        void RemoveIndex(const Event *event);
         std::map<int32_t, std::function<void(const Event &)>> handlers_;
-        std::deque<std::unique_ptr<Event>> events_;
+        std::deque<std::shared_ptr<Event>> events_;
+        std::unordered_multimap<size_t, Event *> index_;
         int32_t depth_ = 0;
     };
-    ConcurrentMap<int32_t, std::list<std::function<void(const Event &)>>> observers_;
+    ConcurrentMap<int32_t, Channel> observers_;
+    ConcurrentMap<int32_t, Merger> mergers_;
+    mutable std::mutex executorsMutex_;
+    std::shared_ptr<ExecutorPool> executors_;
     static thread_local AsyncQueue *asyncQueue_;
+    static thread_local const AsyncChannel *draining_;
 };
 } // namespace DistributedData
 } // namespace OHOS
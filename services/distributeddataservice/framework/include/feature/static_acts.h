@@ -36,6 +36,9 @@ public:
     void SetThreadPool(std::shared_ptr<ExecutorPool> executors);
     void Execute(Task task);
 
+protected:
+    std::shared_ptr<ExecutorPool> GetThreadPool() const;
+
 private:
     std::shared_ptr<ExecutorPool> executors_;
 };
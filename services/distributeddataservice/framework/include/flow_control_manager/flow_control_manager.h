@@ -17,21 +17,30 @@
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <priority_queue.h>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 #include "executor_pool.h"
+#include "utils/ref_count.h"
 #include "visibility.h"
 namespace OHOS {
 namespace DistributedData {
 class API_EXPORT FlowControlManager {
 public:
     using Task = std::function<void()>;
+    // the task holds a running slot until the last copy of the slot is gone.
+    using HeldTask = std::function<void(RefCount slot)>;
     using Tp = std::chrono::steady_clock::time_point;
     struct TaskInfo {
-        TaskInfo(uint32_t type = 0, std::string label = "") : type(type), label(std::move(label)) {}
+        TaskInfo(uint32_t type = 0, std::string label = "", uint32_t priority = 0)
+            : type(type), label(std::move(label)), priority(priority) {}
         uint32_t type = 0;
         std::string label;
+        // 0 is the highest class.
+        uint32_t priority = 0;
     };
     class Strategy {
     public:
@@ -40,34 +49,48 @@ public:
     };
     using Filter = std::function<bool(const TaskInfo &)>;
 
-    FlowControlManager(std::shared_ptr<ExecutorPool> pool, std::shared_ptr<Strategy> strategy);
+    // maxRunning limits the tasks holding a slot at the same time, 0 means no limit.
+    // A slot held longer than maxHold is released by force, zero means no deadline.
+    FlowControlManager(std::shared_ptr<ExecutorPool> pool, std::shared_ptr<Strategy> strategy,
+        uint32_t maxRunning = 0, ExecutorPool::Duration maxHold = ExecutorPool::Duration::zero());
     ~FlowControlManager();
     void Execute(Task task, uint32_t type = 0);
     void Execute(Task task, TaskInfo info);
+    void ExecuteHeld(HeldTask task, TaskInfo info);
     void Remove(uint32_t type);
     void Remove(Filter filter = nullptr);
+    void RemoveByLabel(const std::string &label);
 
 private:
     static constexpr uint32_t INVALID_INNER_TASK_ID = 0;
     struct InnerTask {
-        InnerTask(Task task, TaskInfo taskInfo, Tp tp, uint64_t taskId)
-            : task(std::move(task)), info(std::move(taskInfo)), time(tp), id(taskId)
+        InnerTask(HeldTask task, TaskInfo taskInfo) : task(std::move(task)), info(std::move(taskInfo))
         {
         }
-        Task task;
+        HeldTask task;
         TaskInfo info;
-        Tp time;
-        uint64_t id;
-        bool operator<(const InnerTask &other) const
-        {
-            return time > other.time;
-        }
     };
+    // slots may outlive the manager, they release through the gate which is closed on destruction.
+    struct Gate {
+        std::mutex mutex;
+        FlowControlManager *owner = nullptr;
+    };
+    // tasks run in the order of time, the id keeps the submission order of the same time.
+    using TaskKey = std::pair<Tp, uint64_t>;
+
+    void Push(HeldTask task, TaskInfo info, Tp executeTime);
+
+    void EraseTask(std::map<TaskKey, InnerTask>::iterator it);
 
     void Schedule();
 
     void ExecuteTask();
 
+    static RefCount GenSlot(std::shared_ptr<Gate> gate, std::weak_ptr<ExecutorPool> pool,
+        ExecutorPool::Duration maxHold);
+
+    void Release();
+
     uint64_t GenTaskId()
     {
         auto taskId = ++innerTaskId_;
@@ -79,9 +102,14 @@ private:
 
     const std::shared_ptr<ExecutorPool> pool_;
     const std::shared_ptr<Strategy> strategy_;
+    const uint32_t maxRunning_;
+    const ExecutorPool::Duration maxHold_;
+    std::shared_ptr<Gate> gate_;
     bool isRunning_ = true;
     std::mutex mutex_;
-    std::priority_queue<InnerTask> tasks_;
+    std::map<TaskKey, InnerTask> tasks_;
+    std::unordered_map<std::string, std::set<TaskKey>> labels_;
+    uint32_t running_ = 0;
     ExecutorPool::TaskId taskId_ = ExecutorPool::INVALID_TASK_ID;
     std::atomic_uint64_t innerTaskId_ = INVALID_INNER_TASK_ID;
 };
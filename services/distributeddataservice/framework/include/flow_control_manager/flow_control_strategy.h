@@ -0,0 +1,116 @@
+/*
+* Copyright (c) 2025 Huawei Device Co., Ltd.
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_FLOW_CONTROL_STRATEGY_H
+#define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_FLOW_CONTROL_STRATEGY_H
+
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "flow_control_manager/flow_control_manager.h"
+#include "visibility.h"
+namespace OHOS {
+namespace DistributedData {
+// the strategy whose decision only depends on the given time, so it can be replayed with a simulated clock.
+class API_EXPORT FlowControlStrategy : public FlowControlManager::Strategy {
+public:
+    using Tp = FlowControlManager::Tp;
+    using Duration = std::chrono::steady_clock::duration;
+    using TaskInfo = FlowControlManager::TaskInfo;
+    FlowControlManager::Tp GetExecuteTime(FlowControlManager::Task task, const TaskInfo &info) override;
+    virtual Tp Reserve(const TaskInfo &info, Tp now) = 0;
+    // the outer strategy runs the task reserved last for the label at the given later time.
+    virtual void Postpone(const TaskInfo &info, Tp executeTime);
+};
+
+// runs at most limit tasks in any period. A task keeps the time chosen by the inner strategy whenever the window
+// around it has room, so a task reserved for now is not queued behind the tasks reserved for later.
+// It keeps the limit only as the outermost strategy.
+class API_EXPORT SlidingWindowStrategy : public FlowControlStrategy {
+public:
+    // period is in milliseconds, limit 0 means no limit.
+    SlidingWindowStrategy(uint32_t limit, uint32_t period, std::shared_ptr<FlowControlStrategy> inner = nullptr);
+    Tp Reserve(const TaskInfo &info, Tp now) override;
+
+private:
+    bool HasRoom(Tp time) const;
+    std::mutex mutex_;
+    std::shared_ptr<FlowControlStrategy> inner_;
+    const uint32_t limit_ = 0;
+    const Duration period_ = Duration::zero();
+    std::multiset<Tp> reserved_;
+};
+
+// admits a burst of tasks at once, and then rate tasks per period in the submission order. A token is taken at the
+// time chosen by the inner strategy, so a task postponed by the inner one does not hold the bucket meanwhile.
+class API_EXPORT TokenBucketStrategy : public FlowControlStrategy {
+public:
+    // period is in milliseconds, rate 0 means no limit.
+    TokenBucketStrategy(uint32_t rate, uint32_t period, uint32_t burst,
+        std::shared_ptr<FlowControlStrategy> inner = nullptr);
+    Tp Reserve(const TaskInfo &info, Tp now) override;
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<FlowControlStrategy> inner_;
+    Duration interval_ = Duration::zero();
+    Duration tolerance_ = Duration::zero();
+    // the time the bucket is full again.
+    Tp arrival_;
+};
+
+// shares rate tasks per period among the labels with pending tasks in proportion to their weights,
+// so a label flooding tasks only delays itself. A label may run burst tasks at once before it is spaced by its share.
+class API_EXPORT WeightedFairStrategy : public FlowControlStrategy {
+public:
+    using Weigher = std::function<uint32_t(const TaskInfo &)>;
+    // period is in milliseconds, rate 0 means no limit, the weight of a label is 1 without weigher.
+    WeightedFairStrategy(uint32_t rate, uint32_t period, uint32_t burst = 1, Weigher weigher = nullptr);
+    Tp Reserve(const TaskInfo &info, Tp now) override;
+    void Postpone(const TaskInfo &info, Tp executeTime) override;
+
+private:
+    struct Flow {
+        Tp finish;
+        int64_t weight = 1;
+        Duration share = Duration::zero();
+    };
+    std::mutex mutex_;
+    Duration interval_ = Duration::zero();
+    Duration period_ = Duration::zero();
+    int64_t burst_ = 1;
+    Weigher weigher_;
+    std::unordered_map<std::string, Flow> flows_;
+};
+
+// the tasks of a class never run before the tasks already reserved by the higher classes,
+// but at most maxDelay later than the inner strategy allows.
+class API_EXPORT PriorityClassStrategy : public FlowControlStrategy {
+public:
+    // maxDelay is in milliseconds, the priority beyond the classes falls into the lowest class.
+    PriorityClassStrategy(std::shared_ptr<FlowControlStrategy> inner, uint32_t classes, uint32_t maxDelay);
+    Tp Reserve(const TaskInfo &info, Tp now) override;
+    void Postpone(const TaskInfo &info, Tp executeTime) override;
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<FlowControlStrategy> inner_;
+    Duration maxDelay_ = Duration::zero();
+    std::vector<Tp> reserved_;
+};
+} // namespace DistributedData
+} // namespace OHOS
+#endif // OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_FLOW_CONTROL_STRATEGY_H
@@ -15,10 +15,13 @@
 
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_METADATA_META_DATA_MANAGER_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_METADATA_META_DATA_MANAGER_H
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <type_traits>
+#include <typeindex>
 
 #include "concurrent_map.h"
 #include "serializable/serializable.h"
@@ -90,18 +93,48 @@ public:
         return true;
     }
 
+    /**
+     * Returns an immutable, already unmarshalled snapshot of the meta stored under key. The snapshot is shared
+     * with other callers and stays valid after the meta changes; a later call returns the new value.
+     */
+    template<class T>
+    API_EXPORT std::shared_ptr<const T> LoadMetaSnapshot(const std::string &key, bool isLocal = false)
+    {
+        static_assert(std::is_base_of_v<Serializable, T>, "T must be Serializable");
+        if (!inited_) {
+            return nullptr;
+        }
+        std::shared_ptr<const void> object;
+        if (LoadCacheObject(key, isLocal, typeid(T), object)) {
+            return std::static_pointer_cast<const T>(object);
+        }
+        uint64_t version = objectVersion_.load();
+        auto value = std::make_shared<T>();
+        if (!LoadMeta(key, *value, isLocal)) {
+            return nullptr;
+        }
+        SaveCacheObject(key, isLocal, typeid(T), value, version);
+        return value;
+    }
+
     API_EXPORT bool DelMeta(const std::string &key, bool isLocal = false);
     API_EXPORT bool DelMeta(const std::vector<std::string> &keys, bool isLocal = false);
     API_EXPORT bool Subscribe(std::string prefix, Observer observer, bool isLocal = false);
     API_EXPORT bool Unsubscribe(std::string filter);
     API_EXPORT bool Sync(const DeviceMetaSyncOption &option, OnComplete complete);
 private:
+    struct CacheObject {
+        std::type_index type = typeid(void);
+        std::shared_ptr<const void> object;
+    };
+    static constexpr uint32_t OBJECT_CACHE_SIZE = 256;
     MetaDataManager();
     ~MetaDataManager();
 
     API_EXPORT bool GetEntries(const std::string &prefix, std::vector<Bytes> &entries, bool isLocal);
     void DelCacheMeta(const std::string &key, bool isLocal)
     {
+        DelCacheObject(key, isLocal);
         if (!isLocal) {
             return;
         }
@@ -129,6 +162,19 @@ private:
         localdata_.Set(key, data);
     }
 
+    static std::string GetObjectKey(const std::string &key, bool isLocal)
+    {
+        return (isLocal ? "L" : "G") + key;
+    }
+
+    API_EXPORT bool LoadCacheObject(const std::string &key, bool isLocal, std::type_index type,
+        std::shared_ptr<const void> &object);
+    API_EXPORT void SaveCacheObject(const std::string &key, bool isLocal, std::type_index type,
+        std::shared_ptr<const void> object, uint64_t version);
+    void DelCacheObject(const std::string &key, bool isLocal);
+    void RegisterCacheObserver();
+    void DumpCacheInfo(int fd, std::map<std::string, std::vector<std::string>> &params);
+
     void StopSA();
     OnComplete CommonSyncComplete(const DeviceMetaSyncOption &option, OnComplete complete);
     bool SyncCommonMeta(const DeviceMetaSyncOption &option, OnComplete complete);
@@ -144,6 +190,12 @@ private:
     CloudSyncer cloudSyncer_;
     std::string storeId_;
     LRUBucket<std::string, std::string> localdata_ {64};
+    std::mutex objectMutex_;
+    std::atomic<uint64_t> objectVersion_ { 0 };
+    std::atomic<uint64_t> objectHits_ { 0 };
+    std::atomic<uint64_t> objectMisses_ { 0 };
+    std::shared_ptr<MetaObserver> cacheObserver_;
+    LRUBucket<std::string, CacheObject> objects_ {OBJECT_CACHE_SIZE};
 };
 } // namespace OHOS::DistributedData
 #endif // OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_METADATA_META_DATA_MANAGER_H
@@ -15,8 +15,11 @@
 
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_STORE_AUTO_CACHE_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_STORE_AUTO_CACHE_H
+#include <atomic>
+#include <future>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 
@@ -24,6 +27,7 @@
 #include "concurrent_striped_map.h"
 #include "error/general_error.h"
 #include "executor_pool.h"
+#include "lru_bucket.h"
 #include "metadata/store_meta_data.h"
 #include "store/general_store.h"
 #include "store/general_value.h"
@@ -46,6 +50,32 @@ public:
     using TaskId = ExecutorPool::TaskId;
     using Creator = std::function<std::pair<int32_t, GeneralStore *>(const StoreMetaData &, const StoreOption &)>;
     using Filter = std::function<bool(const StoreMetaData &)>;
+    enum MemoryLevel : int32_t {
+        MEMORY_LEVEL_MODERATE = 0,
+        MEMORY_LEVEL_LOW,
+        MEMORY_LEVEL_CRITICAL,
+    };
+    class EvictionPolicy {
+    public:
+        struct StoreStat {
+            Time lastAccess;
+            uint64_t accessCount = 0;
+            uint64_t openCost = 0;
+            uint32_t reopenCount = 0;
+        };
+        virtual ~EvictionPolicy() = default;
+        // the stores with the lower priority are closed first when the open budget is exceeded.
+        virtual double GetPriority(const StoreStat &stat, Time now) const = 0;
+    };
+    class LruPolicy : public EvictionPolicy {
+    public:
+        API_EXPORT double GetPriority(const StoreStat &stat, Time now) const override;
+    };
+    // the frequency of use weighted by the reopen cost of the store and aged by the idle time.
+    class LfuPolicy : public EvictionPolicy {
+    public:
+        API_EXPORT double GetPriority(const StoreStat &stat, Time now) const override;
+    };
 
     API_EXPORT static AutoCache &GetInstance();
 
@@ -74,6 +104,11 @@ public:
  
     API_EXPORT void Disable(uint32_t tokenId, const std::string &path = "", const std::string &storeId = "");
 
+    API_EXPORT void SetEvictionPolicy(std::shared_ptr<EvictionPolicy> policy, uint32_t maxOpen);
+
+    // closes the stores chosen by the policy until the budget left for the level is met.
+    API_EXPORT void OnMemoryPressure(int32_t level);
+
 private:
     AutoCache();
     ~AutoCache();
@@ -81,6 +116,19 @@ private:
     void GarbageCollect(bool isForce);
     void StartTimer();
     static int32_t CheckStatusBeforeOpen(const StoreMetaData &meta);
+    bool IsDisabled(uint32_t tokenId, const std::string &storeKey);
+    uint64_t BeginOpen(uint32_t tokenId);
+    void EndOpen(uint32_t tokenId);
+    uint64_t GetCloseEpoch(uint32_t tokenId);
+    void UpdateCloseEpoch(uint32_t tokenId);
+    bool FindStore(uint32_t tokenId, const std::string &storeKey, const Watchers &watchers, Store &store);
+    std::pair<int32_t, Store> OpenStore(const StoreMetaData &meta, const std::string &storeKey,
+        const Watchers &watchers, const StoreOption &option);
+    std::shared_ptr<EvictionPolicy> GetEvictionPolicy();
+    void Evict(uint32_t budget, std::shared_ptr<EvictionPolicy> policy);
+    uint32_t GetResidentCount();
+    void RecordClosed(uint32_t tokenId, const std::string &storeKey, const Delegate &delegate);
+    void DumpCacheInfo(int fd, std::map<std::string, std::vector<std::string>> &params);
     struct Delegate : public GeneralWatcher {
         Delegate(GeneralStore *delegate, const Watchers &watchers,
                  const StoreMetaData &meta,
@@ -95,9 +143,15 @@ private:
         int32_t OnChange(const Origin &origin, const PRIFields &primaryFields, ChangeInfo &&values) override;
         int32_t OnChange(const Origin &origin, const Fields &fields, ChangeData &&datas) override;
         void PostDataChange(const StoreMetaData &meta, const std::vector<std::string> &tables);
+        void SetOpenStat(uint64_t openCost, uint32_t reopenCount);
+        EvictionPolicy::StoreStat GetStat() const;
 
     private:
         mutable Time time_;
+        Time lastAccess_;
+        uint64_t accessCount_ = 0;
+        uint64_t openCost_ = 0;
+        uint32_t reopenCount_ = 0;
         GeneralStore *store_ = nullptr;
         Watchers watchers_;
         const StoreMetaData meta_;
@@ -106,12 +160,30 @@ private:
     };
     static constexpr uint32_t DEFAULT_INTERVAL = 60 * 1000;
     static constexpr int32_t MAX_CREATOR_NUM = 30;
+    static constexpr uint32_t MAX_CLOSED_HISTORY = 512;
 
     uint32_t garbageInterval_ = DEFAULT_INTERVAL;
     std::shared_ptr<Executor> executor_;
     TaskId taskId_ = Executor::INVALID_TASK_ID;
     ConcurrentStripedMap<uint32_t, std::map<std::string, Delegate>> stores_;
     ConcurrentMap<uint32_t, std::set<std::string>> disables_;
+    // the stores being opened, the requesters of the same store wait for the result of the first one.
+    ConcurrentMap<std::string, std::shared_future<int32_t>> openings_;
+    // a store opened across a close of its token is discarded instead of published. Only the tokens with an
+    // open in progress are kept, a close of any other token has nothing to discard.
+    struct CloseEpoch {
+        uint32_t openings = 0;
+        uint64_t closes = 0;
+    };
+    ConcurrentMap<uint32_t, CloseEpoch> closeEpochs_;
+    std::atomic<uint64_t> closeEpoch_ { 0 };
+    std::mutex policyMutex_;
+    std::shared_ptr<EvictionPolicy> policy_;
+    std::atomic<uint32_t> maxOpen_ { 0 };
+    std::atomic<uint64_t> opens_ { 0 };
+    std::atomic<uint64_t> reopens_ { 0 };
+    std::atomic<uint64_t> evictions_ { 0 };
+    LRUBucket<std::string, uint32_t> closedStores_ { MAX_CLOSED_HISTORY };
     Creator creators_[MAX_CREATOR_NUM];
 };
 } // namespace OHOS::DistributedData
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_STORE_FLAT_BUCKETS_H
+#define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_STORE_FLAT_BUCKETS_H
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "store/general_value.h"
+#include "visibility.h"
+namespace OHOS::DistributedData {
+// Rows sharing one column list, the cells are kept row by row in a single vector.
+// The columns are sorted as the keys of VBucket, so converting in either direction only moves the values.
+class API_EXPORT FlatBuckets final {
+public:
+    using Columns = std::vector<std::string>;
+    static constexpr int32_t INVALID_COLUMN = -1;
+
+    FlatBuckets() = default;
+    explicit FlatBuckets(std::shared_ptr<const Columns> columns);
+    explicit FlatBuckets(VBuckets &&buckets);
+    // The sorted union of the keys of the buckets.
+    template<typename T>
+    static std::shared_ptr<const Columns> CollectColumns(const std::vector<std::map<std::string, T>> &buckets);
+    const Columns &GetColumns() const;
+    std::shared_ptr<const Columns> GetSharedColumns() const;
+    int32_t IndexOf(const std::string &column) const;
+    size_t ColumnCount() const;
+    size_t Size() const;
+    bool Empty() const;
+    void Reserve(size_t rows);
+    // The columns of the bucket must be part of the columns of the rows.
+    bool Append(VBucket &&bucket);
+    // The values must be in the order of the columns, they are moved out and the capacity is kept for the next row.
+    bool Append(Values &&values);
+    // Absent cells are the columns the source bucket of the row did not have.
+    bool IsAbsent(size_t row, size_t col) const;
+    const Value *Get(size_t row, size_t col) const;
+    Value *Get(size_t row, size_t col);
+    VBucket GetBucket(size_t row) const;
+    VBucket TakeBucket(size_t row);
+    VBuckets TakeBuckets();
+
+private:
+    static const Columns EMPTY_COLUMNS;
+    void MarkAbsent(size_t cell);
+
+    std::shared_ptr<const Columns> columns_;
+    Values values_;
+    // only allocated when some rows lack columns
+    std::vector<bool> absent_;
+    size_t rows_ = 0;
+};
+
+template<typename T>
+std::shared_ptr<const FlatBuckets::Columns> FlatBuckets::CollectColumns(
+    const std::vector<std::map<std::string, T>> &buckets)
+{
+    auto columns = std::make_shared<Columns>();
+    for (auto &bucket : buckets) {
+        bool same = bucket.size() == columns->size();
+        auto col = columns->begin();
+        for (auto it = bucket.begin(); same && it != bucket.end(); ++it, ++col) {
+            same = (it->first == *col);
+        }
+        if (same) {
+            continue;
+        }
+        // rows of a result nearly always share the columns, merge only when they differ
+        Columns merged;
+        merged.reserve(columns->size() + bucket.size());
+        col = columns->begin();
+        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+            while (col != columns->end() && *col < it->first) {
+                merged.push_back(std::move(*col++));
+            }
+            if (col != columns->end() && *col == it->first) {
+                ++col;
+            }
+            merged.push_back(it->first);
+        }
+        merged.insert(merged.end(), std::make_move_iterator(col), std::make_move_iterator(columns->end()));
+        *columns = std::move(merged);
+    }
+    return columns;
+}
+} // namespace OHOS::DistributedData
+#endif // OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_STORE_FLAT_BUCKETS_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_THREAD_STARTUP_GRAPH_H
+#define OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_THREAD_STARTUP_GRAPH_H
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "executor_pool.h"
+#include "visibility.h"
+namespace OHOS::DistributedData {
+// Startup stages with the stages each one needs done first. Stages that do not depend on each other run at the
+// same time on the executor pool, and the time of every stage is kept for the dump.
+class API_EXPORT StartupGraph final {
+public:
+    using Task = std::function<void()>;
+    enum Affinity : int32_t {
+        ANY_THREAD,
+        // for stages relying on thread local state of the caller, such as a deferred event center
+        CALLER_THREAD,
+    };
+    struct Timing {
+        std::string name;
+        // from the start of Run, in milliseconds
+        int64_t begin = 0;
+        int64_t cost = 0;
+    };
+
+    // The dependencies must be added before the stage.
+    bool AddStage(const std::string &name, Task task, const std::vector<std::string> &dependencies = {},
+        Affinity affinity = ANY_THREAD);
+    // Returns after every stage finished, the calling thread runs stages as well.
+    void Run(std::shared_ptr<ExecutorPool> executors);
+    // Runs the task on the calling thread and keeps its time as a stage after the graph.
+    void Measure(const std::string &name, const Task &task);
+    std::vector<Timing> GetTimings() const;
+    std::string Dump() const;
+
+private:
+    static constexpr size_t INVALID_STAGE = static_cast<size_t>(-1);
+    struct Stage {
+        std::string name;
+        Task task;
+        Affinity affinity = ANY_THREAD;
+        std::vector<size_t> dependents;
+        size_t pending = 0;
+    };
+    void Schedule(size_t index);
+    void Dispatch(size_t index);
+    void Finish(size_t index, std::vector<size_t> &ready);
+    int64_t Since(std::chrono::steady_clock::time_point time) const;
+
+    std::vector<Stage> stages_;
+    std::vector<Timing> timings_;
+    std::vector<Timing> measures_;
+    std::shared_ptr<ExecutorPool> executors_;
+    std::chrono::steady_clock::time_point start_;
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<size_t> callerStages_;
+    size_t finished_ = 0;
+    int64_t total_ = 0;
+};
+} // namespace OHOS::DistributedData
+#endif // OHOS_DISTRIBUTED_DATA_SERVICES_FRAMEWORK_THREAD_STARTUP_GRAPH_H
@@ -17,10 +17,12 @@
 #include "store_types.h"
 #include "types_export.h"
 #include <csignal>
+#include <cstdio>
 #include <memory>
 #define LOG_TAG "MetaDataManager"
 
 #include "directory/directory_manager.h"
+#include "dump/dump_manager.h"
 #include "metadata/capability_meta_data.h"
 #include "metadata/store_meta_data.h"
 #include "metadata/user_meta_data.h"
@@ -158,6 +160,76 @@ void MetaDataManager::Initialize(std::shared_ptr<MetaStore> metaStore, const Bac
     backup_ = backup;
     storeId_ = storeId;
     inited_ = true;
+    RegisterCacheObserver();
+    DumpManager::GetInstance().AddFeatureHandler(uintptr_t(this),
+        [this](int fd, std::map<std::string, std::vector<std::string>> &params) { DumpCacheInfo(fd, params); });
+}
+
+void MetaDataManager::RegisterCacheObserver()
+{
+    // the snapshots of synced meta must be dropped when peers or the cloud change the underlying keys.
+    cacheObserver_ = std::make_shared<MetaObserver>(
+        [this](const std::string &key, const std::string &value, int32_t action) {
+            DelCacheObject(key, false);
+            return true;
+        },
+        std::make_shared<Filter>(""));
+    auto status = metaStore_->RegisterObserver(DistributedDB::Key(),
+        DistributedDB::OBSERVER_CHANGES_NATIVE | DistributedDB::OBSERVER_CHANGES_FOREIGN, cacheObserver_);
+    if (status == DistributedDB::DBStatus::OK) {
+        status = metaStore_->RegisterObserver(
+            DistributedDB::Key(), DistributedDB::OBSERVER_CHANGES_CLOUD, cacheObserver_);
+    }
+    if (status != DistributedDB::DBStatus::OK) {
+        ZLOGW("register cache observer failed, status:%{public}d, cache synced meta disabled.", status);
+        metaStore_->UnRegisterObserver(cacheObserver_);
+        cacheObserver_ = nullptr;
+    }
+}
+
+bool MetaDataManager::LoadCacheObject(const std::string &key, bool isLocal, std::type_index type,
+    std::shared_ptr<const void> &object)
+{
+    CacheObject cache;
+    if (!objects_.Get(GetObjectKey(key, isLocal), cache) || cache.type != type || cache.object == nullptr) {
+        objectMisses_++;
+        return false;
+    }
+    objectHits_++;
+    object = std::move(cache.object);
+    return true;
+}
+
+void MetaDataManager::SaveCacheObject(const std::string &key, bool isLocal, std::type_index type,
+    std::shared_ptr<const void> object, uint64_t version)
+{
+    if (!isLocal && cacheObserver_ == nullptr) {
+        return;
+    }
+    std::lock_guard<decltype(objectMutex_)> lock(objectMutex_);
+    // the meta changed while it was being loaded, the loaded object may be stale.
+    if (version != objectVersion_) {
+        return;
+    }
+    objects_.Set(GetObjectKey(key, isLocal), { type, std::move(object) });
+}
+
+void MetaDataManager::DelCacheObject(const std::string &key, bool isLocal)
+{
+    std::lock_guard<decltype(objectMutex_)> lock(objectMutex_);
+    objectVersion_++;
+    objects_.Delete(GetObjectKey(key, isLocal));
+}
+
+void MetaDataManager::DumpCacheInfo(int fd, std::map<std::string, std::vector<std::string>> &params)
+{
+    (void)params;
+    std::string info;
+    info.append("hits:").append(std::to_string(objectHits_.load()))
+        .append(" misses:").append(std::to_string(objectMisses_.load()))
+        .append(" capacity:").append(std::to_string(OBJECT_CACHE_SIZE));
+    dprintf(fd, "-------------------------------------MetaCacheInfo------------------------------\n%s\n",
+        info.c_str());
 }
 
 void MetaDataManager::SetSyncer(const Syncer &syncer)
@@ -221,6 +293,9 @@ bool MetaDataManager::SaveMeta(const std::vector<Entry> &values, bool isLocal)
         DelCacheMeta(key, isLocal);
     }
     auto status = isLocal ? metaStore_->PutLocalBatch(entries) : metaStore_->PutBatch(entries);
+    for (const auto &[key, value] : values) {
+        DelCacheObject(key, isLocal);
+    }
     if (status == DistributedDB::DBStatus::INVALID_PASSWD_OR_CORRUPTED_DB) {
         ZLOGE("db corrupted! status:%{public}d isLocal:%{public}d, size:%{public}zu", status, isLocal, values.size());
         CorruptReporter::CreateCorruptedFlag(DirectoryManager::GetInstance().GetMetaStorePath(), storeId_);
@@ -300,6 +375,7 @@ bool MetaDataManager::DelMeta(const std::string &key, bool isLocal)
     DelCacheMeta(key, isLocal);
     auto status = isLocal ? metaStore_->DeleteLocal({ key.begin(), key.end() })
                           : metaStore_->Delete({ key.begin(), key.end() });
+    DelCacheObject(key, isLocal);
     if (status == DistributedDB::DBStatus::INVALID_PASSWD_OR_CORRUPTED_DB) {
         ZLOGE("db corrupted! status:%{public}d isLocal:%{public}d, key:%{public}s",
             status, isLocal, Anonymous::Change(key).c_str());
@@ -331,6 +407,9 @@ bool MetaDataManager::DelMeta(const std::vector<std::string> &keys, bool isLocal
         DelCacheMeta(key, isLocal);
     }
     auto status = isLocal ? metaStore_->DeleteLocalBatch(dbKeys) : metaStore_->DeleteBatch(dbKeys);
+    for (auto &key : keys) {
+        DelCacheObject(key, isLocal);
+    }
     if (status == DistributedDB::DBStatus::INVALID_PASSWD_OR_CORRUPTED_DB) {
         ZLOGE("db corrupted! status:%{public}d isLocal:%{public}d, key size:%{public}zu", status, isLocal,
             dbKeys.size());
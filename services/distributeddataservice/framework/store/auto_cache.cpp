@@ -15,11 +15,14 @@
 #define LOG_TAG "AutoCache"
 #include "store/auto_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstdio>
 
 #include "account/account_delegate.h"
 #include "changeevent/remote_change_event.h"
 #include "dfx/xcollie.h"
+#include "dump/dump_manager.h"
 #include "eventcenter/event_center.h"
 #include "log_print.h"
 #include "screen/screen_manager.h"
@@ -28,6 +31,9 @@ namespace OHOS::DistributedData {
 namespace {
 constexpr uint32_t AUTO_CACHE_XCOLLIE_TIMEOUT = 3 * 60;
 constexpr uint32_t AUTO_CACHE_XCOLLIE_FLAG = XCollie::XCOLLIE_LOG | XCollie::XCOLLIE_RECOVERY;
+constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0;
+// a store used within this time is not evicted by the open budget, or a new store could be closed right away.
+constexpr auto MIN_RESIDENT_TIME = std::chrono::seconds(1);
 } // namespace
 
 using Account = AccountDelegate;
@@ -53,6 +59,8 @@ void AutoCache::Bind(std::shared_ptr<Executor> executor)
         return;
     }
     executor_ = std::move(executor);
+    DumpManager::GetInstance().AddFeatureHandler(uintptr_t(this),
+        [this](int fd, std::map<std::string, std::vector<std::string>> &params) { DumpCacheInfo(fd, params); });
 }
 
 AutoCache::AutoCache()
@@ -105,8 +113,7 @@ std::pair<int32_t, AutoCache::Store> AutoCache::GetDBStore(
     Store store;
     auto storeKey = GenerateKey(meta.dataDir, meta.storeId);
     if (meta.storeType >= MAX_CREATOR_NUM || meta.storeType < 0 || !creators_[meta.storeType] ||
-        disables_.ContainIf(meta.tokenId,
-            [&storeKey](const std::set<std::string> &stores) -> bool { return stores.count(storeKey) != 0; })) {
+        IsDisabled(meta.tokenId, storeKey)) {
         ZLOGW("storeType %{public}d is invalid or store is disabled, user:%{public}s, bundleName:%{public}s, "
               "storeName:%{public}s",
             meta.storeType, meta.user.c_str(), meta.bundleName.c_str(), meta.GetStoreAlias().c_str());
@@ -116,36 +123,278 @@ std::pair<int32_t, AutoCache::Store> AutoCache::GetDBStore(
     if (ret != E_OK) {
         return { ret, store };
     }
-    bool startTimer = false;
     XCollie xcollie(__FUNCTION__, AUTO_CACHE_XCOLLIE_FLAG, AUTO_CACHE_XCOLLIE_TIMEOUT);
-    stores_.Compute(meta.tokenId,
-        [this, &meta, &watchers, &store, &storeKey, &option, &ret, &startTimer](
-            auto &, std::map<std::string, Delegate> &stores) -> bool {
-            auto it = stores.find(storeKey);
-            if (it != stores.end()) {
-                if (!watchers.empty()) {
-                    it->second.SetObservers(watchers);
-                }
-                store = it->second;
-                return !stores.empty();
+    auto openKey = std::to_string(meta.tokenId).append(KEY_SEPARATOR).append(storeKey);
+    while (!FindStore(meta.tokenId, storeKey, watchers, store)) {
+        std::promise<int32_t> promise;
+        std::shared_future<int32_t> opening;
+        bool isOwner = false;
+        openings_.Compute(openKey, [&promise, &opening, &isOwner](auto &, std::shared_future<int32_t> &future) {
+            if (!future.valid()) {
+                future = promise.get_future().share();
+                isOwner = true;
             }
-            GeneralStore *dbStore = nullptr;
-            std::tie(ret, dbStore) = creators_[meta.storeType](meta, option);
-            if (dbStore == nullptr) {
-                ZLOGE("creator failed. storeName:%{public}s", meta.GetStoreAlias().c_str());
-                return !stores.empty();
+            opening = future;
+            return true;
+        });
+        if (!isOwner) {
+            ret = opening.get();
+            if (ret != E_OK) {
+                return { ret, store };
             }
-            dbStore->SetExecutor(executor_);
-            auto result = stores.emplace(std::piecewise_construct, std::forward_as_tuple(storeKey),
-                std::forward_as_tuple(dbStore, watchers, meta, garbageInterval_));
-            store = result.first->second;
-            startTimer = true;
+            continue;
+        }
+        std::tie(ret, store) = OpenStore(meta, storeKey, watchers, option);
+        openings_.Erase(openKey);
+        promise.set_value(ret == E_OK && store == nullptr ? E_ERROR : ret);
+        break;
+    }
+    return { ret == E_OK && store == nullptr ? E_ERROR : ret, store };
+}
+
+bool AutoCache::IsDisabled(uint32_t tokenId, const std::string &storeKey)
+{
+    return disables_.ContainIf(tokenId,
+        [&storeKey](const std::set<std::string> &stores) -> bool { return stores.count(storeKey) != 0; });
+}
+
+uint64_t AutoCache::BeginOpen(uint32_t tokenId)
+{
+    uint64_t closes = 0;
+    closeEpochs_.Compute(tokenId, [&closes](auto &, CloseEpoch &epoch) {
+        epoch.openings++;
+        closes = epoch.closes;
+        return true;
+    });
+    return closeEpoch_.load() + closes;
+}
+
+void AutoCache::EndOpen(uint32_t tokenId)
+{
+    closeEpochs_.ComputeIfPresent(tokenId, [](auto &, CloseEpoch &epoch) {
+        epoch.openings--;
+        return epoch.openings != 0;
+    });
+}
+
+uint64_t AutoCache::GetCloseEpoch(uint32_t tokenId)
+{
+    // both parts only grow while an open of the token is in progress, so the sum changes with either of them.
+    return closeEpoch_.load() + closeEpochs_.Find(tokenId).second.closes;
+}
+
+void AutoCache::UpdateCloseEpoch(uint32_t tokenId)
+{
+    closeEpochs_.ComputeIfPresent(tokenId, [](auto &, CloseEpoch &epoch) {
+        epoch.closes++;
+        return true;
+    });
+}
+
+bool AutoCache::FindStore(uint32_t tokenId, const std::string &storeKey, const Watchers &watchers, Store &store)
+{
+    stores_.ComputeIfPresent(tokenId, [&storeKey, &watchers, &store](auto &, auto &stores) -> bool {
+        auto it = stores.find(storeKey);
+        if (it != stores.end()) {
+            if (!watchers.empty()) {
+                it->second.SetObservers(watchers);
+            }
+            store = it->second;
+        }
+        return !stores.empty();
+    });
+    return store != nullptr;
+}
+
+std::pair<int32_t, AutoCache::Store> AutoCache::OpenStore(const StoreMetaData &meta, const std::string &storeKey,
+    const Watchers &watchers, const StoreOption &option)
+{
+    Store store;
+    // the previous owner may have published the store before this one became the owner.
+    if (FindStore(meta.tokenId, storeKey, watchers, store)) {
+        return { E_OK, store };
+    }
+    // the creator opens files and derives keys, so it runs without holding the stripe lock of the token.
+    auto epoch = BeginOpen(meta.tokenId);
+    int32_t ret = E_OK;
+    GeneralStore *dbStore = nullptr;
+    auto begin = std::chrono::steady_clock::now();
+    std::tie(ret, dbStore) = creators_[meta.storeType](meta, option);
+    if (dbStore == nullptr) {
+        EndOpen(meta.tokenId);
+        ZLOGE("creator failed. storeName:%{public}s", meta.GetStoreAlias().c_str());
+        return { ret, store };
+    }
+    uint64_t openCost =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    opens_++;
+    auto historyKey = std::to_string(meta.tokenId).append(KEY_SEPARATOR).append(storeKey);
+    uint32_t reopenCount = 0;
+    if (closedStores_.Get(historyKey, reopenCount)) {
+        closedStores_.Delete(historyKey);
+        reopenCount++;
+        reopens_++;
+    }
+    dbStore->SetExecutor(executor_);
+    bool startTimer = false;
+    stores_.Compute(meta.tokenId, [this, &meta, &watchers, &store, &storeKey, &dbStore, &startTimer, openCost,
+        reopenCount, epoch](auto &, std::map<std::string, Delegate> &stores) -> bool {
+        // a close of the token ran while the creator was opening, the close must not be undone.
+        if (IsDisabled(meta.tokenId, storeKey) || GetCloseEpoch(meta.tokenId) != epoch) {
             return !stores.empty();
-        });
+        }
+        auto result = stores.emplace(std::piecewise_construct, std::forward_as_tuple(storeKey),
+            std::forward_as_tuple(dbStore, watchers, meta, garbageInterval_));
+        if (result.second) {
+            result.first->second.SetOpenStat(openCost, reopenCount);
+            dbStore = nullptr;
+            startTimer = true;
+        }
+        store = result.first->second;
+        return !stores.empty();
+    });
+    EndOpen(meta.tokenId);
+    if (dbStore != nullptr) {
+        dbStore->Close(true);
+        dbStore->Release();
+    }
+    if (store == nullptr) {
+        ZLOGW("store is closed while opening, storeName:%{public}s", meta.GetStoreAlias().c_str());
+        return { E_ERROR, store };
+    }
     if (startTimer) {
         StartTimer();
     }
-    return { ret == E_OK && store == nullptr ? E_ERROR : ret, store };
+    auto maxOpen = maxOpen_.load();
+    auto policy = GetEvictionPolicy();
+    if (startTimer && maxOpen != 0 && policy != nullptr) {
+        if (executor_ == nullptr) {
+            Evict(maxOpen, policy);
+        } else {
+            executor_->Execute([this, maxOpen, policy]() { Evict(maxOpen, policy); });
+        }
+    }
+    return { ret, store };
+}
+
+void AutoCache::SetEvictionPolicy(std::shared_ptr<EvictionPolicy> policy, uint32_t maxOpen)
+{
+    {
+        std::lock_guard<decltype(policyMutex_)> lock(policyMutex_);
+        policy_ = policy;
+    }
+    maxOpen_ = maxOpen;
+    if (policy != nullptr && maxOpen != 0) {
+        Evict(maxOpen, policy);
+    }
+}
+
+std::shared_ptr<AutoCache::EvictionPolicy> AutoCache::GetEvictionPolicy()
+{
+    std::lock_guard<decltype(policyMutex_)> lock(policyMutex_);
+    return policy_;
+}
+
+void AutoCache::OnMemoryPressure(int32_t level)
+{
+    auto policy = GetEvictionPolicy();
+    if (policy == nullptr) {
+        policy = std::make_shared<LruPolicy>();
+    }
+    auto resident = GetResidentCount();
+    uint32_t budget = maxOpen_ == 0 ? resident : std::min(resident, maxOpen_.load());
+    switch (level) {
+        case MEMORY_LEVEL_MODERATE:
+            budget = budget / 2; // keep half of the budget
+            break;
+        case MEMORY_LEVEL_LOW:
+            budget = budget / 4; // keep a quarter of the budget
+            break;
+        case MEMORY_LEVEL_CRITICAL:
+            budget = 0;
+            break;
+        default:
+            return;
+    }
+    ZLOGI("memory level:%{public}d, resident:%{public}u, budget:%{public}u", level, resident, budget);
+    Evict(budget, policy);
+}
+
+uint32_t AutoCache::GetResidentCount()
+{
+    uint32_t count = 0;
+    stores_.ForEach([&count](const auto &, std::map<std::string, Delegate> &delegates) {
+        count += delegates.size();
+        return false;
+    });
+    return count;
+}
+
+void AutoCache::Evict(uint32_t budget, std::shared_ptr<EvictionPolicy> policy)
+{
+    struct Candidate {
+        uint32_t tokenId;
+        std::string storeKey;
+        double priority;
+    };
+    std::vector<Candidate> candidates;
+    auto now = std::chrono::steady_clock::now();
+    bool isScreenLocked = ScreenManager::GetInstance()->IsLocked();
+    uint32_t resident = 0;
+    XCollie xcollie(__FUNCTION__, AUTO_CACHE_XCOLLIE_FLAG, AUTO_CACHE_XCOLLIE_TIMEOUT);
+    stores_.EraseIf([&candidates, &resident, &policy, now, isScreenLocked, budget](
+        auto &tokenId, std::map<std::string, Delegate> &delegates) {
+        for (auto &[storeKey, delegate] : delegates) {
+            resident++;
+            auto stat = delegate.GetStat();
+            if ((isScreenLocked && delegate.GetArea() == GeneralStore::EL4) ||
+                (budget != 0 && now - stat.lastAccess < MIN_RESIDENT_TIME)) {
+                continue;
+            }
+            candidates.push_back({ tokenId, storeKey, policy->GetPriority(stat, now) });
+        }
+        return delegates.empty();
+    });
+    if (resident <= budget) {
+        return;
+    }
+    size_t count = std::min(static_cast<size_t>(resident - budget), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [](const Candidate &left, const Candidate &right) { return left.priority < right.priority; });
+    uint32_t evicted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        auto &candidate = candidates[i];
+        stores_.ComputeIfPresent(candidate.tokenId, [this, &candidate, &evicted](auto &, auto &delegates) {
+            auto it = delegates.find(candidate.storeKey);
+            // the BUSY store is skipped, it will be evicted next time.
+            if (it != delegates.end() && it->second.Close()) {
+                RecordClosed(candidate.tokenId, candidate.storeKey, it->second);
+                delegates.erase(it);
+                evicted++;
+            }
+            return !delegates.empty();
+        });
+    }
+    evictions_ += evicted;
+    ZLOGI("evict end. resident:%{public}u, budget:%{public}u, evicted:%{public}u", resident, budget, evicted);
+}
+
+void AutoCache::RecordClosed(uint32_t tokenId, const std::string &storeKey, const Delegate &delegate)
+{
+    closedStores_.Set(std::to_string(tokenId).append(KEY_SEPARATOR).append(storeKey), delegate.GetStat().reopenCount);
+}
+
+void AutoCache::DumpCacheInfo(int fd, std::map<std::string, std::vector<std::string>> &params)
+{
+    (void)params;
+    std::string info;
+    info.append("opens:").append(std::to_string(opens_.load()))
+        .append(" reopens:").append(std::to_string(reopens_.load()))
+        .append(" evictions:").append(std::to_string(evictions_.load()))
+        .append(" resident:").append(std::to_string(GetResidentCount()))
+        .append(" maxOpen:").append(std::to_string(maxOpen_.load()));
+    dprintf(fd, "-------------------------------------AutoCacheInfo------------------------------\n%s\n",
+        info.c_str());
 }
 
 AutoCache::Store AutoCache::GetStore(const StoreMetaData &meta, const Watchers &watchers)
@@ -203,6 +452,7 @@ void AutoCache::CloseStore(uint32_t tokenId, const std::string &path, const std:
     ZLOGD("close store start, store:%{public}s, token:%{public}u", Anonymous::Change(storeId).c_str(), tokenId);
     bool isScreenLocked = ScreenManager::GetInstance()->IsLocked();
     auto storeKey = GenerateKey(path, storeId);
+    UpdateCloseEpoch(tokenId);
     XCollie xcollie(__FUNCTION__, AUTO_CACHE_XCOLLIE_FLAG, AUTO_CACHE_XCOLLIE_TIMEOUT);
     stores_.ComputeIfPresent(tokenId, [&storeKey, isScreenLocked](auto &, auto &delegates) {
         auto it = delegates.begin();
@@ -224,6 +474,8 @@ void AutoCache::CloseStore(const AutoCache::Filter &filter)
     if (filter == nullptr) {
         return;
     }
+    // the token of a store being opened is unknown to the filter, so every open in progress is discarded.
+    closeEpoch_++;
     XCollie xcollie(__FUNCTION__, AUTO_CACHE_XCOLLIE_FLAG, AUTO_CACHE_XCOLLIE_TIMEOUT);
     stores_.EraseIf([&filter](auto &tokenId, auto &delegates) {
         auto it = delegates.begin();
@@ -262,12 +514,13 @@ void AutoCache::GarbageCollect(bool isForce)
     uint32_t removeCount = 0;
     uint32_t remainCount = 0;
     XCollie xcollie(__FUNCTION__, AUTO_CACHE_XCOLLIE_FLAG, AUTO_CACHE_XCOLLIE_TIMEOUT);
-    stores_.EraseIf([&current, isForce, isScreenLocked, &removeCount, &remainCount](
+    stores_.EraseIf([this, &current, isForce, isScreenLocked, &removeCount, &remainCount](
                         auto &key, std::map<std::string, Delegate> &delegates) {
         for (auto it = delegates.begin(); it != delegates.end();) {
             // if the store is BUSY we wait more INTERVAL minutes again
             if ((!isScreenLocked || it->second.GetArea() != GeneralStore::EL4) && (isForce || it->second < current) &&
                 it->second.Close()) {
+                RecordClosed(key, it->first, it->second);
                 it = delegates.erase(it);
                 ++removeCount;
             } else {
@@ -311,7 +564,8 @@ AutoCache::Delegate::Delegate(
     GeneralStore *delegate, const Watchers &watchers, const StoreMetaData &meta, uint32_t garbageInterval)
     : store_(delegate), watchers_(watchers), meta_(meta), garbageInterval_(garbageInterval)
 {
-    time_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(garbageInterval);
+    lastAccess_ = std::chrono::steady_clock::now();
+    time_ = lastAccess_ + std::chrono::milliseconds(garbageInterval);
 
     if (store_ != nullptr) {
         store_->Watch(Origin::ORIGIN_ALL, *this);
@@ -330,7 +584,9 @@ AutoCache::Delegate::~Delegate()
 
 AutoCache::Delegate::operator Store()
 {
-    time_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(garbageInterval_);
+    lastAccess_ = std::chrono::steady_clock::now();
+    time_ = lastAccess_ + std::chrono::milliseconds(garbageInterval_);
+    accessCount_++;
     if (store_ != nullptr) {
         store_->AddRef();
         return Store(store_, [](GeneralStore *store) { store->Release(); });
@@ -361,6 +617,17 @@ void AutoCache::Delegate::SetObservers(const AutoCache::Watchers &watchers)
     watchers_ = watchers;
 }
 
+void AutoCache::Delegate::SetOpenStat(uint64_t openCost, uint32_t reopenCount)
+{
+    openCost_ = openCost;
+    reopenCount_ = reopenCount;
+}
+
+AutoCache::EvictionPolicy::StoreStat AutoCache::Delegate::GetStat() const
+{
+    return { lastAccess_, accessCount_, openCost_, reopenCount_ };
+}
+
 int32_t AutoCache::Delegate::GetArea() const
 {
     return meta_.area;
@@ -417,6 +684,18 @@ int32_t AutoCache::Delegate::OnChange(const Origin &origin, const Fields &fields
     return Error::E_OK;
 }
 
+double AutoCache::LruPolicy::GetPriority(const StoreStat &stat, Time now) const
+{
+    return -std::chrono::duration<double>(now - stat.lastAccess).count();
+}
+
+double AutoCache::LfuPolicy::GetPriority(const StoreStat &stat, Time now) const
+{
+    double idle = std::max(std::chrono::duration<double>(now - stat.lastAccess).count(), 0.0);
+    double openCost = static_cast<double>(stat.openCost) / MICROSECONDS_PER_MILLISECOND;
+    return (stat.accessCount + stat.reopenCount) * (1.0 + openCost) / (1.0 + idle);
+}
+
 void AutoCache::Delegate::PostDataChange(const StoreMetaData &meta, const std::vector<std::string> &tables)
 {
     RemoteChangeEvent::DataInfo info;
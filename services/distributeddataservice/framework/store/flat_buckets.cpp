@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "store/flat_buckets.h"
+
+#include <algorithm>
+#include <iterator>
+namespace OHOS::DistributedData {
+const FlatBuckets::Columns FlatBuckets::EMPTY_COLUMNS;
+
+FlatBuckets::FlatBuckets(std::shared_ptr<const Columns> columns)
+{
+    if (columns != nullptr && !std::is_sorted(columns->begin(), columns->end())) {
+        auto sorted = std::make_shared<Columns>(*columns);
+        std::sort(sorted->begin(), sorted->end());
+        sorted->erase(std::unique(sorted->begin(), sorted->end()), sorted->end());
+        columns = std::move(sorted);
+    }
+    columns_ = std::move(columns);
+}
+
+FlatBuckets::FlatBuckets(VBuckets &&buckets) : columns_(CollectColumns(buckets))
+{
+    Reserve(buckets.size());
+    for (auto &bucket : buckets) {
+        Append(std::move(bucket));
+    }
+    buckets.clear();
+}
+
+const FlatBuckets::Columns &FlatBuckets::GetColumns() const
+{
+    return columns_ == nullptr ? EMPTY_COLUMNS : *columns_;
+}
+
+std::shared_ptr<const FlatBuckets::Columns> FlatBuckets::GetSharedColumns() const
+{
+    return columns_;
+}
+
+int32_t FlatBuckets::IndexOf(const std::string &column) const
+{
+    auto &columns = GetColumns();
+    auto it = std::lower_bound(columns.begin(), columns.end(), column);
+    if (it == columns.end() || *it != column) {
+        return INVALID_COLUMN;
+    }
+    return static_cast<int32_t>(it - columns.begin());
+}
+
+size_t FlatBuckets::ColumnCount() const
+{
+    return GetColumns().size();
+}
+
+size_t FlatBuckets::Size() const
+{
+    return rows_;
+}
+
+bool FlatBuckets::Empty() const
+{
+    return rows_ == 0;
+}
+
+void FlatBuckets::Reserve(size_t rows)
+{
+    values_.reserve(rows * ColumnCount());
+}
+
+bool FlatBuckets::Append(VBucket &&bucket)
+{
+    auto &columns = GetColumns();
+    size_t base = values_.size();
+    values_.resize(base + columns.size());
+    auto it = bucket.begin();
+    size_t col = 0;
+    for (; col < columns.size(); ++col) {
+        if (it != bucket.end() && it->first == columns[col]) {
+            values_[base + col] = std::move(it->second);
+            ++it;
+            continue;
+        }
+        if (it != bucket.end() && it->first < columns[col]) {
+            break;
+        }
+        MarkAbsent(base + col);
+    }
+    if (it == bucket.end()) {
+        rows_++;
+        return true;
+    }
+    // the bucket has a column the rows do not know, give back what was moved
+    for (size_t i = 0; i < col; ++i) {
+        if (!IsAbsent(rows_, i)) {
+            bucket.insert_or_assign(columns[i], std::move(values_[base + i]));
+        }
+    }
+    values_.resize(base);
+    if (absent_.size() > base) {
+        absent_.resize(base);
+    }
+    return false;
+}
+
+bool FlatBuckets::Append(Values &&values)
+{
+    if (values.size() != ColumnCount()) {
+        return false;
+    }
+    std::move(values.begin(), values.end(), std::back_inserter(values_));
+    values.clear();
+    rows_++;
+    return true;
+}
+
+bool FlatBuckets::IsAbsent(size_t row, size_t col) const
+{
+    auto cell = row * ColumnCount() + col;
+    return cell < absent_.size() && absent_[cell];
+}
+
+const Value *FlatBuckets::Get(size_t row, size_t col) const
+{
+    if (row >= rows_ || col >= ColumnCount() || IsAbsent(row, col)) {
+        return nullptr;
+    }
+    return &values_[row * ColumnCount() + col];
+}
+
+Value *FlatBuckets::Get(size_t row, size_t col)
+{
+    return const_cast<Value *>(static_cast<const FlatBuckets *>(this)->Get(row, col));
+}
+
+VBucket FlatBuckets::GetBucket(size_t row) const
+{
+    VBucket bucket;
+    auto &columns = GetColumns();
+    for (size_t col = 0; row < rows_ && col < columns.size(); ++col) {
+        if (!IsAbsent(row, col)) {
+            bucket.emplace_hint(bucket.end(), columns[col], values_[row * columns.size() + col]);
+        }
+    }
+    return bucket;
+}
+
+VBucket FlatBuckets::TakeBucket(size_t row)
+{
+    VBucket bucket;
+    auto &columns = GetColumns();
+    for (size_t col = 0; row < rows_ && col < columns.size(); ++col) {
+        if (!IsAbsent(row, col)) {
+            bucket.emplace_hint(bucket.end(), columns[col], std::move(values_[row * columns.size() + col]));
+        }
+    }
+    return bucket;
+}
+
+VBuckets FlatBuckets::TakeBuckets()
+{
+    VBuckets buckets;
+    buckets.reserve(rows_);
+    for (size_t row = 0; row < rows_; ++row) {
+        buckets.push_back(TakeBucket(row));
+    }
+    values_.clear();
+    absent_.clear();
+    rows_ = 0;
+    return buckets;
+}
+
+void FlatBuckets::MarkAbsent(size_t cell)
+{
+    if (absent_.size() < values_.size()) {
+        absent_.resize(values_.size(), false);
+    }
+    absent_[cell] = true;
+}
+} // namespace OHOS::DistributedData
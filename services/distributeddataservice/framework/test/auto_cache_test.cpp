@@ -18,10 +18,17 @@
 
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <cinttypes>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #include "gtest/gtest.h"
+#include "log_print.h"
 #include "mock/account_delegate_mock.h"
 #include "mock/account_delegate_mock_proxy.h"
 #include "mock/general_store_mock.h"
@@ -968,5 +975,221 @@ HWTEST_F(AutoCacheTest, AutoCache_GetDBStore_CheckStatusBeforeOpen_ValidUserVeri
     EXPECT_EQ(store.get(), mock.get());
     EXPECT_EQ(creationCount, 1);
 }
+
+/**
+ * @tc.name: AutoCache_GetDBStore_ConcurrentOpen
+ * @tc.desc: Test that concurrent requesters of one store share a single open and unrelated stores open in parallel
+ * Step 1: Register a creator that takes 20ms to open a store and counts the opens of every store
+ * Step 2: Open the same store from many threads and verify the creator ran only once
+ * Step 3: Open different stores of different tokens from many threads and verify the creator ran exactly once
+ *         for every store, then report the p50/p99 open latency
+ * @tc.type: FUNC
+ */
+HWTEST_F(AutoCacheTest, AutoCache_GetDBStore_ConcurrentOpen, TestSize.Level1)
+{
+    const int32_t storeType = 19;
+    const int32_t threadNum = 32;
+    const auto openCost = std::chrono::milliseconds(20);
+    std::atomic_int32_t creationCount = 0;
+    std::mutex mutex;
+    std::map<std::string, int32_t> creations;
+    auto result = AutoCache::GetInstance().RegCreator(storeType,
+        [&creationCount, &mutex, &creations, openCost](const StoreMetaData &meta,
+            const AutoCache::StoreOption &option) -> std::pair<int32_t, GeneralStore *> {
+            creationCount++;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                creations[meta.storeId]++;
+            }
+            std::this_thread::sleep_for(openCost);
+            return { E_OK, new (std::nothrow) AutoCacheTestGeneralStoreMock(meta, option.createRequired) };
+        });
+    ASSERT_EQ(result, E_OK);
+    auto open = [this, storeType](uint32_t tokenId, const std::string &storeId, std::vector<int64_t> &costs,
+        size_t index) {
+        auto meta = GetStoreMetaData(storeId);
+        meta.storeType = storeType;
+        meta.tokenId = tokenId;
+        auto begin = std::chrono::steady_clock::now();
+        auto [err, store] = AutoCache::GetInstance().GetDBStore(meta, {}, {});
+        costs[index] = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        EXPECT_EQ(err, E_OK);
+        EXPECT_NE(store, nullptr);
+    };
+    std::vector<int64_t> costs(threadNum, 0);
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < threadNum; ++i) {
+        threads.emplace_back(open, 500, "concurrent_same.db", std::ref(costs), i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    EXPECT_EQ(creationCount, 1);
+
+    creationCount = 0;
+    creations.clear();
+    for (int32_t i = 0; i < threadNum; ++i) {
+        threads.emplace_back(open, 600 + i, "concurrent_" + std::to_string(i) + ".db", std::ref(costs), i);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(creationCount, threadNum);
+    EXPECT_EQ(creations.size(), static_cast<size_t>(threadNum));
+    for (auto &[storeId, count] : creations) {
+        EXPECT_EQ(count, 1) << storeId;
+    }
+    std::sort(costs.begin(), costs.end());
+    ZLOGI("open latency p50:%{public}" PRId64 "us p99:%{public}" PRId64 "us", costs[costs.size() / 2],
+        costs[costs.size() * 99 / 100]);
+}
+
+/**
+ * @tc.name: AutoCache_GetDBStore_CloseWhileOpening
+ * @tc.desc: Test that a store closed while its creator is running is discarded instead of published
+ * Step 1: Register a creator that blocks until the test releases it
+ * Step 2: Open the store in another thread and close the token while the creator is blocked
+ * Step 3: Release the creator and verify the open fails and the store is not resident
+ * Step 4: Open the store again and verify it is published
+ * Step 5: Verify no close epoch of the token is kept once its opens finished
+ * @tc.type: FUNC
+ */
+HWTEST_F(AutoCacheTest, AutoCache_GetDBStore_CloseWhileOpening, TestSize.Level1)
+{
+    const int32_t storeType = 20;
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic_int32_t creationCount = 0;
+    auto result = AutoCache::GetInstance().RegCreator(storeType,
+        [&entered, released, &creationCount](const StoreMetaData &meta,
+            const AutoCache::StoreOption &option) -> std::pair<int32_t, GeneralStore *> {
+            if (creationCount++ == 0) {
+                entered.set_value();
+                released.wait();
+            }
+            return { E_OK, new (std::nothrow) AutoCacheTestGeneralStoreMock(meta, option.createRequired) };
+        });
+    ASSERT_EQ(result, E_OK);
+    auto meta = GetStoreMetaData("close_while_opening.db");
+    meta.storeType = storeType;
+    meta.tokenId = 800;
+    std::pair<int32_t, AutoCache::Store> opened;
+    std::thread opener([&opened, &meta]() { opened = AutoCache::GetInstance().GetDBStore(meta, {}, {}); });
+    entered.get_future().wait();
+    AutoCache::GetInstance().CloseStore(meta.tokenId, meta.dataDir, meta.storeId);
+    release.set_value();
+    opener.join();
+    EXPECT_EQ(opened.first, E_ERROR);
+    EXPECT_EQ(opened.second, nullptr);
+    EXPECT_TRUE(AutoCache::GetInstance().GetStoresIfPresent(meta.tokenId).empty());
+    EXPECT_FALSE(AutoCache::GetInstance().closeEpochs_.Contains(meta.tokenId));
+
+    auto [err, store] = AutoCache::GetInstance().GetDBStore(meta, {}, {});
+    EXPECT_EQ(err, E_OK);
+    EXPECT_NE(store, nullptr);
+    EXPECT_EQ(creationCount, 2);
+    AutoCache::GetInstance().CloseStore(meta.tokenId, meta.dataDir, meta.storeId);
+    EXPECT_FALSE(AutoCache::GetInstance().closeEpochs_.Contains(meta.tokenId));
+}
+
+/**
+ * @tc.name: AutoCache_EvictionPolicy_Priority
+ * @tc.desc: Test the priorities of the built-in eviction policies
+ * Step 1: Verify LRU gives the recently used store the higher priority
+ * Step 2: Verify LFU gives the frequently used and expensive to reopen store the higher priority
+ * @tc.type: FUNC
+ */
+HWTEST_F(AutoCacheTest, AutoCache_EvictionPolicy_Priority, TestSize.Level1)
+{
+    auto now = std::chrono::steady_clock::now();
+    AutoCache::EvictionPolicy::StoreStat recent = { now, 1, 100, 0 };
+    AutoCache::EvictionPolicy::StoreStat old = { now - std::chrono::seconds(10), 1, 100, 0 };
+    AutoCache::LruPolicy lru;
+    EXPECT_GT(lru.GetPriority(recent, now), lru.GetPriority(old, now));
+
+    AutoCache::LfuPolicy lfu;
+    AutoCache::EvictionPolicy::StoreStat hot = { now, 100, 100, 0 };
+    AutoCache::EvictionPolicy::StoreStat expensive = { now, 1, 500 * 1000, 2 };
+    EXPECT_GT(lfu.GetPriority(hot, now), lfu.GetPriority(recent, now));
+    EXPECT_GT(lfu.GetPriority(expensive, now), lfu.GetPriority(recent, now));
+}
+
+/**
+ * @tc.name: AutoCache_Evict_OpenBudget
+ * @tc.desc: Test that the open budget closes the stores chosen by the policy and only those are counted as evictions
+ * Step 1: Open three stores and use the first one again
+ * Step 2: Set an LRU policy with a budget of one store less than resident and verify the least recently used
+ *         store is closed
+ * Step 3: Reopen the closed store and verify the reopen is counted
+ * Step 4: Close the stores by the idle timer and verify the evictions are not changed
+ * @tc.type: FUNC
+ */
+HWTEST_F(AutoCacheTest, AutoCache_Evict_OpenBudget, TestSize.Level1)
+{
+    auto meta1 = GetStoreMetaData("evict_1.db");
+    auto meta2 = GetStoreMetaData("evict_2.db");
+    auto meta3 = GetStoreMetaData("evict_3.db");
+    meta1.tokenId = 700;
+    meta2.tokenId = 701;
+    meta3.tokenId = 702;
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta1, {}), nullptr);
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta2, {}), nullptr);
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta3, {}), nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta1, {}), nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta3, {}), nullptr);
+
+    // the budget is relative to the resident count, so the stores opened by other cases do not matter.
+    auto resident = AutoCache::GetInstance().GetResidentCount();
+    ASSERT_GE(resident, 3);
+    auto evictions = AutoCache::GetInstance().evictions_.load();
+    AutoCache::GetInstance().SetEvictionPolicy(std::make_shared<AutoCache::LruPolicy>(), resident - 1);
+    EXPECT_EQ(AutoCache::GetInstance().evictions_.load(), evictions + 1);
+    EXPECT_TRUE(AutoCache::GetInstance().GetStoresIfPresent(meta2.tokenId).empty());
+    EXPECT_FALSE(AutoCache::GetInstance().GetStoresIfPresent(meta1.tokenId).empty());
+    EXPECT_FALSE(AutoCache::GetInstance().GetStoresIfPresent(meta3.tokenId).empty());
+
+    auto reopens = AutoCache::GetInstance().reopens_.load();
+    AutoCache::GetInstance().SetEvictionPolicy(nullptr, 0);
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta2, {}), nullptr);
+    EXPECT_EQ(AutoCache::GetInstance().reopens_.load(), reopens + 1);
+
+    evictions = AutoCache::GetInstance().evictions_.load();
+    AutoCache::GetInstance().GarbageCollect(true);
+    EXPECT_TRUE(AutoCache::GetInstance().GetStoresIfPresent(meta1.tokenId).empty());
+    EXPECT_EQ(AutoCache::GetInstance().evictions_.load(), evictions);
+}
+
+/**
+ * @tc.name: AutoCache_OnMemoryPressure
+ * @tc.desc: Test that the memory pressure closes the cached stores and an unknown level closes none
+ * Step 1: Open two stores and report an unknown memory level, verify both stay open
+ * Step 2: Report critical memory pressure and verify both stores are closed and counted as evictions
+ * @tc.type: FUNC
+ */
+HWTEST_F(AutoCacheTest, AutoCache_OnMemoryPressure, TestSize.Level1)
+{
+    auto meta1 = GetStoreMetaData("pressure_1.db");
+    auto meta2 = GetStoreMetaData("pressure_2.db");
+    meta1.tokenId = 710;
+    meta2.tokenId = 711;
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta1, {}), nullptr);
+    ASSERT_NE(AutoCache::GetInstance().GetStore(meta2, {}), nullptr);
+
+    AutoCache::GetInstance().OnMemoryPressure(-1);
+    EXPECT_FALSE(AutoCache::GetInstance().GetStoresIfPresent(meta1.tokenId).empty());
+    EXPECT_FALSE(AutoCache::GetInstance().GetStoresIfPresent(meta2.tokenId).empty());
+
+    auto evictions = AutoCache::GetInstance().evictions_.load();
+    AutoCache::GetInstance().OnMemoryPressure(AutoCache::MEMORY_LEVEL_CRITICAL);
+    EXPECT_EQ(AutoCache::GetInstance().GetResidentCount(), 0);
+    EXPECT_TRUE(AutoCache::GetInstance().GetStoresIfPresent(meta1.tokenId).empty());
+    EXPECT_TRUE(AutoCache::GetInstance().GetStoresIfPresent(meta2.tokenId).empty());
+    EXPECT_GE(AutoCache::GetInstance().evictions_.load(), evictions + 2);
+}
 } // namespace DistributedDataAutoCacheTest
 } // namespace OHOS::Test
\ No newline at end of file
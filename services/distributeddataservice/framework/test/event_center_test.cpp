@@ -14,6 +14,15 @@
  */
 #define LOG_TAG "EventCenterTest"
 #include "eventcenter/event_center.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <future>
+#include <map>
+#include <numeric>
+#include <thread>
+
+#include "changeevent/remote_change_event.h"
 #include "gtest/gtest.h"
 #include "log_print.h"
 using namespace testing::ext;
@@ -25,6 +34,8 @@ public:
         TEST_EVT_BEGIN = Event::EVT_CUSTOM + 1,
         TEST_EVT_MIDDLE,
         TEST_EVT_END,
+        TEST_EVT_KEYED,
+        TEST_EVT_ASYNC,
     };
     class TestBegin : public Event {
     public:
@@ -38,7 +49,32 @@ public:
     public:
         TestEnd(): Event(TEST_EVT_END) {};
     };
-    static void SetUpTestCase(void) {}
+    class TestKeyed : public Event {
+    public:
+        TestKeyed(int32_t key, int32_t value, bool indexed = true)
+            : Event(TEST_EVT_KEYED), key(key), value(value), indexed(indexed) {};
+        bool Equals(const Event &event) const override
+        {
+            auto &evt = static_cast<const TestKeyed &>(event);
+            return key == evt.key && value == evt.value;
+        }
+        size_t GetHash() const override
+        {
+            return indexed ? static_cast<size_t>(key) + 1 : 0;
+        }
+        int32_t key = 0;
+        int32_t value = 0;
+        bool indexed = true;
+    };
+    class TestAsync : public Event {
+    public:
+        explicit TestAsync(int32_t value): Event(TEST_EVT_ASYNC), value(value) {};
+        int32_t value = 0;
+    };
+    static void SetUpTestCase(void)
+    {
+        EventCenter::GetInstance().BindExecutor(std::make_shared<ExecutorPool>(4, 2));
+    }
     static void TearDownTestCase(void) {}
     void SetUp()
     {
@@ -152,3 +188,313 @@ HWTEST_F(EventCenterTest, ImmediatelyASyncEvent, TestSize.Level2)
     ASSERT_EQ(currEvent_, TEST_EVT_END);
     ASSERT_EQ(waitEvent_, TEST_EVT_UNKNOWN);
 }
+
+
+/**
+* @tc.name: CoalesceKeyedEvent
+* @tc.desc: the queued events with the same hash are dropped when equal and folded by the merger otherwise.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, CoalesceKeyedEvent, TestSize.Level2)
+{
+    constexpr int32_t keys = 10;
+    constexpr int32_t times = 100;
+    std::map<int32_t, int32_t> received;
+    int32_t dispatched = 0;
+    EventCenter::GetInstance().Subscribe(TEST_EVT_KEYED, [&received, &dispatched](const Event &event) {
+        auto &evt = static_cast<const TestKeyed &>(event);
+        received[evt.key] += evt.value;
+        dispatched++;
+    });
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, [](Event &queued, const Event &event) {
+        static_cast<TestKeyed &>(queued).value += static_cast<const TestKeyed &>(event).value;
+        return true;
+    });
+    {
+        EventCenter::Defer defer;
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(0, 1));
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(0, 1));
+        for (int32_t i = 1; i < times; ++i) {
+            for (int32_t key = 1; key < keys; ++key) {
+                // the values never equal the merged sum, so every post is merged instead of dropped as equal.
+                EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(key, times + i));
+            }
+        }
+        ASSERT_EQ(dispatched, 0);
+    }
+    EXPECT_EQ(dispatched, keys);
+    EXPECT_EQ(received[0], 1);
+    int32_t expected = 0;
+    for (int32_t i = 1; i < times; ++i) {
+        expected += times + i;
+    }
+    for (int32_t key = 1; key < keys; ++key) {
+        EXPECT_EQ(received[key], expected);
+    }
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, nullptr);
+    EventCenter::GetInstance().Unsubscribe(TEST_EVT_KEYED);
+}
+
+/**
+* @tc.name: RepostWhileDispatching
+* @tc.desc: the event posted again by its handler is queued, not merged into the event being dispatched.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, RepostWhileDispatching, TestSize.Level2)
+{
+    std::vector<int32_t> received;
+    EventCenter::GetInstance().Subscribe(TEST_EVT_KEYED, [&received](const Event &event) {
+        auto &evt = static_cast<const TestKeyed &>(event);
+        received.push_back(evt.value);
+        if (received.size() == 1) {
+            EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(0, 2));
+        }
+    });
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, [](Event &queued, const Event &event) {
+        static_cast<TestKeyed &>(queued).value += static_cast<const TestKeyed &>(event).value;
+        return true;
+    });
+    {
+        EventCenter::Defer defer;
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(0, 1));
+    }
+    EXPECT_EQ(received, std::vector<int32_t>({ 1, 2 }));
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, nullptr);
+    EventCenter::GetInstance().Unsubscribe(TEST_EVT_KEYED);
+}
+
+/**
+* @tc.name: CoalesceDataChangeEvent
+* @tc.desc: the data change events of the same store union their tables, the empty tables are never merged.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, CoalesceDataChangeEvent, TestSize.Level2)
+{
+    auto makeEvent = [](const std::string &storeId, std::vector<std::string> tables) {
+        RemoteChangeEvent::DataInfo info;
+        info.userId = "100";
+        info.storeId = storeId;
+        info.bundleName = "com.example.test";
+        info.tables = std::move(tables);
+        return std::make_unique<RemoteChangeEvent>(RemoteChangeEvent::DATA_CHANGE, std::move(info));
+    };
+    auto first = makeEvent("store", { "a", "b" });
+    auto second = makeEvent("store", { "b", "c" });
+    ASSERT_EQ(first->GetHash(), second->GetHash());
+    ASSERT_TRUE(RemoteChangeEvent::Merge(*first, *second));
+    EXPECT_EQ(first->GetDataInfo().tables, std::vector<std::string>({ "a", "b", "c" }));
+    EXPECT_FALSE(RemoteChangeEvent::Merge(*first, *makeEvent("other", { "d" })));
+    EXPECT_FALSE(RemoteChangeEvent::Merge(*first, *makeEvent("store", {})));
+    EXPECT_EQ(first->GetDataInfo().tables.size(), 3);
+}
+
+/**
+* @tc.name: CoalescePostCost
+* @tc.desc: compare the cost of posting distinct events with the linear scan and with the hash index.
+* @tc.type: PERF
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, CoalescePostCost, TestSize.Level2)
+{
+    constexpr int32_t count = 10000;
+    auto post = [](bool indexed) {
+        auto begin = std::chrono::steady_clock::now();
+        {
+            EventCenter::Defer defer;
+            for (int32_t i = 0; i < count; ++i) {
+                EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(i, i, indexed));
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    };
+    auto linear = post(false);
+    auto indexed = post(true);
+    ZLOGI("post %{public}d events, linear:%{public}" PRId64 "us indexed:%{public}" PRId64 "us", count,
+        static_cast<int64_t>(linear), static_cast<int64_t>(indexed));
+    EXPECT_LT(indexed, linear);
+}
+
+
+/**
+* @tc.name: AsyncEventInOrder
+* @tc.desc: the events of an async observer are dispatched on the executors in posting order.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, AsyncEventInOrder, TestSize.Level2)
+{
+    constexpr int32_t count = 1000;
+    std::mutex mutex;
+    std::vector<int32_t> values;
+    std::promise<std::thread::id> finished;
+    EventCenter::GetInstance().Subscribe(TEST_EVT_ASYNC, [&](const Event &event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(static_cast<const TestAsync &>(event).value);
+        if (values.size() == count) {
+            finished.set_value(std::this_thread::get_id());
+        }
+    }, true);
+    for (int32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(EventCenter::GetInstance().PostEvent(std::make_unique<TestAsync>(i)), EventCenter::CODE_SYNC);
+    }
+    auto future = finished.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+    std::vector<int32_t> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values, expected);
+    // the latency is recorded after the observer returns.
+    std::vector<uint64_t> latency;
+    for (int32_t retry = 0; retry < 100; ++retry) {
+        latency = EventCenter::GetInstance().GetLatency(TEST_EVT_ASYNC);
+        if (std::accumulate(latency.begin(), latency.end(), uint64_t(0)) == uint64_t(count)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(latency.size(), EventCenter::LATENCY_BUCKETS);
+    EXPECT_EQ(std::accumulate(latency.begin(), latency.end(), uint64_t(0)), uint64_t(count));
+    EXPECT_TRUE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_ASYNC));
+}
+
+/**
+* @tc.name: AsyncEventCoalesce
+* @tc.desc: the events queued for a blocked async observer are merged instead of dropped, the posting thread never
+*           waits and the sync observers of the same event still run on it.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, AsyncEventCoalesce, TestSize.Level2)
+{
+    constexpr int32_t count = 100;
+    std::promise<void> started;
+    std::promise<void> release;
+    auto blocker = release.get_future().share();
+    std::mutex mutex;
+    std::map<int32_t, int32_t> received;
+    int32_t dispatched = 0;
+    EventCenter::GetInstance().Subscribe(TEST_EVT_KEYED, [&](const Event &event) {
+        auto &evt = static_cast<const TestKeyed &>(event);
+        if (evt.key == 0) {
+            started.set_value();
+            blocker.wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        received[evt.key] += evt.value;
+        dispatched++;
+    }, true);
+    auto caller = std::this_thread::get_id();
+    int32_t syncCount = 0;
+    EventCenter::GetInstance().Subscribe(TEST_EVT_KEYED, [&caller, &syncCount](const Event &event) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        syncCount++;
+    });
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, [](Event &queued, const Event &event) {
+        static_cast<TestKeyed &>(queued).value += static_cast<const TestKeyed &>(event).value;
+        return true;
+    });
+    EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(0, 1));
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    int32_t expected = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        // the values never equal the merged sum, so every post is merged instead of dropped as equal.
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestKeyed>(1, count + i));
+        expected += count + i;
+    }
+    EXPECT_EQ(syncCount, count + 1);
+    release.set_value();
+    for (int32_t retry = 0; retry < 500; ++retry) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received[1] == expected) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received[0], 1);
+    EXPECT_EQ(received[1], expected);
+    EXPECT_LT(dispatched, count + 1);
+    EventCenter::GetInstance().RegisterMerger(TEST_EVT_KEYED, nullptr);
+    EXPECT_TRUE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_KEYED));
+}
+
+/**
+* @tc.name: AsyncEventBackpressure
+* @tc.desc: a post into the full queue of a blocked async observer waits for room and then drops the event, the
+*           queued events are still dispatched in order.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, AsyncEventBackpressure, TestSize.Level2)
+{
+    constexpr uint32_t capacity = 4;
+    constexpr int32_t overflow = 2;
+    std::promise<void> started;
+    std::promise<void> release;
+    auto blocker = release.get_future().share();
+    std::mutex mutex;
+    std::vector<int32_t> values;
+    ASSERT_FALSE(EventCenter::GetInstance().Subscribe(TEST_EVT_ASYNC, [](const Event &event) {}, true, 0));
+    EventCenter::GetInstance().Subscribe(TEST_EVT_ASYNC, [&](const Event &event) {
+        auto value = static_cast<const TestAsync &>(event).value;
+        if (value == 0) {
+            started.set_value();
+            blocker.wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(value);
+    }, true, capacity);
+    EventCenter::GetInstance().PostEvent(std::make_unique<TestAsync>(0));
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    for (int32_t i = 1; i <= static_cast<int32_t>(capacity); ++i) {
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestAsync>(i));
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < overflow; ++i) {
+        EventCenter::GetInstance().PostEvent(std::make_unique<TestAsync>(capacity + 1 + i));
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, EventCenter::BUSY_WAIT * overflow);
+    release.set_value();
+    for (int32_t retry = 0; retry < 500; ++retry) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (values.size() == capacity + 1) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<int32_t> expected(capacity + 1);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values, expected);
+    EXPECT_TRUE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_ASYNC));
+}
+
+/**
+* @tc.name: UnsubscribeUnknown
+* @tc.desc: unsubscribing an event without observers reports false.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(EventCenterTest, UnsubscribeUnknown, TestSize.Level2)
+{
+    EXPECT_FALSE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_UNKNOWN));
+    EventCenter::GetInstance().Subscribe(TEST_EVT_UNKNOWN, [](const Event &event) {});
+    EXPECT_TRUE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_UNKNOWN));
+    EXPECT_FALSE(EventCenter::GetInstance().Unsubscribe(TEST_EVT_UNKNOWN));
+}
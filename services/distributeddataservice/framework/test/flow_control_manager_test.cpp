@@ -12,11 +12,17 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
+#define LOG_TAG "FlowControlManagerTest"
 #include "flow_control_manager/flow_control_manager.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cinttypes>
+
+#include "flow_control_manager/flow_control_strategy.h"
+#include "log_print.h"
+
 using namespace testing::ext;
 using namespace OHOS::DistributedData;
 namespace OHOS::Test {
@@ -1015,4 +1021,247 @@ HWTEST_F(FlowControlManagerTest, FlowControlManager_NullPoolOnInit_Test, TestSiz
     EXPECT_EQ(flag->load(), 0); // No tasks should be executed due to null pool
     flowControlManager.Remove();
 }
+
+/**
+* @tc.name: FlowControlManager_RemoveByLabel_Test
+* @tc.desc: Test removing the pending tasks of one label through the label index
+* @tc.type: FUNC
+* @tc.step: 1. Submit delayed tasks of two labels
+* @tc.step: 2. Remove the tasks of the first label
+* @tc.expected: Only the tasks of the second label execute
+*/
+HWTEST_F(FlowControlManagerTest, FlowControlManager_RemoveByLabel_Test, TestSize.Level1)
+{
+    auto pool = std::make_shared<ExecutorPool>(3, 2);
+    FlowControlManager flowControlManager(pool, std::make_shared<RemoveByTypeRangeFilterStrategy>());
+    auto removed = std::make_shared<std::atomic_uint32_t>(0);
+    auto kept = std::make_shared<std::atomic_uint32_t>(0);
+    for (int i = 0; i < 10; i++) {
+        flowControlManager.Execute([removed]() { (*removed)++; }, { 0, "removed" });
+        flowControlManager.Execute([kept]() { (*kept)++; }, { 0, "kept" });
+    }
+    flowControlManager.RemoveByLabel("removed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    EXPECT_EQ(removed->load(), 0);
+    EXPECT_EQ(kept->load(), 10);
+    flowControlManager.Remove();
+}
+
+/**
+* @tc.name: FlowControlManager_HeldSlot_Test
+* @tc.desc: Test that the held tasks keep their slot until released and the others wait for a free slot
+* @tc.type: FUNC
+* @tc.step: 1. Create a manager running at most 2 tasks and submit 5 held tasks keeping their slots
+* @tc.step: 2. Release the slots and check the waiting tasks start
+* @tc.expected: Only 2 tasks start while the slots are held, all 5 start after the slots are released
+*/
+HWTEST_F(FlowControlManagerTest, FlowControlManager_HeldSlot_Test, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::vector<RefCount> slots;
+    auto pool = std::make_shared<ExecutorPool>(5, 2);
+    FlowControlManager flowControlManager(pool, nullptr, 2);
+    for (int i = 0; i < 5; i++) {
+        flowControlManager.ExecuteHeld([&mutex, &slots](RefCount slot) {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots.push_back(std::move(slot));
+        }, { 0, "held" });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(slots.size(), 2);
+    }
+    for (int i = 0; i < 5; i++) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &slot : slots) {
+                slot = RefCount();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    flowControlManager.Remove();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(slots.size(), 5);
+    slots.clear();
+}
+
+/**
+* @tc.name: FlowControlManager_HeldSlotTimeout_Test
+* @tc.desc: Test that a slot held beyond the max hold time is released by force and only once
+* @tc.type: FUNC
+* @tc.step: 1. Create a manager running 1 task with a max hold of 500ms and submit 2 held tasks keeping their slots
+* @tc.step: 2. Check the second task starts after the first slot times out
+* @tc.step: 3. Drop the timed out slot and check a third task still waits for the second slot
+* @tc.expected: The second task starts after the deadline, the late release of the first slot frees nothing
+*/
+HWTEST_F(FlowControlManagerTest, FlowControlManager_HeldSlotTimeout_Test, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::vector<RefCount> slots;
+    auto pool = std::make_shared<ExecutorPool>(5, 2);
+    FlowControlManager flowControlManager(pool, nullptr, 1, std::chrono::milliseconds(500));
+    auto task = [&mutex, &slots](RefCount slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots.push_back(std::move(slot));
+    };
+    flowControlManager.ExecuteHeld(task, { 0, "held" });
+    flowControlManager.ExecuteHeld(task, { 0, "held" });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(slots.size(), 1);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(slots.size(), 2);
+        slots.front() = RefCount();
+    }
+    flowControlManager.ExecuteHeld(task, { 0, "held" });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    flowControlManager.Remove();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(slots.size(), 2);
+    slots.clear();
+}
+
+/**
+* @tc.name: TokenBucketStrategy_Reserve_Test
+* @tc.desc: Test that the token bucket admits the burst at once and then spaces the tasks by the rate
+* @tc.type: FUNC
+* @tc.expected: The first 3 tasks run at once, the others 100ms apart, the idle bucket refills
+*/
+HWTEST_F(FlowControlManagerTest, TokenBucketStrategy_Reserve_Test, TestSize.Level1)
+{
+    TokenBucketStrategy strategy(10, 1000, 3);
+    FlowControlStrategy::Tp now{};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now);
+    }
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now + std::chrono::milliseconds(100));
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now + std::chrono::milliseconds(200));
+    auto later = now + std::chrono::seconds(10);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, later), later);
+    }
+}
+
+/**
+* @tc.name: SlidingWindowStrategy_Reserve_Test
+* @tc.desc: Test that the sliding window runs at most limit tasks in any period and fills the gaps before the later tasks
+* @tc.type: FUNC
+* @tc.expected: The task for now runs before the tasks reserved later, the task beyond the limit waits a period
+*/
+HWTEST_F(FlowControlManagerTest, SlidingWindowStrategy_Reserve_Test, TestSize.Level1)
+{
+    SlidingWindowStrategy strategy(3, 1000);
+    FlowControlStrategy::Tp now{};
+    auto later = now + std::chrono::milliseconds(5000);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, later), later);
+    }
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now);
+    }
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now + std::chrono::milliseconds(1000));
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now + std::chrono::milliseconds(4500)),
+        now + std::chrono::milliseconds(6000));
+}
+
+/**
+* @tc.name: WeightedFairStrategy_Reserve_Test
+* @tc.desc: Test that a label runs its burst at once, is then spaced by its share and the idle label gets its burst back
+* @tc.type: FUNC
+* @tc.expected: The first 3 tasks run at once, the others 100ms apart, the idle label runs 3 tasks at once again
+*/
+HWTEST_F(FlowControlManagerTest, WeightedFairStrategy_Reserve_Test, TestSize.Level1)
+{
+    WeightedFairStrategy strategy(10, 1000, 3);
+    FlowControlStrategy::Tp now{};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now);
+    }
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now + std::chrono::milliseconds(100));
+    EXPECT_EQ(strategy.Reserve({ 0, "app" }, now), now + std::chrono::milliseconds(200));
+    auto later = now + std::chrono::seconds(10);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(strategy.Reserve({ 0, "app" }, later), later);
+    }
+}
+
+/**
+* @tc.name: PriorityClassStrategy_Reserve_Test
+* @tc.desc: Test that the background tasks yield to the reserved foreground tasks within the max delay
+* @tc.type: FUNC
+* @tc.expected: The background task runs after the foreground ones, but no later than the max delay
+*/
+HWTEST_F(FlowControlManagerTest, PriorityClassStrategy_Reserve_Test, TestSize.Level1)
+{
+    auto inner = std::make_shared<WeightedFairStrategy>(0, 0);
+    PriorityClassStrategy strategy(inner, 2, 1000);
+    FlowControlStrategy::Tp now{};
+    auto foreground = now + std::chrono::milliseconds(300);
+    EXPECT_EQ(strategy.Reserve({ 0, "fg", 0 }, foreground), foreground);
+    EXPECT_EQ(strategy.Reserve({ 0, "bg", 1 }, now), foreground);
+    EXPECT_EQ(strategy.Reserve({ 0, "bg", 5 }, now), foreground);
+    auto far = now + std::chrono::seconds(10);
+    EXPECT_EQ(strategy.Reserve({ 0, "fg", 0 }, far), far);
+    EXPECT_EQ(strategy.Reserve({ 0, "bg", 1 }, now), now + std::chrono::milliseconds(1000));
+    EXPECT_EQ(strategy.Reserve({ 0, "fg", 0 }, now), now);
+}
+
+/**
+* @tc.name: FlowControlStrategy_NoisyLabelSimulation_Test
+* @tc.desc: Replay three noisy apps and a quiet app on a simulated clock with the FIFO window and the fair window
+* @tc.type: PERF
+* @tc.step: 1. Each second every noisy app releases its limit of 5 tasks, the quiet app one task in the middle
+* @tc.step: 2. Compare the waits of the quiet app in the last rounds under both strategies and check the global limit
+* @tc.expected: Both run at most 10 tasks in any second, the fair window runs the quiet app at once after the
+*     first rounds, the FIFO window makes it wait longer and longer behind the noisy ones
+*/
+HWTEST_F(FlowControlManagerTest, FlowControlStrategy_NoisyLabelSimulation_Test, TestSize.Level1)
+{
+    constexpr uint32_t rate = 10;
+    constexpr uint32_t period = 1000;
+    constexpr uint32_t appLimit = 5;
+    constexpr int warmUp = 10;
+    constexpr int rounds = 20;
+    auto simulate = [](FlowControlStrategy &strategy, std::vector<FlowControlStrategy::Tp> &reserved) {
+        FlowControlStrategy::Tp begin{};
+        int64_t maxWait = 0;
+        for (int round = 0; round < rounds; round++) {
+            auto now = begin + std::chrono::milliseconds(round * period);
+            for (auto label : { "noisy1", "noisy2", "noisy3" }) {
+                for (uint32_t i = 0; i < appLimit; i++) {
+                    reserved.push_back(strategy.Reserve({ 0, label }, now));
+                }
+            }
+            now += std::chrono::milliseconds(period / 2);
+            reserved.push_back(strategy.Reserve({ 0, "quiet" }, now));
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(reserved.back() - now).count();
+            if (round >= warmUp) {
+                maxWait = std::max<int64_t>(maxWait, wait);
+            }
+        }
+        std::sort(reserved.begin(), reserved.end());
+        return maxWait;
+    };
+    SlidingWindowStrategy fifo(rate, period);
+    SlidingWindowStrategy fair(rate, period, std::make_shared<WeightedFairStrategy>(rate, period, appLimit));
+    std::vector<FlowControlStrategy::Tp> fifoReserved;
+    std::vector<FlowControlStrategy::Tp> fairReserved;
+    auto fifoWait = simulate(fifo, fifoReserved);
+    auto fairWait = simulate(fair, fairReserved);
+    ZLOGI("fifo: quiet max wait %{public}" PRId64 "ms; fair: quiet max wait %{public}" PRId64 "ms",
+        fifoWait, fairWait);
+    EXPECT_GT(fifoWait, static_cast<int64_t>(warmUp * period));
+    EXPECT_EQ(fairWait, 0);
+    for (auto *reserved : { &fifoReserved, &fairReserved }) {
+        for (size_t i = rate; i < reserved->size(); i++) {
+            EXPECT_GE((*reserved)[i] - (*reserved)[i - rate], std::chrono::milliseconds(period));
+        }
+    }
+}
 } // namespace OHOS::Test
\ No newline at end of file
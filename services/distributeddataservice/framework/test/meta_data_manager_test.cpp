@@ -513,4 +513,52 @@ HWTEST_F(MetaDataManagerTest, SyncWithOptionTest009, TestSize.Level1)
     EXPECT_FALSE(result);
     metaStore->syncFunc = nullptr;
 }
+
+/**
+ * @tc.name: LoadMetaSnapshotTest001
+ * @tc.desc: the second load is served from the object cache with the same snapshot.
+ * @tc.type: FUNC
+ * @tc.require:
+ * @tc.author:
+ */
+HWTEST_F(MetaDataManagerTest, LoadMetaSnapshotTest001, TestSize.Level1)
+{
+    UserMetaData userMetaData;
+    userMetaData.users.push_back(UserStatus(100, true));
+    std::string key = UserMetaRow::GetKeyFor("LoadMetaSnapshotTest001");
+    ASSERT_TRUE(MetaDataManager::GetInstance().SaveMeta(key, userMetaData, true));
+    auto first = MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, true);
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(first->users.size(), 1);
+    auto hits = MetaDataManager::GetInstance().objectHits_.load();
+    auto second = MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, true);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(MetaDataManager::GetInstance().objectHits_.load(), hits + 1);
+    EXPECT_EQ(MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, false), nullptr);
+}
+
+/**
+ * @tc.name: LoadMetaSnapshotTest002
+ * @tc.desc: save and delete drop the cached snapshot.
+ * @tc.type: FUNC
+ * @tc.require:
+ * @tc.author:
+ */
+HWTEST_F(MetaDataManagerTest, LoadMetaSnapshotTest002, TestSize.Level1)
+{
+    UserMetaData userMetaData;
+    userMetaData.users.push_back(UserStatus(100, true));
+    std::string key = UserMetaRow::GetKeyFor("LoadMetaSnapshotTest002");
+    ASSERT_TRUE(MetaDataManager::GetInstance().SaveMeta(key, userMetaData, true));
+    auto first = MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, true);
+    ASSERT_NE(first, nullptr);
+    userMetaData.users.push_back(UserStatus(101, false));
+    ASSERT_TRUE(MetaDataManager::GetInstance().SaveMeta(key, userMetaData, true));
+    auto second = MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, true);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(first->users.size(), 1);
+    EXPECT_EQ(second->users.size(), 2);
+    ASSERT_TRUE(MetaDataManager::GetInstance().DelMeta(key, true));
+    EXPECT_EQ(MetaDataManager::GetInstance().LoadMetaSnapshot<UserMetaData>(key, true), nullptr);
+}
 } // namespace OHOS::Test
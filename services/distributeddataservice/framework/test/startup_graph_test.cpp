@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "StartupGraphTest"
+#include "thread/startup_graph.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "log_print.h"
+
+using namespace testing::ext;
+using namespace OHOS::DistributedData;
+namespace OHOS::Test {
+class StartupGraphTest : public testing::Test {
+public:
+    static void SetUpTestCase(void){};
+    static void TearDownTestCase(void){};
+    void SetUp(){};
+    void TearDown(){};
+
+protected:
+    static constexpr size_t MAX_THREADS = 4;
+    static constexpr size_t MIN_THREADS = 2;
+};
+
+/**
+* @tc.name: AddStage001
+* @tc.desc: AddStage rejects a stage with an unknown dependency or a name already added.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(StartupGraphTest, AddStage001, TestSize.Level1)
+{
+    StartupGraph graph;
+    EXPECT_TRUE(graph.AddStage("first", []() {}));
+    EXPECT_FALSE(graph.AddStage("first", []() {}));
+    EXPECT_FALSE(graph.AddStage("second", []() {}, { "unknown" }));
+    EXPECT_TRUE(graph.AddStage("second", []() {}, { "first" }));
+}
+
+/**
+* @tc.name: Run001
+* @tc.desc: Run starts a stage only after all its dependencies finished.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(StartupGraphTest, Run001, TestSize.Level1)
+{
+    auto executors = std::make_shared<ExecutorPool>(MAX_THREADS, MIN_THREADS);
+    StartupGraph graph;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto stage = [&mutex, &order](const std::string &name) {
+        return [&mutex, &order, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+    graph.AddStage("a", stage("a"));
+    graph.AddStage("b", stage("b"));
+    graph.AddStage("c", stage("c"), { "a", "b" });
+    graph.AddStage("d", stage("d"), { "c" });
+    graph.AddStage("e", stage("e"), { "a" });
+    graph.Run(executors);
+    ASSERT_EQ(order.size(), 5);
+    auto position = [&order](const std::string &name) {
+        return std::find(order.begin(), order.end(), name) - order.begin();
+    };
+    EXPECT_LT(position("a"), position("c"));
+    EXPECT_LT(position("b"), position("c"));
+    EXPECT_LT(position("c"), position("d"));
+    EXPECT_LT(position("a"), position("e"));
+}
+
+/**
+* @tc.name: Run002
+* @tc.desc: Stages without dependencies between them run at the same time.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(StartupGraphTest, Run002, TestSize.Level1)
+{
+    auto executors = std::make_shared<ExecutorPool>(MAX_THREADS, MIN_THREADS);
+    StartupGraph graph;
+    std::atomic<int32_t> arrived = 0;
+    std::atomic<int32_t> met = 0;
+    // each stage waits for the other one, they only meet when running in parallel
+    auto stage = [&arrived, &met]() {
+        arrived++;
+        for (int32_t i = 0; i < 200 && arrived < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        if (arrived == 2) {
+            met++;
+        }
+    };
+    graph.AddStage("left", stage);
+    graph.AddStage("right", stage);
+    graph.Run(executors);
+    EXPECT_EQ(met, 2);
+}
+
+/**
+* @tc.name: Run003
+* @tc.desc: CALLER_THREAD stages run on the thread calling Run, all stages run without a pool.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(StartupGraphTest, Run003, TestSize.Level1)
+{
+    auto executors = std::make_shared<ExecutorPool>(MAX_THREADS, MIN_THREADS);
+    StartupGraph graph;
+    std::thread::id caller;
+    std::atomic<int32_t> count = 0;
+    graph.AddStage("pool", [&count]() { count++; });
+    graph.AddStage("caller", [&caller, &count]() {
+        caller = std::this_thread::get_id();
+        count++;
+    }, { "pool" }, StartupGraph::CALLER_THREAD);
+    graph.Run(executors);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(caller, std::this_thread::get_id());
+
+    StartupGraph serial;
+    serial.AddStage("first", [&count]() { count++; });
+    serial.AddStage("second", [&count]() { count++; }, { "first" });
+    serial.Run(nullptr);
+    EXPECT_EQ(count, 4);
+}
+
+/**
+* @tc.name: Dump001
+* @tc.desc: Dump lists the stages of the graph and the measured steps after it.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(StartupGraphTest, Dump001, TestSize.Level1)
+{
+    auto executors = std::make_shared<ExecutorPool>(MAX_THREADS, MIN_THREADS);
+    StartupGraph graph;
+    graph.AddStage("slow", []() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    graph.Run(executors);
+    graph.Measure("after", []() {});
+    auto timings = graph.GetTimings();
+    ASSERT_EQ(timings.size(), 2);
+    EXPECT_EQ(timings[0].name, "slow");
+    EXPECT_GE(timings[0].cost, 20);
+    EXPECT_EQ(timings[1].name, "after");
+    EXPECT_GE(timings[1].begin, timings[0].cost);
+    auto dump = graph.Dump();
+    ZLOGI("%{public}s", dump.c_str());
+    EXPECT_NE(dump.find("slow"), std::string::npos);
+    EXPECT_NE(dump.find("after"), std::string::npos);
+}
+} // namespace OHOS::Test
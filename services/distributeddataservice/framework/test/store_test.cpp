@@ -26,6 +26,7 @@
 #include "rdb_types.h"
 #include "screen_mock.h"
 #include "store/auto_cache.h"
+#include "store/flat_buckets.h"
 #include "store/general_store.h"
 #include "store/general_value.h"
 #include "store/general_watcher.h"
@@ -102,6 +103,49 @@ HWTEST_F(GeneralValueTest, SetQueryNodesTest, TestSize.Level2)
     EXPECT_EQ(nodes1[0].fieldValue.size(), 3);
 }
 
+/**
+ * @tc.name: FlatBucketsTest
+ * @tc.desc: convert buckets with different columns into flat rows and back.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(GeneralValueTest, FlatBucketsTest, TestSize.Level1)
+{
+    VBuckets buckets = {
+        { { "id", int64_t(1) }, { "name", std::string("a") } },
+        { { "id", int64_t(2) }, { "age", double(3) } },
+    };
+    FlatBuckets rows(std::move(buckets));
+    ASSERT_EQ(rows.Size(), 2);
+    std::vector<std::string> columns = { "age", "id", "name" };
+    EXPECT_EQ(rows.GetColumns(), columns);
+    EXPECT_EQ(rows.IndexOf("id"), 1);
+    EXPECT_EQ(rows.IndexOf("none"), FlatBuckets::INVALID_COLUMN);
+    EXPECT_TRUE(rows.IsAbsent(0, 0));
+    EXPECT_EQ(rows.Get(0, 0), nullptr);
+    ASSERT_NE(rows.Get(1, 0), nullptr);
+    EXPECT_EQ(std::get<double>(*rows.Get(1, 0)), 3);
+
+    VBucket unknown = { { "id", int64_t(3) }, { "other", true } };
+    EXPECT_FALSE(rows.Append(std::move(unknown)));
+    EXPECT_EQ(unknown.size(), 2);
+    EXPECT_EQ(std::get<int64_t>(unknown["id"]), 3);
+    EXPECT_EQ(rows.Size(), 2);
+    Values values = { double(4), int64_t(4) };
+    EXPECT_FALSE(rows.Append(std::move(values)));
+    values.emplace_back(std::string("d"));
+    EXPECT_TRUE(rows.Append(std::move(values)));
+    EXPECT_TRUE(values.empty());
+
+    auto bucket = rows.GetBucket(0);
+    EXPECT_EQ(bucket.size(), 2);
+    auto result = rows.TakeBuckets();
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[1].size(), 2);
+    EXPECT_EQ(std::get<std::string>(result[2]["name"]), "d");
+    EXPECT_TRUE(rows.Empty());
+}
+
 /**
 * @tc.name: GetMixModeTest
 * @tc.desc: get mix mode
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "StartupGraph"
+#include "thread/startup_graph.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "log_print.h"
+namespace OHOS::DistributedData {
+bool StartupGraph::AddStage(const std::string &name, Task task, const std::vector<std::string> &dependencies,
+    Affinity affinity)
+{
+    auto find = [this](const std::string &stageName) {
+        auto it = std::find_if(stages_.begin(), stages_.end(),
+            [&stageName](const Stage &stage) { return stage.name == stageName; });
+        return it == stages_.end() ? INVALID_STAGE : static_cast<size_t>(it - stages_.begin());
+    };
+    if (find(name) != INVALID_STAGE) {
+        ZLOGE("stage %{public}s exists", name.c_str());
+        return false;
+    }
+    std::vector<size_t> indexes;
+    for (const auto &dependency : dependencies) {
+        auto index = find(dependency);
+        if (index == INVALID_STAGE) {
+            ZLOGE("stage %{public}s depends on unknown stage %{public}s", name.c_str(), dependency.c_str());
+            return false;
+        }
+        indexes.push_back(index);
+    }
+    // a stage only depends on earlier stages, so the graph never has a cycle
+    for (auto index : indexes) {
+        stages_[index].dependents.push_back(stages_.size());
+    }
+    stages_.push_back({ name, std::move(task), affinity, {}, indexes.size() });
+    return true;
+}
+
+void StartupGraph::Run(std::shared_ptr<ExecutorPool> executors)
+{
+    executors_ = std::move(executors);
+    start_ = std::chrono::steady_clock::now();
+    timings_.assign(stages_.size(), {});
+    // the roots are taken before any stage runs, the pending counts change from then on
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        if (stages_[i].pending == 0) {
+            roots.push_back(i);
+        }
+    }
+    for (auto root : roots) {
+        Dispatch(root);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (finished_ < stages_.size()) {
+        cond_.wait(lock, [this]() { return !callerStages_.empty() || finished_ == stages_.size(); });
+        if (callerStages_.empty()) {
+            continue;
+        }
+        auto index = callerStages_.front();
+        callerStages_.pop_front();
+        lock.unlock();
+        Schedule(index);
+        lock.lock();
+    }
+    total_ = Since(start_);
+    executors_ = nullptr;
+    auto slowest = std::max_element(timings_.begin(), timings_.end(),
+        [](const Timing &left, const Timing &right) { return left.cost < right.cost; });
+    ZLOGI("%{public}zu stages cost %{public}" PRId64 "ms, slowest %{public}s %{public}" PRId64 "ms", stages_.size(),
+        total_, slowest == timings_.end() ? "" : slowest->name.c_str(), slowest == timings_.end() ? 0 : slowest->cost);
+}
+
+void StartupGraph::Measure(const std::string &name, const Task &task)
+{
+    auto begin = std::chrono::steady_clock::now();
+    if (task) {
+        task();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (start_ == std::chrono::steady_clock::time_point()) {
+        start_ = begin;
+    }
+    measures_.push_back({ name, std::chrono::duration_cast<std::chrono::milliseconds>(begin - start_).count(),
+        Since(begin) });
+}
+
+std::vector<StartupGraph::Timing> StartupGraph::GetTimings() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto timings = timings_;
+    timings.insert(timings.end(), measures_.begin(), measures_.end());
+    return timings;
+}
+
+std::string StartupGraph::Dump() const
+{
+    auto timings = GetTimings();
+    std::string info;
+    info.append("stages:").append(std::to_string(stages_.size()))
+        .append(" cost:").append(std::to_string(total_)).append("ms\n");
+    for (const auto &timing : timings) {
+        info.append(timing.name).append(" begin:").append(std::to_string(timing.begin))
+            .append("ms cost:").append(std::to_string(timing.cost)).append("ms\n");
+    }
+    return info;
+}
+
+// Runs the stage, then goes on with a stage it made ready, the others are handed out.
+void StartupGraph::Schedule(size_t index)
+{
+    while (index != INVALID_STAGE) {
+        auto begin = std::chrono::steady_clock::now();
+        if (stages_[index].task) {
+            stages_[index].task();
+        }
+        timings_[index] = { stages_[index].name,
+            std::chrono::duration_cast<std::chrono::milliseconds>(begin - start_).count(), Since(begin) };
+        std::vector<size_t> ready;
+        Finish(index, ready);
+        index = INVALID_STAGE;
+        for (auto next : ready) {
+            if (index == INVALID_STAGE && stages_[next].affinity == ANY_THREAD) {
+                index = next;
+                continue;
+            }
+            Dispatch(next);
+        }
+    }
+}
+
+void StartupGraph::Dispatch(size_t index)
+{
+    if (stages_[index].affinity == ANY_THREAD && executors_ != nullptr &&
+        executors_->Execute([this, index]() { Schedule(index); }) != ExecutorPool::INVALID_TASK_ID) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    callerStages_.push_back(index);
+    cond_.notify_all();
+}
+
+void StartupGraph::Finish(size_t index, std::vector<size_t> &ready)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto dependent : stages_[index].dependents) {
+        if (--stages_[dependent].pending == 0) {
+            ready.push_back(dependent);
+        }
+    }
+    if (++finished_ == stages_.size()) {
+        cond_.notify_all();
+    }
+}
+
+int64_t StartupGraph::Since(std::chrono::steady_clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time).count();
+}
+} // namespace OHOS::DistributedData
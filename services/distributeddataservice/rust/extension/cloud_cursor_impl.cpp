@@ -36,24 +36,21 @@ static std::set<std::string> EXTEND_KEYS = {
 
 CloudCursorImpl::CloudCursorImpl(OhCloudExtCloudDbData *cloudData) : cloudData_(cloudData)
 {
-    OhCloudExtCloudDbDataGetValues(cloudData_, &values_);
-    if (values_ == nullptr) {
+    unsigned int valuesLen = 0;
+    if (OhCloudExtCloudDbDataGetValuesLen(cloudData_, &valuesLen) != ERRNO_SUCCESS) {
         return;
     }
-    OhCloudExtVectorGetLength(values_, reinterpret_cast<unsigned int *>(&valuesLen_));
-    if (valuesLen_ > 0) {
-        void *values = nullptr;
-        size_t valueLen = 0;
-        auto status = OhCloudExtVectorGet(values_, 0, &values, reinterpret_cast<unsigned int *>(&valueLen));
-        if (status == ERRNO_SUCCESS && values != nullptr) {
-            OhCloudExtValueBucket *vBucket = reinterpret_cast<OhCloudExtValueBucket *>(values);
-            auto data = GetData(vBucket);
-            for (auto &[key, value] : data) {
-                names_.push_back(key);
+    closed_ = false;
+    valuesLen_ = valuesLen;
+    index_ = 0;
+    if (valuesLen_ > 0 && LoadBatch()) {
+        for (auto col : dataColumns_) {
+            if (GetValue(col).index() != TYPE_INDEX<std::monostate>) {
+                names_.push_back(columns_[col]);
             }
-            OhCloudExtValueBucketFree(vBucket);
         }
     }
+    index_ = INVALID_INDEX;
     bool hasMore = false;
     OhCloudExtCloudDbDataGetHasMore(cloudData_, &hasMore);
     finished_ = !hasMore;
@@ -68,19 +65,16 @@ CloudCursorImpl::CloudCursorImpl(OhCloudExtCloudDbData *cloudData) : cloudData_(
 
 CloudCursorImpl::~CloudCursorImpl()
 {
+    FreeBatch();
     if (cloudData_ != nullptr) {
         OhCloudExtCloudDbDataFree(cloudData_);
         cloudData_ = nullptr;
     }
-    if (values_ != nullptr) {
-        OhCloudExtVectorFree(values_);
-        values_ = nullptr;
-    }
 }
 
 int32_t CloudCursorImpl::GetColumnNames(std::vector<std::string> &names) const
 {
-    if (values_ == nullptr) {
+    if (closed_) {
         return DBErr::E_ALREADY_CLOSED;
     }
     names = names_;
@@ -108,7 +102,7 @@ int32_t CloudCursorImpl::GetCount() const
 
 int32_t CloudCursorImpl::MoveToFirst()
 {
-    if (values_ == nullptr) {
+    if (closed_) {
         return DBErr::E_ALREADY_CLOSED;
     }
     if (index_ != INVALID_INDEX || valuesLen_ == 0) {
@@ -121,7 +115,7 @@ int32_t CloudCursorImpl::MoveToFirst()
 
 int32_t CloudCursorImpl::MoveToNext()
 {
-    if (values_ == nullptr) {
+    if (closed_) {
         return DBErr::E_ALREADY_CLOSED;
     }
     if (index_ >= valuesLen_) {
@@ -149,85 +143,140 @@ int32_t CloudCursorImpl::GetEntry(DBVBucket &entry)
     if (consumed_ || index_ >= valuesLen_) {
         return DBErr::E_ALREADY_CONSUMED;
     }
-    void *values = nullptr;
-    size_t valueLen = 0;
-    auto status = OhCloudExtVectorGet(values_, index_, &values, reinterpret_cast<unsigned int *>(&valueLen));
-    if (status != ERRNO_SUCCESS || values == nullptr) {
+    if (!LoadBatch()) {
         return DBErr::E_ERROR;
     }
-    OhCloudExtValueBucket *vBucket = reinterpret_cast<OhCloudExtValueBucket *>(values);
-    auto data = GetData(vBucket);
-    for (auto &[key, value] : data) {
-        entry[key] = value;
+    for (auto col : dataColumns_) {
+        auto value = GetValue(col);
+        if (value.index() == TYPE_INDEX<std::monostate>) {
+            continue;
+        }
+        entry[columns_[col]] = std::move(value);
     }
-    entry[DBSchemaMeta::DELETE_FIELD] = GetExtend(vBucket, OPERATION_KEY);
-    entry[DBSchemaMeta::GID_FIELD] = GetExtend(vBucket, GID_KEY);
-    entry[DBSchemaMeta::CREATE_FIELD] = GetExtend(vBucket, CREATE_TIME_KEY);
-    entry[DBSchemaMeta::MODIFY_FIELD] = GetExtend(vBucket, MODIFY_TIME_KEY);
+    entry[DBSchemaMeta::DELETE_FIELD] = GetExtend(OPERATION_KEY);
+    entry[DBSchemaMeta::GID_FIELD] = GetExtend(GID_KEY);
+    entry[DBSchemaMeta::CREATE_FIELD] = GetExtend(CREATE_TIME_KEY);
+    entry[DBSchemaMeta::MODIFY_FIELD] = GetExtend(MODIFY_TIME_KEY);
     entry[DBSchemaMeta::CURSOR_FIELD] = cursor_;
     consumed_ = true;
-    OhCloudExtValueBucketFree(vBucket);
     return DBErr::E_OK;
 }
 
-std::vector<std::pair<std::string, DBValue>> CloudCursorImpl::GetData(OhCloudExtValueBucket *vb)
+// Keeps the page holding the current row, the rows are read forward so every page is converted once.
+bool CloudCursorImpl::LoadBatch()
 {
-    std::vector<std::pair<std::string, DBValue>> result {};
-    OhCloudExtVector *keys = nullptr;
-    size_t keysLen = 0;
-    auto status = OhCloudExtValueBucketGetKeys(vb, &keys, reinterpret_cast<unsigned int *>(&keysLen));
-    if (status != ERRNO_SUCCESS || keys == nullptr) {
-        return result;
+    if (batch_ != nullptr && index_ >= batchStart_ && index_ - batchStart_ < view_.rows) {
+        return true;
     }
-    auto pKeys = std::shared_ptr<OhCloudExtVector>(keys, [](auto *keys) { OhCloudExtVectorFree(keys); });
-    for (size_t i = 0; i < keysLen; i++) {
-        void *value = nullptr;
-        size_t valueLen = 0;
-        auto status = OhCloudExtVectorGet(pKeys.get(), i, &value, reinterpret_cast<unsigned int *>(&valueLen));
-        if (status != ERRNO_SUCCESS && value == nullptr) {
-            return result;
-        }
-        char *str = reinterpret_cast<char *>(value);
-        auto key = std::string(str, valueLen);
-        if (EXTEND_KEYS.find(key) != EXTEND_KEYS.end()) {
-            continue;
-        }
-        auto dBValue = ExtensionUtil::ConvertValues(vb, key);
-        if (dBValue.index() == TYPE_INDEX<std::monostate>) {
-            continue;
+    FreeBatch();
+    auto status = OhCloudExtCloudDbDataGetBatch(cloudData_, static_cast<unsigned int>(index_), BATCH_ROWS, &batch_);
+    if (status != ERRNO_SUCCESS || batch_ == nullptr) {
+        ZLOGE("get batch failed, status:%{public}d, index:%{public}zu", status, index_);
+        batch_ = nullptr;
+        return false;
+    }
+    status = OhCloudExtRowBatchGetView(batch_, &view_);
+    if (status != ERRNO_SUCCESS || view_.rows == 0) {
+        ZLOGE("get view failed, status:%{public}d, rows:%{public}u", status, view_.rows);
+        FreeBatch();
+        return false;
+    }
+    batchStart_ = index_;
+    columns_.reserve(view_.columns);
+    for (size_t col = 0; col < view_.columns; col++) {
+        auto &name = view_.names[col];
+        columns_.emplace_back(reinterpret_cast<const char *>(view_.arena + name.offset), name.len);
+        if (EXTEND_KEYS.find(columns_.back()) != EXTEND_KEYS.end()) {
+            extends_[columns_.back()] = col;
+        } else {
+            dataColumns_.push_back(col);
         }
-        std::pair<std::string, DBValue> data { std::move(key),  std::move(dBValue) };
-        result.push_back(std::move(data));
+    }
+    return true;
+}
+
+void CloudCursorImpl::FreeBatch()
+{
+    if (batch_ != nullptr) {
+        OhCloudExtRowBatchFree(batch_);
+        batch_ = nullptr;
+    }
+    view_ = {};
+    batchStart_ = 0;
+    columns_.clear();
+    dataColumns_.clear();
+    extends_.clear();
+}
+
+DBValue CloudCursorImpl::GetValue(size_t col) const
+{
+    DBValue result;
+    auto &cell = view_.cells[col * view_.rows + (index_ - batchStart_)];
+    auto content = view_.arena + cell.number;
+    switch (cell.typ) {
+        case OhCloudExtValueType::VALUEINNERTYPE_INT:
+            result = static_cast<int64_t>(cell.number);
+            break;
+        case OhCloudExtValueType::VALUEINNERTYPE_BOOL:
+            result = cell.number != 0;
+            break;
+        case OhCloudExtValueType::VALUEINNERTYPE_STRING:
+            result = std::string(reinterpret_cast<const char *>(content), cell.len);
+            break;
+        case OhCloudExtValueType::VALUEINNERTYPE_BYTES:
+            result = std::vector<uint8_t>(content, content + cell.len);
+            break;
+        case OhCloudExtValueType::VALUEINNERTYPE_ASSET:
+        case OhCloudExtValueType::VALUEINNERTYPE_ASSETS:
+            result = GetAsset(cell);
+            break;
+        default:
+            // floats are left out as ExtensionUtil::ConvertValues does
+            break;
     }
     return result;
 }
 
-DBValue CloudCursorImpl::GetExtend(OhCloudExtValueBucket *vb, const std::string &col)
+DBValue CloudCursorImpl::GetAsset(const OhCloudExtBatchCell &cell) const
 {
     DBValue result;
-    int32_t status = ERRNO_SUCCESS;
-    auto keyStr = reinterpret_cast<const unsigned char *>(col.c_str());
-    OhCloudExtKeyName keyName = OhCloudExtKeyNameNew(keyStr, col.size());
     OhCloudExtValueType type = OhCloudExtValueType::VALUEINNERTYPE_EMPTY;
     void *content = nullptr;
-    size_t ctLen = 0;
-    status = OhCloudExtValueBucketGetValue(vb, keyName, &type, &content, reinterpret_cast<unsigned int *>(&ctLen));
+    unsigned int ctLen = 0;
+    auto status = OhCloudExtRowBatchGetAsset(batch_, static_cast<unsigned int>(cell.number), &type, &content, &ctLen);
     if (status != ERRNO_SUCCESS || content == nullptr) {
         return result;
     }
-    if (col == OPERATION_KEY) {
-        auto flag = *reinterpret_cast<int *>(content);
-        result = (flag == DELETE) ? true : false;
-    } else if (col == GID_KEY) {
-        result = std::string(reinterpret_cast<char *>(content), ctLen);
-    } else if (col == CREATE_TIME_KEY) {
-        std::string createTime = std::string(reinterpret_cast<char *>(content), ctLen);
-        int64_t create = strtoll(createTime.c_str(), nullptr, 10);
-        result = create;
-    } else if (col == MODIFY_TIME_KEY) {
-        std::string modifyTime = std::string(reinterpret_cast<char *>(content), ctLen);
-        int64_t modify = strtoll(modifyTime.c_str(), nullptr, 10);
-        result = modify;
+    if (type == OhCloudExtValueType::VALUEINNERTYPE_ASSET) {
+        auto asset = reinterpret_cast<OhCloudExtCloudAsset *>(content);
+        result = ExtensionUtil::ConvertAsset(asset);
+        OhCloudExtCloudAssetFree(asset);
+    } else {
+        auto assets = reinterpret_cast<OhCloudExtVector *>(content);
+        result = ExtensionUtil::ConvertAssets(assets);
+        OhCloudExtVectorFree(assets);
+    }
+    return result;
+}
+
+DBValue CloudCursorImpl::GetExtend(const std::string &col) const
+{
+    DBValue result;
+    auto it = extends_.find(col);
+    if (it == extends_.end()) {
+        return result;
+    }
+    auto &cell = view_.cells[it->second * view_.rows + (index_ - batchStart_)];
+    auto isInt = cell.typ == OhCloudExtValueType::VALUEINNERTYPE_INT;
+    auto isString = cell.typ == OhCloudExtValueType::VALUEINNERTYPE_STRING;
+    std::string text = isString ? std::string(reinterpret_cast<const char *>(view_.arena + cell.number), cell.len) : "";
+    if (col == OPERATION_KEY && isInt) {
+        result = (cell.number == DELETE) ? true : false;
+    } else if (col == GID_KEY && isString) {
+        result = std::move(text);
+    } else if ((col == CREATE_TIME_KEY || col == MODIFY_TIME_KEY) && (isInt || isString)) {
+        int64_t time = isInt ? cell.number : strtoll(text.c_str(), nullptr, 10);
+        result = time;
     }
     return result;
 }
@@ -260,41 +309,37 @@ int32_t CloudCursorImpl::Get(const std::string &col, DBValue &value)
     if (consumed_ || index_ >= valuesLen_) {
         return DBErr::E_ALREADY_CONSUMED;
     }
-
-    void *data = nullptr;
-    size_t valueLen = 0;
-    auto status = OhCloudExtVectorGet(values_, index_, &data, reinterpret_cast<unsigned int *>(&valueLen));
-    if (status != ERRNO_SUCCESS || data == nullptr) {
+    if (!LoadBatch()) {
         return DBErr::E_ERROR;
     }
-    OhCloudExtValueBucket *vBucket = reinterpret_cast<OhCloudExtValueBucket *>(data);
     auto it = std::find(names_.begin(), names_.end(), col);
     if (it == names_.end()) {
-        value = GetExtend(vBucket, EXTEND_TO_KEYS[col]);
-        OhCloudExtValueBucketFree(vBucket);
+        auto extend = EXTEND_TO_KEYS.find(col);
+        value = extend == EXTEND_TO_KEYS.end() ? DBValue() : GetExtend(extend->second);
         return DBErr::E_OK;
     }
-    auto pair = GetData(vBucket);
-    OhCloudExtValueBucketFree(vBucket);
-    for (auto &[first, second] : pair) {
-        if (first == col) {
-            value = second;
-            return DBErr::E_OK;
+    for (auto index : dataColumns_) {
+        if (columns_[index] != col) {
+            continue;
+        }
+        auto data = GetValue(index);
+        if (data.index() == TYPE_INDEX<std::monostate>) {
+            break;
         }
+        value = std::move(data);
+        return DBErr::E_OK;
     }
     return DBErr::E_INVALID_ARGS;
 }
 
 int32_t CloudCursorImpl::Close()
 {
+    FreeBatch();
     if (cloudData_ != nullptr) {
         OhCloudExtCloudDbDataFree(cloudData_);
         cloudData_ = nullptr;
     }
-    if (values_ != nullptr) {
-        OhCloudExtVectorFree(values_);
-        values_ = nullptr;
-    }
+    closed_ = true;
     index_ = INVALID_INDEX;
     return DBErr::E_OK;
 }
@@ -16,6 +16,7 @@
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_EXTENSION_CLOUD_CURSOR_IMPL_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_EXTENSION_CLOUD_CURSOR_IMPL_H
 
+#include <map>
 #include <set>
 #include "basic_rust_types.h"
 #include "cloud_ext_types.h"
@@ -52,6 +53,8 @@ private:
         DELETE = 2
     };
     static const size_t INVALID_INDEX = SIZE_MAX;
+    // rows converted by one call across the ffi
+    static constexpr uint32_t BATCH_ROWS = 512;
     static constexpr const char *OPERATION_KEY = "operation";
     static constexpr const char *GID_KEY = "id";
     static constexpr const char *CREATE_TIME_KEY = "createTime";
@@ -59,11 +62,21 @@ private:
     template<class T>
     inline static constexpr auto TYPE_INDEX = DistributedData::TYPE_INDEX<T>;
 
-    std::vector<std::pair<std::string, DBValue>> GetData(OhCloudExtValueBucket *vb);
-    DBValue GetExtend(OhCloudExtValueBucket *vb, const std::string &col);
+    bool LoadBatch();
+    void FreeBatch();
+    DBValue GetValue(size_t col) const;
+    DBValue GetAsset(const OhCloudExtBatchCell &cell) const;
+    DBValue GetExtend(const std::string &col) const;
     OhCloudExtCloudDbData *cloudData_ = nullptr;
-    OhCloudExtVector *values_ = nullptr;
+    bool closed_ = true;
     size_t valuesLen_ = 0;
+    OhCloudExtRowBatch *batch_ = nullptr;
+    OhCloudExtRowBatchView view_ {};
+    size_t batchStart_ = 0;
+    // the names of the batch columns, the extend ones are only in extends_
+    std::vector<std::string> columns_;
+    std::vector<size_t> dataColumns_;
+    std::map<std::string, size_t> extends_;
     bool finished_ = true;
     std::string cursor_;
     size_t index_ = INVALID_INDEX;
@@ -0,0 +1,256 @@
+/*
+* Copyright (c) 2026 Huawei Device Co., Ltd.
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#define LOG_TAG "CloudCursorImplTest"
+#include "cloud_cursor_impl.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include "extension_util.h"
+#include "log_print.h"
+
+using namespace testing::ext;
+using namespace OHOS::CloudData;
+
+namespace OHOS::Test {
+class CloudCursorImplTest : public testing::Test {
+public:
+    static constexpr size_t PAGE_ROWS = 512;
+    static constexpr int64_t DELETE_FLAG = 2;
+    static constexpr const char *NEXT_CURSOR = "next_cursor";
+    static std::shared_ptr<CloudCursorImpl> CreateCursor(DBVBuckets &&rows, bool hasMore = false);
+    static DBVBucket CreateRow(size_t row);
+};
+
+// The cursor frees the CloudDbData it is created on.
+std::shared_ptr<CloudCursorImpl> CloudCursorImplTest::CreateCursor(DBVBuckets &&rows, bool hasMore)
+{
+    auto [values, len] = ExtensionUtil::Convert(std::move(rows));
+    if (values == nullptr) {
+        return nullptr;
+    }
+    auto cloudData = OhCloudExtCloudDbDataNew(reinterpret_cast<const unsigned char *>(NEXT_CURSOR),
+        strlen(NEXT_CURSOR), hasMore, values);
+    if (cloudData == nullptr) {
+        return nullptr;
+    }
+    return std::make_shared<CloudCursorImpl>(cloudData);
+}
+
+// The create time comes as an INT, the modify time as a STRING, as the cloud sends both.
+DBVBucket CloudCursorImplTest::CreateRow(size_t row)
+{
+    DBVBucket bucket;
+    bucket["id"] = "gid_" + std::to_string(row);
+    bucket["operation"] = static_cast<int64_t>(row % 3 == 0 ? DELETE_FLAG : 0);
+    bucket["createTime"] = static_cast<int64_t>(row);
+    bucket["modifyTime"] = std::to_string(row * 10);
+    bucket["name"] = "name_" + std::to_string(row);
+    bucket["age"] = static_cast<int64_t>(row);
+    bucket["valid"] = row % 2 == 0;
+    bucket["photo"] = std::vector<uint8_t>(4, static_cast<uint8_t>(row));
+    return bucket;
+}
+
+/**
+* @tc.name: GetEntry001
+* @tc.desc: Check every row is read through the pages, across the page boundaries.
+* @tc.type: FUNC
+*/
+HWTEST_F(CloudCursorImplTest, GetEntry001, TestSize.Level1)
+{
+    size_t rows = PAGE_ROWS * 2 + 3;
+    DBVBuckets buckets;
+    for (size_t row = 0; row < rows; ++row) {
+        buckets.push_back(CreateRow(row));
+    }
+    auto cursor = CreateCursor(std::move(buckets), true);
+    ASSERT_NE(cursor, nullptr);
+    EXPECT_EQ(cursor->GetCount(), static_cast<int32_t>(rows));
+    EXPECT_FALSE(cursor->IsEnd());
+    std::vector<std::string> names;
+    EXPECT_EQ(cursor->GetColumnNames(names), DBErr::E_OK);
+    EXPECT_EQ(names, std::vector<std::string>({ "age", "name", "photo", "valid" }));
+
+    size_t count = 0;
+    for (auto status = cursor->MoveToFirst(); status == DBErr::E_OK && count < rows; status = cursor->MoveToNext()) {
+        DBValue age;
+        ASSERT_EQ(cursor->Get("age", age), DBErr::E_OK);
+        EXPECT_EQ(std::get<int64_t>(age), static_cast<int64_t>(count));
+        DBVBucket entry;
+        ASSERT_EQ(cursor->GetEntry(entry), DBErr::E_OK);
+        EXPECT_EQ(std::get<std::string>(entry["name"]), "name_" + std::to_string(count));
+        EXPECT_EQ(std::get<bool>(entry["valid"]), count % 2 == 0);
+        EXPECT_EQ(std::get<std::vector<uint8_t>>(entry["photo"]),
+            std::vector<uint8_t>(4, static_cast<uint8_t>(count)));
+        EXPECT_EQ(std::get<bool>(entry[DBSchemaMeta::DELETE_FIELD]), count % 3 == 0);
+        EXPECT_EQ(std::get<std::string>(entry[DBSchemaMeta::GID_FIELD]), "gid_" + std::to_string(count));
+        EXPECT_EQ(std::get<std::string>(entry[DBSchemaMeta::CURSOR_FIELD]), NEXT_CURSOR);
+        EXPECT_EQ(cursor->GetEntry(entry), DBErr::E_ALREADY_CONSUMED);
+        count++;
+    }
+    EXPECT_EQ(count, rows);
+    EXPECT_EQ(cursor->MoveToNext(), DBErr::E_ALREADY_CONSUMED);
+    EXPECT_EQ(cursor->Close(), DBErr::E_OK);
+    EXPECT_EQ(cursor->GetColumnNames(names), DBErr::E_ALREADY_CLOSED);
+}
+
+/**
+* @tc.name: GetEntry002
+* @tc.desc: Check the pages with different columns, and the rows missing a column of their page.
+* @tc.type: FUNC
+*/
+HWTEST_F(CloudCursorImplTest, GetEntry002, TestSize.Level1)
+{
+    size_t rows = PAGE_ROWS + 2;
+    DBVBuckets buckets;
+    for (size_t row = 0; row < rows; ++row) {
+        DBVBucket bucket;
+        bucket["id"] = "gid_" + std::to_string(row);
+        if (row < PAGE_ROWS) {
+            bucket["name"] = "name_" + std::to_string(row);
+        } else {
+            bucket["title"] = "title_" + std::to_string(row);
+        }
+        if (row % 2 == 0) {
+            bucket["age"] = static_cast<int64_t>(row);
+        }
+        buckets.push_back(std::move(bucket));
+    }
+    auto cursor = CreateCursor(std::move(buckets));
+    ASSERT_NE(cursor, nullptr);
+    EXPECT_TRUE(cursor->IsEnd());
+    std::vector<std::string> names;
+    EXPECT_EQ(cursor->GetColumnNames(names), DBErr::E_OK);
+    EXPECT_EQ(names, std::vector<std::string>({ "age", "name" }));
+
+    size_t count = 0;
+    for (auto status = cursor->MoveToFirst(); status == DBErr::E_OK && count < rows; status = cursor->MoveToNext()) {
+        DBValue age;
+        EXPECT_EQ(cursor->Get("age", age), count % 2 == 0 ? DBErr::E_OK : DBErr::E_INVALID_ARGS);
+        DBVBucket entry;
+        ASSERT_EQ(cursor->GetEntry(entry), DBErr::E_OK);
+        EXPECT_EQ(entry.count("age") == 1, count % 2 == 0);
+        EXPECT_EQ(entry.count("name") == 1, count < PAGE_ROWS);
+        EXPECT_EQ(entry.count("title") == 1, count >= PAGE_ROWS);
+        EXPECT_EQ(std::get<std::string>(entry[DBSchemaMeta::GID_FIELD]), "gid_" + std::to_string(count));
+        // the rows without operation or times leave the extend fields empty
+        EXPECT_EQ(entry[DBSchemaMeta::DELETE_FIELD].index(), DistributedData::TYPE_INDEX<std::monostate>);
+        EXPECT_EQ(entry[DBSchemaMeta::CREATE_FIELD].index(), DistributedData::TYPE_INDEX<std::monostate>);
+        count++;
+    }
+    EXPECT_EQ(count, rows);
+}
+
+/**
+* @tc.name: GetExtend001
+* @tc.desc: Check the times given as INT or STRING are both read as int64.
+* @tc.type: FUNC
+*/
+HWTEST_F(CloudCursorImplTest, GetExtend001, TestSize.Level1)
+{
+    int64_t time = 1750000000000;
+    DBVBuckets buckets;
+    for (size_t row = 0; row < PAGE_ROWS + 1; ++row) {
+        DBVBucket bucket;
+        bucket["id"] = "gid_" + std::to_string(row);
+        bucket["operation"] = static_cast<int64_t>(row == PAGE_ROWS ? DELETE_FLAG : 0);
+        // the first page has INT times, the second one STRING times
+        if (row < PAGE_ROWS) {
+            bucket["createTime"] = time + static_cast<int64_t>(row);
+            bucket["modifyTime"] = time;
+        } else {
+            bucket["createTime"] = std::to_string(time + static_cast<int64_t>(row));
+            bucket["modifyTime"] = std::to_string(time);
+        }
+        buckets.push_back(std::move(bucket));
+    }
+    auto cursor = CreateCursor(std::move(buckets));
+    ASSERT_NE(cursor, nullptr);
+    ASSERT_EQ(cursor->MoveToFirst(), DBErr::E_OK);
+    for (size_t row = 0; row < PAGE_ROWS + 1; ++row) {
+        DBValue createTime;
+        ASSERT_EQ(cursor->Get(DBSchemaMeta::CREATE_FIELD, createTime), DBErr::E_OK);
+        EXPECT_EQ(std::get<int64_t>(createTime), time + static_cast<int64_t>(row));
+        DBValue modifyTime;
+        ASSERT_EQ(cursor->Get(DBSchemaMeta::MODIFY_FIELD, modifyTime), DBErr::E_OK);
+        EXPECT_EQ(std::get<int64_t>(modifyTime), time);
+        DBValue deleted;
+        ASSERT_EQ(cursor->Get(DBSchemaMeta::DELETE_FIELD, deleted), DBErr::E_OK);
+        EXPECT_EQ(std::get<bool>(deleted), row == PAGE_ROWS);
+        cursor->MoveToNext();
+    }
+}
+
+/**
+* @tc.name: ReadCost001
+* @tc.desc: Compare the cost of reading the rows by the value buckets, a call for every key, and by the cursor.
+* @tc.type: PERF
+*/
+HWTEST_F(CloudCursorImplTest, ReadCost001, TestSize.Level3)
+{
+    size_t rows = 20000;
+    DBVBuckets buckets;
+    for (size_t row = 0; row < rows; ++row) {
+        buckets.push_back(CreateRow(row));
+    }
+    auto [vector, len] = ExtensionUtil::Convert(DBVBuckets(buckets));
+    ASSERT_NE(vector, nullptr);
+    auto cloudData = OhCloudExtCloudDbDataNew(nullptr, 0, false, vector);
+    ASSERT_NE(cloudData, nullptr);
+    auto cursor = CreateCursor(std::move(buckets));
+    ASSERT_NE(cursor, nullptr);
+
+    auto begin = std::chrono::steady_clock::now();
+    OhCloudExtVector *values = nullptr;
+    ASSERT_EQ(OhCloudExtCloudDbDataGetValues(cloudData, &values), ERRNO_SUCCESS);
+    size_t bucketValues = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        void *value = nullptr;
+        unsigned int valueLen = 0;
+        ASSERT_EQ(OhCloudExtVectorGet(values, row, &value, &valueLen), ERRNO_SUCCESS);
+        auto bucket = reinterpret_cast<OhCloudExtValueBucket *>(value);
+        OhCloudExtVector *keys = nullptr;
+        unsigned int keysLen = 0;
+        ASSERT_EQ(OhCloudExtValueBucketGetKeys(bucket, &keys, &keysLen), ERRNO_SUCCESS);
+        for (unsigned int i = 0; i < keysLen; ++i) {
+            void *key = nullptr;
+            unsigned int keyLen = 0;
+            OhCloudExtVectorGet(keys, i, &key, &keyLen);
+            auto data = ExtensionUtil::ConvertValues(bucket, std::string(reinterpret_cast<char *>(key), keyLen));
+            bucketValues += data.index() == DistributedData::TYPE_INDEX<std::monostate> ? 0 : 1;
+        }
+        OhCloudExtVectorFree(keys);
+        OhCloudExtValueBucketFree(bucket);
+    }
+    OhCloudExtVectorFree(values);
+    OhCloudExtCloudDbDataFree(cloudData);
+    auto bucketCost = std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    size_t cursorValues = 0;
+    for (auto status = cursor->MoveToFirst(); status == DBErr::E_OK; status = cursor->MoveToNext()) {
+        DBVBucket entry;
+        if (cursor->GetEntry(entry) != DBErr::E_OK) {
+            break;
+        }
+        // the cursor adds the cursor field to every row
+        cursorValues += entry.size() - 1;
+    }
+    auto cursorCost = std::chrono::steady_clock::now() - begin;
+    EXPECT_EQ(bucketValues, cursorValues);
+    ZLOGI("%{public}zu rows, value buckets:%{public}lldms, cursor:%{public}lldms", rows,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(bucketCost).count()),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(cursorCost).count()));
+}
+} // namespace OHOS::Test
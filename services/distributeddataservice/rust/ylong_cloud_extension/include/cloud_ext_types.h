@@ -570,6 +570,14 @@ typedef struct {
     const size_t id;
 } OhCloudExtCloudDbData;
 
+/**
+ * @brief       Create a CloudDbData instance.
+ * @param       values  [IN] Vec<HashMap<String, Value>>
+ * @attention   The values don't need to be freed again, their management is transferred to the CloudDbData.
+ */
+OhCloudExtCloudDbData *OhCloudExtCloudDbDataNew(const unsigned char *cursor, unsigned int cursorLen, bool hasMore,
+                                                OhCloudExtVector *values);
+
 /**
  * @brief       Get the next cursor from a CloudDbData pointer.
  */
@@ -592,6 +600,84 @@ int OhCloudExtCloudDbDataGetValues(const OhCloudExtCloudDbData *data, OhCloudExt
  */
 void OhCloudExtCloudDbDataFree(OhCloudExtCloudDbData *ptr);
 
+/**
+ * @brief       Get the number of value buckets of a CloudDbData pointer.
+ */
+int OhCloudExtCloudDbDataGetValuesLen(const OhCloudExtCloudDbData *data, unsigned int *len);
+
+/**
+ * @brief       Type declaration of Rust cloud extension struct RowBatch, a page of value buckets of a CloudDbData
+ *              in column major order. The columns are sorted by name.
+ * @attention   The memory is managed by Rust. Therefore, to prevent memory leaks, users should call
+ *              `OhCloudExtRowBatchFree` to release the memory occupied
+ */
+typedef struct {
+    const size_t id;
+} OhCloudExtRowBatch;
+
+/**
+ * @brief       Name of a RowBatch column, kept in the arena of the batch.
+ */
+typedef struct {
+    unsigned long long offset;
+    unsigned int len;
+} OhCloudExtBatchName;
+
+/**
+ * @brief       Cell of a RowBatch. A column missing in a row is a VALUEINNERTYPE_EMPTY cell.
+ * @param       number  The value of INT and BOOL cells, the arena offset of STRING and BYTES cells, and the index
+ *                      to pass to OhCloudExtRowBatchGetAsset of ASSET and ASSETS cells.
+ *              real    The value of FLOAT cells.
+ */
+typedef struct {
+    OhCloudExtValueType typ;
+    unsigned int len;
+    long long number;
+    double real;
+} OhCloudExtBatchCell;
+
+/**
+ * @brief       Layout of a RowBatch, the cell of the column `col` in the row `row` is `cells[col * rows + row]`.
+ * @attention   The pointers are valid until the RowBatch is freed.
+ */
+typedef struct {
+    unsigned int rows;
+    unsigned int columns;
+    const OhCloudExtBatchName *names;
+    const OhCloudExtBatchCell *cells;
+    const unsigned char *arena;
+    unsigned long long arenaLen;
+} OhCloudExtRowBatchView;
+
+/**
+ * @brief       Get at most `count` value buckets from index `start` of a CloudDbData pointer as a RowBatch.
+ * @param       batch   [OUT]
+ * @attention   The RowBatch returned should be freed by OhCloudExtRowBatchFree.
+ */
+int OhCloudExtCloudDbDataGetBatch(const OhCloudExtCloudDbData *data, unsigned int start, unsigned int count,
+                                  OhCloudExtRowBatch **batch);
+
+/**
+ * @brief       Get the layout of a RowBatch pointer.
+ */
+int OhCloudExtRowBatchGetView(OhCloudExtRowBatch *batch, OhCloudExtRowBatchView *view);
+
+/**
+ * @brief       Get the asset of an ASSET or ASSETS cell of a RowBatch pointer.
+ * @param       index       [IN] The number of the cell.
+ *              typ         [OUT]
+ *              content     [OUT] OhCloudExtCloudAsset or OhCloudExtVector of assets.
+ *              contentLen  [OUT]
+ * @attention   The pointer returned should be freed by OhCloudExtCloudAssetFree or OhCloudExtVectorFree.
+ */
+int OhCloudExtRowBatchGetAsset(OhCloudExtRowBatch *batch, unsigned int index, OhCloudExtValueType *typ,
+                               void **content, unsigned int *contentLen);
+
+/**
+ * @brief       Free a RowBatch pointer.
+ */
+void OhCloudExtRowBatchFree(OhCloudExtRowBatch *batch);
+
 /**
  * @brief       Type declaration of Rust cloud extension struct KeyName.
  */
@@ -17,7 +17,7 @@ use crate::c_adapter::basic_rust_types::{HashMapCffi, VectorCffi};
 use crate::c_adapter::*;
 use crate::ipc_conn;
 use crate::service_impl::{asset_loader, cloud_db, cloud_service, types};
-use std::collections::HashMap;
+use std::collections::{BTreeSet, HashMap};
 use std::ffi::{c_int, c_longlong, c_uchar, c_uint, c_ulonglong, c_void};
 use std::ptr::{null, null_mut, slice_from_raw_parts};
 
@@ -82,6 +82,8 @@ pub type OhCloudExtRelationSet = SafeCffiWrapper<cloud_service::RelationSet>;
 pub type OhCloudExtCloudDbData = SafeCffiWrapper<cloud_db::CloudDbData>;
 /// ValueBucket pointer passed to C side.
 pub type OhCloudExtValueBucket = SafeCffiWrapper<ipc_conn::ValueBucket>;
+/// RowBatch pointer passed to C side.
+pub type OhCloudExtRowBatch = SafeCffiWrapper<RowBatch>;
 
 /// Create a Value instance according to ValueInnerType.
 #[no_mangle]
@@ -1119,6 +1121,42 @@ pub unsafe extern "C" fn OhCloudExtRelationSetFree(re: *mut OhCloudExtRelationSe
     let _ = OhCloudExtRelationSet::from_ptr(re, SafetyCheckId::RelationSet);
 }
 
+/// Create a CloudDbData instance. Parameter `values` should be a Vector of HashMap<String, Value>.
+/// When passed in, values don't need to be freed again, because their management will be
+/// transferred to CloudDbData instance.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtCloudDbDataNew(
+    cursor: *const c_uchar,
+    cursor_len: c_uint,
+    has_more: bool,
+    values: *mut OhCloudExtVector,
+) -> *mut OhCloudExtCloudDbData {
+    if values.is_null() {
+        return null_mut();
+    }
+
+    let values = match OhCloudExtVector::get_inner(values, SafetyCheckId::Vector) {
+        Some(VectorCffi::HashMapValue(v)) => v,
+        _ => return null_mut(),
+    };
+    let values = values
+        .iter()
+        .map(|map| {
+            ipc_conn::ValueBucket(
+                map.iter()
+                    .map(|(key, value)| (key.clone(), ipc_conn::FieldRaw::from(value)))
+                    .collect(),
+            )
+        })
+        .collect();
+    let data = cloud_db::CloudDbData {
+        next_cursor: char_ptr_to_string(cursor, cursor_len),
+        has_more,
+        values,
+    };
+    OhCloudExtCloudDbData::new(data, SafetyCheckId::CloudDbData).into_ptr()
+}
+
 /// Get the next cursor from a CloudDbData pointer.
 #[no_mangle]
 pub unsafe extern "C" fn OhCloudExtCloudDbDataGetNextCursor(
@@ -1183,6 +1221,246 @@ pub unsafe extern "C" fn OhCloudExtCloudDbDataFree(src: *mut OhCloudExtCloudDbDa
     let _ = OhCloudExtCloudDbData::from_ptr(src, SafetyCheckId::CloudDbData);
 }
 
+/// Name of a RowBatch column, kept in the arena of the batch.
+#[repr(C)]
+#[derive(Debug)]
+pub struct OhCloudExtBatchName {
+    pub offset: c_ulonglong,
+    pub len: c_uint,
+}
+
+/// Cell of a RowBatch. `number` holds the value of INT and BOOL cells, the arena offset of STRING and
+/// BYTES cells and the index to pass to `OhCloudExtRowBatchGetAsset` of ASSET and ASSETS cells. `real`
+/// holds the value of FLOAT cells. A column missing in a row is an EMPTY cell.
+#[repr(C)]
+#[derive(Debug)]
+pub struct OhCloudExtBatchCell {
+    pub typ: OhCloudExtValueType,
+    pub len: c_uint,
+    pub number: c_longlong,
+    pub real: f64,
+}
+
+/// Layout of a RowBatch, the cell of the column `col` in the row `row` is `cells[col * rows + row]`.
+/// The pointers stay valid until the RowBatch is freed.
+#[repr(C)]
+pub struct OhCloudExtRowBatchView {
+    pub rows: c_uint,
+    pub columns: c_uint,
+    pub names: *const OhCloudExtBatchName,
+    pub cells: *const OhCloudExtBatchCell,
+    pub arena: *const c_uchar,
+    pub arena_len: c_ulonglong,
+}
+
+/// Page of value buckets in column major order, the columns are sorted by name. Texts, bytes and
+/// column names share one arena, so the page is read without a call for every value.
+#[derive(Debug, Default)]
+pub struct RowBatch {
+    rows: usize,
+    names: Vec<OhCloudExtBatchName>,
+    cells: Vec<OhCloudExtBatchCell>,
+    arena: Vec<u8>,
+    assets: Vec<ipc_conn::FieldRaw>,
+}
+
+impl RowBatch {
+    fn new(values: &[ipc_conn::ValueBucket]) -> RowBatch {
+        let columns = values
+            .iter()
+            .flat_map(|vb| vb.0.keys())
+            .collect::<BTreeSet<&String>>();
+        let mut batch = RowBatch {
+            rows: values.len(),
+            names: Vec::with_capacity(columns.len()),
+            cells: Vec::with_capacity(columns.len() * values.len()),
+            ..Default::default()
+        };
+        for name in columns.iter() {
+            let offset = batch.push_arena(name.as_bytes());
+            batch.names.push(OhCloudExtBatchName {
+                offset,
+                len: name.len() as c_uint,
+            });
+        }
+        for name in columns.iter() {
+            for vb in values {
+                let cell = batch.new_cell(vb.0.get(*name));
+                batch.cells.push(cell);
+            }
+        }
+        batch
+    }
+
+    fn push_arena(&mut self, bytes: &[u8]) -> c_ulonglong {
+        let offset = self.arena.len() as c_ulonglong;
+        self.arena.extend_from_slice(bytes);
+        offset
+    }
+
+    fn new_cell(&mut self, field: Option<&ipc_conn::FieldRaw>) -> OhCloudExtBatchCell {
+        let mut cell = OhCloudExtBatchCell {
+            typ: OhCloudExtValueType::EMPTY,
+            len: 0,
+            number: 0,
+            real: 0.0,
+        };
+        match field {
+            None | Some(ipc_conn::FieldRaw::Null) => {}
+            Some(ipc_conn::FieldRaw::Number(i)) => {
+                cell.typ = OhCloudExtValueType::INT;
+                cell.number = *i;
+            }
+            Some(ipc_conn::FieldRaw::Real(f)) => {
+                cell.typ = OhCloudExtValueType::FLOAT;
+                cell.real = *f;
+            }
+            Some(ipc_conn::FieldRaw::Bool(b)) => {
+                cell.typ = OhCloudExtValueType::BOOL;
+                cell.number = *b as c_longlong;
+            }
+            Some(ipc_conn::FieldRaw::Text(s)) => {
+                cell.typ = OhCloudExtValueType::STRING;
+                cell.number = self.push_arena(s.as_bytes()) as c_longlong;
+                cell.len = s.len() as c_uint;
+            }
+            Some(ipc_conn::FieldRaw::Blob(b)) => {
+                cell.typ = OhCloudExtValueType::BYTES;
+                cell.number = self.push_arena(b) as c_longlong;
+                cell.len = b.len() as c_uint;
+            }
+            Some(raw @ ipc_conn::FieldRaw::Asset(_)) => {
+                cell.typ = OhCloudExtValueType::ASSET;
+                cell.number = self.assets.len() as c_longlong;
+                self.assets.push(raw.clone());
+            }
+            Some(raw @ ipc_conn::FieldRaw::Assets(a)) => {
+                cell.typ = OhCloudExtValueType::ASSETS;
+                cell.number = self.assets.len() as c_longlong;
+                cell.len = a.0.len() as c_uint;
+                self.assets.push(raw.clone());
+            }
+        }
+        cell
+    }
+}
+
+/// Get the number of value buckets of a CloudDbData pointer.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtCloudDbDataGetValuesLen(
+    data: *mut OhCloudExtCloudDbData,
+    len: *mut c_uint,
+) -> c_int {
+    if data.is_null() || len.is_null() {
+        return ERRNO_NULLPTR;
+    }
+
+    let data_struct = match OhCloudExtCloudDbData::get_inner_ref(data, SafetyCheckId::CloudDbData) {
+        None => return ERRNO_WRONG_TYPE,
+        Some(v) => v,
+    };
+    *len = data_struct.values.len() as c_uint;
+    ERRNO_SUCCESS
+}
+
+/// Get at most `count` value buckets from index `start` of a CloudDbData pointer as a RowBatch.
+/// Parameter `batch` will be updated to hold the output RowBatch, and it should be freed by
+/// `RowBatchFree`.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtCloudDbDataGetBatch(
+    data: *mut OhCloudExtCloudDbData,
+    start: c_uint,
+    count: c_uint,
+    batch: *mut *const OhCloudExtRowBatch,
+) -> c_int {
+    if data.is_null() || batch.is_null() {
+        return ERRNO_NULLPTR;
+    }
+
+    let data_struct = match OhCloudExtCloudDbData::get_inner_ref(data, SafetyCheckId::CloudDbData) {
+        None => return ERRNO_WRONG_TYPE,
+        Some(v) => v,
+    };
+    let start = start as usize;
+    if start > data_struct.values.len() {
+        return ERRNO_OUT_OF_RANGE;
+    }
+    let end = data_struct
+        .values
+        .len()
+        .min(start.saturating_add(count as usize));
+    let rows = RowBatch::new(&data_struct.values[start..end]);
+    *batch = OhCloudExtRowBatch::new(rows, SafetyCheckId::RowBatch).into_ptr();
+    ERRNO_SUCCESS
+}
+
+/// Get the layout of a RowBatch pointer.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtRowBatchGetView(
+    batch: *mut OhCloudExtRowBatch,
+    view: *mut OhCloudExtRowBatchView,
+) -> c_int {
+    if batch.is_null() || view.is_null() {
+        return ERRNO_NULLPTR;
+    }
+
+    let batch_struct = match OhCloudExtRowBatch::get_inner_ref(batch, SafetyCheckId::RowBatch) {
+        None => return ERRNO_WRONG_TYPE,
+        Some(v) => v,
+    };
+    *view = OhCloudExtRowBatchView {
+        rows: batch_struct.rows as c_uint,
+        columns: batch_struct.names.len() as c_uint,
+        names: batch_struct.names.as_ptr(),
+        cells: batch_struct.cells.as_ptr(),
+        arena: batch_struct.arena.as_ptr(),
+        arena_len: batch_struct.arena.len() as c_ulonglong,
+    };
+    ERRNO_SUCCESS
+}
+
+/// Get the asset of an ASSET or ASSETS cell of a RowBatch pointer, `index` is the number of the cell.
+/// The CloudAsset or Vector returned should be freed by `CloudAssetFree` or `VectorFree`.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtRowBatchGetAsset(
+    batch: *mut OhCloudExtRowBatch,
+    index: c_uint,
+    typ: *mut OhCloudExtValueType,
+    content: *mut *const c_void,
+    len: *mut c_uint,
+) -> c_int {
+    if batch.is_null() || typ.is_null() || content.is_null() || len.is_null() {
+        return ERRNO_NULLPTR;
+    }
+
+    let batch_struct = match OhCloudExtRowBatch::get_inner_ref(batch, SafetyCheckId::RowBatch) {
+        None => return ERRNO_WRONG_TYPE,
+        Some(v) => v,
+    };
+    match batch_struct.assets.get(index as usize) {
+        Some(ipc_conn::FieldRaw::Asset(a)) => {
+            *typ = OhCloudExtValueType::ASSET;
+            *content = OhCloudExtCloudAsset::new(a.clone(), SafetyCheckId::CloudAsset).into_ptr()
+                as *mut c_void;
+            *len = 0;
+        }
+        Some(ipc_conn::FieldRaw::Assets(a)) => {
+            *typ = OhCloudExtValueType::ASSETS;
+            let vec = VectorCffi::CloudAsset(a.0.to_vec());
+            *content = OhCloudExtVector::new(vec, SafetyCheckId::Vector).into_ptr() as *mut c_void;
+            *len = a.0.len() as c_uint;
+        }
+        _ => return ERRNO_OUT_OF_RANGE,
+    }
+    ERRNO_SUCCESS
+}
+
+/// Free a RowBatch pointer.
+#[no_mangle]
+pub unsafe extern "C" fn OhCloudExtRowBatchFree(batch: *mut OhCloudExtRowBatch) {
+    let _ = OhCloudExtRowBatch::from_ptr(batch, SafetyCheckId::RowBatch);
+}
+
 #[repr(C)]
 pub struct OhCloudExtKeyName {
     key: *const c_uchar,
@@ -1299,8 +1577,8 @@ pub unsafe extern "C" fn OhCloudExtValueBucketFree(info: *mut OhCloudExtValueBuc
 #[cfg(test)]
 mod test {
     use crate::c_adapter::basic_rust_types::{
-        OhCloudExtHashMap, OhCloudExtRustType, OhCloudExtVector, OhCloudExtVectorNew,
-        OhCloudExtVectorPush,
+        OhCloudExtHashMap, OhCloudExtRustType, OhCloudExtVector, OhCloudExtVectorFree,
+        OhCloudExtVectorGet, OhCloudExtVectorNew, OhCloudExtVectorPush,
     };
     use crate::c_adapter::cloud_ext_types::*;
 
@@ -1649,4 +1927,339 @@ mod test {
             OhCloudExtRelationSetFree(set);
         }
     }
+
+    fn new_cloud_db_data(rows: usize) -> cloud_db::CloudDbData {
+        let mut values = Vec::with_capacity(rows);
+        for i in 0..rows {
+            let mut bucket = HashMap::new();
+            bucket.insert(
+                "id".to_string(),
+                ipc_conn::FieldRaw::Text(format!("gid_{i}")),
+            );
+            bucket.insert("operation".to_string(), ipc_conn::FieldRaw::Number(0));
+            bucket.insert(
+                "createTime".to_string(),
+                ipc_conn::FieldRaw::Text(i.to_string()),
+            );
+            bucket.insert(
+                "modifyTime".to_string(),
+                ipc_conn::FieldRaw::Text(i.to_string()),
+            );
+            bucket.insert(
+                "name".to_string(),
+                ipc_conn::FieldRaw::Text(format!("name_{i}")),
+            );
+            bucket.insert("age".to_string(), ipc_conn::FieldRaw::Number(i as i64));
+            bucket.insert("score".to_string(), ipc_conn::FieldRaw::Real(i as f64));
+            bucket.insert("valid".to_string(), ipc_conn::FieldRaw::Bool(i % 2 == 0));
+            bucket.insert(
+                "photo".to_string(),
+                ipc_conn::FieldRaw::Blob(vec![i as u8; 16]),
+            );
+            bucket.insert("remark".to_string(), ipc_conn::FieldRaw::Null);
+            values.push(ipc_conn::ValueBucket(bucket));
+        }
+        cloud_db::CloudDbData {
+            next_cursor: "cursor".to_string(),
+            has_more: false,
+            values,
+        }
+    }
+
+    /// UT test for CloudDbData creation and destruction.
+    ///
+    /// # Title
+    /// ut_cloud_db_data
+    ///
+    /// # Brief
+    /// 1. Create a CloudDbData from a vector of value hashmaps.
+    /// 2. Get the cursor, has_more and the values from it.
+    /// 3. Free the CloudDbData ptr.
+    /// 4. No error and memory leak should happen.
+    #[test]
+    fn ut_cloud_db_data() {
+        unsafe {
+            assert!(OhCloudExtCloudDbDataNew(null(), 0, false, null_mut()).is_null());
+            let mut map = HashMap::new();
+            map.insert("age".to_string(), types::Value::Int(1));
+            map.insert("name".to_string(), types::Value::String("name_1".to_string()));
+            let values = OhCloudExtVector::new(
+                VectorCffi::HashMapValue(vec![map.clone(), map]),
+                SafetyCheckId::Vector,
+            )
+            .into_ptr();
+            let cursor = "cursor";
+            let data = OhCloudExtCloudDbDataNew(
+                cursor.as_ptr() as *const c_uchar,
+                cursor.len() as c_uint,
+                true,
+                values,
+            );
+            assert!(!data.is_null());
+
+            let mut len = 0 as c_uint;
+            assert_eq!(
+                OhCloudExtCloudDbDataGetValuesLen(data, &mut len),
+                ERRNO_SUCCESS
+            );
+            assert_eq!(len, 2);
+            let mut has_more = 0_u8;
+            assert_eq!(
+                OhCloudExtCloudDbDataGetHasMore(data, &mut has_more),
+                ERRNO_SUCCESS
+            );
+            assert_eq!(has_more, 1);
+            let data_struct =
+                OhCloudExtCloudDbData::get_inner_ref(data, SafetyCheckId::CloudDbData).unwrap();
+            assert_eq!(data_struct.next_cursor, cursor);
+            assert!(matches!(
+                data_struct.values[1].0.get("age"),
+                Some(ipc_conn::FieldRaw::Number(1))
+            ));
+            OhCloudExtCloudDbDataFree(data);
+        }
+    }
+
+    /// UT test for RowBatch creation and destruction.
+    ///
+    /// # Title
+    /// ut_row_batch
+    ///
+    /// # Brief
+    /// 1. Create a CloudDbData with rows of different columns.
+    /// 2. Get a RowBatch of the rows from it.
+    /// 3. Check the column names, the cells and the assets of the batch.
+    /// 4. Free the RowBatch ptr.
+    /// 5. No error and memory leak should happen.
+    #[test]
+    fn ut_row_batch() {
+        unsafe {
+            let mut data = new_cloud_db_data(3);
+            data.values[1].0.insert(
+                "asset".to_string(),
+                ipc_conn::FieldRaw::Asset(ipc_conn::CloudAsset::default()),
+            );
+            data.values[2].0.remove("name");
+            let data = OhCloudExtCloudDbData::new(data, SafetyCheckId::CloudDbData).into_ptr();
+
+            let mut len = 0 as c_uint;
+            assert_eq!(
+                OhCloudExtCloudDbDataGetValuesLen(data, &mut len),
+                ERRNO_SUCCESS
+            );
+            assert_eq!(len, 3);
+            let mut batch: *const OhCloudExtRowBatch = null();
+            assert_eq!(
+                OhCloudExtCloudDbDataGetBatch(data, 4, 1, &mut batch),
+                ERRNO_OUT_OF_RANGE
+            );
+            assert_eq!(
+                OhCloudExtCloudDbDataGetBatch(data, 1, 8, &mut batch),
+                ERRNO_SUCCESS
+            );
+            assert!(!batch.is_null());
+            let mut view = OhCloudExtRowBatchView {
+                rows: 0,
+                columns: 0,
+                names: null(),
+                cells: null(),
+                arena: null(),
+                arena_len: 0,
+            };
+            let batch = batch as *mut OhCloudExtRowBatch;
+            assert_eq!(OhCloudExtRowBatchGetView(batch, &mut view), ERRNO_SUCCESS);
+            assert_eq!(view.rows, 2);
+            assert_eq!(view.columns, 11);
+
+            let arena = &*slice_from_raw_parts(view.arena, view.arena_len as usize);
+            let names = &*slice_from_raw_parts(view.names, view.columns as usize);
+            let cells = &*slice_from_raw_parts(view.cells, (view.columns * view.rows) as usize);
+            let column = |name: &str| {
+                names
+                    .iter()
+                    .position(|n| {
+                        &arena[n.offset as usize..(n.offset as usize + n.len as usize)]
+                            == name.as_bytes()
+                    })
+                    .unwrap()
+            };
+            let cell = |name: &str, row: usize| &cells[column(name) * view.rows as usize + row];
+            assert_eq!(column("age"), 0);
+            assert_eq!(cell("age", 0).typ, OhCloudExtValueType::INT);
+            assert_eq!(cell("age", 1).number, 2);
+            assert_eq!(cell("score", 0).typ, OhCloudExtValueType::FLOAT);
+            assert_eq!(cell("score", 1).real, 2.0);
+            assert_eq!(cell("valid", 1).typ, OhCloudExtValueType::BOOL);
+            assert_eq!(cell("valid", 1).number, 1);
+            assert_eq!(cell("remark", 0).typ, OhCloudExtValueType::EMPTY);
+            let name = cell("name", 0);
+            assert_eq!(name.typ, OhCloudExtValueType::STRING);
+            let offset = name.number as usize;
+            assert_eq!(&arena[offset..offset + name.len as usize], b"name_1");
+            assert_eq!(cell("name", 1).typ, OhCloudExtValueType::EMPTY);
+            assert_eq!(cell("photo", 1).typ, OhCloudExtValueType::BYTES);
+            assert_eq!(cell("photo", 1).len, 16);
+            assert_eq!(cell("asset", 1).typ, OhCloudExtValueType::EMPTY);
+
+            let asset = cell("asset", 0);
+            assert_eq!(asset.typ, OhCloudExtValueType::ASSET);
+            let mut typ = OhCloudExtValueType::EMPTY;
+            let mut content: *const c_void = null();
+            let mut length = 0 as c_uint;
+            assert_eq!(
+                OhCloudExtRowBatchGetAsset(
+                    batch,
+                    asset.number as c_uint,
+                    &mut typ,
+                    &mut content,
+                    &mut length
+                ),
+                ERRNO_SUCCESS
+            );
+            assert_eq!(typ, OhCloudExtValueType::ASSET);
+            assert!(!content.is_null());
+            OhCloudExtCloudAssetFree(content as *mut OhCloudExtCloudAsset);
+            assert_eq!(
+                OhCloudExtRowBatchGetAsset(batch, 1, &mut typ, &mut content, &mut length),
+                ERRNO_OUT_OF_RANGE
+            );
+
+            OhCloudExtRowBatchFree(batch);
+            OhCloudExtCloudDbDataFree(data);
+        }
+    }
+
+    /// UT test for the cost of reading CloudDbData by value buckets and by RowBatch.
+    ///
+    /// # Title
+    /// ut_row_batch_cost
+    ///
+    /// # Brief
+    /// 1. Create a CloudDbData of 20000 synthetic rows.
+    /// 2. Read and decode every value through the value buckets, a call for every key, as the cursor
+    /// did.
+    /// 3. Read and decode every value through RowBatches of 512 rows.
+    /// 4. Both decode the same values, the batches in no more time than the value buckets.
+    #[test]
+    fn ut_row_batch_cost() {
+        unsafe {
+            let rows = 20000;
+            let page = 512;
+            let data =
+                OhCloudExtCloudDbData::new(new_cloud_db_data(rows), SafetyCheckId::CloudDbData)
+                    .into_ptr();
+
+            let begin = std::time::Instant::now();
+            let mut bucket_values = 0;
+            let mut bucket_sum = 0i64;
+            let mut values: *const OhCloudExtVector = null();
+            assert_eq!(
+                OhCloudExtCloudDbDataGetValues(data, &mut values),
+                ERRNO_SUCCESS
+            );
+            let values = values as *mut OhCloudExtVector;
+            for row in 0..rows {
+                let mut vb: *const c_void = null();
+                let mut vb_len = 0 as c_uint;
+                assert_eq!(
+                    OhCloudExtVectorGet(values, row, &mut vb, &mut vb_len),
+                    ERRNO_SUCCESS
+                );
+                let vb = vb as *mut OhCloudExtValueBucket;
+                let mut keys: *const OhCloudExtVector = null();
+                let mut keys_len = 0 as c_uint;
+                assert_eq!(
+                    OhCloudExtValueBucketGetKeys(vb, &mut keys, &mut keys_len),
+                    ERRNO_SUCCESS
+                );
+                for i in 0..keys_len as usize {
+                    let mut key: *const c_void = null();
+                    let mut key_len = 0 as c_uint;
+                    OhCloudExtVectorGet(keys, i, &mut key, &mut key_len);
+                    let name = char_ptr_to_string(key as *const c_uchar, key_len);
+                    let mut typ = OhCloudExtValueType::EMPTY;
+                    let mut content: *const c_void = null();
+                    let mut len = 0 as c_uint;
+                    let key_name = OhCloudExtKeyNameNew(name.as_ptr(), name.len() as c_uint);
+                    if OhCloudExtValueBucketGetValue(vb, key_name, &mut typ, &mut content, &mut len)
+                        != ERRNO_SUCCESS
+                    {
+                        continue;
+                    }
+                    bucket_values += 1;
+                    bucket_sum += match typ {
+                        OhCloudExtValueType::INT => *(content as *const i64),
+                        OhCloudExtValueType::FLOAT => *(content as *const f64) as i64,
+                        OhCloudExtValueType::BOOL => *(content as *const bool) as i64,
+                        OhCloudExtValueType::STRING | OhCloudExtValueType::BYTES => {
+                            let bytes =
+                                std::slice::from_raw_parts(content as *const u8, len as usize)
+                                    .to_vec();
+                            bytes.iter().map(|b| *b as i64).sum()
+                        }
+                        _ => 0,
+                    };
+                }
+                OhCloudExtVectorFree(keys as *mut OhCloudExtVector);
+                OhCloudExtValueBucketFree(vb);
+            }
+            OhCloudExtVectorFree(values);
+            let bucket_cost = begin.elapsed();
+
+            let begin = std::time::Instant::now();
+            let mut batch_values = 0;
+            let mut batch_sum = 0i64;
+            for start in (0..rows).step_by(page) {
+                let mut batch: *const OhCloudExtRowBatch = null();
+                assert_eq!(
+                    OhCloudExtCloudDbDataGetBatch(
+                        data,
+                        start as c_uint,
+                        page as c_uint,
+                        &mut batch
+                    ),
+                    ERRNO_SUCCESS
+                );
+                let batch = batch as *mut OhCloudExtRowBatch;
+                let mut view = OhCloudExtRowBatchView {
+                    rows: 0,
+                    columns: 0,
+                    names: null(),
+                    cells: null(),
+                    arena: null(),
+                    arena_len: 0,
+                };
+                assert_eq!(OhCloudExtRowBatchGetView(batch, &mut view), ERRNO_SUCCESS);
+                let batch_rows = view.rows as usize;
+                let names = std::slice::from_raw_parts(view.names, view.columns as usize);
+                let cells = std::slice::from_raw_parts(view.cells, batch_rows * names.len());
+                let arena = std::slice::from_raw_parts(view.arena, view.arena_len as usize);
+                for (col, name) in names.iter().enumerate() {
+                    let offset = name.offset as usize;
+                    let name = &arena[offset..offset + name.len as usize];
+                    assert!(!String::from_utf8_lossy(name).is_empty());
+                    for cell in &cells[col * batch_rows..(col + 1) * batch_rows] {
+                        batch_values += 1;
+                        batch_sum += match cell.typ {
+                            OhCloudExtValueType::INT | OhCloudExtValueType::BOOL => cell.number,
+                            OhCloudExtValueType::FLOAT => cell.real as i64,
+                            OhCloudExtValueType::STRING | OhCloudExtValueType::BYTES => {
+                                let offset = cell.number as usize;
+                                let bytes = arena[offset..offset + cell.len as usize].to_vec();
+                                bytes.iter().map(|b| *b as i64).sum()
+                            }
+                            _ => 0,
+                        };
+                    }
+                }
+                OhCloudExtRowBatchFree(batch);
+            }
+            let batch_cost = begin.elapsed();
+
+            assert_eq!(bucket_values, batch_values);
+            assert_eq!(bucket_sum, batch_sum);
+            assert!(batch_cost <= bucket_cost);
+            OhCloudExtCloudDbDataFree(data);
+        }
+    }
 }
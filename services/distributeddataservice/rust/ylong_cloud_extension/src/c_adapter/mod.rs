@@ -90,6 +90,7 @@ pub(crate) enum SafetyCheckId {
     CloudAssetLoader = 45,
     CloudDatabase = 46,
     CloudSync = 47,
+    RowBatch = 48,
 }
 
 impl SafetyCheckId {
@@ -22,6 +22,7 @@
 
 #include "accesstoken_kit.h"
 #include "account/account_delegate.h"
+#include "changeevent/remote_change_event.h"
 #include "checker/checker_manager.h"
 #include "cloud/change_event.h"
 #include "cloud/cloud_last_sync_info.h"
@@ -80,6 +81,9 @@ static constexpr const char *FT_SYNC_TASK = "SYNC_TASK";
 static constexpr const char *FT_ENCRYPT_CHANGED = "ENCRYPT_CHANGED";
 static constexpr const char *CLOUD_SCHEMA = "arkdata/cloud/cloud_schema.json";
 __attribute__((used)) CloudServiceImpl::Factory CloudServiceImpl::factory_;
+std::mutex CloudServiceImpl::schemaFetchMutex_;
+std::map<std::string, std::shared_ptr<CloudServiceImpl::SchemaFetch>> CloudServiceImpl::schemaFetches_;
+ConcurrentMap<std::string, CloudServiceImpl::StatisticCache> CloudServiceImpl::statistics_;
 const CloudServiceImpl::SaveStrategy CloudServiceImpl::STRATEGY_SAVERS[Strategy::STRATEGY_BUTT] = {
     &CloudServiceImpl::SaveNetworkStrategy
 };
@@ -113,8 +117,18 @@ CloudServiceImpl::CloudServiceImpl()
         DoSync(event);
     });
     EventCenter::GetInstance().Subscribe(CloudEvent::CLOUD_SYNC_FINISHED, [this](const Event &event) {
+        OnStoreChanged(event);
         OnSyncInfoChanged(event);
     });
+    EventCenter::GetInstance().Subscribe(CloudEvent::LOCAL_CHANGE, [this](const Event &event) {
+        OnStoreChanged(event);
+    });
+    EventCenter::GetInstance().Subscribe(CloudEvent::DATA_CHANGE, [this](const Event &event) {
+        OnStoreChanged(event);
+    });
+    EventCenter::GetInstance().Subscribe(RemoteChangeEvent::DATA_CHANGE, [this](const Event &event) {
+        OnRemoteChanged(event);
+    });
     MetaDataManager::GetInstance().Subscribe(
         Subscription::GetPrefix({ "" }), [this](const std::string &key,
             const std::string &value, int32_t flag) -> auto {
@@ -243,6 +257,7 @@ int32_t CloudServiceImpl::ChangeAppSwitch(const std::string &id, const std::stri
         }
     }
     SyncConfig::UpdateConfig(user, bundleName, config.dbInfo);
+    InvalidateStatistics(std::to_string(cloudInfo.user), bundleName);
     Execute(GenTask(0, cloudInfo.user, scene, { WORK_CLOUD_INFO_UPDATE, WORK_SCHEMA_UPDATE, WORK_SUB }));
     if (appSwitch == SWITCH_OFF) {
         syncManager_.ClearLastSyncInfo(cloudInfo.user, cloudInfo.id, bundleName);
@@ -386,6 +401,7 @@ void CloudServiceImpl::ExecuteDatabaseClean(const StoreMetaData &meta, int32_t a
         EventCenter::GetInstance().PostEvent(std::make_unique<CloudEvent>(CloudEvent::CLEAN_DATA, storeInfo));
     }
     auto status = store->Clean("", meta.user, action, tableList);
+    InvalidateStatistics(meta.user, meta.bundleName, meta.storeId, tableList);
     if (status != E_OK) {
         ZLOGW("clean data status:%{public}d, user:%{public}s, bundleName:%{public}s, storeId:%{public}s", status,
             meta.user.c_str(), meta.bundleName.c_str(), meta.GetStoreAlias().c_str());
@@ -766,21 +782,66 @@ std::map<std::string, StatisticInfos> CloudServiceImpl::ExecuteStatistics(const
 StatisticInfos CloudServiceImpl::QueryStatistics(const StoreMetaData &storeMetaData,
     const DistributedData::Database &database)
 {
+    auto key = Constant::Join("", Constant::KEY_SEPARATOR,
+        { storeMetaData.user, storeMetaData.bundleName, storeMetaData.storeId });
+    auto now = steady_clock::now();
+    uint64_t version = 0;
+    std::map<std::string, StatisticInfo> cached;
+    statistics_.Compute(key, [&storeMetaData, &version, &cached, now](const auto &, StatisticCache &cache) {
+        cache.user = storeMetaData.user;
+        cache.bundleName = storeMetaData.bundleName;
+        version = cache.version;
+        for (auto it = cache.tables.begin(); it != cache.tables.end();) {
+            if (it->second.second <= now) {
+                it = cache.tables.erase(it);
+                continue;
+            }
+            cached.emplace(it->first, it->second.first);
+            ++it;
+        }
+        return true;
+    });
     std::vector<StatisticInfo> infos;
-    auto store = AutoCache::GetInstance().GetStore(storeMetaData, {});
-    if (store == nullptr) {
-        ZLOGE("store failed, store is nullptr,bundleName:%{public}s",
-            Anonymous::Change(storeMetaData.bundleName).c_str());
-        return infos;
-    }
     infos.reserve(database.tables.size());
+    std::map<std::string, StatisticInfo> scanned;
+    AutoCache::Store store;
     for (const auto &table : database.tables) {
+        auto it = cached.find(table.name);
+        if (it != cached.end()) {
+            infos.push_back(it->second);
+            infos.back().table = table.alias;
+            continue;
+        }
+        if (store == nullptr) {
+            store = AutoCache::GetInstance().GetStore(storeMetaData, {});
+        }
+        if (store == nullptr) {
+            ZLOGE("store failed, store is nullptr,bundleName:%{public}s",
+                Anonymous::Change(storeMetaData.bundleName).c_str());
+            return {};
+        }
         auto [success, info] = QueryTableStatistic(table.name, store);
         if (success) {
+            scanned.insert_or_assign(table.name, info);
             info.table = table.alias;
             infos.push_back(std::move(info));
         }
     }
+    if (scanned.empty()) {
+        return infos;
+    }
+    statistics_.ComputeIfPresent(key, [version, &scanned, now](const auto &, StatisticCache &cache) {
+        // the store changed while it was scanned, the next query scans again
+        if (cache.version != version) {
+            return true;
+        }
+        for (auto &[table, info] : scanned) {
+            cache.tables.insert_or_assign(table, std::make_pair(std::move(info), now + STATISTIC_EXPIRE));
+        }
+        return true;
+    });
+    ZLOGD("bundleName:%{public}s, storeId:%{public}s, cached:%{public}zu, scanned:%{public}zu",
+        storeMetaData.bundleName.c_str(), storeMetaData.GetStoreAlias().c_str(), cached.size(), scanned.size());
     return infos;
 }
 
@@ -829,6 +890,54 @@ std::string CloudServiceImpl::BuildStatisticSql(const std::string &tableName)
     return sql;
 }
 
+void CloudServiceImpl::InvalidateStatistics(const std::string &user, const std::string &bundleName,
+    const std::string &storeId, const std::vector<std::string> &tables)
+{
+    auto invalidate = [&tables](StatisticCache &cache) {
+        cache.version++;
+        if (tables.empty()) {
+            cache.tables.clear();
+            return;
+        }
+        for (const auto &table : tables) {
+            cache.tables.erase(table);
+        }
+    };
+    if (!storeId.empty()) {
+        statistics_.ComputeIfPresent(Constant::Join("", Constant::KEY_SEPARATOR, { user, bundleName, storeId }),
+            [&invalidate](const auto &, StatisticCache &cache) {
+                invalidate(cache);
+                return true;
+            });
+        return;
+    }
+    statistics_.ForEach([&user, &bundleName, &invalidate](const auto &, StatisticCache &cache) {
+        if (cache.user == user && cache.bundleName == bundleName) {
+            invalidate(cache);
+        }
+        return false;
+    });
+}
+
+void CloudServiceImpl::EraseStatistics(const std::string &user, const std::string &bundleName)
+{
+    statistics_.EraseIf([&user, &bundleName](const auto &, const StatisticCache &cache) {
+        return cache.user == user && (bundleName.empty() || cache.bundleName == bundleName);
+    });
+}
+
+void CloudServiceImpl::OnStoreChanged(const Event &event)
+{
+    auto &storeInfo = static_cast<const CloudEvent &>(event).GetStoreInfo();
+    InvalidateStatistics(std::to_string(storeInfo.user), storeInfo.bundleName, storeInfo.storeName);
+}
+
+void CloudServiceImpl::OnRemoteChanged(const Event &event)
+{
+    auto &dataInfo = static_cast<const RemoteChangeEvent &>(event).GetDataInfo();
+    InvalidateStatistics(dataInfo.userId, dataInfo.bundleName, dataInfo.storeId, dataInfo.tables);
+}
+
 std::pair<int32_t, std::map<std::string, StatisticInfos>> CloudServiceImpl::QueryStatistics(const std::string &id,
     const std::string &bundleName, const std::string &storeId)
 {
@@ -1049,12 +1158,15 @@ int32_t CloudServiceImpl::OnUserChange(uint32_t code, const std::string &user, c
         Anonymous::Change(account).c_str());
     switch (code) {
         case static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_SWITCHED):
+            // the statistics of the previous user are not queried any more
+            statistics_.Clear();
             Execute(GenTask(0, userId, CloudSyncScene::USER_CHANGE,
                 { WORK_CLOUD_INFO_UPDATE, WORK_SCHEMA_UPDATE, WORK_DO_CLOUD_SYNC, WORK_SUB }));
             break;
         case static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_DELETE):
         case static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_STOPPING):
         case static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_STOPPED):
+            EraseStatistics(user);
             Execute(GenTask(0, userId, CloudSyncScene::ACCOUNT_STOP, { WORK_STOP_CLOUD_SYNC, WORK_RELEASE }));
             break;
         case static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_UNLOCKED):
@@ -1198,6 +1310,9 @@ bool CloudServiceImpl::UpdateSchema(int32_t user, CloudSyncScene scene)
         return false;
     }
     auto keys = cloudInfo.GetSchemaKey();
+    std::map<std::string, HapInfo> hapInfos;
+    std::map<std::string, SchemaMeta> schemas;
+    std::vector<std::string> remotes;
     for (const auto &[bundle, key] : keys) {
         HapInfo hapInfo{ .user = user, .instIndex = 0, .bundleName = bundle };
         auto appInfoOpt = cloudInfo.GetAppInfo(bundle);
@@ -1205,81 +1320,136 @@ bool CloudServiceImpl::UpdateSchema(int32_t user, CloudSyncScene scene)
             const CloudInfo::AppInfo &appInfo = appInfoOpt.value();
             hapInfo.instIndex = appInfo.instanceId;
         }
-
-        SchemaMeta schemaMeta;
-        std::tie(status, schemaMeta) = GetSchemaFromHap(hapInfo);
-        if (status != SUCCESS) {
-            std::tie(status, schemaMeta) = GetAppSchemaFromServer(user, bundle);
+        hapInfos.insert_or_assign(bundle, hapInfo);
+        auto [ret, schemaMeta] = GetSchemaFromHap(hapInfo);
+        if (ret == SUCCESS) {
+            schemas.insert_or_assign(bundle, std::move(schemaMeta));
+        } else {
+            remotes.push_back(bundle);
         }
-        if (status == NOT_SUPPORT) {
+    }
+    auto results = GetAppSchemasFromServer(user, remotes, executor_);
+    std::vector<MetaDataManager::Entry> entries;
+    for (const auto &[bundle, key] : keys) {
+        auto result = results.find(bundle);
+        if (result != results.end() && result->second.first == NOT_SUPPORT) {
             ZLOGW("app not support, del cloudInfo! user:%{public}d, bundleName:%{public}s", user, bundle.c_str());
+            MetaDataManager::GetInstance().SaveMeta(entries, true);
             MetaDataManager::GetInstance().DelMeta(cloudInfo.GetKey(), true);
             return false;
         }
-        if (status != SUCCESS) {
+        if (result != results.end() && result->second.first == SUCCESS) {
+            schemas.insert_or_assign(bundle, std::move(result->second.second));
+        }
+        auto schema = schemas.find(bundle);
+        if (schema == schemas.end()) {
             continue;
         }
         SchemaMeta oldMeta;
         if (MetaDataManager::GetInstance().LoadMeta(key, oldMeta, true)) {
             UpgradeSchemaMeta(user, oldMeta);
-            UpdateClearWaterMark(hapInfo, schemaMeta, oldMeta);
+            UpdateClearWaterMark(hapInfos[bundle], schema->second, oldMeta);
         }
-        if (oldMeta != schemaMeta) {
-            MetaDataManager::GetInstance().SaveMeta(key, schemaMeta, true);
+        if (oldMeta != schema->second) {
+            entries.push_back({ key, Serializable::Marshall(schema->second) });
         }
     }
+    MetaDataManager::GetInstance().SaveMeta(entries, true);
     return true;
 }
 
 /**
 * Will be called when 'cloudDriver' OnAppUpdate/OnAppInstall to get the newest 'e2eeEnable'.
 */
-int32_t CloudServiceImpl::UpdateSchemaFromServer(int32_t user)
+int32_t CloudServiceImpl::UpdateSchemaFromServer(int32_t user, std::shared_ptr<ExecutorPool> executor)
 {
     auto [status, cloudInfo] = GetCloudInfo(user);
     if (status != SUCCESS) {
         ZLOGW("get cloud info failed, user:%{public}d, status:%{public}d", user, status);
         return status;
     }
-    return UpdateSchemaFromServer(cloudInfo, user);
+    return UpdateSchemaFromServer(cloudInfo, user, std::move(executor));
 }
 
-int32_t CloudServiceImpl::UpdateSchemaFromServer(const CloudInfo &cloudInfo, int32_t user)
+int32_t CloudServiceImpl::UpdateSchemaFromServer(const CloudInfo &cloudInfo, int32_t user,
+    std::shared_ptr<ExecutorPool> executor)
 {
     auto keys = cloudInfo.GetSchemaKey();
+    std::vector<std::string> bundles;
+    bundles.reserve(keys.size());
+    for (const auto &[bundle, key] : keys) {
+        bundles.push_back(bundle);
+    }
+    auto results = GetAppSchemasFromServer(user, bundles, std::move(executor));
+    std::vector<MetaDataManager::Entry> entries;
+    int32_t status = SUCCESS;
     for (const auto &[bundle, key] : keys) {
-        auto [status, schemaMeta] = GetAppSchemaFromServer(user, bundle);
-        if (status == NOT_SUPPORT) {
+        auto &[ret, schemaMeta] = results[bundle];
+        if (ret == NOT_SUPPORT) {
             ZLOGW("app not support, del cloudInfo! user:%{public}d, bundleName:%{public}s", user, bundle.c_str());
             MetaDataManager::GetInstance().DelMeta(cloudInfo.GetKey(), true);
-            return status;
+            status = ret;
+            break;
         }
-        if (status != SUCCESS) {
-            continue;
+        SchemaMeta oldMeta;
+        if (ret == SUCCESS && UpdateE2eeEnable(key, schemaMeta.e2eeEnable, bundle, oldMeta)) {
+            entries.push_back({ key, Serializable::Marshall(oldMeta) });
         }
-        UpdateE2eeEnable(key, schemaMeta.e2eeEnable, bundle);
     }
-    return SUCCESS;
+    MetaDataManager::GetInstance().SaveMeta(entries, true);
+    return status;
 }
 
-void CloudServiceImpl::UpdateE2eeEnable(const std::string &schemaKey, bool newE2eeEnable,
-    const std::string &bundleName)
+bool CloudServiceImpl::UpdateE2eeEnable(const std::string &schemaKey, bool newE2eeEnable,
+    const std::string &bundleName, SchemaMeta &schemaMeta)
 {
-    SchemaMeta oldMeta;
-    if (!MetaDataManager::GetInstance().LoadMeta(schemaKey, oldMeta, true)) {
-        return;
+    if (!MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true)) {
+        return false;
     }
-    if (oldMeta.e2eeEnable == newE2eeEnable) {
-        return;
+    if (schemaMeta.e2eeEnable == newE2eeEnable) {
+        return false;
     }
-    ZLOGI("Update e2eeEnable: %{public}d->%{public}d", oldMeta.e2eeEnable, newE2eeEnable);
+    ZLOGI("Update e2eeEnable: %{public}d->%{public}d", schemaMeta.e2eeEnable, newE2eeEnable);
     Report(FT_ENCRYPT_CHANGED, Fault::CSF_APP_SCHEMA, bundleName,
-        "oldE2eeEnable=" + std::to_string(oldMeta.e2eeEnable) + ",newE2eeEnable=" + std::to_string(newE2eeEnable));
-    oldMeta.e2eeEnable = newE2eeEnable;
-    MetaDataManager::GetInstance().SaveMeta(schemaKey, oldMeta, true);
+        "oldE2eeEnable=" + std::to_string(schemaMeta.e2eeEnable) + ",newE2eeEnable=" + std::to_string(newE2eeEnable));
+    schemaMeta.e2eeEnable = newE2eeEnable;
+    return true;
 }
 
 std::pair<int32_t, SchemaMeta> CloudServiceImpl::GetAppSchemaFromServer(int32_t user, const std::string &bundleName)
+{
+    auto key = Constant::Join("", Constant::KEY_SEPARATOR, { std::to_string(user), bundleName });
+    std::shared_ptr<SchemaFetch> fetch;
+    bool owner = false;
+    {
+        std::lock_guard<decltype(schemaFetchMutex_)> lock(schemaFetchMutex_);
+        auto &current = schemaFetches_[key];
+        if (current == nullptr) {
+            current = std::make_shared<SchemaFetch>();
+            owner = true;
+        }
+        fetch = current;
+    }
+    if (!owner) {
+        std::unique_lock<decltype(fetch->mutex)> lock(fetch->mutex);
+        fetch->cond.wait(lock, [&fetch]() { return fetch->finished; });
+        return fetch->result;
+    }
+    auto result = FetchAppSchema(user, bundleName);
+    {
+        std::lock_guard<decltype(schemaFetchMutex_)> lock(schemaFetchMutex_);
+        schemaFetches_.erase(key);
+    }
+    {
+        std::lock_guard<decltype(fetch->mutex)> lock(fetch->mutex);
+        fetch->result = result;
+        fetch->finished = true;
+    }
+    fetch->cond.notify_all();
+    return result;
+}
+
+std::pair<int32_t, SchemaMeta> CloudServiceImpl::FetchAppSchema(int32_t user, const std::string &bundleName)
 {
     SchemaMeta schemaMeta;
     if (!NetworkDelegate::GetInstance()->IsNetworkAvailable()) {
@@ -1300,6 +1470,60 @@ std::pair<int32_t, SchemaMeta> CloudServiceImpl::GetAppSchemaFromServer(int32_t
     return { SUCCESS, schemaMeta };
 }
 
+// Fetches the schemas on up to MAX_SCHEMA_FETCHES threads, the caller included. The caller only waits for the
+// fetches already running, a worker started after all bundles were taken returns at once.
+std::map<std::string, std::pair<int32_t, SchemaMeta>> CloudServiceImpl::GetAppSchemasFromServer(int32_t user,
+    const std::vector<std::string> &bundles, std::shared_ptr<ExecutorPool> executor)
+{
+    struct Context {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<std::string> bundles;
+        std::vector<std::pair<int32_t, SchemaMeta>> results;
+        size_t next = 0;
+        size_t finished = 0;
+    };
+    auto context = std::make_shared<Context>();
+    context->bundles = bundles;
+    context->results.resize(bundles.size());
+    auto fetch = [user, context]() {
+        while (true) {
+            size_t index = 0;
+            {
+                std::lock_guard<decltype(context->mutex)> lock(context->mutex);
+                if (context->next >= context->bundles.size()) {
+                    return;
+                }
+                index = context->next++;
+            }
+            auto result = GetAppSchemaFromServer(user, context->bundles[index]);
+            {
+                std::lock_guard<decltype(context->mutex)> lock(context->mutex);
+                context->results[index] = std::move(result);
+                context->finished++;
+            }
+            context->cond.notify_all();
+        }
+    };
+    auto begin = steady_clock::now();
+    auto workers = std::min(bundles.size(), MAX_SCHEMA_FETCHES);
+    for (size_t i = 1; executor != nullptr && i < workers; ++i) {
+        executor->Execute(fetch);
+    }
+    fetch();
+    std::map<std::string, std::pair<int32_t, SchemaMeta>> results;
+    std::unique_lock<decltype(context->mutex)> lock(context->mutex);
+    context->cond.wait(lock, [&context]() { return context->finished == context->bundles.size(); });
+    for (size_t i = 0; i < context->bundles.size(); ++i) {
+        results.insert_or_assign(context->bundles[i], std::move(context->results[i]));
+    }
+    if (!bundles.empty()) {
+        ZLOGI("user:%{public}d, bundles:%{public}zu, cost:%{public}" PRId64 "ms", user, bundles.size(),
+            static_cast<int64_t>(duration_cast<milliseconds>(steady_clock::now() - begin).count()));
+    }
+    return results;
+}
+
 void CloudServiceImpl::UpgradeSchemaMeta(int32_t user, const SchemaMeta &schemaMeta)
 {
     if (schemaMeta.metaVersion == SchemaMeta::CURRENT_VERSION) {
@@ -1435,6 +1659,7 @@ int32_t CloudServiceImpl::CloudStatic::OnAppUninstall(const std::string &bundleN
     MetaDataManager::GetInstance().DelMeta(Subscription::GetRelationKey(user, bundleName), true);
     MetaDataManager::GetInstance().DelMeta(CloudInfo::GetSchemaKey(user, bundleName, index), true);
     MetaDataManager::GetInstance().DelMeta(NetworkSyncStrategy::GetKey(user, bundleName), true);
+    EraseStatistics(std::to_string(user), bundleName);
     return E_OK;
 }
 
@@ -1472,7 +1697,7 @@ bool CloudServiceImpl::CloudStatic::CloudDriverCheck(const std::string &bundleNa
     if (instance->CloudDriverUpdated(bundleName)) {
         // cloudDriver install, update schema(for update 'e2eeEnable')
         ZLOGI("cloud driver check valid, bundleName:%{public}s, user:%{public}d", bundleName.c_str(), user);
-        Execute([this, user]() { UpdateSchemaFromServer(user); });
+        Execute([this, user]() { UpdateSchemaFromServer(user, GetThreadPool()); });
         return true;
     }
     return false;
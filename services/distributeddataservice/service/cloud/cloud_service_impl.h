@@ -16,6 +16,8 @@
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_CLOUD_CLOUD_SERVICE_IMPL_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_CLOUD_CLOUD_SERVICE_IMPL_H
 
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <queue>
 
@@ -184,6 +186,9 @@ private:
     static std::pair<int32_t, CloudInfo> GetCloudInfoFromServer(int32_t userId);
     static int32_t UpdateCloudInfoFromServer(int32_t user);
     static std::pair<int32_t, SchemaMeta> GetAppSchemaFromServer(int32_t user, const std::string &bundleName);
+    static std::pair<int32_t, SchemaMeta> FetchAppSchema(int32_t user, const std::string &bundleName);
+    static std::map<std::string, std::pair<int32_t, SchemaMeta>> GetAppSchemasFromServer(int32_t user,
+        const std::vector<std::string> &bundles, std::shared_ptr<ExecutorPool> executor);
     static Details HandleGenDetails(const DistributedData::GenDetails &details);
 
     void OnAsyncComplete(uint32_t tokenId, pid_t pid, uint32_t seqNum, Details &&result);
@@ -194,6 +199,11 @@ private:
     StatisticInfos QueryStatistics(const StoreMetaData &storeMetaData, const DistributedData::Database &database);
     std::pair<bool, StatisticInfo> QueryTableStatistic(const std::string &tableName, AutoCache::Store store);
     std::string BuildStatisticSql(const std::string &tableName);
+    void InvalidateStatistics(const std::string &user, const std::string &bundleName,
+        const std::string &storeId = "", const std::vector<std::string> &tables = {});
+    static void EraseStatistics(const std::string &user, const std::string &bundleName = "");
+    void OnStoreChanged(const Event &event);
+    void OnRemoteChanged(const Event &event);
 
     void GetSchema(const Event &event);
     void CloudShare(const Event &event);
@@ -245,9 +255,11 @@ private:
 
     static std::pair<int32_t, SchemaMeta> GetSchemaFromHap(const HapInfo &hapInfo);
     static int32_t UpdateSchemaFromHap(const HapInfo &hapInfo);
-    static int32_t UpdateSchemaFromServer(int32_t user);
-    static int32_t UpdateSchemaFromServer(const CloudInfo &cloudInfo, int32_t user);
-    static void UpdateE2eeEnable(const std::string &schemaKey, bool newE2eeEnable, const std::string &bundleName);
+    static int32_t UpdateSchemaFromServer(int32_t user, std::shared_ptr<ExecutorPool> executor = nullptr);
+    static int32_t UpdateSchemaFromServer(const CloudInfo &cloudInfo, int32_t user,
+        std::shared_ptr<ExecutorPool> executor = nullptr);
+    static bool UpdateE2eeEnable(const std::string &schemaKey, bool newE2eeEnable, const std::string &bundleName,
+        SchemaMeta &schemaMeta);
     static void UpdateClearWaterMark(
         const HapInfo &hapInfo, const SchemaMeta &newSchemaMeta, const SchemaMeta &schemaMeta);
 
@@ -265,6 +277,31 @@ private:
     std::mutex subscribeMutex_;
     std::map<CloudSubscribeType, std::map<std::string, std::vector<uint32_t>>> subscribes_;
 
+    // The statistics of a table are kept until a change of its store or the expire time, so a polling caller
+    // does not count the whole log table every time.
+    struct StatisticCache {
+        using Time = std::chrono::steady_clock::time_point;
+        std::string user;
+        std::string bundleName;
+        // changed on every invalidation, a scan started before it does not fill the cache
+        uint64_t version = 0;
+        std::map<std::string, std::pair<StatisticInfo, Time>> tables;
+    };
+    // static like schemaFetches_, the static acts prune it when an app is uninstalled
+    static ConcurrentMap<std::string, StatisticCache> statistics_;
+    static constexpr std::chrono::seconds STATISTIC_EXPIRE = std::chrono::seconds(30);
+
+    // one GetAppSchema call serves all the callers asking for the same schema meanwhile
+    struct SchemaFetch {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool finished = false;
+        std::pair<int32_t, SchemaMeta> result;
+    };
+    static std::mutex schemaFetchMutex_;
+    static std::map<std::string, std::shared_ptr<SchemaFetch>> schemaFetches_;
+    static constexpr size_t MAX_SCHEMA_FETCHES = 4;
+
     std::mutex notifyMutex_;
     std::map<uint32_t, BatchQueryLastResults> pendingNotifies_;
     TaskId notifyTaskId_ = ExecutorPool::INVALID_TASK_ID;
@@ -15,10 +15,13 @@
 #define LOG_TAG "SyncManager"
 #include "sync_manager.h"
 
+#include <algorithm>
 #include <chrono>
+#include <random>
 #include <unordered_set>
 
 #include "account/account_delegate.h"
+#include "app_state/app_state_manager.h"
 #include "bootstrap.h"
 #include "checker/checker_manager.h"
 #include "cloud/cloud_lock_event.h"
@@ -32,6 +35,7 @@
 #include "dfx/dfx_types.h"
 #include "dfx/reporter.h"
 #include "eventcenter/event_center.h"
+#include "flow_control_manager/flow_control_strategy.h"
 #include "log_print.h"
 #include "metadata/meta_data_manager.h"
 #include "network/network_delegate.h"
@@ -189,6 +193,45 @@ bool SyncManager::SyncInfo::Contains(const std::string &storeName) const
     return tables_.empty() || tables_.find(storeName) != tables_.end();
 }
 
+bool SyncManager::SyncInfo::Merge(const SyncInfo &info)
+{
+    // a caller waiting for its own result or syncing by its own query keeps its own sync
+    if (async_ || info.async_ || query_ != nullptr || info.query_ != nullptr) {
+        return false;
+    }
+    if (user_ != info.user_ || bundleName_ != info.bundleName_ || id_ != info.id_ || mode_ != info.mode_ ||
+        wait_ != info.wait_ || isCompensation_ != info.isCompensation_ || isDownloadOnly_ != info.isDownloadOnly_ ||
+        isEnablePredicate_ != info.isEnablePredicate_ || isFullSync_ != info.isFullSync_ ||
+        triggerMode_ != info.triggerMode_ || prepareTraceId_ != info.prepareTraceId_) {
+        return false;
+    }
+    // no stores means all stores, no tables means all tables of the store
+    if (tables_.empty() || info.tables_.empty()) {
+        tables_.clear();
+        return true;
+    }
+    for (const auto &[store, tables] : info.tables_) {
+        auto it = tables_.find(store);
+        if (it == tables_.end()) {
+            tables_.emplace(store, tables);
+            continue;
+        }
+        if (it->second.empty()) {
+            continue;
+        }
+        if (tables.empty()) {
+            it->second.clear();
+            continue;
+        }
+        for (const auto &table : tables) {
+            if (std::find(it->second.begin(), it->second.end(), table) == it->second.end()) {
+                it->second.push_back(table);
+            }
+        }
+    }
+    return true;
+}
+
 std::function<void(const Event &)> SyncManager::GetLockChangeHandler()
 {
     return [](const Event &event) {
@@ -264,6 +307,12 @@ SyncManager::~SyncManager()
         });
         executor_ = nullptr;
     }
+    // released outside of the lock, the manager waits for its scheduled task
+    std::shared_ptr<FlowControlManager> admission;
+    {
+        std::lock_guard<decltype(admissionMutex_)> lock(admissionMutex_);
+        admission = std::move(admission_);
+    }
 }
 
 int32_t SyncManager::Bind(std::shared_ptr<ExecutorPool> executor)
@@ -278,11 +327,8 @@ int32_t SyncManager::DoCloudSync(SyncInfo syncInfo)
         return E_NOT_INIT;
     }
     auto syncId = GenerateId(syncInfo.user_);
-    auto ref = GenSyncRef(syncId);
-    actives_.Compute(syncId, [this, &ref, &syncInfo](const uint64_t &key, TaskId &taskId) mutable {
-        taskId = executor_->Execute(GetSyncTask(0, true, ref, std::move(syncInfo)));
-        return true;
-    });
+    actives_.Insert(syncId, ExecutorPool::INVALID_TASK_ID);
+    Admit(0, true, GenSyncRef(syncId), std::move(syncInfo));
     return E_OK;
 }
 
@@ -297,13 +343,34 @@ int32_t SyncManager::StopCloudSync(int32_t user)
         }
         return false;
     });
+    std::map<uint64_t, PendingSync> stopped;
+    std::shared_ptr<FlowControlManager> admission;
+    {
+        std::lock_guard<decltype(admissionMutex_)> lock(admissionMutex_);
+        for (auto it = pendings_.begin(); it != pendings_.end();) {
+            if (it->second.info.user_ == user) {
+                stopped.insert(pendings_.extract(it++));
+                continue;
+            }
+            ++it;
+        }
+        admission = admission_;
+    }
+    if (admission != nullptr) {
+        admission->Remove([user](const FlowControlManager::TaskInfo &info) {
+            return info.type == static_cast<uint32_t>(user);
+        });
+    }
     return E_OK;
 }
 
 GeneralError SyncManager::IsValid(SyncInfo &info, CloudInfo &cloud)
 {
-    if (!MetaDataManager::GetInstance().LoadMeta(cloud.GetKey(), cloud, true) ||
-        (info.id_ != SyncInfo::DEFAULT_ID && cloud.id != info.id_)) {
+    auto snapshot = MetaDataManager::GetInstance().LoadMetaSnapshot<CloudInfo>(cloud.GetKey(), true);
+    if (snapshot != nullptr) {
+        cloud = *snapshot;
+    }
+    if (snapshot == nullptr || (info.id_ != SyncInfo::DEFAULT_ID && cloud.id != info.id_)) {
         info.SetError(E_CLOUD_DISABLED);
         ZLOGE("cloudInfo invalid:%{public}d, <syncId:%{public}s, metaId:%{public}s>", cloud.IsValid(),
             Anonymous::Change(info.id_).c_str(), Anonymous::Change(cloud.id).c_str());
@@ -423,10 +490,13 @@ bool SyncManager::PrepareForCloudSync(SyncInfo &info, CloudInfo &cloud, CloudSyn
     return true;
 }
 
-ExecutorPool::Task SyncManager::GetSyncTask(int32_t times, bool retry, RefCount ref, SyncInfo &&syncInfo)
+ExecutorPool::Task SyncManager::GetSyncTask(int32_t times, bool retry, RefCount ref, RefCount slot,
+    SyncInfo &&syncInfo)
 {
     times++;
-    return [this, times, retry, keep = std::move(ref), info = std::move(syncInfo)]() mutable {
+    return [this, times, retry, keep = std::move(ref), slot = std::move(slot), info = std::move(syncInfo)]() mutable {
+        // the slot is released when this task returns, unless the started store syncs hold it through the retryer
+        auto running = std::move(slot);
         activeInfos_.Erase(info.syncId_);
         bool createdByDefaultUser = InitDefaultUser(info.user_);
         CloudInfo cloud;
@@ -436,7 +506,7 @@ ExecutorPool::Task SyncManager::GetSyncTask(int32_t times, bool retry, RefCount
         if (!PrepareForCloudSync(info, cloud, cloudSyncInfos, traceIds)) {
             return;
         }
-        auto retryer = GetRetryer(times, info, cloud.user);
+        auto retryer = GetRetryer(times, info, cloud.user, std::move(running));
         auto schemas = GetSchemaMeta(cloud, info);
         if (schemas.empty()) {
             UpdateSchema(info);
@@ -480,9 +550,11 @@ void SyncManager::StartCloudSync(const DistributedData::SyncEvent &evt, const St
     syncParam.assetTempPath = meta.assetTempPath;
     syncParam.assetDownloadOnDemand = meta.assetDownloadOnDemand;
 
+    auto callback = evt.AutoRetry() ? RetryCallback(storeInfo, retryer, evt.GetTriggerMode(), prepareTraceId, user)
+                                    : GetCallback(async, storeInfo, evt.GetTriggerMode(), prepareTraceId, user);
+    // the retryer keeps the admission slot of the sync task until the store drops the finished callback
     auto [status, dbCode] = store->Sync({ SyncInfo::DEFAULT_ID }, *(evt.GetQuery()),
-        evt.AutoRetry() ? RetryCallback(storeInfo, retryer, evt.GetTriggerMode(), prepareTraceId, user)
-                        : GetCallback(async, storeInfo, evt.GetTriggerMode(), prepareTraceId, user), syncParam);
+        [callback, retryer](const GenDetails &result) { callback(result); }, syncParam);
     if (status != E_OK) {
         if (async) {
             detail.code = ConvertValidGeneralCode(status);
@@ -577,7 +649,7 @@ std::function<void(const Event &)> SyncManager::GetClientChangeHandler()
         syncInfo.SetEnablePredicate(evt.GetEnablePredicate());
         syncInfo.SetFullSync(evt.GetFullSync());
         auto times = evt.AutoRetry() ? RETRY_TIMES - CLIENT_RETRY_TIMES : RETRY_TIMES;
-        executor_->Execute(GetSyncTask(times, evt.AutoRetry(), RefCount(), std::move(syncInfo)));
+        Admit(times, evt.AutoRetry(), RefCount(), std::move(syncInfo));
     };
 }
 
@@ -612,15 +684,15 @@ bool SyncManager::HandleRetryFinished(const SyncInfo &info, int32_t user, int32_
     return true;
 }
 
-SyncManager::Retryer SyncManager::GetRetryer(int32_t times, const SyncInfo &syncInfo, int32_t user)
+SyncManager::Retryer SyncManager::GetRetryer(int32_t times, const SyncInfo &syncInfo, int32_t user, RefCount slot)
 {
     if (times >= RETRY_TIMES) {
-        return [this, user, info = SyncInfo(syncInfo)](Duration, int32_t code, int32_t dbCode,
+        return [this, user, slot, info = SyncInfo(syncInfo)](Duration, int32_t code, int32_t dbCode,
                    const std::string &prepareTraceId, CloudErrorAction cloudAction) mutable {
             return HandleRetryFinished(info, user, code, dbCode, prepareTraceId);
         };
     }
-    return [this, times, user, info = SyncInfo(syncInfo)](Duration interval, int32_t code, int32_t dbCode,
+    return [this, times, user, slot, info = SyncInfo(syncInfo)](Duration interval, int32_t code, int32_t dbCode,
                const std::string &prepareTraceId, CloudErrorAction cloudAction) mutable {
         if (code == E_OK || code == E_SYNC_TASK_MERGED) {
             return true;
@@ -644,8 +716,11 @@ SyncManager::Retryer SyncManager::GetRetryer(int32_t times, const SyncInfo &sync
         activeInfos_.ComputeIfAbsent(info.syncId_, [this, times, interval, &info](uint64_t key) mutable {
             auto syncId = GenerateId(info.user_);
             auto ref = GenSyncRef(syncId);
-            actives_.Compute(syncId, [this, times, interval, &ref, &info](const uint64_t &key, TaskId &value) mutable {
-                value = executor_->Schedule(interval, GetSyncTask(times, true, ref, std::move(info)));
+            auto backoff = GetBackoff(interval, ++info.retries_);
+            actives_.Compute(syncId, [this, times, backoff, &ref, &info](const uint64_t &key, TaskId &value) mutable {
+                value = executor_->Schedule(backoff, [this, times, ref, info = std::move(info)]() mutable {
+                    Admit(times, true, std::move(ref), std::move(info));
+                });
                 return true;
             });
             return syncId;
@@ -784,20 +859,23 @@ int32_t SyncManager::FillUserBindInfos(const AutoCache::Store &store, const Stor
     bool mustBind, CloudInfo &info, UserBindInfo &infos)
 {
     GeneralStore::CloudConfig config;
-    if (MetaDataManager::GetInstance().LoadMeta(info.GetKey(), info, true)) {
+    auto cloud = MetaDataManager::GetInstance().LoadMetaSnapshot<CloudInfo>(info.GetKey(), true);
+    if (cloud != nullptr) {
+        info = *cloud;
         config.maxNumber = info.maxNumber;
         config.maxSize = info.maxSize;
     }
     if (store->IsBound(info.user, info.id)) {
         return E_OK;
     }
-    SchemaMeta schemaMeta;
     std::string schemaKey = info.GetSchemaKey(meta.bundleName, meta.instanceId);
-    if (!MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true)) {
+    auto schema = MetaDataManager::GetInstance().LoadMetaSnapshot<SchemaMeta>(schemaKey, true);
+    if (schema == nullptr) {
         ZLOGE("failed, no schema bundleName:%{public}s, storeId:%{public}s", meta.bundleName.c_str(),
             meta.GetStoreAlias().c_str());
         return E_ERROR;
     }
+    const SchemaMeta &schemaMeta = *schema;
     config.isSupportEncrypt = schemaMeta.e2eeEnable;
     auto dbMeta = schemaMeta.GetDataBase(meta.storeId);
     std::vector<int32_t> users = { info.user };
@@ -899,12 +977,12 @@ std::vector<std::tuple<QueryKey, uint64_t>> SyncManager::GetCloudSyncInfo(const
         }
     }
     auto schemaKey = CloudInfo::GetSchemaKey(cloud.user, info.bundleName_);
-    SchemaMeta schemaMeta;
-    if (!MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true)) {
+    auto schemaMeta = MetaDataManager::GetInstance().LoadMetaSnapshot<SchemaMeta>(schemaKey, true);
+    if (schemaMeta == nullptr) {
         ZLOGE("load schema fail, bundleName: %{public}s, user %{public}d", info.bundleName_.c_str(), info.user_);
         return cloudSyncInfos;
     }
-    auto stores = schemaMeta.GetStores();
+    auto stores = schemaMeta->GetStores();
 
     if (!info.tables_.empty()) {
         stores = GetStoresIntersection(stores, info.tables_);
@@ -1104,11 +1182,12 @@ std::string SyncManager::GetAccountId(int32_t user)
 {
     CloudInfo cloudInfo;
     cloudInfo.user = user;
-    if (!MetaDataManager::GetInstance().LoadMeta(cloudInfo.GetKey(), cloudInfo, true)) {
+    auto snapshot = MetaDataManager::GetInstance().LoadMetaSnapshot<CloudInfo>(cloudInfo.GetKey(), true);
+    if (snapshot == nullptr) {
         ZLOGE("not exist meta, user:%{public}d.", cloudInfo.user);
         return "";
     }
-    return cloudInfo.id;
+    return snapshot->id;
 }
 
 ExecutorPool::Duration SyncManager::GetInterval(int32_t code)
@@ -1123,6 +1202,92 @@ ExecutorPool::Duration SyncManager::GetInterval(int32_t code)
     }
 }
 
+// Doubles the interval for every retry up to MAX_RETRY_INTERVAL, then takes a random point between the interval and
+// the doubled one, so the stores failing together do not retry together.
+ExecutorPool::Duration SyncManager::GetBackoff(Duration interval, int32_t retries)
+{
+    auto shift = std::clamp(retries - 1, 0, MAX_BACKOFF_SHIFT);
+    auto backoff = std::min<Duration>(interval * (1 << shift), std::max(interval, MAX_RETRY_INTERVAL));
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    std::uniform_int_distribution<Duration::rep> distribution(interval.count(), backoff.count());
+    return Duration(distribution(engine));
+}
+
+void SyncManager::Admit(int32_t times, bool retry, RefCount ref, SyncInfo &&syncInfo)
+{
+    auto admission = GetAdmission();
+    if (admission == nullptr) {
+        return;
+    }
+    uint64_t pendingId = 0;
+    FlowControlManager::TaskInfo taskInfo(static_cast<uint32_t>(syncInfo.user_), syncInfo.bundleName_,
+        AppStateManager::GetInstance()->IsForeground(syncInfo.bundleName_, syncInfo.user_) ?
+        ADMISSION_FOREGROUND : ADMISSION_BACKGROUND);
+    {
+        std::lock_guard<decltype(admissionMutex_)> lock(admissionMutex_);
+        for (auto &[id, pending] : pendings_) {
+            if (!pending.info.Merge(syncInfo)) {
+                continue;
+            }
+            ZLOGD("merged sync, user:%{public}d, bundleName:%{public}s, pending:%{public}zu", syncInfo.user_,
+                syncInfo.bundleName_.c_str(), pendings_.size());
+            pending.times = std::min(pending.times, times);
+            pending.retry = pending.retry || retry;
+            return;
+        }
+        pendingId = ++pendingId_;
+        pendings_.emplace(pendingId, PendingSync{ times, retry, std::move(ref), std::move(syncInfo) });
+    }
+    admission->ExecuteHeld([this, pendingId](RefCount slot) {
+        Start(pendingId, std::move(slot));
+    }, std::move(taskInfo));
+}
+
+void SyncManager::Start(uint64_t pendingId, RefCount slot)
+{
+    decltype(pendings_)::node_type node;
+    {
+        std::lock_guard<decltype(admissionMutex_)> lock(admissionMutex_);
+        node = pendings_.extract(pendingId);
+    }
+    if (node.empty()) {
+        return;
+    }
+    auto &pending = node.mapped();
+    auto executor = executor_;
+    if (executor == nullptr) {
+        return;
+    }
+    auto user = pending.info.user_;
+    auto bundleName = pending.info.bundleName_;
+    auto task = GetSyncTask(pending.times, pending.retry, std::move(pending.ref), std::move(slot),
+        std::move(pending.info));
+    if (executor->Execute(std::move(task)) == ExecutorPool::INVALID_TASK_ID) {
+        ZLOGE("execute failed, user:%{public}d, bundleName:%{public}s", user, bundleName.c_str());
+    }
+}
+
+// The cloud syncs are admitted as the RDB syncs are: at most ADMISSION_RATE per period in total, the foreground
+// apps first and an app flooding triggers only delays itself, and at most MAX_RUNNING_SYNCS at the same time.
+std::shared_ptr<FlowControlManager> SyncManager::GetAdmission()
+{
+    auto executor = executor_;
+    if (executor == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<decltype(admissionMutex_)> lock(admissionMutex_);
+    if (admission_ != nullptr) {
+        return admission_;
+    }
+    auto fair = std::make_shared<WeightedFairStrategy>(ADMISSION_RATE, ADMISSION_PERIOD);
+    auto priority = std::make_shared<PriorityClassStrategy>(std::move(fair), ADMISSION_BUTT, ADMISSION_PERIOD);
+    auto strategy = std::make_shared<TokenBucketStrategy>(ADMISSION_RATE, ADMISSION_PERIOD, MAX_RUNNING_SYNCS,
+        std::move(priority));
+    admission_ = std::make_shared<FlowControlManager>(std::move(executor), std::move(strategy), MAX_RUNNING_SYNCS,
+        MAX_SYNC_HOLD);
+    return admission_;
+}
+
 std::vector<SchemaMeta> SyncManager::GetSchemaMeta(const CloudInfo &cloud, const SyncInfo &info)
 {
     std::vector<SchemaMeta> schemas;
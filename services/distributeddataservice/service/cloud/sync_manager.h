@@ -16,6 +16,9 @@
 #ifndef OHOS_DISTRIBUTED_DATA_SERVICES_CLOUD_SYNC_MANAGER_H
 #define OHOS_DISTRIBUTED_DATA_SERVICES_CLOUD_SYNC_MANAGER_H
 
+#include <map>
+#include <mutex>
+
 #include "cloud/cloud_conflict_handler.h"
 #include "cloud/cloud_event.h"
 #include "cloud/cloud_info.h"
@@ -27,6 +30,7 @@
 #include "dfx/radar_reporter.h"
 #include "eventcenter/event.h"
 #include "executor_pool.h"
+#include "flow_control_manager/flow_control_manager.h"
 #include "metadata/store_meta_data_local.h"
 #include "store/auto_cache.h"
 #include "store/general_store.h"
@@ -91,7 +95,12 @@ public:
 
     private:
         friend SyncManager;
+        // Takes the stores and tables of a later trigger of the same app, false if the two can not be one sync.
+        bool Merge(const SyncInfo &info);
+
         uint64_t syncId_ = 0;
+        // the retries already scheduled, the backoff grows with it
+        int32_t retries_ = 0;
         int32_t mode_ = GenStore::MixMode(GenStore::CLOUD_TIME_FIRST, GenStore::AUTO_SYNC_MODE);
         int32_t user_ = 0;
         int32_t wait_ = 0;
@@ -171,9 +180,17 @@ private:
     static constexpr int32_t MV_BIT = 32;
     static constexpr int32_t EXPIRATION_TIME = 6 * 60 * 60 * 1000;                      // 6 hours
     static constexpr int32_t INVALID_SYNC_CODE = -1;                                    // sentinel: no valid result
+    static constexpr ExecutorPool::Duration MAX_RETRY_INTERVAL = std::chrono::seconds(600); // 10 minutes
+    static constexpr int32_t MAX_BACKOFF_SHIFT = 4;
+    static constexpr uint32_t MAX_RUNNING_SYNCS = 4;
+    // a sync not finished by then gives its slot up, so a hung extension cannot block the others
+    static constexpr ExecutorPool::Duration MAX_SYNC_HOLD = std::chrono::minutes(10);
+    static constexpr uint32_t ADMISSION_RATE = 10;                                      // syncs per period
+    static constexpr uint32_t ADMISSION_PERIOD = 1000;                                  // millisecond
 
     static uint64_t GenerateId(int32_t user);
     static ExecutorPool::Duration GetInterval(int32_t code);
+    static ExecutorPool::Duration GetBackoff(Duration interval, int32_t retries);
     static std::map<uint32_t, GenStore::BindInfo> GetBindInfos(
         const StoreMetaData &meta, const std::vector<int32_t> &users, const DistributedData::Database &schemaDatabase);
     static std::string GetAccountId(int32_t user);
@@ -195,11 +212,11 @@ private:
         int32_t code);
     bool HandleRetryFinished(const SyncInfo &info, int32_t user, int32_t code, int32_t dbCode,
         const std::string &prepareTraceId);
-    Task GetSyncTask(int32_t times, bool retry, RefCount ref, SyncInfo &&syncInfo);
+    Task GetSyncTask(int32_t times, bool retry, RefCount ref, RefCount slot, SyncInfo &&syncInfo);
     void UpdateSchema(const SyncInfo &syncInfo);
     std::function<void(const Event &)> GetSyncHandler(Retryer retryer);
     std::function<void(const Event &)> GetClientChangeHandler();
-    Retryer GetRetryer(int32_t times, const SyncInfo &syncInfo, int32_t user);
+    Retryer GetRetryer(int32_t times, const SyncInfo &syncInfo, int32_t user, RefCount slot);
     RefCount GenSyncRef(uint64_t syncId);
     int32_t Compare(uint64_t syncId, int32_t user);
     void UpdateStartSyncInfo(const CloudSyncInfos &cloudSyncInfos);
@@ -244,6 +261,23 @@ private:
         std::string traceId;
     };
     void HandleSyncError(const ErrorContext &context);
+
+    // A sync task waiting for one of the MAX_RUNNING_SYNCS slots, the later triggers of its app merge into it.
+    struct PendingSync {
+        int32_t times = 0;
+        bool retry = false;
+        RefCount ref;
+        SyncInfo info;
+    };
+    // the foreground apps are admitted first
+    enum AdmissionPriority : uint32_t {
+        ADMISSION_FOREGROUND = 0,
+        ADMISSION_BACKGROUND,
+        ADMISSION_BUTT,
+    };
+    void Admit(int32_t times, bool retry, RefCount ref, SyncInfo &&syncInfo);
+    void Start(uint64_t pendingId, RefCount slot);
+    std::shared_ptr<DistributedData::FlowControlManager> GetAdmission();
     static std::atomic<uint32_t> genId_;
     std::shared_ptr<ExecutorPool> executor_;
     ConcurrentMap<uint64_t, TaskId> actives_;
@@ -253,6 +287,10 @@ private:
     std::set<std::string> kvApps_;
     ConcurrentMap<int32_t, std::map<std::string, std::set<std::string>>> compensateSyncInfos_;
     NetworkRecoveryManager networkRecoveryManager_{ *this };
+    std::mutex admissionMutex_;
+    std::map<uint64_t, PendingSync> pendings_;
+    uint64_t pendingId_ = 0;
+    std::shared_ptr<DistributedData::FlowControlManager> admission_;
 };
 } // namespace OHOS::CloudData
 #endif // OHOS_DISTRIBUTED_DATA_SERVICES_CLOUD_SYNC_MANAGER_H
\ No newline at end of file
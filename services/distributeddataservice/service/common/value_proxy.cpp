@@ -170,6 +170,30 @@ ValueProxy::Buckets ValueProxy::Convert(DistributedData::VBuckets &&buckets)
     return proxy;
 }
 
+DistributedData::FlatBuckets ValueProxy::ToFlatBuckets(std::vector<DistributedDB::VBucket> &&buckets)
+{
+    DistributedData::FlatBuckets rows(DistributedData::FlatBuckets::CollectColumns(buckets));
+    rows.Reserve(buckets.size());
+    DistributedData::Values row;
+    row.reserve(rows.ColumnCount());
+    for (auto &bucket : buckets) {
+        if (bucket.size() == rows.ColumnCount()) {
+            for (auto &[key, value] : bucket) {
+                row.emplace_back(static_cast<DistributedData::Value>(Convert(std::move(value))));
+            }
+            rows.Append(std::move(row));
+            continue;
+        }
+        DistributedData::VBucket sparse;
+        for (auto &[key, value] : bucket) {
+            sparse.emplace_hint(sparse.end(), key, static_cast<DistributedData::Value>(Convert(std::move(value))));
+        }
+        rows.Append(std::move(sparse));
+    }
+    buckets.clear();
+    return rows;
+}
+
 ValueProxy::Value ValueProxy::Convert(DistributedDB::VariantData &&value)
 {
     Value proxy;
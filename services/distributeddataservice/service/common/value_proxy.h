@@ -18,6 +18,7 @@
 #include "asset_value.h"
 #include "cloud/cloud_store_types.h"
 #include "distributeddb/result_set.h"
+#include "store/flat_buckets.h"
 #include "store/general_value.h"
 #include "value_object.h"
 #include "values_bucket.h"
@@ -231,6 +232,8 @@ public:
 
     static Value Convert(DistributedDB::VariantData &&value);
     static Bucket Convert(std::map<std::string, DistributedDB::VariantData> &&value);
+    // Converts the rows straight into the shared column layout, without building a VBucket per row.
+    static DistributedData::FlatBuckets ToFlatBuckets(std::vector<DistributedDB::VBucket> &&buckets);
 
     template<typename T>
     static std::enable_if_t < CVT_INDEX<T, Proxy><MAX, Bucket>
@@ -35,6 +35,9 @@ class DBDelegate {
 public:
     using Time = std::chrono::steady_clock::time_point;
     using Filter = std::function<bool(const std::string &user)>;
+    // what the rdb observers get in place of the rows of a predicate that do not fit the notification,
+    // see IDataProxyRdbObserver::OnChangeFromRdb
+    static constexpr const char *INCOMPLETE_RESULT = "{\"incomplete\":true}";
     static std::shared_ptr<DBDelegate> Create(DistributedData::StoreMetaData &metaData, const std::string &extUri = "",
         const std::string &backup = "", int32_t accountId = -1);
     static bool Delete(const DistributedData::StoreMetaData &metaData);
@@ -14,11 +14,14 @@
  */
 #define LOG_TAG "KvAdaptor"
 
+#include <chrono>
 #include <cstddef>
 #include <cinttypes>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "kv_delegate.h"
 
@@ -46,7 +49,17 @@ const char* g_backupFiles[] = {
     "dataShare.db.undo",
 };
 constexpr const char* BACKUP_SUFFIX = ".backup";
+// The next backup pass compares against the staging copies, they hold the backup before the current one.
+constexpr const char* STAGING_SUFFIX = ".staging";
+constexpr const char* SWAP_SUFFIX = ".swap";
 constexpr std::chrono::milliseconds COPY_TIME_OUT_MS = std::chrono::milliseconds(500);
+constexpr size_t BACKUP_SEGMENT_SIZE = 64 * 1024;
+constexpr int32_t MAX_STALE_BACKUPS = 3;
+
+static int64_t ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
 
 // If isBackUp is true, remove db backup files. Otherwise remove source db files.
 void KvDelegate::RemoveDbFile(bool isBackUp) const
@@ -92,26 +105,163 @@ bool KvDelegate::CopyFile(bool isBackup)
     return ret;
 }
 
+// Writes only the segments of src which differ from dst, and cuts dst to the size of src.
+KvDelegate::CopyStatus KvDelegate::CopySegments(const std::string &src, const std::string &dst,
+    const std::function<bool()> &isStale, BackupStats &stats)
+{
+    std::ifstream in(src, std::ios::binary);
+    if (!in.is_open()) {
+        ZLOGE("failed to open file %{public}s", src.c_str());
+        return COPY_FAILED;
+    }
+    std::fstream out(dst, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out.is_open()) {
+        out.open(dst, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    }
+    if (!out.is_open()) {
+        ZLOGE("failed to open file %{public}s", dst.c_str());
+        return COPY_FAILED;
+    }
+    std::vector<char> srcBuf(BACKUP_SEGMENT_SIZE);
+    std::vector<char> dstBuf(BACKUP_SEGMENT_SIZE);
+    uint64_t offset = 0;
+    while (in.read(srcBuf.data(), BACKUP_SEGMENT_SIZE) || in.gcount() > 0) {
+        if (isStale != nullptr && isStale()) {
+            return COPY_STALE;
+        }
+        auto size = in.gcount();
+        out.seekg(offset);
+        out.read(dstBuf.data(), size);
+        bool same = out.gcount() == size && memcmp(srcBuf.data(), dstBuf.data(), size) == 0;
+        out.clear();
+        if (!same) {
+            out.seekp(offset);
+            if (!out.write(srcBuf.data(), size)) {
+                ZLOGE("failed to write file %{public}s", dst.c_str());
+                return COPY_FAILED;
+            }
+            stats.copied += static_cast<uint64_t>(size);
+        }
+        offset += static_cast<uint64_t>(size);
+    }
+    stats.total += offset;
+    if (in.bad()) {
+        ZLOGE("failed to read file %{public}s", src.c_str());
+        return COPY_FAILED;
+    }
+    out.close();
+    std::error_code code;
+    std::filesystem::resize_file(dst, offset, code);
+    if (code) {
+        ZLOGE("failed to resize file %{public}s, err: %{public}s", dst.c_str(), code.message().c_str());
+        return COPY_FAILED;
+    }
+    return COPY_DONE;
+}
+
+// Brings the staging copies up to date with the db files. It stops once the db is opened after generation.
+KvDelegate::CopyStatus KvDelegate::CopyToStaging(uint64_t generation, BackupStats &stats) const
+{
+    auto isStale = [this, generation]() {
+        return generation_ != generation;
+    };
+    int index = 0;
+    for (auto &fileName : g_backupFiles) {
+        std::string src = path_ + "/" + fileName;
+        TimeoutReport timeoutReport({"", "", "", __FUNCTION__, 0});
+        auto status = CopySegments(src, src + BACKUP_SUFFIX + STAGING_SUFFIX, isStale, stats);
+        timeoutReport.Report(("file index:" + std::to_string(index)), COPY_TIME_OUT_MS);
+        if (status != COPY_DONE) {
+            return status;
+        }
+        index++;
+    }
+    return COPY_DONE;
+}
+
+// Swaps the staging copies with the backups. Only renames are done here, so it is cheap to run under the lock.
+bool KvDelegate::CommitStaging() const
+{
+    for (auto &fileName : g_backupFiles) {
+        std::string backup = path_ + "/" + fileName + BACKUP_SUFFIX;
+        std::string staging = backup + STAGING_SUFFIX;
+        std::string swap = backup + SWAP_SUFFIX;
+        std::error_code code;
+        bool hasBackup = std::filesystem::exists(backup, code);
+        if (hasBackup) {
+            std::filesystem::rename(backup, swap, code);
+        }
+        if (!code) {
+            std::filesystem::rename(staging, backup, code);
+        }
+        if (!code && hasBackup) {
+            std::filesystem::rename(swap, staging, code);
+        }
+        if (code) {
+            ZLOGE("failed to commit file %{public}s, err: %{public}s", fileName, code.message().c_str());
+            RemoveDbFile(true);
+            return false;
+        }
+    }
+    return true;
+}
+
 // Restore database data when it is broken somehow. Some failure of insertion / deletion / updates will be considered
 // as database files damage, and therefore trigger the process of restoration.
 void KvDelegate::Restore()
 {
     // No need to lock because this inner method will only be called when upper methods lock up
+    generation_++;
     CopyFile(false);
     ZLOGD_MACRO("finish restoring kv");
 }
 
-// Backup database data by copying its key files. This mechanism might be costly, but acceptable when updating
-// contents of KV database happens not so frequently now.
+// Backup database data by copying the segments of its key files that changed since the staging copies were written.
+// The copy runs out of the lock while the db stays closed. If a request opens the db meanwhile, the pass is given up
+// and the staging copies are kept, so the next pass only copies what is still different.
 void KvDelegate::Backup()
 {
-    // No need to lock because this inner method will only be called when upper methods lock up
     ZLOGD_MACRO("backup kv");
-    if (hasChange_) {
-        CopyFile(true);
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    if (!hasChange_) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (db_ != nullptr) {
+        FlushPending();
+        GRD_DBClose(db_, GRD_DB_CLOSE);
+        db_ = nullptr;
+        isInitDone_ = false;
+    }
+    BackupStats stats;
+    uint64_t generation = generation_;
+    // a busy db could give up the passes forever, so keep the requests out after a few
+    bool holdLock = staleBackups_ >= MAX_STALE_BACKUPS;
+    if (!holdLock) {
+        stats.lockHoldMs += ElapsedMs(start);
+        lock.unlock();
+    }
+    auto status = CopyToStaging(generation, stats);
+    if (!holdLock) {
+        lock.lock();
+        start = std::chrono::steady_clock::now();
+    }
+    if (status == COPY_DONE && generation_ != generation) {
+        status = COPY_STALE;
+    }
+    if (status == COPY_STALE) {
+        staleBackups_++;
+    } else {
+        staleBackups_ = 0;
         hasChange_ = false;
     }
-    ZLOGD_MACRO("finish backing up kv");
+    if (status == COPY_DONE && !CommitStaging()) {
+        status = COPY_FAILED;
+    }
+    stats.lockHoldMs += ElapsedMs(start);
+    ZLOGI("backup kv status %{public}d, copied %{public}" PRIu64 " of %{public}" PRIu64 " bytes, "
+        "lock held %{public}" PRId64 "ms, stale %{public}d", status, stats.copied, stats.total, stats.lockHoldMs,
+        staleBackups_);
 }
 
 // Set hasChange_ to true. Caller can use this to control when to back up db.
@@ -140,10 +290,33 @@ bool KvDelegate::RestoreIfNeed(int32_t dbStatus)
     return false;
 }
 
+// Reads only hold the shared lock, the restoration needs the exclusive one. If the db was opened or restored since
+// generation, another thread has already dealt with the failure.
+void KvDelegate::RestoreIfNeed(int32_t dbStatus, uint64_t generation)
+{
+    // a missing doc fails the read too, keep the readers off the exclusive lock for it
+    if (dbStatus != GRD_INVALID_FILE_FORMAT && dbStatus != GRD_REBUILD_DATABASE) {
+        return;
+    }
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    if (generation_ == generation) {
+        RestoreIfNeed(dbStatus);
+    }
+}
+
+// Writers announce themselves before waiting, so the writer holding the lock knows whether to flush.
+std::unique_lock<std::shared_mutex> KvDelegate::LockWriter()
+{
+    pendingWriters_++;
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    pendingWriters_--;
+    return lock;
+}
+
 std::pair<int32_t, int32_t> KvDelegate::Upsert(const std::string &collectionName, const std::string &filter,
     const std::string &value)
 {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto lock = LockWriter();
     if (!Init()) {
         ZLOGE("init failed, %{public}s", collectionName.c_str());
         return std::make_pair(E_ERROR, 0);
@@ -160,17 +333,17 @@ std::pair<int32_t, int32_t> KvDelegate::Upsert(const std::string &collectionName
 
 std::pair<int32_t, int32_t> KvDelegate::Delete(const std::string &collectionName, const std::string &filter)
 {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto lock = LockWriter();
     if (!Init()) {
         ZLOGE("init failed, %{public}s", collectionName.c_str());
         return std::make_pair(E_ERROR, 0);
     }
     std::vector<std::string> queryResults;
 
-    int32_t status = GetBatch(collectionName, filter, "{\"id_\": true}", queryResults);
+    int32_t status = FindAll(collectionName, filter, "{\"id_\": true}", queryResults);
     if (status != E_OK) {
         ZLOGE("db GetBatch failed, %{public}s %{public}d", filter.c_str(), status);
-        // `GetBatch` should decide whether to restore before errors are returned, so skip restoration here.
+        RestoreIfNeed(status);
         return std::make_pair(status, 0);
     }
     int32_t deleteCount = 0;
@@ -203,11 +376,15 @@ void KvDelegate::ScheduleBackup()
     }
 
     taskId_ = executors_->Schedule(std::chrono::seconds(waitTime_), [this]() {
-        std::lock_guard<decltype(mutex_)> lock(mutex_);
-        GRD_DBClose(db_, GRD_DB_CLOSE);
-        db_ = nullptr;
-        isInitDone_ = false;
-        taskId_ = ExecutorPool::INVALID_TASK_ID;
+        {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            FlushPending();
+            GRD_DBClose(db_, GRD_DB_CLOSE);
+            db_ = nullptr;
+            isInitDone_ = false;
+            taskId_ = ExecutorPool::INVALID_TASK_ID;
+        }
+        // Backup takes the lock again and releases it while copying
         Backup();
     });
 }
@@ -216,6 +393,7 @@ void KvDelegate::GarbageCollect()
 {
     cleanTaskId_ =  executors_->Schedule(std::chrono::seconds(CLOSE_BY_SECONDS), [this]() {
         std::lock_guard<decltype(mutex_)> lock(mutex_);
+        FlushPending();
         auto ret = GRD_DBClose(db_, GRD_DB_CLOSE);
         if (ret == 0) {
             db_ = nullptr;
@@ -242,6 +420,8 @@ bool KvDelegate::Init()
         }
         return true;
     }
+    // opening may recover and write the db files
+    generation_++;
     int status = GRD_DBOpen(
         (path_ + "/dataShare.db").c_str(), nullptr, GRD_DB_OPEN_CREATE | GRD_DB_OPEN_CHECK_FOR_ABNORMAL, &db_);
     if (status != GRD_OK || db_ == nullptr) {
@@ -286,6 +466,7 @@ KvDelegate::~KvDelegate()
 {
     std::lock_guard<decltype(mutex_)> lock(mutex_);
     if (isInitDone_) {
+        FlushPending();
         int status = GRD_DBClose(db_, 0);
         if (status != GRD_OK) {
             ZLOGE("GRD_DBClose failed,status %{public}d", status);
@@ -335,14 +516,44 @@ bool KvDelegate::GetVersion(const std::string &collectionName, const std::string
     return true;
 }
 
+// Readers share the lock once the db is open, only opening it takes the exclusive lock. The lock is not held when it
+// fails.
+bool KvDelegate::InitShared(std::shared_lock<std::shared_mutex> &lock)
+{
+    while (!isInitDone_) {
+        lock.unlock();
+        {
+            std::lock_guard<decltype(mutex_)> writeLock(mutex_);
+            if (!Init()) {
+                return false;
+            }
+        }
+        // the db may be closed again before the shared lock is back
+        lock.lock();
+    }
+    return Init();
+}
+
 int32_t KvDelegate::Get(
     const std::string &collectionName, const std::string &filter, const std::string &projection, std::string &result)
 {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
-    if (!Init()) {
+    std::shared_lock<decltype(mutex_)> lock(mutex_);
+    if (!InitShared(lock)) {
         ZLOGE("init failed, %{public}s", collectionName.c_str());
         return E_ERROR;
     }
+    uint64_t generation = generation_;
+    int32_t status = FindOne(collectionName, filter, projection, result);
+    if (status != E_OK) {
+        lock.unlock();
+        RestoreIfNeed(status, generation);
+    }
+    return status;
+}
+
+int32_t KvDelegate::FindOne(
+    const std::string &collectionName, const std::string &filter, const std::string &projection, std::string &result)
+{
     Query query;
     query.filter = filter.c_str();
     query.projection = projection.c_str();
@@ -350,14 +561,12 @@ int32_t KvDelegate::Get(
     int status = GRD_FindDoc(db_, collectionName.c_str(), query, 0, &resultSet);
     if (status != GRD_OK || resultSet == nullptr) {
         ZLOGE("GRD_FindDoc failed,status %{public}d", status);
-        RestoreIfNeed(status);
         return status;
     }
     status = GRD_Next(resultSet);
     if (status != GRD_OK) {
         GRD_FreeResultSet(resultSet);
         ZLOGE("GRD_Next failed,status %{public}d", status);
-        RestoreIfNeed(status);
         return status;
     }
     char *value = nullptr;
@@ -365,7 +574,6 @@ int32_t KvDelegate::Get(
     if (status != GRD_OK || value == nullptr) {
         GRD_FreeResultSet(resultSet);
         ZLOGE("GRD_GetValue failed,status %{public}d", status);
-        RestoreIfNeed(status);
         return status;
     }
     result = value;
@@ -374,8 +582,14 @@ int32_t KvDelegate::Get(
     return E_OK;
 }
 
+// Group commit: a writer waiting for the lock flushes the writes of this one together with its own.
 void KvDelegate::Flush()
 {
+    if (pendingWriters_ > 0) {
+        hasUnflushed_ = true;
+        return;
+    }
+    hasUnflushed_ = false;
     int status = GRD_Flush(db_, GRD_DB_FLUSH_ASYNC);
     if (status != GRD_OK) {
         ZLOGE("GRD_Flush failed,status %{public}d", status);
@@ -383,14 +597,38 @@ void KvDelegate::Flush()
     }
 }
 
+// The last writer of a burst may have failed before flushing, so flush what is left before closing the db.
+void KvDelegate::FlushPending()
+{
+    if (hasUnflushed_ && db_ != nullptr) {
+        hasUnflushed_ = false;
+        int status = GRD_Flush(db_, GRD_DB_FLUSH_ASYNC);
+        if (status != GRD_OK) {
+            ZLOGE("GRD_Flush failed,status %{public}d", status);
+        }
+    }
+}
+
 int32_t KvDelegate::GetBatch(const std::string &collectionName, const std::string &filter,
     const std::string &projection, std::vector<std::string> &result)
 {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
-    if (!Init()) {
+    std::shared_lock<decltype(mutex_)> lock(mutex_);
+    if (!InitShared(lock)) {
         ZLOGE("init failed, %{public}s", collectionName.c_str());
         return E_ERROR;
     }
+    uint64_t generation = generation_;
+    int32_t status = FindAll(collectionName, filter, projection, result);
+    if (status != E_OK) {
+        lock.unlock();
+        RestoreIfNeed(status, generation);
+    }
+    return status;
+}
+
+int32_t KvDelegate::FindAll(const std::string &collectionName, const std::string &filter,
+    const std::string &projection, std::vector<std::string> &result)
+{
     Query query;
     query.filter = filter.c_str();
     query.projection = projection.c_str();
@@ -398,7 +636,6 @@ int32_t KvDelegate::GetBatch(const std::string &collectionName, const std::strin
     int status = GRD_FindDoc(db_, collectionName.c_str(), query, GRD_DOC_ID_DISPLAY, &resultSet);
     if (status != GRD_OK || resultSet == nullptr) {
         ZLOGE("GRD_FindDoc failed,status %{public}d", status);
-        RestoreIfNeed(status);
         return status;
     }
     char *value = nullptr;
@@ -407,7 +644,6 @@ int32_t KvDelegate::GetBatch(const std::string &collectionName, const std::strin
         if (status != GRD_OK || value == nullptr) {
             GRD_FreeResultSet(resultSet);
             ZLOGE("GRD_GetValue failed,status %{public}d", status);
-            RestoreIfNeed(status);
             return status;
         }
         result.emplace_back(value);
@@ -16,7 +16,10 @@
 #ifndef DATASHARESERVICE_KV_DELEGATE_H
 #define DATASHARESERVICE_KV_DELEGATE_H
 
+#include <atomic>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 
 #include "db_delegate.h"
@@ -39,19 +42,43 @@ public:
     void NotifyBackup() override;
 
 private:
+    enum CopyStatus : int32_t {
+        COPY_DONE,
+        // the db was opened during the copy
+        COPY_STALE,
+        COPY_FAILED,
+    };
+    struct BackupStats {
+        uint64_t total = 0;
+        uint64_t copied = 0;
+        int64_t lockHoldMs = 0;
+    };
     bool Init();
+    bool InitShared(std::shared_lock<std::shared_mutex> &lock);
+    std::unique_lock<std::shared_mutex> LockWriter();
+    int32_t FindOne(const std::string &collectionName, const std::string &filter, const std::string &projection,
+        std::string &result);
+    int32_t FindAll(const std::string &collectionName, const std::string &filter, const std::string &projection,
+        std::vector<std::string> &result);
     bool GetVersion(const std::string &collectionName, const std::string &filter, int &version);
     std::pair<int32_t, int32_t> Upsert(const std::string &collectionName, const std::string &filter,
         const std::string &value);
     void Flush();
+    void FlushPending();
     bool RestoreIfNeed(int32_t dbStatus);
+    void RestoreIfNeed(int32_t dbStatus, uint64_t generation);
     void Backup();
     void Restore();
     void RemoveDbFile(bool isBackUp) const;
     bool CopyFile(bool isBackup);
+    CopyStatus CopyToStaging(uint64_t generation, BackupStats &stats) const;
+    bool CommitStaging() const;
+    static CopyStatus CopySegments(const std::string &src, const std::string &dst,
+        const std::function<bool()> &isStale, BackupStats &stats);
     void ScheduleBackup();
     void GarbageCollect();
-    std::recursive_mutex mutex_;
+    // reads share it once the db is open, opening, writing, closing and restoring take it exclusively
+    std::shared_mutex mutex_;
     std::string path_;
     GRD_DB *db_ = nullptr;
     bool isInitDone_ = false;
@@ -61,6 +88,13 @@ private:
     int64_t absoluteWaitTime_ = 0;
     int64_t waitTime_ = 6 * 3600; // 6 hours
     ExecutorPool::TaskId cleanTaskId_ = ExecutorPool::INVALID_TASK_ID;
+    // bumped whenever the db files may change, a backup pass is only kept if it did not move
+    std::atomic<uint64_t> generation_{ 0 };
+    // passes given up in a row, the next pass holds the lock once there are too many
+    int32_t staleBackups_ = 0;
+    // writers waiting for the lock, the last writer of a burst flushes for all of them
+    std::atomic<int32_t> pendingWriters_{ 0 };
+    bool hasUnflushed_ = false;
 };
 } // namespace OHOS::DataShare
 #endif // DATASHARESERVICE_KV_DELEGATE_H
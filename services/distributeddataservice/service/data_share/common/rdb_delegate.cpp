@@ -18,13 +18,14 @@
 #include "crypto/crypto_manager.h"
 #include "datashare_errno.h"
 #include "datashare_radar_reporter.h"
+#include "datashare_template.h"
 #include "device_manager_adapter.h"
 #include "extension_connect_adaptor.h"
 #include "int_wrapper.h"
 #include "metadata/meta_data_manager.h"
 #include "metadata/store_meta_data.h"
 #include "metadata/secret_key_meta_data.h"
-#include "resultset_json_formatter.h"
+#include "resultset_stream_writer.h"
 #include "log_print.h"
 #include "rdb_errno.h"
 #include "rdb_utils.h"
@@ -307,8 +308,18 @@ std::string RdbDelegate::Query(const std::string &sql, const std::vector<std::st
         ZLOGE("query failed, err:%{public}d", E_SQLITE_ERROR);
         EraseStoreCache(tokenId_);
     }
-    ResultSetJsonFormatter formatter(std::move(resultSet));
-    return DistributedData::Serializable::Marshall(formatter);
+    // a result larger than the shared memory of the notification can not reach the observer anyway,
+    // the subscriber manager budgets the results of all the predicates against the whole notification
+    ResultSetStreamWriter::Option option;
+    option.budget = DATA_SIZE_ASHMEM_TRANSFER_LIMIT;
+    ResultSetStreamWriter writer(option);
+    std::string result;
+    if (!writer.Write(*resultSet, result)) {
+        ZLOGE("%{public}s result incomplete, truncated:%{public}d, rows:%{public}zu",
+            StringUtils::GeneralAnonymous(sql).c_str(), writer.IsTruncated(), writer.GetRows());
+    }
+    // the subscriber is told the rows are missing instead of getting nothing
+    return writer.IsTruncated() ? INCOMPLETE_RESULT : result;
 }
 
 std::shared_ptr<NativeRdb::ResultSet> RdbDelegate::QuerySql(const std::string &sql)
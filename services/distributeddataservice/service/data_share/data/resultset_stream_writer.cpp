@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "ResultSetStreamWriter"
+#include "resultset_stream_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+#include "log_print.h"
+#include "rdb_errno.h"
+
+namespace OHOS::DataShare {
+using namespace NativeRdb;
+// The length of the utf-8 sequence the lead byte starts, 0 for a byte no sequence starts with.
+static size_t Utf8Length(uint8_t lead)
+{
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return 2; // 2 bytes
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        return 3; // 3 bytes
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        return 4; // 4 bytes
+    }
+    return 0;
+}
+
+ResultSetStreamWriter::ResultSetStreamWriter(const Option &option) : option_(option)
+{
+}
+
+bool ResultSetStreamWriter::Write(ResultSet &resultSet, std::string &output)
+{
+    size_t start = output.size();
+    rows_ = 0;
+    truncated_ = false;
+    if (!PrepareColumns(resultSet, output)) {
+        return false;
+    }
+    // room for the closing bracket of the array
+    size_t tail = option_.format == JSON ? 1 : 0;
+    bool isOk = true;
+    while (resultSet.GoToNextRow() == E_OK) {
+        size_t rowStart = output.size();
+        if (!WriteRow(resultSet, output)) {
+            ZLOGE("write row %{public}zu failed", rows_);
+            output.resize(rowStart);
+            isOk = false;
+            break;
+        }
+        if (option_.budget != 0 && output.size() - start + tail > option_.budget) {
+            truncated_ = true;
+            if (option_.truncation == DISCARD) {
+                ZLOGW("result exceeds %{public}zu bytes at row %{public}zu, discarded", option_.budget, rows_);
+                output.resize(start);
+                return false;
+            }
+            ZLOGW("result exceeds %{public}zu bytes, kept %{public}zu rows", option_.budget, rows_);
+            output.resize(rowStart);
+            isOk = false;
+            break;
+        }
+        rows_++;
+    }
+    if (option_.format == JSON) {
+        output.push_back(']');
+    }
+    return isOk;
+}
+
+size_t ResultSetStreamWriter::GetRows() const
+{
+    return rows_;
+}
+
+bool ResultSetStreamWriter::IsTruncated() const
+{
+    return truncated_;
+}
+
+bool ResultSetStreamWriter::PrepareColumns(ResultSet &resultSet, std::string &output)
+{
+    order_.clear();
+    keys_.clear();
+    int32_t count = 0;
+    std::vector<std::string> names;
+    auto status = resultSet.GetColumnCount(count);
+    for (int32_t i = 0; status == E_OK && i < count; i++) {
+        names.emplace_back();
+        status = resultSet.GetColumnName(i, names.back());
+    }
+    if (status != E_OK) {
+        ZLOGE("get columns err, %{public}d", status);
+        if (option_.format == JSON) {
+            output.append("[]");
+        }
+        return false;
+    }
+    if (option_.format == BINARY) {
+        output.push_back(static_cast<char>(VERSION));
+        AppendVarint(names.size(), output);
+        for (int32_t i = 0; i < count; i++) {
+            AppendVarint(names[i].size(), output);
+            output.append(names[i]);
+            order_.push_back(i);
+        }
+        return true;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        order_.push_back(i);
+    }
+    std::stable_sort(order_.begin(), order_.end(), [&names](int32_t lhs, int32_t rhs) {
+        return names[lhs] < names[rhs];
+    });
+    auto last = std::unique(order_.rbegin(), order_.rend(), [&names](int32_t lhs, int32_t rhs) {
+        return names[lhs] == names[rhs];
+    });
+    order_.erase(order_.begin(), last.base());
+    for (auto col : order_) {
+        keys_.emplace_back();
+        AppendJsonString(names[col], keys_.back());
+        keys_.back().push_back(':');
+    }
+    output.push_back('[');
+    return true;
+}
+
+bool ResultSetStreamWriter::WriteRow(ResultSet &resultSet, std::string &output)
+{
+    if (option_.format == BINARY) {
+        for (auto col : order_) {
+            if (!WriteBinaryCell(resultSet, col, output)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (rows_ != 0) {
+        output.push_back(',');
+    }
+    output.push_back('{');
+    for (size_t i = 0; i < order_.size(); i++) {
+        if (i != 0) {
+            output.push_back(',');
+        }
+        output.append(keys_[i]);
+        if (!WriteJsonCell(resultSet, order_[i], output)) {
+            return false;
+        }
+    }
+    output.push_back('}');
+    return true;
+}
+
+bool ResultSetStreamWriter::WriteJsonCell(ResultSet &resultSet, int32_t col, std::string &output)
+{
+    ColumnType type;
+    if (resultSet.GetColumnType(col, type) != E_OK) {
+        ZLOGE("GetColumnType err %{public}d", col);
+        return false;
+    }
+    switch (type) {
+        case ColumnType::TYPE_INTEGER: {
+            int64_t value = 0;
+            resultSet.GetLong(col, value);
+            char buffer[24];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            output.append(buffer, end);
+            return true;
+        }
+        case ColumnType::TYPE_FLOAT: {
+            double value = 0;
+            resultSet.GetDouble(col, value);
+            AppendDouble(value, output);
+            return true;
+        }
+        case ColumnType::TYPE_NULL:
+            output.append("null");
+            return true;
+        case ColumnType::TYPE_STRING:
+            text_.clear();
+            resultSet.GetString(col, text_);
+            AppendJsonString(text_, output);
+            return true;
+        case ColumnType::TYPE_BLOB: {
+            blob_.clear();
+            resultSet.GetBlob(col, blob_);
+            output.push_back('[');
+            for (size_t i = 0; i < blob_.size(); i++) {
+                if (i != 0) {
+                    output.push_back(',');
+                }
+                char buffer[4];
+                auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), blob_[i]);
+                output.append(buffer, end);
+            }
+            output.push_back(']');
+            return true;
+        }
+        default:
+            ZLOGE("unknow type %{public}d", type);
+            return false;
+    }
+}
+
+bool ResultSetStreamWriter::WriteBinaryCell(ResultSet &resultSet, int32_t col, std::string &output)
+{
+    ColumnType type;
+    if (resultSet.GetColumnType(col, type) != E_OK) {
+        ZLOGE("GetColumnType err %{public}d", col);
+        return false;
+    }
+    switch (type) {
+        case ColumnType::TYPE_INTEGER: {
+            int64_t value = 0;
+            resultSet.GetLong(col, value);
+            output.push_back(static_cast<char>(TAG_INTEGER));
+            // zigzag, small negative numbers stay short
+            auto bits = static_cast<uint64_t>(value);
+            AppendVarint((bits << 1) ^ (value < 0 ? ~0ULL : 0ULL), output);
+            return true;
+        }
+        case ColumnType::TYPE_FLOAT: {
+            double value = 0;
+            resultSet.GetDouble(col, value);
+            output.push_back(static_cast<char>(TAG_FLOAT));
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (size_t i = 0; i < sizeof(bits); i++) {
+                output.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+            }
+            return true;
+        }
+        case ColumnType::TYPE_NULL:
+            output.push_back(static_cast<char>(TAG_NULL));
+            return true;
+        case ColumnType::TYPE_STRING:
+            text_.clear();
+            resultSet.GetString(col, text_);
+            output.push_back(static_cast<char>(TAG_STRING));
+            AppendVarint(text_.size(), output);
+            output.append(text_);
+            return true;
+        case ColumnType::TYPE_BLOB:
+            blob_.clear();
+            resultSet.GetBlob(col, blob_);
+            output.push_back(static_cast<char>(TAG_BLOB));
+            AppendVarint(blob_.size(), output);
+            output.append(blob_.begin(), blob_.end());
+            return true;
+        default:
+            ZLOGE("unknow type %{public}d", type);
+            return false;
+    }
+}
+
+// Escapes as json dump does: invalid utf-8 is replaced by U+FFFD and only the control characters are escaped.
+void ResultSetStreamWriter::AppendJsonString(const std::string &value, std::string &output)
+{
+    static constexpr const char *REPLACEMENT = "\xEF\xBF\xBD";
+    static constexpr const char *HEX = "0123456789abcdef";
+    output.push_back('"');
+    size_t size = value.size();
+    for (size_t i = 0; i < size;) {
+        auto ch = static_cast<uint8_t>(value[i]);
+        if (ch >= 0x80) {
+            size_t len = Utf8Length(ch);
+            // the second byte has narrower ranges after E0, ED, F0 and F4
+            uint8_t low = ch == 0xE0 ? 0xA0 : (ch == 0xF0 ? 0x90 : 0x80);
+            uint8_t high = ch == 0xED ? 0x9F : (ch == 0xF4 ? 0x8F : 0xBF);
+            // the bytes of the sequence that are fine so far, one U+FFFD replaces them if it breaks off
+            size_t matched = len == 0 ? 0 : 1;
+            while (matched != 0 && matched < len && i + matched < size) {
+                auto next = static_cast<uint8_t>(value[i + matched]);
+                if (matched == 1 ? (next < low || next > high) : (next < 0x80 || next > 0xBF)) {
+                    break;
+                }
+                matched++;
+            }
+            if (matched != 0 && matched == len) {
+                output.append(value, i, len);
+            } else {
+                output.append(REPLACEMENT);
+            }
+            i += std::max<size_t>(matched, 1);
+            continue;
+        }
+        switch (ch) {
+            case '"':
+                output.append("\\\"");
+                break;
+            case '\\':
+                output.append("\\\\");
+                break;
+            case '\b':
+                output.append("\\b");
+                break;
+            case '\f':
+                output.append("\\f");
+                break;
+            case '\n':
+                output.append("\\n");
+                break;
+            case '\r':
+                output.append("\\r");
+                break;
+            case '\t':
+                output.append("\\t");
+                break;
+            default:
+                if (ch < 0x20) {
+                    output.append("\\u00");
+                    output.push_back(HEX[ch >> 4]);
+                    output.push_back(HEX[ch & 0xF]);
+                } else {
+                    output.push_back(static_cast<char>(ch));
+                }
+                break;
+        }
+        i++;
+    }
+    output.push_back('"');
+}
+
+// The shortest digits reading back to the same double, laid out as json dump does: fixed notation with at least
+// one fraction digit while the decimal point is within 15 digits, otherwise d.ddde+XX.
+void ResultSetStreamWriter::AppendDouble(double value, std::string &output)
+{
+    static constexpr int MIN_EXP = -4;
+    static constexpr int MAX_EXP = 15;
+    if (!std::isfinite(value)) {
+        output.append("null");
+        return;
+    }
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::scientific);
+    if (ec != std::errc()) {
+        output.append("null");
+        return;
+    }
+    std::string_view text(buffer, end - buffer);
+    if (text.front() == '-') {
+        output.push_back('-');
+        text.remove_prefix(1);
+    }
+    auto ePos = text.find('e');
+    int exponent = 0;
+    std::from_chars(text.data() + ePos + (text[ePos + 1] == '+' ? 2 : 1), text.data() + text.size(), exponent);
+    std::string digits(text.substr(0, ePos));
+    digits.erase(std::remove(digits.begin(), digits.end(), '.'), digits.end());
+    // the value is 0.digits * 10^point
+    int count = static_cast<int>(digits.size());
+    int point = exponent + 1;
+    if (count <= point && point <= MAX_EXP) {
+        output.append(digits).append(point - count, '0').append(".0");
+    } else if (point > 0 && point <= MAX_EXP) {
+        output.append(digits, 0, point).append(".").append(digits, point, std::string::npos);
+    } else if (point > MIN_EXP && point <= 0) {
+        output.append("0.").append(-point, '0').append(digits);
+    } else {
+        output.push_back(digits[0]);
+        if (count > 1) {
+            output.append(".").append(digits, 1, std::string::npos);
+        }
+        output.append(exponent < 0 ? "e-" : "e+");
+        auto magnitude = std::to_string(exponent < 0 ? -exponent : exponent);
+        if (magnitude.size() < 2) {
+            output.push_back('0');
+        }
+        output.append(magnitude);
+    }
+}
+
+void ResultSetStreamWriter::AppendVarint(uint64_t value, std::string &output)
+{
+    static constexpr uint8_t LOW_BITS = 0x7F;
+    static constexpr uint8_t MORE = 0x80;
+    while (value > LOW_BITS) {
+        output.push_back(static_cast<char>((value & LOW_BITS) | MORE));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+} // namespace OHOS::DataShare
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DATASHARESERVICE_RESULTSET_STREAM_WRITER_H
+#define DATASHARESERVICE_RESULTSET_STREAM_WRITER_H
+
+#include <string>
+#include <vector>
+
+#include "result_set.h"
+
+namespace OHOS::DataShare {
+// Writes the rows of a result set straight into a buffer, cell by cell, without building a json document.
+class ResultSetStreamWriter final {
+public:
+    enum Format : int32_t {
+        // the array of row objects ResultSetJsonFormatter produces
+        JSON,
+        // VERSION, the column count and names, then a tag and the value of every cell, row by row
+        BINARY,
+    };
+    enum Truncation : int32_t {
+        // give up the whole output
+        DISCARD,
+        // keep the rows that fit, the output is still a complete document
+        DROP_ROWS,
+    };
+    struct Option {
+        Format format = JSON;
+        // 0 means no limit
+        size_t budget = 0;
+        Truncation truncation = DISCARD;
+    };
+    enum Tag : uint8_t {
+        TAG_NULL,
+        TAG_INTEGER,
+        TAG_FLOAT,
+        TAG_STRING,
+        TAG_BLOB,
+    };
+    static constexpr uint8_t VERSION = 1;
+
+    explicit ResultSetStreamWriter(const Option &option);
+    // Appends the rows after the current position. It is false on a read error, where the output keeps the rows
+    // read before it, and when the budget is exceeded.
+    bool Write(NativeRdb::ResultSet &resultSet, std::string &output);
+    size_t GetRows() const;
+    bool IsTruncated() const;
+
+private:
+    bool PrepareColumns(NativeRdb::ResultSet &resultSet, std::string &output);
+    bool WriteRow(NativeRdb::ResultSet &resultSet, std::string &output);
+    bool WriteJsonCell(NativeRdb::ResultSet &resultSet, int32_t col, std::string &output);
+    bool WriteBinaryCell(NativeRdb::ResultSet &resultSet, int32_t col, std::string &output);
+    static void AppendJsonString(const std::string &value, std::string &output);
+    static void AppendDouble(double value, std::string &output);
+    static void AppendVarint(uint64_t value, std::string &output);
+
+    Option option_;
+    // the json object keys are written sorted and only the last one of duplicate names is kept, as json did
+    std::vector<int32_t> order_;
+    std::vector<std::string> keys_;
+    std::string text_;
+    std::vector<uint8_t> blob_;
+    size_t rows_ = 0;
+    bool truncated_ = false;
+};
+} // namespace OHOS::DataShare
+#endif // DATASHARESERVICE_RESULTSET_STREAM_WRITER_H
@@ -56,6 +56,7 @@ public:
         bool storeMetaDataFromUri = false;
         bool normalAppAccessible = false;
         bool accountIsolation = false;
+        bool reusePredicateResults = false;
         AccessCrossMode accessCrossMode = AccessCrossMode::USER_UNDEFINED;
         std::vector<AllowList> allowLists;
     };
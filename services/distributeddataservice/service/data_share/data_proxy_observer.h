@@ -25,6 +25,10 @@ namespace DataShare {
 class IDataProxyRdbObserver : public OHOS::IRemoteBroker {
 public:
     DECLARE_INTERFACE_DESCRIPTOR(u"OHOS.DataShare.IDataProxyRdbObserver");
+    // Every entry of changeNode.data_ is {"<predicate key>":<rows as a JSON array>}, one per template predicate.
+    // The whole node must fit DATA_SIZE_ASHMEM_TRANSFER_LIMIT once serialized. When the rows of a predicate do not
+    // fit in what is left, its entry is {"<predicate key>":{"incomplete":true}} and the observer has to query the
+    // rows itself.
     virtual void OnChangeFromRdb(RdbChangeNode &changeNode) = 0;
 };
 
@@ -66,6 +66,8 @@ struct ProfileInfo : public DistributedData::Serializable {
     bool storeMetaDataFromUri = false;
     bool launchForCleanData = false;
     bool accountIsolation = false;
+    // the template predicates not reading the written table may keep their last results
+    bool reusePredicateResults = false;
     bool Marshal(json &node) const override;
     bool Unmarshal(const json &node) override;
 };
@@ -133,7 +133,8 @@ std::pair<int32_t, int32_t> DataShareServiceImpl::InsertEx(const std::string &ur
         auto [errCode, ret] = dbDelegate->InsertEx(providerInfo.tableName, valuesBucket);
         if (errCode == E_OK && ret > 0) {
             NotifyChange(uri, providerInfo.visitedUserId);
-            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData);
+            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData,
+                GetChangedTables(providerInfo));
         }
         if (errCode != E_OK) {
             ReportExcuteFault(callingTokenId, providerInfo, errCode, func);
@@ -163,6 +164,15 @@ bool DataShareServiceImpl::NotifyChange(const std::string &uri, int32_t userId)
     return true;
 }
 
+// Only a provider opting in lets the subscribers keep the results of the predicates not reading the table.
+std::set<std::string> DataShareServiceImpl::GetChangedTables(const DataProviderConfig::ProviderInfo &providerInfo)
+{
+    if (!providerInfo.reusePredicateResults || providerInfo.tableName.empty()) {
+        return {};
+    }
+    return { providerInfo.tableName };
+}
+
 bool DataShareServiceImpl::VerifyPredicates(const DataSharePredicates &predicates, uint32_t callingTokenId,
     DataProviderConfig::ProviderInfo &providerInfo, std::string &func)
 {
@@ -205,7 +215,8 @@ std::pair<int32_t, int32_t> DataShareServiceImpl::UpdateEx(const std::string &ur
         auto [errCode, ret] = dbDelegate->UpdateEx(providerInfo.tableName, predicate, valuesBucket);
         if (errCode == E_OK && ret > 0) {
             NotifyChange(uri, providerInfo.visitedUserId);
-            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData);
+            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData,
+                GetChangedTables(providerInfo));
         }
         if (errCode != E_OK) {
             ReportExcuteFault(callingTokenId, providerInfo, errCode, func);
@@ -237,7 +248,8 @@ std::pair<int32_t, int32_t> DataShareServiceImpl::DeleteEx(const std::string &ur
         auto [errCode, ret] = dbDelegate->DeleteEx(providerInfo.tableName, predicate);
         if (errCode == E_OK && ret > 0) {
             NotifyChange(uri, providerInfo.visitedUserId);
-            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData);
+            RdbSubscriberManager::GetInstance().Emit(uri, providerInfo.visitedUserId, metaData,
+                GetChangedTables(providerInfo));
         }
         if (errCode != E_OK) {
             ReportExcuteFault(callingTokenId, providerInfo, errCode, func);
@@ -724,9 +736,10 @@ void DataShareServiceImpl::SubscribeChange()
         auto dataInfo = evt.GetDataInfo();
         SaveLaunchInfo(dataInfo.bundleName, dataInfo.userId, dataInfo.deviceId);
     });
+    // auto launch waits for the extension connection, which must not block the threads reporting the changes.
     EventCenter::GetInstance().Subscribe(RemoteChangeEvent::DATA_CHANGE, [this](const Event &event) {
         AutoLaunch(event);
-    });
+    }, true);
 }
 
 void DataShareServiceImpl::SaveLaunchInfo(const std::string &bundleName, const std::string &userId,
@@ -1020,7 +1033,9 @@ void DataShareServiceImpl::RegisterHandler()
 void DataShareServiceImpl::DumpDataShareServiceInfo(int fd, std::map<std::string, std::vector<std::string>> &params)
 {
     (void)params;
-    std::string info;
+    auto stats = RdbSubscriberManager::GetInstance().GetQueryStats();
+    std::string info = "TemplateQuery executed:" + std::to_string(stats.executed) +
+        " memoized:" + std::to_string(stats.memoized) + " reused:" + std::to_string(stats.reused);
     dprintf(fd, "-------------------------------------DataShareServiceInfo------------------------------\n%s\n",
         info.c_str());
 }
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <functional>
 #include <mutex>
+#include <set>
 #include <string>
 
 #include "accesstoken_kit.h"
@@ -172,6 +173,7 @@ private:
     bool VerifyPredicates(const DataSharePredicates &predicates, uint32_t callingTokenId,
         DataProviderConfig::ProviderInfo &providerInfo, std::string &func);
     std::shared_ptr<DataShareServiceImpl::TimerReceiver> GetTimerReceiver();
+    static std::set<std::string> GetChangedTables(const DataProviderConfig::ProviderInfo &providerInfo);
     std::vector<DataProxyResult> DeleteAndNotifyProxyData(const std::vector<std::string> &uris,
         const BundleInfo &callerBundleInfo);
     static Factory factory_;
@@ -16,7 +16,10 @@
 
 #include "rdb_subscriber_manager.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cinttypes>
+#include <cstring>
 #include <utility>
 
 #include "ipc_skeleton.h"
@@ -28,6 +31,14 @@
 #include "utils/anonymous.h"
 
 namespace OHOS::DataShare {
+// the size of {"":} around the result of a predicate
+static constexpr size_t WRAPPER_SIZE = 5;
+// the serialized size of a change node entry: the length, the wrapper, the key and the result
+static size_t GetEntrySize(const std::string &key, size_t resultSize)
+{
+    return sizeof(int32_t) + WRAPPER_SIZE + key.size() + resultSize;
+}
+
 bool TemplateManager::Get(const Key &key, int32_t userId, Template &tpl)
 {
     return TemplateData::Query(Id(TemplateData::GenId(key.uri, key.bundleName, key.subscriberId), userId), tpl) == E_OK;
@@ -122,7 +133,13 @@ int RdbSubscriberManager::Add(const Key &key, const sptr<IDataProxyRdbObserver>
         auto callerPid = IPCSkeleton::GetCallingPid();
         ObserverNode observerNode(observer, context->callerTokenId, callerTokenId, callerPid, context->visitedUserId);
         observerNode.enabled = enabled;
-        value.emplace_back(observerNode);
+        auto nodes = value == nullptr ? std::make_shared<std::vector<ObserverNode>>()
+                                      : std::make_shared<std::vector<ObserverNode>>(*value);
+        nodes->emplace_back(observerNode);
+        value = std::move(nodes);
+        if (value->size() == 1) {
+            AddIndex(key);
+        }
         std::vector<ObserverNode> node;
         node.emplace_back(observerNode);
         bool isFirstSubscribe = SchedulerManager::GetInstance().Add(key);
@@ -148,43 +165,47 @@ int RdbSubscriberManager::Add(const Key &key, const sptr<IDataProxyRdbObserver>
 int RdbSubscriberManager::Delete(const Key &key, uint32_t firstCallerTokenId)
 {
     auto result =
-        rdbCache_.ComputeIfPresent(key, [&firstCallerTokenId, this](const auto &key,
-            std::vector<ObserverNode> &value) {
+        rdbCache_.ComputeIfPresent(key, [&firstCallerTokenId, this](const auto &key, Observers &value) {
             ZLOGI("delete subscriber, uri %{public}s tokenId 0x%{public}x",
                 URIUtils::Anonymous(key.uri).c_str(), firstCallerTokenId);
-            for (auto it = value.begin(); it != value.end();) {
+            auto nodes = std::make_shared<std::vector<ObserverNode>>(*value);
+            for (auto it = nodes->begin(); it != nodes->end();) {
                 if (it->firstCallerTokenId == firstCallerTokenId) {
                     ZLOGI("erase start");
-                    it = value.erase(it);
+                    it = nodes->erase(it);
                 } else {
                     it++;
                 }
             }
-            if (value.empty()) {
+            value = std::move(nodes);
+            if (value->empty()) {
                 SchedulerManager::GetInstance().Stop(key);
+                RemoveIndex(key);
             }
-            return !value.empty();
+            return !value->empty();
         });
     return result ? E_OK : E_SUBSCRIBER_NOT_EXIST;
 }
 
 void RdbSubscriberManager::Delete(uint32_t callerTokenId, uint32_t callerPid)
 {
-    rdbCache_.EraseIf([&callerTokenId, &callerPid, this](const auto &key, std::vector<ObserverNode> &value) {
-        for (auto it = value.begin(); it != value.end();) {
-            if (it->callerTokenId == callerTokenId && it->callerPid == callerPid) {
-                it = value.erase(it);
-            } else {
-                it++;
-            }
+    rdbCache_.EraseIf([&callerTokenId, &callerPid, this](const auto &key, Observers &value) {
+        auto isCaller = [&callerTokenId, &callerPid](const ObserverNode &node) {
+            return node.callerTokenId == callerTokenId && node.callerPid == callerPid;
+        };
+        if (std::any_of(value->begin(), value->end(), isCaller)) {
+            auto nodes = std::make_shared<std::vector<ObserverNode>>(*value);
+            nodes->erase(std::remove_if(nodes->begin(), nodes->end(), isCaller), nodes->end());
+            value = std::move(nodes);
         }
-        if (value.empty()) {
+        if (value->empty()) {
             ZLOGI("delete timer, subId %{public}" PRId64 ", bundleName %{public}s, tokenId %{public}x, uri %{public}s.",
                 key.subscriberId, key.bundleName.c_str(), callerTokenId,
                 URIUtils::Anonymous(key.uri).c_str());
             SchedulerManager::GetInstance().Stop(key);
+            RemoveIndex(key);
         }
-        return value.empty();
+        return value->empty();
     });
 }
 
@@ -193,8 +214,9 @@ int RdbSubscriberManager::Disable(const Key &key, uint32_t firstCallerTokenId)
     bool isAllDisabled = true;
     bool result =
         rdbCache_.ComputeIfPresent(key, [&firstCallerTokenId, &isAllDisabled, this](const auto &key,
-            std::vector<ObserverNode> &value) {
-            for (auto it = value.begin(); it != value.end(); it++) {
+            Observers &value) {
+            auto nodes = std::make_shared<std::vector<ObserverNode>>(*value);
+            for (auto it = nodes->begin(); it != nodes->end(); it++) {
                 if (it->firstCallerTokenId == firstCallerTokenId) {
                     it->enabled = false;
                     it->isNotifyOnEnabled = false;
@@ -203,6 +225,7 @@ int RdbSubscriberManager::Disable(const Key &key, uint32_t firstCallerTokenId)
                     isAllDisabled = false;
                 }
             }
+            value = std::move(nodes);
             return true;
         });
     if (isAllDisabled) {
@@ -221,8 +244,10 @@ int RdbSubscriberManager::Enable(const Key &key, std::shared_ptr<Context> contex
     DistributedData::StoreMetaData metaData;
     std::vector<ObserverNode> observers;
     bool result = rdbCache_.ComputeIfPresent(key, [&context, &metaData, &isChanged, &observers, this](const auto &key,
-        std::vector<ObserverNode> &value) {
-        for (auto it = value.begin(); it != value.end(); it++) {
+        Observers &value) {
+        auto nodes = std::make_shared<std::vector<ObserverNode>>(*value);
+        value = nodes;
+        for (auto it = nodes->begin(); it != nodes->end(); it++) {
             if (it->firstCallerTokenId != context->callerTokenId) {
                 continue;
             }
@@ -262,73 +287,98 @@ void RdbSubscriberManager::Emit(const std::string &uri, std::shared_ptr<Context>
         loadDataInfo(context);
     }
     DistributedData::StoreMetaData metaData = RdbSubscriberManager::GenMetaDataFromContext(context);
-    std::map<Key, std::vector<ObserverNode>> obsMap;
-    rdbCache_.ForEach([&uri, &context, &metaData, &obsMap, this](const Key &key, std::vector<ObserverNode> &val) {
-        if (key.uri != uri) {
-            return false;
-        }
-        for (const auto &node : val) {
-            if (node.enabled) {
-                obsMap.emplace(key, val);
-                break;
-            }
+    // the provider changed its store itself, so no last result is known to be fresh.
+    lastResults_.Clear();
+    QueryMemo memo;
+    for (const auto &[key, observers] : TakeSnapshot(uri)) {
+        auto isEnabled = [](const ObserverNode &node) { return node.enabled; };
+        if (std::any_of(observers->begin(), observers->end(), isEnabled)) {
+            Notify(key, context->visitedUserId, *observers, metaData, -1, &memo);
         }
-        SetObserverNotifyOnEnabled(val);
-        return false;
-    });
-    for (const auto &observers : obsMap) {
-        Notify(observers.first, context->visitedUserId, observers.second, metaData);
     }
     SchedulerManager::GetInstance().Execute(
         uri, context->visitedUserId, metaData);
 }
 
 void RdbSubscriberManager::Emit(const std::string &uri, int32_t userId,
-    DistributedData::StoreMetaData &metaData)
+    DistributedData::StoreMetaData &metaData, const std::set<std::string> &changedTables)
 {
     if (!URIUtils::IsDataProxyURI(uri)) {
         return;
     }
-    bool hasObserver = false;
-    std::map<Key, std::vector<ObserverNode>> obsMap;
-    rdbCache_.ForEach([&uri, &userId, &metaData, &hasObserver, &obsMap, this](const Key &key,
-        std::vector<ObserverNode> &val) {
-        if (key.uri != uri) {
-            return false;
-        }
-        hasObserver = true;
-        obsMap.emplace(key, val);
-        SetObserverNotifyOnEnabled(val);
-        return false;
-    });
-    if (!hasObserver) {
+    auto snapshot = TakeSnapshot(uri);
+    if (snapshot.empty()) {
         return;
     }
-    for (const auto &observers : obsMap) {
-        Notify(observers.first, userId, observers.second, metaData);
+    QueryMemo memo;
+    for (auto table : changedTables) {
+        std::transform(table.begin(), table.end(), table.begin(),
+            [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+        memo.changedTables.insert(std::move(table));
+    }
+    for (const auto &[key, observers] : snapshot) {
+        Notify(key, userId, *observers, metaData, -1, &memo);
     }
     SchedulerManager::GetInstance().Execute(
         uri, userId, metaData);
 }
 
-void RdbSubscriberManager::SetObserverNotifyOnEnabled(std::vector<ObserverNode> &nodes)
+void RdbSubscriberManager::SetObserverNotifyOnEnabled(Observers &nodes)
 {
-    for (auto &node : nodes) {
+    auto isUnmarked = [](const ObserverNode &node) { return !node.enabled && !node.isNotifyOnEnabled; };
+    if (std::none_of(nodes->begin(), nodes->end(), isUnmarked)) {
+        return;
+    }
+    auto marked = std::make_shared<std::vector<ObserverNode>>(*nodes);
+    for (auto &node : *marked) {
         if (!node.enabled) {
             node.isNotifyOnEnabled = true;
         }
     }
+    nodes = std::move(marked);
+}
+
+void RdbSubscriberManager::AddIndex(const Key &key)
+{
+    uriIndex_.Compute(key.uri, [&key](const std::string &uri, std::set<Key> &keys) {
+        keys.insert(key);
+        return true;
+    });
+}
+
+void RdbSubscriberManager::RemoveIndex(const Key &key)
+{
+    uriIndex_.ComputeIfPresent(key.uri, [&key](const std::string &uri, std::set<Key> &keys) {
+        keys.erase(key);
+        return !keys.empty();
+    });
+}
+
+// Copies the observers of the keys of the uri, and marks the disabled ones to be notified on enabled.
+RdbSubscriberManager::Snapshot RdbSubscriberManager::TakeSnapshot(const std::string &uri,
+    const std::function<bool(const Key &)> &filter)
+{
+    Snapshot snapshot;
+    for (const auto &key : GetKeysByUri(uri)) {
+        if (filter != nullptr && !filter(key)) {
+            continue;
+        }
+        rdbCache_.ComputeIfPresent(key, [&snapshot](const Key &key, Observers &nodes) {
+            snapshot.emplace_back(key, nodes);
+            SetObserverNotifyOnEnabled(nodes);
+            return true;
+        });
+    }
+    return snapshot;
 }
 
 std::vector<Key> RdbSubscriberManager::GetKeysByUri(const std::string &uri)
 {
     std::vector<Key> results;
-    rdbCache_.ForEach([&uri, &results](const Key &key, std::vector<ObserverNode> &val) {
-        if (key.uri != uri) {
-            return false;
-        }
-        results.emplace_back(key);
-        return false;
+    uriIndex_.ComputeIfPresent(uri, [&results](const std::string &uri, std::set<Key> &keys) {
+        results.reserve(keys.size());
+        results.insert(results.end(), keys.begin(), keys.end());
+        return true;
     });
     return results;
 }
@@ -338,14 +388,14 @@ void RdbSubscriberManager::EmitByKey(const Key &key, int32_t userId, const Distr
     if (!URIUtils::IsDataProxyURI(key.uri)) {
         return;
     }
-    std::vector<ObserverNode> observers;
-    rdbCache_.ComputeIfPresent(key, [&userId, &metaData, &observers, this](const Key &key, auto &val) {
-        observers.insert(observers.end(), val.begin(), val.end());
+    Observers observers;
+    rdbCache_.ComputeIfPresent(key, [&observers](const Key &key, Observers &val) {
+        observers = val;
         SetObserverNotifyOnEnabled(val);
         return true;
     });
-    if (!observers.empty()) {
-        Notify(key, userId, observers, metaData);
+    if (observers != nullptr && !observers->empty()) {
+        Notify(key, userId, *observers, metaData);
     }
 }
 
@@ -356,7 +406,7 @@ int RdbSubscriberManager::GetEnableObserverCount(const Key &key)
         return 0;
     }
     int count = 0;
-    for (const auto &observer : pair.second) {
+    for (const auto &observer : *pair.second) {
         if (observer.enabled) {
             count++;
         }
@@ -365,7 +415,7 @@ int RdbSubscriberManager::GetEnableObserverCount(const Key &key)
 }
 
 int RdbSubscriberManager::Notify(const Key &key, int32_t userId, const std::vector<ObserverNode> &val,
-    const DistributedData::StoreMetaData &metaData, int32_t accountId)
+    const DistributedData::StoreMetaData &metaData, int32_t accountId, QueryMemo *memo)
 {
     Template tpl;
     if (!TemplateManager::GetInstance().Get(key, userId, tpl)) {
@@ -385,12 +435,35 @@ int RdbSubscriberManager::Notify(const Key &key, int32_t userId, const std::vect
     changeNode.uri_ = key.uri;
     changeNode.templateId_.subscriberId_ = key.subscriberId;
     changeNode.templateId_.bundleName_ = key.bundleName;
+    std::string store = meta.dataDir + "/" + meta.storeId + "#" + meta.user + "#" + std::to_string(accountId);
+    // the node is serialized as [count; len, data; len, data; ...] into the shared memory of the notification,
+    // every predicate after the current one keeps the room to tell the observer its rows are incomplete
+    size_t incompleteSize = strlen(DBDelegate::INCOMPLETE_RESULT);
+    size_t remaining = static_cast<size_t>(DATA_SIZE_ASHMEM_TRANSFER_LIMIT) - sizeof(int32_t);
+    size_t reserved = 0;
     for (const auto &predicate : tpl.predicates_) {
-        std::string result = delegate->Query(predicate.selectSql_);
+        reserved += GetEntrySize(predicate.key_, incompleteSize);
+    }
+    for (const auto &predicate : tpl.predicates_) {
+        reserved -= GetEntrySize(predicate.key_, incompleteSize);
+        std::string result = QueryPredicate(*delegate, store, predicate.selectSql_, memo);
         if (result.empty()) {
             continue;
         }
-        changeNode.data_.emplace_back("{\"" + predicate.key_ + "\":" + result + "}");
+        if (GetEntrySize(predicate.key_, result.size()) + reserved > remaining) {
+            ZLOGW("rows exceed the notification, key:%{public}s, size:%{public}zu, remaining:%{public}zu",
+                predicate.key_.c_str(), result.size(), remaining);
+            result = DBDelegate::INCOMPLETE_RESULT;
+        }
+        auto entrySize = GetEntrySize(predicate.key_, result.size());
+        if (entrySize > remaining) {
+            continue;
+        }
+        remaining -= entrySize;
+        // one allocation for the wrapped result instead of a temporary per concatenation
+        auto &data = changeNode.data_.emplace_back();
+        data.reserve(predicate.key_.size() + result.size() + WRAPPER_SIZE);
+        data.append("{\"").append(predicate.key_).append("\":").append(result).push_back('}');
     }
     if (!tpl.update_.empty()) {
         auto [errCode, rowCount] = delegate->UpdateSql(tpl.update_);
@@ -398,6 +471,9 @@ int RdbSubscriberManager::Notify(const Key &key, int32_t userId, const std::vect
             ZLOGE("Update failed, err:%{public}d, %{public}s, %{public}" PRId64 ", %{public}s",
             errCode, URIUtils::Anonymous(key.uri).c_str(), key.subscriberId, key.bundleName.c_str());
         }
+        if (rowCount > 0) {
+            DropResults(store, memo);
+        }
     }
 
     ZLOGI("emit, valSize: %{public}zu, dataSize:%{public}zu, uri:%{public}s,",
@@ -416,9 +492,188 @@ int RdbSubscriberManager::Notify(const Key &key, int32_t userId, const std::vect
     return E_OK;
 }
 
+std::string RdbSubscriberManager::QueryPredicate(DBDelegate &delegate, const std::string &store,
+    const std::string &sql, QueryMemo *memo)
+{
+    if (memo != nullptr) {
+        auto it = memo->results.find({ store, sql });
+        if (it != memo->results.end()) {
+            memoized_++;
+            return it->second;
+        }
+    }
+    std::string result;
+    bool reused = false;
+    if (memo != nullptr && !memo->changedTables.empty()) {
+        if (IsUnaffected(delegate, store, sql, *memo)) {
+            auto now = std::chrono::steady_clock::now();
+            lastResults_.ComputeIfPresent(store, [&sql, &result, &reused, now](const std::string &store,
+                auto &results) {
+                auto it = results.find(sql);
+                if (it != results.end() && now - it->second.time < LAST_RESULT_TTL) {
+                    result = it->second.value;
+                    reused = true;
+                }
+                return true;
+            });
+        }
+    }
+    if (reused) {
+        reused_++;
+    } else {
+        auto seq = ++querySeq_;
+        auto time = std::chrono::steady_clock::now();
+        result = delegate.Query(sql);
+        executed_++;
+        lastResults_.Compute(store, [seq, time, &sql, &result](const std::string &store, auto &results) {
+            auto it = results.find(sql);
+            if (it != results.end() && it->second.seq > seq) {
+                return true;
+            }
+            if (result.empty()) {
+                results.erase(sql);
+                return !results.empty();
+            }
+            if (it == results.end() && results.size() >= MAX_LAST_RESULTS) {
+                results.clear();
+            }
+            results.insert_or_assign(sql, LastResult{ seq, time, result });
+            return true;
+        });
+    }
+    if (memo != nullptr) {
+        memo->results.emplace(std::make_pair(store, sql), result);
+    }
+    return result;
+}
+
+// Whether the predicate reads only base tables that are not changed. A view or a trigger may carry the change
+// to a table the predicate names, so they are never proven unaffected.
+bool RdbSubscriberManager::IsUnaffected(DBDelegate &delegate, const std::string &store, const std::string &sql,
+    QueryMemo &memo)
+{
+    auto [parsed, tables] = ParseTables(sql);
+    if (!parsed || tables.empty()) {
+        return false;
+    }
+    auto it = memo.baseTables.find(store);
+    if (it == memo.baseTables.end()) {
+        it = memo.baseTables.emplace(store, std::set<std::string>()).first;
+        auto resultSet = delegate.QuerySql("SELECT name FROM sqlite_master WHERE type = 'table' AND NOT EXISTS "
+            "(SELECT 1 FROM sqlite_master WHERE type = 'trigger')");
+        while (resultSet != nullptr && resultSet->GoToNextRow() == NativeRdb::E_OK) {
+            std::string name;
+            if (resultSet->GetString(0, name) != NativeRdb::E_OK) {
+                it->second.clear();
+                break;
+            }
+            std::transform(name.begin(), name.end(), name.begin(),
+                [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            it->second.insert(std::move(name));
+        }
+        if (resultSet != nullptr) {
+            resultSet->Close();
+        }
+    }
+    auto &base = it->second;
+    auto &changed = memo.changedTables;
+    return std::all_of(tables.begin(), tables.end(), [&base, &changed](const std::string &table) {
+        return base.count(table) != 0 && changed.count(table) == 0;
+    });
+}
+
+// Forgets the results of the store after a template updated it.
+void RdbSubscriberManager::DropResults(const std::string &store, QueryMemo *memo)
+{
+    lastResults_.Erase(store);
+    if (memo == nullptr) {
+        return;
+    }
+    for (auto it = memo->results.begin(); it != memo->results.end();) {
+        it = it->first.first == store ? memo->results.erase(it) : std::next(it);
+    }
+}
+
+// The tables read after FROM and JOIN in lower case. It fails on sql it can not see through, such as
+// a cte, a subquery in FROM or a quoted name with spaces, so the predicate is always evaluated.
+std::pair<bool, std::set<std::string>> RdbSubscriberManager::ParseTables(const std::string &sql)
+{
+    std::vector<std::string> tokens;
+    std::string token;
+    for (char ch : sql) {
+        bool isPunct = ch == ',' || ch == '(' || ch == ')' || ch == ';';
+        if (!isPunct && !std::isspace(static_cast<unsigned char>(ch))) {
+            token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+            continue;
+        }
+        if (!token.empty()) {
+            tokens.push_back(std::move(token));
+            token.clear();
+        }
+        if (isPunct) {
+            tokens.emplace_back(1, ch);
+        }
+    }
+    if (!token.empty()) {
+        tokens.push_back(std::move(token));
+    }
+    static const std::set<std::string> clauses = { "where", "join", "inner", "left", "right", "full", "cross",
+        "outer", "natural", "on", "using", "group", "order", "limit", "union", "except", "intersect", "having",
+        "window", "indexed", "not", ",", "(", ")", ";" };
+    std::set<std::string> tables;
+    if (tokens.empty() || tokens[0] == "with") {
+        return { false, tables };
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i] != "from" && tokens[i] != "join") {
+            continue;
+        }
+        while (true) {
+            if (++i >= tokens.size() || clauses.count(tokens[i]) != 0) {
+                return { false, {} };
+            }
+            std::string table = tokens[i];
+            auto dot = table.rfind('.');
+            if (dot != std::string::npos) {
+                table = table.substr(dot + 1);
+            }
+            if (table.front() == '"' || table.front() == '`' || table.front() == '[') {
+                char close = table.front() == '[' ? ']' : table.front();
+                if (table.size() < 2 || table.back() != close) {
+                    return { false, {} };
+                }
+                table = table.substr(1, table.size() - 2);
+            }
+            tables.insert(std::move(table));
+            if (i + 1 < tokens.size() && tokens[i + 1] == "as") {
+                i += 2;
+            } else if (i + 1 < tokens.size() && clauses.count(tokens[i + 1]) == 0) {
+                i++;
+            }
+            // more tables listed after a comma
+            if (i + 1 >= tokens.size() || tokens[i + 1] != ",") {
+                break;
+            }
+            i++;
+        }
+    }
+    return { !tables.empty(), tables };
+}
+
+RdbSubscriberManager::QueryStats RdbSubscriberManager::GetQueryStats() const
+{
+    QueryStats stats;
+    stats.executed = executed_;
+    stats.memoized = memoized_;
+    stats.reused = reused_;
+    return stats;
+}
+
 void RdbSubscriberManager::Clear()
 {
     rdbCache_.Clear();
+    uriIndex_.Clear();
+    lastResults_.Clear();
 }
 
 void RdbSubscriberManager::Emit(const std::string &uri, int64_t subscriberId,
@@ -432,18 +687,10 @@ void RdbSubscriberManager::Emit(const std::string &uri, int64_t subscriberId,
         loadDataInfo(context);
     }
     DistributedData::StoreMetaData metaData = RdbSubscriberManager::GenMetaDataFromContext(context);
-    std::map<Key, std::vector<ObserverNode>> obsMap;
-    rdbCache_.ForEach([&uri, &context, &subscriberId, &metaData, &obsMap, this](const Key &key,
-        std::vector<ObserverNode> &val) {
-        if (key.uri != uri || key.subscriberId != subscriberId) {
-            return false;
-        }
-        obsMap.emplace(key, val);
-        SetObserverNotifyOnEnabled(val);
-        return false;
-    });
-    for (const auto &observers : obsMap) {
-        Notify(observers.first, context->visitedUserId, observers.second, metaData, context->accountId);
+    auto snapshot = TakeSnapshot(uri, [subscriberId](const Key &key) { return key.subscriberId == subscriberId; });
+    QueryMemo memo;
+    for (const auto &[key, observers] : snapshot) {
+        Notify(key, context->visitedUserId, *observers, metaData, context->accountId, &memo);
     }
     Key executeKey(uri, subscriberId, bundleName);
     SchedulerManager::GetInstance().Start(executeKey, context->visitedUserId, metaData);
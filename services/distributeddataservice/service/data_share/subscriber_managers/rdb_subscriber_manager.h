@@ -16,14 +16,22 @@
 #ifndef DATASHARESERVICE_RDB_SUBSCRIBER_MANAGER_H
 #define DATASHARESERVICE_RDB_SUBSCRIBER_MANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <list>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "concurrent_map.h"
 #include "context.h"
 #include "data_provider_config.h"
 #include "data_proxy_observer.h"
 #include "data_share_db_config.h"
+#include "db_delegate.h"
 #include "datashare_template.h"
 #include "executor_pool.h"
 
@@ -54,6 +62,13 @@ private:
 
 class RdbSubscriberManager {
 public:
+    struct QueryStats {
+        uint64_t executed = 0;
+        // served by an earlier subscriber of the same emit
+        uint64_t memoized = 0;
+        // kept from an earlier emit as none of the tables of the predicate changed
+        uint64_t reused = 0;
+    };
     static RdbSubscriberManager &GetInstance();
     int Add(const Key &key, const sptr<IDataProxyRdbObserver> observer, std::shared_ptr<Context> context,
         std::shared_ptr<ExecutorPool> executorPool, bool enabled = true);
@@ -64,10 +79,14 @@ public:
     void Emit(const std::string &uri, int64_t subscriberId, const std::string &bundleName,
         std::shared_ptr<Context> context);
     void Emit(const std::string &uri, std::shared_ptr<Context> context);
-    void Emit(const std::string &uri, int32_t userId, DistributedData::StoreMetaData &metaData);
+    // The predicates reading only base tables other than the changedTables keep their last results, empty means
+    // all may change. A view, or any table of a store with triggers, is always taken as changed.
+    void Emit(const std::string &uri, int32_t userId, DistributedData::StoreMetaData &metaData,
+        const std::set<std::string> &changedTables = {});
     void EmitByKey(const Key &key, int32_t userId, const DistributedData::StoreMetaData &metaData);
     DistributedData::StoreMetaData GenMetaDataFromContext(const std::shared_ptr<Context> context);
     std::vector<Key> GetKeysByUri(const std::string &uri);
+    QueryStats GetQueryStats() const;
     void Clear();
 
 private:
@@ -83,12 +102,48 @@ private:
         int32_t userId = 0;
     };
 
+    // The nodes of a key are never changed in place, so Emit notifies a snapshot without holding the lock.
+    using Observers = std::shared_ptr<const std::vector<ObserverNode>>;
+    using Snapshot = std::vector<std::pair<Key, Observers>>;
+    // The predicate results of one emit, shared by all the subscribers it notifies.
+    struct QueryMemo {
+        std::set<std::string> changedTables;
+        std::map<std::pair<std::string, std::string>, std::string> results;
+        // store -> its tables, none when a trigger may write one table on a change of another
+        std::map<std::string, std::set<std::string>> baseTables;
+    };
+    // The result of the last evaluation of a predicate, a later query never loses to an earlier one.
+    struct LastResult {
+        uint64_t seq = 0;
+        std::chrono::steady_clock::time_point time;
+        std::string value;
+    };
+    static constexpr size_t MAX_LAST_RESULTS = 64;
+    // the provider may write its store without a notification, so a last result is reused only briefly.
+    static constexpr std::chrono::seconds LAST_RESULT_TTL = std::chrono::seconds(3);
+
     RdbSubscriberManager() = default;
-    ConcurrentMap<Key, std::vector<ObserverNode>> rdbCache_;
-    int Notify(const Key &key, int32_t userId,
-        const std::vector<ObserverNode> &val, const DistributedData::StoreMetaData &metaData, int32_t accountId = -1);
+    ConcurrentMap<Key, Observers> rdbCache_;
+    // the keys of rdbCache_ grouped by uri, Emit looks them up instead of walking every subscription
+    ConcurrentMap<std::string, std::set<Key>> uriIndex_;
+    // store -> sql -> the last result
+    ConcurrentMap<std::string, std::map<std::string, LastResult>> lastResults_;
+    std::atomic<uint64_t> querySeq_ = 0;
+    std::atomic<uint64_t> executed_ = 0;
+    std::atomic<uint64_t> memoized_ = 0;
+    std::atomic<uint64_t> reused_ = 0;
+    int Notify(const Key &key, int32_t userId, const std::vector<ObserverNode> &val,
+        const DistributedData::StoreMetaData &metaData, int32_t accountId = -1, QueryMemo *memo = nullptr);
+    std::string QueryPredicate(DBDelegate &delegate, const std::string &store, const std::string &sql,
+        QueryMemo *memo);
+    bool IsUnaffected(DBDelegate &delegate, const std::string &store, const std::string &sql, QueryMemo &memo);
+    void DropResults(const std::string &store, QueryMemo *memo);
+    static std::pair<bool, std::set<std::string>> ParseTables(const std::string &sql);
     int GetEnableObserverCount(const Key &key);
-    void SetObserverNotifyOnEnabled(std::vector<ObserverNode> &nodes);
+    static void SetObserverNotifyOnEnabled(Observers &nodes);
+    void AddIndex(const Key &key);
+    void RemoveIndex(const Key &key);
+    Snapshot TakeSnapshot(const std::string &uri, const std::function<bool(const Key &)> &filter = nullptr);
 };
 } // namespace OHOS::DataShare
 #endif // DATASHARESERVICE_RDB_SUBSCRIBER_MANAGER_H
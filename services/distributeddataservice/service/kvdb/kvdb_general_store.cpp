@@ -12,6 +12,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <chrono>
 #include <memory>
 #define LOG_TAG "KVDBGeneralStore"
 #include "kvdb_general_store.h"
@@ -53,9 +54,11 @@ using DBSchema = DistributedDB::DataBaseSchema;
 using ClearMode = DistributedDB::ClearMode;
 using DMAdapter = DistributedData::DeviceManagerAdapter;
 using DBInterceptedData = DistributedDB::InterceptedData;
+using DBEntry = DistributedDB::KVEntry;
 using ChangeOp = DistributedData::GeneralWatcher::ChangeOp;
 static constexpr const char *FT_CLOUD_SYNC = "CLOUD_SYNC";
 constexpr int UUID_WIDTH = 4;
+constexpr int64_t SLOW_INTERCEPT_COST = 100;
 const std::map<DBStatus, KVDBGeneralStore::GenErr> KVDBGeneralStore::dbStatusMap_ = {
     { DBStatus::OK, GenErr::E_OK },
     { DBStatus::CLOUD_NETWORK_ERROR, GenErr::E_NETWORK_ERROR },
@@ -918,19 +921,10 @@ void KVDBGeneralStore::SetDBPushDataInterceptor(int32_t storeType)
                 ZLOGE("targetID empty");
                 return static_cast<int>(DBStatus::DB_ERROR);
             }
+            auto start = std::chrono::steady_clock::now();
             auto entries = data.GetEntries();
-            for (size_t i = 0; i < entries.size(); i++) {
-                if (entries[i].key.empty()) {
-                    continue;
-                }
-                auto oriKey = entries[i].key;
-                auto newKey = GetNewKey(oriKey, sourceID);
-                errCode = data.ModifyKey(i, newKey);
-                if (errCode != DBStatus::OK) {
-                    ZLOGE("ModifyKey err: %{public}d", errCode);
-                    break;
-                }
-            }
+            errCode = ModifyKeys(data, entries, sourceID);
+            ReportInterceptCost("push", entries.size(), start);
             return errCode;
         });
 }
@@ -947,45 +941,95 @@ void KVDBGeneralStore::SetDBReceiveDataInterceptor(int32_t storeType)
                 ZLOGE("sourceID empty");
                 return static_cast<int>(DBStatus::DB_ERROR);
             }
+            auto start = std::chrono::steady_clock::now();
             auto entries = data.GetEntries();
-            for (size_t i = 0; i < entries.size(); i++) {
-                if (entries[i].key.empty()) {
-                    continue;
-                }
-
-                auto networkId = DMAdapter::GetInstance().ToNetworkID(sourceID);
-                auto encyptedUuid = DMAdapter::GetInstance().GetEncryptedUuidByNetworkId(networkId);
-                if (encyptedUuid.empty()) {
-                    ZLOGE("get encyptedUuid failed");
-                    continue;
-                }
-
-                auto oriKey = entries[i].key;
-                auto newKey = GetNewKey(oriKey, encyptedUuid);
-                errCode = data.ModifyKey(i, newKey);
-                if (errCode != DBStatus::OK) {
-                    ZLOGE("ModifyKey err: %{public}d", errCode);
-                    break;
-                }
+            if (entries.empty()) {
+                return errCode;
+            }
+            // every entry of a batch comes from the same device, resolve its identity once
+            auto encyptedUuid = GetEncryptedUuid(sourceID);
+            if (encyptedUuid.empty()) {
+                ZLOGE("get encyptedUuid failed, size:%{public}zu", entries.size());
+                return errCode;
             }
+            errCode = ModifyKeys(data, entries, encyptedUuid);
+            ReportInterceptCost("receive", entries.size(), start);
             return errCode;
         });
 }
 
-std::vector<uint8_t> KVDBGeneralStore::GetNewKey(std::vector<uint8_t> &key, const std::string &uuid)
+std::string KVDBGeneralStore::GetEncryptedUuid(const std::string &sourceID)
 {
-    uint32_t remoteLen = *(reinterpret_cast<uint32_t *>(&(*(key.end() - sizeof(uint32_t)))));
-    remoteLen = le32toh(remoteLen);
-    uint32_t uuidLen = uuid.size();
+    // the network id changes when the device reconnects, so it keys the cache and stale entries age out
+    auto networkId = DMAdapter::GetInstance().ToNetworkID(sourceID);
+    if (networkId.empty()) {
+        return "";
+    }
+    std::string encyptedUuid;
+    if (encryptedUuids_.Get(networkId, encyptedUuid)) {
+        return encyptedUuid;
+    }
+    encyptedUuid = DMAdapter::GetInstance().GetEncryptedUuidByNetworkId(networkId);
+    if (!encyptedUuid.empty()) {
+        encryptedUuids_.Set(networkId, encyptedUuid);
+    }
+    return encyptedUuid;
+}
 
-    std::vector<uint8_t> out;
-    std::vector<uint8_t> oriKey(key.begin() + remoteLen, key.end() - UUID_WIDTH);
+int KVDBGeneralStore::ModifyKeys(DBInterceptedData &data, const std::vector<DBEntry> &entries,
+    const std::string &uuid)
+{
+    int errCode = DBStatus::OK;
+    std::vector<uint8_t> newKey;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].key.empty()) {
+            continue;
+        }
+        if (!GetNewKey(entries[i].key, uuid, newKey)) {
+            ZLOGW("invalid key, index:%{public}zu size:%{public}zu", i, entries[i].key.size());
+            continue;
+        }
+        errCode = data.ModifyKey(i, newKey);
+        if (errCode != DBStatus::OK) {
+            ZLOGE("ModifyKey err: %{public}d", errCode);
+            break;
+        }
+    }
+    return errCode;
+}
+
+void KVDBGeneralStore::ReportInterceptCost(const char *type, size_t size, std::chrono::steady_clock::time_point start)
+{
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    if (cost.count() >= SLOW_INTERCEPT_COST) {
+        ZLOGW("%{public}s intercept slow, size:%{public}zu cost:%{public}lldms", type, size,
+            static_cast<long long>(cost.count()));
+        return;
+    }
+    ZLOGD("%{public}s intercept size:%{public}zu cost:%{public}lldms", type, size,
+        static_cast<long long>(cost.count()));
+}
+
+bool KVDBGeneralStore::GetNewKey(const std::vector<uint8_t> &key, const std::string &uuid, std::vector<uint8_t> &out)
+{
+    if (key.size() < UUID_WIDTH) {
+        return false;
+    }
+    uint32_t remoteLen = 0;
+    std::copy(key.end() - UUID_WIDTH, key.end(), reinterpret_cast<uint8_t *>(&remoteLen));
+    remoteLen = le32toh(remoteLen);
+    if (remoteLen > key.size() - UUID_WIDTH) {
+        return false;
+    }
+    uint32_t uuidLen = htole32(static_cast<uint32_t>(uuid.size()));
+    const uint8_t *buf = reinterpret_cast<const uint8_t *>(&uuidLen);
+    // keep the capacity of out, it is reused by every entry of the batch
+    out.clear();
+    out.reserve(uuid.size() + key.size() - remoteLen);
     out.insert(out.end(), uuid.begin(), uuid.end());
-    out.insert(out.end(), oriKey.begin(), oriKey.end());
-    uuidLen = htole32(uuidLen);
-    uint8_t *buf = reinterpret_cast<uint8_t *>(&uuidLen);
+    out.insert(out.end(), key.begin() + remoteLen, key.end() - UUID_WIDTH);
     out.insert(out.end(), buf, buf + sizeof(uuidLen));
-    return out;
+    return true;
 }
 
 int32_t KVDBGeneralStore::SetConfig(const GeneralStore::StoreConfig &storeConfig)
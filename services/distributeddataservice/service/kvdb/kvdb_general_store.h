@@ -17,6 +17,7 @@
 #define OHOS_DISTRIBUTED_DATA_DATAMGR_SERVICE_KVDB_GENERAL_STORE_H
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <shared_mutex>
@@ -26,6 +27,7 @@
 #include "kv_store_nb_delegate.h"
 #include "kvstore_sync_callback.h"
 #include "kvstore_sync_manager.h"
+#include "lru_bucket.h"
 #include "metadata/store_meta_data.h"
 #include "store/general_store.h"
 #include "store/general_value.h"
@@ -109,7 +111,11 @@ private:
     static GenErr ConvertStatus(DBStatus status);
     void SetDBPushDataInterceptor(int32_t storeType);
     void SetDBReceiveDataInterceptor(int32_t storeType);
-    std::vector<uint8_t> GetNewKey(std::vector<uint8_t> &key, const std::string &uuid);
+    std::string GetEncryptedUuid(const std::string &sourceID);
+    static int ModifyKeys(DistributedDB::InterceptedData &data, const std::vector<DistributedDB::KVEntry> &entries,
+        const std::string &uuid);
+    static void ReportInterceptCost(const char *type, size_t size, std::chrono::steady_clock::time_point start);
+    static bool GetNewKey(const std::vector<uint8_t> &key, const std::string &uuid, std::vector<uint8_t> &out);
     DBSyncCallback GetDBSyncCompleteCB(DetailAsync async);
     DBProcessCB GetDBProcessCB(DetailAsync async);
     DBStatus CloudSync(const Devices &devices, DistributedDB::SyncMode cloudSyncMode, DetailAsync async, int64_t wait,
@@ -151,6 +157,7 @@ private:
     static int32_t CheckBindInfos(const std::map<uint32_t, std::tuple<Database, BindInfo, std::string>> &bindInfos);
 
     static constexpr uint8_t META_COMPRESS_RATE = 10;
+    static constexpr size_t IDENTITY_CACHE_SIZE = 16;
     const std::shared_ptr<ObserverProxy> observer_;
     KvManager manager_;
     KvDelegate *delegate_ = nullptr;
@@ -169,6 +176,8 @@ private:
     bool isPublic_ = false;
     static const std::map<DBStatus, GenErr> dbStatusMap_;
     std::atomic<bool> isCacheWatcher_ = false;
+    // networkId -> encrypted uuid of the remote devices seen by the receive interceptor
+    LRUBucket<std::string, std::string> encryptedUuids_ { IDENTITY_CACHE_SIZE };
 };
 } // namespace OHOS::DistributedKv
 #endif // OHOS_DISTRIBUTED_DATA_DATAMGR_SERVICE_KVDB_GENERAL_STORE_H
\ No newline at end of file
@@ -14,7 +14,6 @@
  */
 #define LOG_TAG "QueryHelper"
 #include "query_helper.h"
-#include <regex>
 #include <sstream>
 #include "data_query.h"
 #include "device_manager_adapter.h"
@@ -29,8 +28,8 @@ constexpr int MAX_QUERY_LENGTH = 5 * 1024; // Max query string length 5k
 constexpr int MAX_QUERY_COMPLEXITY = 500;  // Max query complexity 500
 constexpr int QUERY_WORD_INDEX = 3;
 constexpr int QUERY_WORD_LEN = 4;
-bool QueryHelper::hasPrefixKey_ = false;
-std::string QueryHelper::deviceId_;
+constexpr size_t QUERY_CACHE_SIZE = 64;
+LRUBucket<std::string, std::shared_ptr<const DistributedDB::Query>> QueryHelper::queries_ { QUERY_CACHE_SIZE };
 const char * const EQUAL_TO = "^EQUAL";
 const char * const NOT_EQUAL_TO = "^NOT_EQUAL";
 const char * const GREATER_THAN = "^GREATER";
@@ -85,118 +84,147 @@ DistributedDB::Query QueryHelper::StringToDbQuery(const std::string &query, bool
         isSuccess = false;
         return dbQuery;
     }
-    deviceId_.clear();
-    hasPrefixKey_ = (query.find(KEY_PREFIX) != std::string::npos);
-    size_t pos = query.find_first_not_of(SPACE);
-    std::string inputTrim = (pos == std::string::npos) ? "" : query.substr(pos);
-    std::regex regex(" ");
-    // regex split string by space
-    std::vector<std::string> words(std::sregex_token_iterator(inputTrim.begin(), inputTrim.end(), regex, -1),
-        std::sregex_token_iterator());
+    std::shared_ptr<const DBQuery> compiled;
+    if (queries_.Get(query, compiled) && compiled != nullptr) {
+        isSuccess = true;
+        return *compiled;
+    }
+    return Compile(query, isSuccess);
+}
 
+DistributedDB::Query QueryHelper::Compile(const std::string &query, bool &isSuccess)
+{
+    ParseResult result;
+    result.hasPrefixKey = (query.find(KEY_PREFIX) != std::string::npos);
+    Words words = Split(query);
     if (words.empty()) {
         ZLOGE("not enough params.");
-        return dbQuery;
+        return result.query;
     }
     int pointer = 0;            // Read pointer starts at 0
     int end = words.size() - 1; // Read pointer ends at size - 1
     // Counts how many keywords has been handled
     for (int count = 0; pointer <= end && count <= MAX_QUERY_COMPLEXITY; ++count) {
-        std::string keyword = words.at(pointer);
+        std::string_view keyword = words.at(pointer);
         if (keyword == EQUAL_TO) {
-            isSuccess = HandleEqualTo(words, pointer, end, dbQuery);
+            isSuccess = HandleEqualTo(words, pointer, end, result);
         } else if (keyword == NOT_EQUAL_TO) {
-            isSuccess = HandleNotEqualTo(words, pointer, end, dbQuery);
+            isSuccess = HandleNotEqualTo(words, pointer, end, result);
         } else if (keyword == GREATER_THAN) {
-            isSuccess = HandleGreaterThan(words, pointer, end, dbQuery);
+            isSuccess = HandleGreaterThan(words, pointer, end, result);
         } else if (keyword == LESS_THAN) {
-            isSuccess = HandleLessThan(words, pointer, end, dbQuery);
+            isSuccess = HandleLessThan(words, pointer, end, result);
         } else if (keyword == GREATER_THAN_OR_EQUAL_TO) {
-            isSuccess = HandleGreaterThanOrEqualTo(words, pointer, end, dbQuery);
+            isSuccess = HandleGreaterThanOrEqualTo(words, pointer, end, result);
         } else if (keyword == LESS_THAN_OR_EQUAL_TO) {
-            isSuccess = HandleLessThanOrEqualTo(words, pointer, end, dbQuery);
+            isSuccess = HandleLessThanOrEqualTo(words, pointer, end, result);
         } else {
-            isSuccess = Handle(words, pointer, end, dbQuery);
+            isSuccess = Handle(words, pointer, end, result);
         }
         if (!isSuccess) {
             ZLOGE("Invalid params.");
             return DBQuery::Select();
         }
     }
-    return dbQuery;
+    // the device id is resolved to the uuid of the moment, so it must be parsed again every time.
+    if (isSuccess && query.find(DEVICE_ID) == std::string::npos) {
+        queries_.Set(query, std::make_shared<const DBQuery>(result.query));
+    }
+    return result.query;
+}
+
+QueryHelper::Words QueryHelper::Split(std::string_view query)
+{
+    Words words;
+    size_t begin = query.find_first_not_of(SPACE);
+    if (begin == std::string_view::npos) {
+        return words;
+    }
+    // the same split as the regex one, an empty word between two spaces is kept but the trailing one is not.
+    while (true) {
+        size_t pos = query.find(SPACE, begin);
+        if (pos == std::string_view::npos) {
+            if (begin < query.size()) {
+                words.push_back(query.substr(begin));
+            }
+            return words;
+        }
+        words.push_back(query.substr(begin, pos - begin));
+        begin = pos + 1;
+    }
 }
 
-bool QueryHelper::Handle(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::Handle(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    std::string keyword = words.at(pointer);
+    std::string_view keyword = words.at(pointer);
     if (keyword == IS_NULL) {
-        return HandleIsNull(words, pointer, end, dbQuery);
+        return HandleIsNull(words, pointer, end, result);
     } else if (keyword == IN) {
-        return HandleIn(words, pointer, end, dbQuery);
+        return HandleIn(words, pointer, end, result);
     } else if (keyword == NOT_IN) {
-        return HandleNotIn(words, pointer, end, dbQuery);
+        return HandleNotIn(words, pointer, end, result);
     } else if (keyword == LIKE) {
-        return HandleLike(words, pointer, end, dbQuery);
+        return HandleLike(words, pointer, end, result);
     } else if (keyword == NOT_LIKE) {
-        return HandleNotLike(words, pointer, end, dbQuery);
+        return HandleNotLike(words, pointer, end, result);
     } else if (keyword == AND) {
-        return HandleAnd(words, pointer, end, dbQuery);
+        return HandleAnd(words, pointer, end, result);
     } else if (keyword == OR) {
-        return HandleOr(words, pointer, end, dbQuery);
+        return HandleOr(words, pointer, end, result);
     } else if (keyword == ORDER_BY_ASC) {
-        return HandleOrderByAsc(words, pointer, end, dbQuery);
+        return HandleOrderByAsc(words, pointer, end, result);
     } else if (keyword == ORDER_BY_DESC) {
-        return HandleOrderByDesc(words, pointer, end, dbQuery);
+        return HandleOrderByDesc(words, pointer, end, result);
     } else if (keyword == ORDER_BY_WRITE_TIME) {
-        return HandleOrderByWriteTime(words, pointer, end, dbQuery);
+        return HandleOrderByWriteTime(words, pointer, end, result);
     } else if (keyword == LIMIT) {
-        return HandleLimit(words, pointer, end, dbQuery);
+        return HandleLimit(words, pointer, end, result);
     } else {
-        return HandleExtra(words, pointer, end, dbQuery);
+        return HandleExtra(words, pointer, end, result);
     }
 }
 
-bool QueryHelper::HandleExtra(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleExtra(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    std::string keyword = words.at(pointer);
+    std::string_view keyword = words.at(pointer);
     if (keyword == BEGIN_GROUP) {
-        return HandleBeginGroup(words, pointer, end, dbQuery);
+        return HandleBeginGroup(words, pointer, end, result);
     } else if (keyword == END_GROUP) {
-        return HandleEndGroup(words, pointer, end, dbQuery);
+        return HandleEndGroup(words, pointer, end, result);
     } else if (keyword == KEY_PREFIX) {
-        return HandleKeyPrefix(words, pointer, end, dbQuery);
+        return HandleKeyPrefix(words, pointer, end, result);
     } else if (keyword == IS_NOT_NULL) {
-        return HandleIsNotNull(words, pointer, end, dbQuery);
+        return HandleIsNotNull(words, pointer, end, result);
     } else if (keyword == DEVICE_ID) {
-        return HandleDeviceId(words, pointer, end, dbQuery);
+        return HandleDeviceId(words, pointer, end, result);
     } else if (keyword == SUGGEST_INDEX) {
-        return HandleSetSuggestIndex(words, pointer, end, dbQuery);
+        return HandleSetSuggestIndex(words, pointer, end, result);
     } else if (keyword == IN_KEYS) {
-        return HandleInKeys(words, pointer, end, dbQuery);
+        return HandleInKeys(words, pointer, end, result);
     }
     ZLOGE("Invalid keyword.");
     return false;
 }
 
-bool QueryHelper::HandleEqualTo(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleEqualTo(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("EqualTo not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.EqualTo(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.EqualTo(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.EqualTo(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.EqualTo(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.EqualTo(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.EqualTo(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_BOOLEAN) {
-        dbQuery.EqualTo(StringToString(fieldName), StringToBoolean(fieldValue));
+        result.query.EqualTo(StringToString(fieldName), StringToBoolean(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.EqualTo(StringToString(fieldName), StringToString(fieldValue));
+        result.query.EqualTo(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("EqualTo wrong type.");
         return false;
@@ -205,25 +233,25 @@ bool QueryHelper::HandleEqualTo(const std::vector<std::string> &words, int &poin
     return true;
 }
 
-bool QueryHelper::HandleNotEqualTo(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleNotEqualTo(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("NotEqualTo not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.NotEqualTo(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.NotEqualTo(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.NotEqualTo(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.NotEqualTo(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.NotEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.NotEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_BOOLEAN) {
-        dbQuery.NotEqualTo(StringToString(fieldName), StringToBoolean(fieldValue));
+        result.query.NotEqualTo(StringToString(fieldName), StringToBoolean(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.NotEqualTo(StringToString(fieldName), StringToString(fieldValue));
+        result.query.NotEqualTo(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("NotEqualTo wrong type.");
         return false;
@@ -232,23 +260,23 @@ bool QueryHelper::HandleNotEqualTo(const std::vector<std::string> &words, int &p
     return true;
 }
 
-bool QueryHelper::HandleGreaterThan(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleGreaterThan(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("GreaterThan not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.GreaterThan(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.GreaterThan(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.GreaterThan(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.GreaterThan(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.GreaterThan(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.GreaterThan(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.GreaterThan(StringToString(fieldName), StringToString(fieldValue));
+        result.query.GreaterThan(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("GreaterThan wrong type.");
         return false;
@@ -257,23 +285,23 @@ bool QueryHelper::HandleGreaterThan(const std::vector<std::string> &words, int &
     return true;
 }
 
-bool QueryHelper::HandleLessThan(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleLessThan(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("LessThan not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.LessThan(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.LessThan(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.LessThan(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.LessThan(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.LessThan(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.LessThan(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.LessThan(StringToString(fieldName), StringToString(fieldValue));
+        result.query.LessThan(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("LessThan wrong type.");
         return false;
@@ -283,23 +311,23 @@ bool QueryHelper::HandleLessThan(const std::vector<std::string> &words, int &poi
 }
 
 bool QueryHelper::HandleGreaterThanOrEqualTo(
-    const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+    const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("GreaterThanOrEqualTo not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.GreaterThanOrEqualTo(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.GreaterThanOrEqualTo(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.GreaterThanOrEqualTo(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.GreaterThanOrEqualTo(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.GreaterThanOrEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.GreaterThanOrEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.GreaterThanOrEqualTo(StringToString(fieldName), StringToString(fieldValue));
+        result.query.GreaterThanOrEqualTo(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("GreaterThanOrEqualTo wrong type.");
         return false;
@@ -309,23 +337,23 @@ bool QueryHelper::HandleGreaterThanOrEqualTo(
 }
 
 bool QueryHelper::HandleLessThanOrEqualTo(
-    const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+    const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 3 > end) { // This keyword has 3 following params
         ZLOGE("LessThanOrEqualTo not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1);  // fieldType
-    const std::string &fieldName = words.at(pointer + 2);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 3); // fieldValue
+    std::string_view fieldType = words.at(pointer + 1);  // fieldType
+    std::string_view fieldName = words.at(pointer + 2);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 3); // fieldValue
     if (fieldType == TYPE_INTEGER) {
-        dbQuery.LessThanOrEqualTo(StringToString(fieldName), StringToInt(fieldValue));
+        result.query.LessThanOrEqualTo(StringToString(fieldName), StringToInt(fieldValue));
     } else if (fieldType == TYPE_LONG) {
-        dbQuery.LessThanOrEqualTo(StringToString(fieldName), StringToLong(fieldValue));
+        result.query.LessThanOrEqualTo(StringToString(fieldName), StringToLong(fieldValue));
     } else if (fieldType == TYPE_DOUBLE) {
-        dbQuery.LessThanOrEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
+        result.query.LessThanOrEqualTo(StringToString(fieldName), StringToDouble(fieldValue));
     } else if (fieldType == TYPE_STRING) {
-        dbQuery.LessThanOrEqualTo(StringToString(fieldName), StringToString(fieldValue));
+        result.query.LessThanOrEqualTo(StringToString(fieldName), StringToString(fieldValue));
     } else {
         ZLOGE("LessThanOrEqualTo wrong type.");
         return false;
@@ -334,31 +362,31 @@ bool QueryHelper::HandleLessThanOrEqualTo(
     return true;
 }
 
-bool QueryHelper::HandleIsNull(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleIsNull(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("IsNull not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1); // fieldName
-    dbQuery.IsNull(StringToString(fieldName));
+    std::string_view fieldName = words.at(pointer + 1); // fieldName
+    result.query.IsNull(StringToString(fieldName));
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleIsNotNull(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleIsNotNull(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("IsNotNull not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1); // fieldName
-    dbQuery.IsNotNull(StringToString(fieldName));
+    std::string_view fieldName = words.at(pointer + 1); // fieldName
+    result.query.IsNotNull(StringToString(fieldName));
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleIn(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleIn(const Words &words, int &pointer, int end, ParseResult &result)
 {
     //       | <-------------------------4---------------------------->|
     // words [ IN, fieldType, fieldName, START_IN, ...valueList, END_IN ]
@@ -371,21 +399,21 @@ bool QueryHelper::HandleIn(const std::vector<std::string> &words, int &pointer,
         ZLOGE("In not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1); // fieldType
-    const std::string &fieldName = words.at(pointer + 2); // fieldName
+    std::string_view fieldType = words.at(pointer + 1); // fieldType
+    std::string_view fieldName = words.at(pointer + 2); // fieldName
     int elementPointer = pointer + 4;                     // first fieldValue, or END if list is empty
     if (fieldType == TYPE_INTEGER) {
         const std::vector<int> intValueList = GetIntegerList(words, elementPointer, end);
-        dbQuery.In(StringToString(fieldName), intValueList);
+        result.query.In(StringToString(fieldName), intValueList);
     } else if (fieldType == TYPE_LONG) {
         const std::vector<int64_t> longValueList = GetLongList(words, elementPointer, end);
-        dbQuery.In(StringToString(fieldName), longValueList);
+        result.query.In(StringToString(fieldName), longValueList);
     } else if (fieldType == TYPE_DOUBLE) {
         const std::vector<double> doubleValueList = GetDoubleList(words, elementPointer, end);
-        dbQuery.In(StringToString(fieldName), doubleValueList);
+        result.query.In(StringToString(fieldName), doubleValueList);
     } else if (fieldType == TYPE_STRING) {
         const std::vector<std::string> stringValueList = GetStringList(words, elementPointer, end);
-        dbQuery.In(StringToString(fieldName), stringValueList);
+        result.query.In(StringToString(fieldName), stringValueList);
     } else {
         ZLOGE("In wrong type.");
         return false;
@@ -394,7 +422,7 @@ bool QueryHelper::HandleIn(const std::vector<std::string> &words, int &pointer,
     return true;
 }
 
-bool QueryHelper::HandleNotIn(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleNotIn(const Words &words, int &pointer, int end, ParseResult &result)
 {
     //       |<--------------------------4-------------------------------->|
     // words [ NOT_IN, fieldType, fieldName, START_IN, ...valueList, END_IN ]
@@ -407,21 +435,21 @@ bool QueryHelper::HandleNotIn(const std::vector<std::string> &words, int &pointe
         ZLOGE("NotIn not enough params.");
         return false;
     }
-    const std::string &fieldType = words.at(pointer + 1); // fieldType
-    const std::string &fieldName = words.at(pointer + 2); // fieldName
+    std::string_view fieldType = words.at(pointer + 1); // fieldType
+    std::string_view fieldName = words.at(pointer + 2); // fieldName
     int elementPointer = pointer + 4;                     // first fieldValue, or END if list is empty
     if (fieldType == TYPE_INTEGER) {
         const std::vector<int> intValueList = GetIntegerList(words, elementPointer, end);
-        dbQuery.NotIn(StringToString(fieldName), intValueList);
+        result.query.NotIn(StringToString(fieldName), intValueList);
     } else if (fieldType == TYPE_LONG) {
         const std::vector<int64_t> longValueList = GetLongList(words, elementPointer, end);
-        dbQuery.NotIn(StringToString(fieldName), longValueList);
+        result.query.NotIn(StringToString(fieldName), longValueList);
     } else if (fieldType == TYPE_DOUBLE) {
         const std::vector<double> doubleValueList = GetDoubleList(words, elementPointer, end);
-        dbQuery.NotIn(StringToString(fieldName), doubleValueList);
+        result.query.NotIn(StringToString(fieldName), doubleValueList);
     } else if (fieldType == TYPE_STRING) {
         const std::vector<std::string> stringValueList = GetStringList(words, elementPointer, end);
-        dbQuery.NotIn(StringToString(fieldName), stringValueList);
+        result.query.NotIn(StringToString(fieldName), stringValueList);
     } else {
         ZLOGE("NotIn wrong type.");
         return false;
@@ -430,84 +458,84 @@ bool QueryHelper::HandleNotIn(const std::vector<std::string> &words, int &pointe
     return true;
 }
 
-bool QueryHelper::HandleLike(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleLike(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 2 > end) { // This keyword has 2 following params
         ZLOGE("Like not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 2); // fieldValue
-    dbQuery.Like(StringToString(fieldName), StringToString(fieldValue));
+    std::string_view fieldName = words.at(pointer + 1);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 2); // fieldValue
+    result.query.Like(StringToString(fieldName), StringToString(fieldValue));
     pointer += 3; // 3 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleNotLike(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleNotLike(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 2 > end) { // This keyword has 2 following params
         ZLOGE("NotLike not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1);  // fieldName
-    const std::string &fieldValue = words.at(pointer + 2); // fieldValue
-    dbQuery.NotLike(StringToString(fieldName), StringToString(fieldValue));
+    std::string_view fieldName = words.at(pointer + 1);  // fieldName
+    std::string_view fieldValue = words.at(pointer + 2); // fieldValue
+    result.query.NotLike(StringToString(fieldName), StringToString(fieldValue));
     pointer += 3; // 3 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleAnd(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleAnd(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    dbQuery.And();
+    result.query.And();
     pointer += 1; // Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleOr(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleOr(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    dbQuery.Or();
+    result.query.Or();
     pointer += 1; // Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleOrderByAsc(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleOrderByAsc(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("OrderByAsc not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1); // fieldName
-    dbQuery.OrderBy(StringToString(fieldName), true);
+    std::string_view fieldName = words.at(pointer + 1); // fieldName
+    result.query.OrderBy(StringToString(fieldName), true);
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleOrderByDesc(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleOrderByDesc(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("OrderByDesc not enough params.");
         return false;
     }
-    const std::string &fieldName = words.at(pointer + 1); // fieldName
-    dbQuery.OrderBy(StringToString(fieldName), false);
+    std::string_view fieldName = words.at(pointer + 1); // fieldName
+    result.query.OrderBy(StringToString(fieldName), false);
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleOrderByWriteTime(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleOrderByWriteTime(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("HandleOrderByWriteTime not enough params.");
         return false;
     }
-    const std::string isAsc = words.at(pointer + 1); // isASC
+    std::string_view isAsc = words.at(pointer + 1); // isASC
 
-    dbQuery.OrderByWriteTime(isAsc == IS_ASC);
+    result.query.OrderByWriteTime(isAsc == IS_ASC);
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleLimit(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleLimit(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 2 > end) { // This keyword has 2 following params
         ZLOGE("Limit not enough params.");
@@ -515,39 +543,39 @@ bool QueryHelper::HandleLimit(const std::vector<std::string> &words, int &pointe
     }
     const int number = StringToInt(words.at(pointer + 1)); // number
     const int offset = StringToInt(words.at(pointer + 2)); // offset
-    dbQuery.Limit(number, offset);
+    result.query.Limit(number, offset);
     pointer += 3; // 3 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleBeginGroup(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleBeginGroup(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    dbQuery.BeginGroup();
+    result.query.BeginGroup();
     pointer += 1; // Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleEndGroup(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleEndGroup(const Words &words, int &pointer, int end, ParseResult &result)
 {
-    dbQuery.EndGroup();
+    result.query.EndGroup();
     pointer += 1; // Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleKeyPrefix(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleKeyPrefix(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("KeyPrefix not enough params.");
         return false;
     }
-    const std::string &prefix = deviceId_ + StringToString(words.at(pointer + 1)); // prefix
+    const std::string prefix = result.deviceId + StringToString(words.at(pointer + 1)); // prefix
     const std::vector<uint8_t> prefixVector(prefix.begin(), prefix.end());
-    dbQuery.PrefixKey(prefixVector);
+    result.query.PrefixKey(prefixVector);
     pointer += 2; // 2 Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleInKeys(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleInKeys(const Words &words, int &pointer, int end, ParseResult &result)
 {
     // pointer points at keyword "IN_KEYS", (pointer + 1) points at keyword "START_IN"
     int startInOffSet = pointer + 1;
@@ -567,38 +595,39 @@ bool QueryHelper::HandleInKeys(const std::vector<std::string> &words, int &point
     }
     int size = inDbKeys.size();
     ZLOGI("size of inKeys=%{public}d", size);
-    dbQuery.InKeys(inDbKeys);
+    result.query.InKeys(inDbKeys);
     int endOffSet = inkeyOffSet;
     pointer = endOffSet + 1; // endOffSet points at keyword "END", Pointer goes to next keyword
     return true;
 }
 
-bool QueryHelper::HandleSetSuggestIndex(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleSetSuggestIndex(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + QUERY_SKIP_SIZE > end) {
         ZLOGE("HandleSetSuggestIndex not enough params.");
         return false;
     }
     std::string index = StringToString(words.at(pointer + QUERY_SKIP_SIZE));
-    dbQuery.SuggestIndex(index);
+    result.query.SuggestIndex(index);
     pointer += QUERY_WORD_SIZE;
     return true;
 }
 
-bool QueryHelper::HandleDeviceId(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery)
+bool QueryHelper::HandleDeviceId(const Words &words, int &pointer, int end, ParseResult &result)
 {
     if (pointer + 1 > end) { // This keyword has 1 following params
         ZLOGE("DeviceId not enough params.");
         return false;
     }
-    deviceId_ = StringToString(words.at(pointer + 1)); // deviceId
-    ZLOGI("query devId string length:%zu", deviceId_.length());
-    deviceId_ = DistributedData::DeviceManagerAdapter::GetInstance().GetUuidByNetworkId(deviceId_); // convert to UUId
-    ZLOGI("query converted devId string length:%zu", deviceId_.length());
-    if (!hasPrefixKey_) {
+    auto &deviceId = result.deviceId;
+    deviceId = StringToString(words.at(pointer + 1)); // deviceId
+    ZLOGI("query devId string length:%zu", deviceId.length());
+    deviceId = DistributedData::DeviceManagerAdapter::GetInstance().GetUuidByNetworkId(deviceId); // convert to UUId
+    ZLOGI("query converted devId string length:%zu", deviceId.length());
+    if (!result.hasPrefixKey) {
         ZLOGD("DeviceId as the only prefixKey.");
-        const std::vector<uint8_t> prefixVector(deviceId_.begin(), deviceId_.end());
-        dbQuery.PrefixKey(prefixVector);
+        const std::vector<uint8_t> prefixVector(deviceId.begin(), deviceId.end());
+        result.query.PrefixKey(prefixVector);
     } else {
         ZLOGD("Join deviceId with user specified prefixkey later.");
     }
@@ -606,28 +635,28 @@ bool QueryHelper::HandleDeviceId(const std::vector<std::string> &words, int &poi
     return true;
 }
 
-int QueryHelper::StringToInt(const std::string &word)
+int QueryHelper::StringToInt(std::string_view word)
 {
     int result;
-    std::istringstream(word) >> result;
+    std::istringstream(std::string(word)) >> result;
     return result;
 }
 
-int64_t QueryHelper::StringToLong(const std::string &word)
+int64_t QueryHelper::StringToLong(std::string_view word)
 {
     int64_t result;
-    std::istringstream(word) >> result;
+    std::istringstream(std::string(word)) >> result;
     return result;
 }
 
-double QueryHelper::StringToDouble(const std::string &word)
+double QueryHelper::StringToDouble(std::string_view word)
 {
     double result;
-    std::istringstream(word) >> result;
+    std::istringstream(std::string(word)) >> result;
     return result;
 }
 
-bool QueryHelper::StringToBoolean(const std::string &word)
+bool QueryHelper::StringToBoolean(std::string_view word)
 {
     if (word == VALUE_TRUE) {
         return true;
@@ -639,9 +668,9 @@ bool QueryHelper::StringToBoolean(const std::string &word)
     }
 }
 
-std::string QueryHelper::StringToString(const std::string &word)
+std::string QueryHelper::StringToString(std::string_view word)
 {
-    std::string result = word;
+    std::string result(word);
     if (result.compare(EMPTY_STRING) == 0) {
         result = "";
         return result;
@@ -667,7 +696,7 @@ std::string QueryHelper::StringToString(const std::string &word)
     return result;
 }
 
-std::vector<int> QueryHelper::GetIntegerList(const std::vector<std::string> &words, int &elementPointer, int end)
+std::vector<int> QueryHelper::GetIntegerList(const Words &words, int &elementPointer, int end)
 {
     std::vector<int> valueList;
     bool isEndFound = false;
@@ -687,7 +716,7 @@ std::vector<int> QueryHelper::GetIntegerList(const std::vector<std::string> &wor
     }
 }
 
-std::vector<int64_t> QueryHelper::GetLongList(const std::vector<std::string> &words, int &elementPointer, int end)
+std::vector<int64_t> QueryHelper::GetLongList(const Words &words, int &elementPointer, int end)
 {
     std::vector<int64_t> valueList;
     bool isEndFound = false;
@@ -707,7 +736,7 @@ std::vector<int64_t> QueryHelper::GetLongList(const std::vector<std::string> &wo
     }
 }
 
-std::vector<double> QueryHelper::GetDoubleList(const std::vector<std::string> &words, int &elementPointer, int end)
+std::vector<double> QueryHelper::GetDoubleList(const Words &words, int &elementPointer, int end)
 {
     std::vector<double> valueList;
     bool isEndFound = false;
@@ -727,7 +756,7 @@ std::vector<double> QueryHelper::GetDoubleList(const std::vector<std::string> &w
     }
 }
 
-std::vector<std::string> QueryHelper::GetStringList(const std::vector<std::string> &words, int &elementPointer, int end)
+std::vector<std::string> QueryHelper::GetStringList(const Words &words, int &elementPointer, int end)
 {
     std::vector<std::string> valueList;
     bool isEndFound = false;
@@ -16,8 +16,11 @@
 #ifndef QUERY_HELPER_H
 #define QUERY_HELPER_H
 
+#include <memory>
 #include <set>
+#include <string_view>
 
+#include "lru_bucket.h"
 #include "query.h"
 #include "types.h"
 
@@ -28,45 +31,52 @@ public:
 
 private:
     using DBQuery = DistributedDB::Query;
-    static std::string deviceId_;
-    static bool hasPrefixKey_;
-    static bool hasInKeys_;
-    static bool Handle(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleExtra(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleEqualTo(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleNotEqualTo(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleGreaterThan(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleLessThan(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleGreaterThanOrEqualTo(
-        const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleLessThanOrEqualTo(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleIsNull(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleIsNotNull(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleIn(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleNotIn(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleLike(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleNotLike(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleAnd(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleOr(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleOrderByAsc(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleOrderByDesc(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleOrderByWriteTime(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleLimit(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleBeginGroup(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleEndGroup(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleKeyPrefix(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleInKeys(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleSetSuggestIndex(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static bool HandleDeviceId(const std::vector<std::string> &words, int &pointer, int end, DBQuery &dbQuery);
-    static int StringToInt(const std::string &word);
-    static int64_t StringToLong(const std::string &word);
-    static double StringToDouble(const std::string &word);
-    static bool StringToBoolean(const std::string &word);
-    static std::string StringToString(const std::string &word);
-    static std::vector<int> GetIntegerList(const std::vector<std::string> &words, int &elementPointer, int end);
-    static std::vector<int64_t> GetLongList(const std::vector<std::string> &words, int &elementPointer, int end);
-    static std::vector<double> GetDoubleList(const std::vector<std::string> &words, int &elementPointer, int end);
-    static std::vector<std::string> GetStringList(const std::vector<std::string> &words, int &elementPointer, int end);
+    // the words are views into the query string, which must outlive them.
+    using Words = std::vector<std::string_view>;
+    // the state of one parse, so the concurrent parses do not share anything but the cache.
+    struct ParseResult {
+        DBQuery query = DBQuery::Select();
+        std::string deviceId;
+        bool hasPrefixKey = false;
+    };
+    static DBQuery Compile(const std::string &query, bool &isSuccess);
+    static Words Split(std::string_view query);
+    static bool Handle(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleExtra(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleEqualTo(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleNotEqualTo(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleGreaterThan(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleLessThan(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleGreaterThanOrEqualTo(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleLessThanOrEqualTo(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleIsNull(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleIsNotNull(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleIn(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleNotIn(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleLike(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleNotLike(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleAnd(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleOr(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleOrderByAsc(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleOrderByDesc(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleOrderByWriteTime(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleLimit(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleBeginGroup(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleEndGroup(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleKeyPrefix(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleInKeys(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleSetSuggestIndex(const Words &words, int &pointer, int end, ParseResult &result);
+    static bool HandleDeviceId(const Words &words, int &pointer, int end, ParseResult &result);
+    static int StringToInt(std::string_view word);
+    static int64_t StringToLong(std::string_view word);
+    static double StringToDouble(std::string_view word);
+    static bool StringToBoolean(std::string_view word);
+    static std::string StringToString(std::string_view word);
+    static std::vector<int> GetIntegerList(const Words &words, int &elementPointer, int end);
+    static std::vector<int64_t> GetLongList(const Words &words, int &elementPointer, int end);
+    static std::vector<double> GetDoubleList(const Words &words, int &elementPointer, int end);
+    static std::vector<std::string> GetStringList(const Words &words, int &elementPointer, int end);
+    static LRUBucket<std::string, std::shared_ptr<const DBQuery>> queries_;
 };
 } // namespace OHOS::DistributedKv
 #endif // QUERY_HELPER_H
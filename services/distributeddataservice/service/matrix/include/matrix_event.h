@@ -40,6 +40,7 @@ public:
     void SetRefCount(RefCount refCount);
     RefCount StealRefCount() const;
     bool Equals(const Event &event) const override;
+    size_t GetHash() const override;
 
 private:
     MatrixData data_;
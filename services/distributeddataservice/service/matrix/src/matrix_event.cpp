@@ -35,6 +35,12 @@ bool MatrixEvent::Equals(const Event &event) const
     return deviceId_ == evt.deviceId_;
 }
 
+size_t MatrixEvent::GetHash() const
+{
+    auto hash = std::hash<std::string>()(deviceId_);
+    return hash == 0 ? 1 : hash;
+}
+
 void MatrixEvent::SetRefCount(RefCount refCount)
 {
     refCount_ = std::move(refCount);
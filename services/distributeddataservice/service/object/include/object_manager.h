@@ -16,6 +16,7 @@
 #define DISTRIBUTEDDATAMGR_OBJECT_MANAGER_H
 
 #include <atomic>
+#include <string_view>
 
 #include "concurrent_map.h"
 #include "device_manager_adapter.h"
@@ -117,12 +118,8 @@ public:
     bool UnRegisterAssetsLister();
 private:
     constexpr static const char *SEPERATOR = "_";
-    constexpr static const char *TIME_REGEX = "_\\d{10}_p_";
-    constexpr static int BUNDLE_NAME_INDEX = 0;
-    constexpr static int SESSION_ID_INDEX = 1;
-    constexpr static int SOURCE_DEVICE_UDID_INDEX = 2;
-    constexpr static int TIME_INDEX = 4;
-    constexpr static int PROPERTY_NAME_INDEX = 5;
+    constexpr static std::string_view PROPERTY_MARK = "_p_";
+    constexpr static size_t TIME_WIDTH = 10;
     constexpr static const char *LOCAL_DEVICE = "local";
     constexpr static const char *USERID = "USERID";
     constexpr static int8_t MAX_OBJECT_SIZE_PER_APP = 16;
@@ -146,6 +143,15 @@ private:
             return pid < it_.pid;
         }
     };
+    // The fields of an entry key, they refer to the key they are parsed from.
+    struct EntryKey {
+        std::string_view bundleName;
+        std::string_view sessionId;
+        std::string_view sourceDeviceId;
+        std::string_view targetDeviceId;
+        std::string_view timestamp;
+        std::string_view propertyName;
+    };
     struct SaveInfo : DistributedData::Serializable {
         std::string bundleName;
         std::string sessionId;
@@ -171,6 +177,8 @@ private:
     int32_t RetrieveFromStore(const std::string &appId, const std::string &sessionId, ObjectRecord &results);
     void SyncCompleted(const std::map<std::string, DistributedDB::DBStatus> &results, uint64_t sequenceId);
     std::vector<std::string> SplitEntryKey(const std::string &key);
+    static bool ParseEntryKey(std::string_view key, EntryKey &entryKey);
+    static size_t FindTimeMark(std::string_view key);
     void ProcessOldEntry(const std::string &appId);
     void ProcessSyncCallback(const std::map<std::string, int32_t> &results, const std::string &appId,
         const std::string &sessionId, const std::string &deviceId);
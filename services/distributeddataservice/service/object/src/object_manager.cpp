@@ -16,7 +16,7 @@
 
 #include "object_manager.h"
 
-#include <regex>
+#include <charconv>
 
 #include "accesstoken_kit.h"
 #include "account/account_delegate.h"
@@ -610,19 +610,20 @@ std::map<std::string, ObjectRecord> ObjectStoreManager::GetObjectData(const Obje
             }
         }
     } else {
+        std::string prefix;
         for (const auto &item : changedData) {
-            std::vector<std::string> splitKeys = SplitEntryKey(item.first);
-            if (splitKeys.size() <= PROPERTY_NAME_INDEX) {
+            EntryKey entryKey;
+            if (!ParseEntryKey(item.first, entryKey)) {
                 continue;
             }
             if (saveInfo.sourceDeviceId.empty() || saveInfo.bundleName.empty()) {
-                saveInfo.sourceDeviceId = splitKeys[SOURCE_DEVICE_UDID_INDEX];
-                saveInfo.bundleName = splitKeys[BUNDLE_NAME_INDEX];
-                saveInfo.sessionId = splitKeys[SESSION_ID_INDEX];
-                saveInfo.timestamp = splitKeys[TIME_INDEX];
+                saveInfo.sourceDeviceId = entryKey.sourceDeviceId;
+                saveInfo.bundleName = entryKey.bundleName;
+                saveInfo.sessionId = entryKey.sessionId;
+                saveInfo.timestamp = entryKey.timestamp;
             }
-            std::string prefix = splitKeys[BUNDLE_NAME_INDEX] + splitKeys[SESSION_ID_INDEX];
-            std::string propertyName = splitKeys[PROPERTY_NAME_INDEX];
+            prefix.assign(entryKey.bundleName).append(entryKey.sessionId);
+            std::string propertyName(entryKey.propertyName);
             data[prefix].insert_or_assign(propertyName, item.second);
             if (IsAssetKey(propertyName)) {
                 hasAsset = true;
@@ -1106,20 +1107,22 @@ void ObjectStoreManager::ProcessOldEntry(const std::string &appId)
     int64_t oldestTime = 0;
     std::string deleteKey;
     for (auto &item : entries) {
-        std::string key(item.key.begin(), item.key.end());
-        std::vector<std::string> splitKeys = SplitEntryKey(key);
-        if (splitKeys.empty()) {
+        std::string_view key(reinterpret_cast<const char *>(item.key.data()), item.key.size());
+        EntryKey entryKey;
+        if (!ParseEntryKey(key, entryKey)) {
             continue;
         }
-        std::string bundleName = splitKeys[BUNDLE_NAME_INDEX];
-        std::string sessionId = splitKeys[SESSION_ID_INDEX];
-        if (sessionIds.count(sessionId) == 0) {
-            char *end = nullptr;
-            sessionIds[sessionId] = strtol(splitKeys[TIME_INDEX].c_str(), &end, DECIMAL_BASE);
+        std::string sessionId(entryKey.sessionId);
+        auto it = sessionIds.find(sessionId);
+        if (it == sessionIds.end()) {
+            int64_t time = 0;
+            std::from_chars(entryKey.timestamp.data(), entryKey.timestamp.data() + entryKey.timestamp.size(), time,
+                DECIMAL_BASE);
+            it = sessionIds.emplace(sessionId, time).first;
         }
-        if (oldestTime == 0 || oldestTime > sessionIds[sessionId]) {
-            oldestTime = sessionIds[sessionId];
-            deleteKey = GetPrefixWithoutDeviceId(bundleName, sessionId);
+        if (oldestTime == 0 || oldestTime > it->second) {
+            oldestTime = it->second;
+            deleteKey = GetPrefixWithoutDeviceId(std::string(entryKey.bundleName), sessionId);
         }
     }
     if (sessionIds.size() < MAX_OBJECT_SIZE_PER_APP) {
@@ -1310,13 +1313,13 @@ int32_t ObjectStoreManager::RetrieveFromStore(const std::string &appId, const st
     }
     ZLOGI("GetEntries success,prefix:%{public}s,count:%{public}zu", Anonymous::Change(prefix).c_str(), entries.size());
     for (const auto &entry : entries) {
-        std::string key(entry.key.begin(), entry.key.end());
-        if (key.find(SAVE_INFO) != std::string::npos) {
+        std::string_view key(reinterpret_cast<const char *>(entry.key.data()), entry.key.size());
+        if (key.find(SAVE_INFO) != std::string_view::npos) {
             continue;
         }
-        auto splitKeys = SplitEntryKey(key);
-        if (!splitKeys.empty()) {
-            results[splitKeys[PROPERTY_NAME_INDEX]] = entry.value;
+        EntryKey entryKey;
+        if (ParseEntryKey(key, entryKey)) {
+            results[std::string(entryKey.propertyName)] = entry.value;
         }
     }
     return OBJECT_SUCCESS;
@@ -1359,49 +1362,55 @@ std::string ObjectStoreManager::SaveInfo::ToPropertyPrefix()
 
 std::vector<std::string> ObjectStoreManager::SplitEntryKey(const std::string &key)
 {
-    std::smatch match;
-    std::regex timeRegex(TIME_REGEX);
-    if (!std::regex_search(key, match, timeRegex)) {
-        ZLOGW("Format error, key.size = %{public}zu", key.size());
-        return {};
-    }
-    auto timePos = match.position();
-    std::string fromTime = key.substr(timePos + 1);
-    std::string beforeTime = key.substr(0, timePos);
-
-    size_t targetDevicePos = beforeTime.find_last_of(SEPERATOR);
-    if (targetDevicePos == std::string::npos) {
-        ZLOGW("Format error, key.size = %{public}zu", key.size());
+    EntryKey entryKey;
+    if (!ParseEntryKey(key, entryKey)) {
         return {};
     }
-    std::string targetDevice = beforeTime.substr(targetDevicePos + 1);
-    std::string beforeTargetDevice = beforeTime.substr(0, targetDevicePos);
+    return { std::string(entryKey.bundleName), std::string(entryKey.sessionId), std::string(entryKey.sourceDeviceId),
+        std::string(entryKey.targetDeviceId), std::string(entryKey.timestamp), std::string(entryKey.propertyName) };
+}
 
-    size_t sourceDeviceUdidPos = beforeTargetDevice.find_last_of(SEPERATOR);
-    if (sourceDeviceUdidPos == std::string::npos) {
+// key: bundleName_sessionId_sourceDeviceId_targetDeviceId_timestamp_p_propertyName, the bundleName may contain '_'
+bool ObjectStoreManager::ParseEntryKey(std::string_view key, EntryKey &entryKey)
+{
+    auto timePos = FindTimeMark(key);
+    if (timePos == std::string_view::npos) {
         ZLOGW("Format error, key.size = %{public}zu", key.size());
-        return {};
+        return false;
     }
-    std::string sourceDeviceUdid = beforeTargetDevice.substr(sourceDeviceUdidPos + 1);
-    std::string beforeSourceDeviceUdid = beforeTargetDevice.substr(0, sourceDeviceUdidPos);
-
-    size_t sessionIdPos = beforeSourceDeviceUdid.find_last_of(SEPERATOR);
-    if (sessionIdPos == std::string::npos) {
-        ZLOGW("Format error, key.size = %{public}zu", key.size());
-        return {};
+    std::string_view *fields[] = { &entryKey.targetDeviceId, &entryKey.sourceDeviceId, &entryKey.sessionId };
+    auto beforeTime = key.substr(0, timePos);
+    for (auto field : fields) {
+        auto pos = beforeTime.rfind(*SEPERATOR);
+        if (pos == std::string_view::npos) {
+            ZLOGW("Format error, key.size = %{public}zu", key.size());
+            return false;
+        }
+        *field = beforeTime.substr(pos + 1);
+        beforeTime = beforeTime.substr(0, pos);
     }
-    std::string sessionId = beforeSourceDeviceUdid.substr(sessionIdPos + 1);
-    std::string bundleName = beforeSourceDeviceUdid.substr(0, sessionIdPos);
+    entryKey.bundleName = beforeTime;
+    entryKey.timestamp = key.substr(timePos + 1, TIME_WIDTH);
+    // the property keeps the "p_" of the mark, as it was stored
+    entryKey.propertyName = key.substr(timePos + 1 + TIME_WIDTH + 1);
+    return true;
+}
 
-    size_t propertyNamePos = fromTime.find_first_of(SEPERATOR);
-    if (propertyNamePos == std::string::npos) {
-        ZLOGW("Format error, key.size = %{public}zu", key.size());
-        return {};
+// The position of the first "_" followed by TIME_WIDTH digits and PROPERTY_MARK.
+size_t ObjectStoreManager::FindTimeMark(std::string_view key)
+{
+    constexpr size_t markSize = 1 + TIME_WIDTH + PROPERTY_MARK.size();
+    for (auto pos = key.find(*SEPERATOR); pos != std::string_view::npos && key.size() - pos >= markSize;
+         pos = key.find(*SEPERATOR, pos + 1)) {
+        size_t digits = 0;
+        while (digits < TIME_WIDTH && key[pos + 1 + digits] >= '0' && key[pos + 1 + digits] <= '9') {
+            digits++;
+        }
+        if (digits == TIME_WIDTH && key.compare(pos + 1 + TIME_WIDTH, PROPERTY_MARK.size(), PROPERTY_MARK) == 0) {
+            return pos;
+        }
     }
-    std::string propertyName = fromTime.substr(propertyNamePos + 1);
-    std::string time = fromTime.substr(0, propertyNamePos);
-
-    return { bundleName, sessionId, sourceDeviceUdid, targetDevice, time, propertyName };
+    return std::string_view::npos;
 }
 
 std::string ObjectStoreManager::GetCurrentUser()
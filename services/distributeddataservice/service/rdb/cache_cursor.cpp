@@ -21,15 +21,28 @@ namespace OHOS::DistributedRdb {
 using namespace OHOS::DistributedData;
 
 CacheCursor::CacheCursor(std::vector<DistributedData::VBucket> &&records)
+    : CacheCursor(FlatBuckets(std::move(records)))
+{
+}
+
+CacheCursor::CacheCursor(DistributedData::FlatBuckets &&records)
     : row_(0), maxCol_(0), records_(std::move(records))
 {
-    maxRow_ = static_cast<int32_t>(records_.size());
+    maxRow_ = static_cast<int32_t>(records_.Size());
     if (maxRow_ > 0) {
-        for (auto it = records_[0].begin(); it != records_[0].end(); it++) {
-            colNames_.push_back(it->first);
-            colTypes_.push_back(it->second.index());
-        }
+        colNames_ = records_.GetColumns();
         maxCol_ = static_cast<int32_t>(colNames_.size());
+        colTypes_.resize(colNames_.size(), static_cast<int32_t>(TYPE_INDEX<std::monostate>));
+        for (size_t col = 0; col < colNames_.size(); col++) {
+            // take the type from the first row having the column
+            for (size_t row = 0; row < records_.Size(); row++) {
+                auto value = records_.Get(row, col);
+                if (value != nullptr) {
+                    colTypes_[col] = static_cast<int32_t>(value->index());
+                    break;
+                }
+            }
+        }
     }
 }
 
@@ -95,7 +108,7 @@ int32_t CacheCursor::GetRow(DistributedData::VBucket &data)
     if (row >= maxRow_) {
         return GeneralError::E_RECODE_LIMIT_EXCEEDED;
     }
-    data = records_[row];
+    data = records_.GetBucket(row);
     return GeneralError::E_OK;
 }
 
@@ -104,7 +117,16 @@ int32_t CacheCursor::Get(int32_t col, DistributedData::Value &value)
     if (col < 0 || col >= maxCol_) {
         return GeneralError::E_INVALID_ARGS;
     }
-    return Get(colNames_[col], value);
+    auto row = row_;
+    if (row >= maxRow_) {
+        return GeneralError::E_RECODE_LIMIT_EXCEEDED;
+    }
+    auto cell = records_.Get(row, col);
+    if (cell == nullptr) {
+        return GeneralError::E_INVALID_ARGS;
+    }
+    value = *cell;
+    return GeneralError::E_OK;
 }
 
 int32_t CacheCursor::Get(const std::string &col, DistributedData::Value &value)
@@ -113,12 +135,11 @@ int32_t CacheCursor::Get(const std::string &col, DistributedData::Value &value)
     if (row >= maxRow_) {
         return GeneralError::E_RECODE_LIMIT_EXCEEDED;
     }
-    auto it = records_[row].find(col);
-    if (it == records_[row].end()) {
+    auto index = records_.IndexOf(col);
+    if (index == FlatBuckets::INVALID_COLUMN) {
         return GeneralError::E_INVALID_ARGS;
     }
-    value = it->second;
-    return GeneralError::E_OK;
+    return Get(index, value);
 }
 
 int32_t CacheCursor::Close()
@@ -16,11 +16,13 @@
 #ifndef OHOS_DISTRIBUTED_DATA_DATAMGR_SERVICE_CACHE_CURSOR_H
 #define OHOS_DISTRIBUTED_DATA_DATAMGR_SERVICE_CACHE_CURSOR_H
 #include "store/cursor.h"
+#include "store/flat_buckets.h"
 
 namespace OHOS::DistributedRdb {
 class CacheCursor : public DistributedData::Cursor {
 public:
     explicit CacheCursor(std::vector<DistributedData::VBucket> &&records);
+    explicit CacheCursor(DistributedData::FlatBuckets &&records);
     ~CacheCursor() = default;
     int32_t GetColumnNames(std::vector<std::string> &names) const override;
     int32_t GetColumnName(int32_t col, std::string &name) const override;
@@ -40,7 +42,7 @@ private:
     int32_t row_;
     int32_t maxRow_;
     int32_t maxCol_;
-    std::vector<DistributedData::VBucket> records_;
+    DistributedData::FlatBuckets records_;
     std::vector<std::string> colNames_;
     std::vector<int32_t> colTypes_;
 };
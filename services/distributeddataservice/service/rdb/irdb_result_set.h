@@ -22,6 +22,11 @@
 namespace OHOS::DistributedRdb {
 class IRdbResultSet : public IRemoteBroker {
 public:
+    // Commands served in addition to NativeRdb::RemoteResultSet::Code, kept far from CMD_MAX so that the
+    // codes of old clients never collide with them.
+    enum ExtCode : uint32_t {
+        CMD_GET_ROWS = 0x100,
+    };
     virtual ~IRdbResultSet() = default;
     DECLARE_INTERFACE_DESCRIPTOR(u"OHOS::NativeRdb.IResultSet");
 };
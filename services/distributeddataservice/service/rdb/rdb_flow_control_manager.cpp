@@ -20,6 +20,19 @@
 #include "log_print.h"
 
 namespace OHOS::DistributedRdb {
+namespace {
+void ReportDelay(const std::string &label, std::chrono::steady_clock::time_point executeTime)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (executeTime <= now) {
+        return;
+    }
+    int64_t delaytime = std::chrono::duration_cast<std::chrono::milliseconds>(executeTime - now).count();
+    ZLOGW("Sync delay %{public}" PRId64 "ms! bundleName:%{public}s.", delaytime, label.c_str());
+    RdbHiViewAdapter::GetInstance().ReportRdbFault({DEVICE_SYNC,
+        DEVICE_SYNC_LIMIT, label, "device sync delay " + std::to_string(delaytime) + " ms"});
+}
+} // namespace
 
 void RdbFlowControlManager::Init(std::shared_ptr<ExecutorPool> pool)
 {
@@ -27,7 +40,13 @@ void RdbFlowControlManager::Init(std::shared_ptr<ExecutorPool> pool)
         return;
     }
     pool_ = pool;
-    auto strategy = std::make_shared<RdbFlowControlStrategy>(globalLimit_, duration_);
+    // the apps share the global limit fairly with a burst of their own limit, and the background syncs yield to
+    // the foreground ones. The sliding window around them keeps the global limit.
+    auto fair = std::make_shared<DistributedData::WeightedFairStrategy>(globalLimit_, duration_, appLimit_);
+    auto priority = std::make_shared<DistributedData::PriorityClassStrategy>(std::move(fair), PRIORITY_BUTT,
+        duration_);
+    auto strategy = std::make_shared<RdbGlobalFlowControlStrategy>(
+        std::make_shared<DistributedData::SlidingWindowStrategy>(globalLimit_, duration_, std::move(priority)));
     globalManager_ = std::make_shared<DistributedData::FlowControlManager>(std::move(pool), std::move(strategy));
 }
 
@@ -54,14 +73,14 @@ int32_t RdbFlowControlManager::Execute(Task task, TaskInfo taskInfo)
         return -1;
     }
     std::weak_ptr<DistributedData::FlowControlManager> globalManager = globalManager_;
-    manager->Execute(
-        [globalManager, task, taskInfo]() mutable {
-            auto realManager = globalManager.lock();
-            if (realManager != nullptr) {
-                realManager->Execute(task, taskInfo);
-            }
-        },
-        std::move(taskInfo));
+    // the global strategy shares the limit by the label, so the task info is copied before it is moved.
+    auto globalTask = [globalManager, task, taskInfo]() mutable {
+        auto realManager = globalManager.lock();
+        if (realManager != nullptr) {
+            realManager->Execute(task, taskInfo);
+        }
+    };
+    manager->Execute(std::move(globalTask), std::move(taskInfo));
     return 0;
 }
 
@@ -70,14 +89,10 @@ int32_t RdbFlowControlManager::Remove(const std::string &label)
     if (globalManager_ == nullptr) {
         return 0;
     }
-    globalManager_->Remove([&label](const TaskInfo &info) {
-        return info.label == label;
-    });
+    globalManager_->RemoveByLabel(label);
     managers_.ComputeIfPresent(label, [](const auto &key, auto &value) {
         if (value != nullptr) {
-            value->Remove([&key](const TaskInfo &info) {
-                return info.label == key;
-            });
+            value->RemoveByLabel(key);
         }
         return false;
     });
@@ -109,15 +124,21 @@ RdbFlowControlManager::Tp RdbFlowControlStrategy::GetExecuteTime(RdbFlowControlM
     if (queue_.size() >= limit_) {
         executeTime = std::max(executeTime, queue_.front() + std::chrono::milliseconds(duration_));
     }
-    if (executeTime > std::chrono::steady_clock::now()) {
-        int64_t delaytime =
-            std::chrono::duration_cast<std::chrono::milliseconds>(executeTime - std::chrono::steady_clock::now())
-                .count();
-        ZLOGW("Sync delay %{public}" PRId64 "ms! bundleName:%{public}s.", delaytime, info.label.c_str());
-        RdbHiViewAdapter::GetInstance().ReportRdbFault({DEVICE_SYNC,
-            DEVICE_SYNC_LIMIT, info.label, "device sync delay " + std::to_string(delaytime) + " ms"});
-    }
+    ReportDelay(info.label, executeTime);
     queue_.push_back(executeTime);
     return executeTime;
 }
+
+RdbGlobalFlowControlStrategy::RdbGlobalFlowControlStrategy(std::shared_ptr<DistributedData::FlowControlStrategy> inner)
+    : inner_(std::move(inner))
+{
+}
+
+RdbFlowControlManager::Tp RdbGlobalFlowControlStrategy::GetExecuteTime(RdbFlowControlManager::Task task,
+    const RdbFlowControlManager::TaskInfo &info)
+{
+    auto executeTime = inner_->GetExecuteTime(std::move(task), info);
+    ReportDelay(info.label, executeTime);
+    return executeTime;
+}
 } // namespace OHOS::DistributedRdb
\ No newline at end of file
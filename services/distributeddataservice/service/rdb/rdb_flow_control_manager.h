@@ -21,6 +21,7 @@
 #include "concurrent_map.h"
 #include "executor_pool.h"
 #include "flow_control_manager/flow_control_manager.h"
+#include "flow_control_manager/flow_control_strategy.h"
 namespace OHOS {
 namespace DistributedRdb {
 class RdbFlowControlManager {
@@ -28,6 +29,11 @@ public:
     enum TaskType {
         TASK_TYPE_SYNC = 0,
     };
+    enum TaskPriority : uint32_t {
+        PRIORITY_FOREGROUND = 0,
+        PRIORITY_BACKGROUND,
+        PRIORITY_BUTT,
+    };
     using Task = DistributedData::FlowControlManager::Task;
     using TaskInfo = DistributedData::FlowControlManager::TaskInfo;
     using Strategy = DistributedData::FlowControlManager::Strategy;
@@ -61,6 +67,17 @@ private:
     const uint32_t limit_ = 0;
     const uint32_t duration_;
 };
+
+// reports the delay of the global strategy like the per-app one.
+class RdbGlobalFlowControlStrategy : public RdbFlowControlManager::Strategy {
+public:
+    explicit RdbGlobalFlowControlStrategy(std::shared_ptr<DistributedData::FlowControlStrategy> inner);
+    RdbFlowControlManager::Tp GetExecuteTime(RdbFlowControlManager::Task task,
+        const RdbFlowControlManager::TaskInfo &info) override;
+
+private:
+    std::shared_ptr<DistributedData::FlowControlStrategy> inner_;
+};
 } // namespace DistributedRdb
 } // namespace OHOS
 #endif //OHOS_DISTRIBUTED_DATA_DATAMGR_SERVICE_RDB_RDB_FLOW_MANAGER_H
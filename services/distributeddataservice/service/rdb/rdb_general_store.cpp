@@ -661,7 +661,7 @@ std::pair<int32_t, std::shared_ptr<Cursor>> RdbGeneralStore::Query(__attribute__
     if (delegate_ == nullptr) {
         return { GeneralError::E_ALREADY_CLOSED, nullptr };
     }
-    auto [errCode, records] = QuerySql(sql, std::move(args));
+    auto [errCode, records] = QueryRows(sql, std::move(args));
     return { errCode, std::make_shared<CacheCursor>(std::move(records)) };
 }
 
@@ -1455,6 +1455,18 @@ std::pair<int32_t, VBuckets> RdbGeneralStore::QuerySql(const std::string &sql, V
     return { ConvertStatus(status), ValueProxy::Convert(std::move(changedData)) };
 }
 
+std::pair<int32_t, FlatBuckets> RdbGeneralStore::QueryRows(const std::string &sql, Values &&args)
+{
+    std::vector<DistributedDB::VBucket> changedData;
+    std::vector<DistributedDB::Type> bindArgs = ValueProxy::Convert(std::move(args));
+    auto status = delegate_->ExecuteSql({ sql, std::move(bindArgs), true }, changedData);
+    if (status != DBStatus::OK) {
+        ZLOGE("Query failed! ret:%{public}d, sql:%{public}s, data size:%{public}zu", status,
+            Anonymous::Change(sql).c_str(), changedData.size());
+    }
+    return { ConvertStatus(status), ValueProxy::ToFlatBuckets(std::move(changedData)) };
+}
+
 void RdbGeneralStore::OnSyncStart(StoreInfo info, uint32_t flag, uint32_t syncMode, uint32_t traceId,
     uint32_t syncCount)
 {
@@ -28,6 +28,7 @@
 #include "rdb_store_config.h"
 #include "relational_store_delegate.h"
 #include "relational_store_manager.h"
+#include "store/flat_buckets.h"
 #include "store/general_store.h"
 #include "store/general_value.h"
 namespace OHOS::DistributedRdb {
@@ -37,6 +38,7 @@ public:
     using GenQuery = DistributedData::GenQuery;
     using VBucket = DistributedData::VBucket;
     using VBuckets = DistributedData::VBuckets;
+    using FlatBuckets = DistributedData::FlatBuckets;
     using Value = DistributedData::Value;
     using Values = DistributedData::Values;
     using StoreMetaData = DistributedData::StoreMetaData;
@@ -187,6 +189,7 @@ private:
     std::string BuildSql(const std::string& table, const std::string& statement,
         const std::vector<std::string>& columns) const;
     std::pair<int32_t, VBuckets> QuerySql(const std::string& sql, Values &&args);
+    std::pair<int32_t, FlatBuckets> QueryRows(const std::string& sql, Values &&args);
     std::set<std::string> GetTables();
     VBuckets ExtractExtend(VBuckets& values) const;
     size_t SqlConcatenate(VBucket &value, std::string &strColumnSql, std::string &strRowValueSql);
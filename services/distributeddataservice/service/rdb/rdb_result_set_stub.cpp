@@ -17,6 +17,7 @@
 
 #include "rdb_result_set_stub.h"
 
+#include <algorithm>
 #include <ipc_skeleton.h>
 
 #include "itypes_util.h"
@@ -36,6 +37,9 @@ int RdbResultSetStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Messag
     if (code >= 0 && code < Code::CMD_MAX) {
         return (this->*HANDLERS[code])(data, reply);
     }
+    if (code == CMD_GET_ROWS) {
+        return OnGetRows(data, reply);
+    }
     return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
 }
 
@@ -252,4 +256,96 @@ int32_t RdbResultSetStub::OnClose(MessageParcel &data, MessageParcel &reply)
     }
     return 0;
 }
-} // namespace OHOS::DistributedRdb
\ No newline at end of file
+
+int32_t RdbResultSetStub::OnGetRows(MessageParcel &data, MessageParcel &reply)
+{
+    int32_t maxRows = 0;
+    int32_t maxBytes = 0;
+    if (!ITypesUtil::Unmarshal(data, maxRows, maxBytes)) {
+        ZLOGE("Unmarshal failed.");
+        return -1;
+    }
+    maxRows = std::clamp(maxRows, 1, MAX_WINDOW_ROWS);
+    size_t budget = maxBytes <= 0 ? MAX_WINDOW_BYTES : std::min(static_cast<size_t>(maxBytes), MAX_WINDOW_BYTES);
+    int columnCount = 0;
+    int status = resultSet_->GetColumnCount(columnCount);
+    std::vector<ColumnBatch> columns(std::max(columnCount, 0));
+    std::vector<NativeRdb::ValueObject> row(columns.size());
+    int32_t rows = 0;
+    size_t bytes = 0;
+    while (status == NativeRdb::E_OK && rows < maxRows && bytes < budget) {
+        auto ret = resultSet_->GoToNextRow();
+        if (ret != NativeRdb::E_OK) {
+            // the end of the set is not an error, the client stops at a window without rows
+            bool ended = false;
+            if (resultSet_->IsEnded(ended) != NativeRdb::E_OK || !ended) {
+                status = ret;
+            }
+            break;
+        }
+        for (int col = 0; col < columnCount && status == NativeRdb::E_OK; ++col) {
+            status = resultSet_->Get(col, row[col]);
+        }
+        // a row is sent only with all its columns, the columns of the window keep the same length
+        if (status != NativeRdb::E_OK) {
+            break;
+        }
+        for (int col = 0; col < columnCount; ++col) {
+            bytes += columns[col].Append(std::move(row[col]));
+        }
+        rows++;
+    }
+    if (!ITypesUtil::Marshal(reply, status, rows, static_cast<int32_t>(columns.size()))) {
+        ZLOGE("Write status or rows failed, status:%{public}d, rows:%{public}d.", status, rows);
+        return -1;
+    }
+    for (const auto &column : columns) {
+        if (!column.Marshal(reply)) {
+            ZLOGE("Write column failed, rows:%{public}d, bytes:%{public}zu.", rows, bytes);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+size_t RdbResultSetStub::ColumnBatch::Append(NativeRdb::ValueObject &&value)
+{
+    if (auto val = std::get_if<int64_t>(&value.value)) {
+        types.push_back(TYPE_INTEGER);
+        integers.push_back(*val);
+        return sizeof(int64_t);
+    }
+    if (auto val = std::get_if<bool>(&value.value)) {
+        types.push_back(TYPE_BOOL);
+        integers.push_back(*val ? 1 : 0);
+        return sizeof(int64_t);
+    }
+    if (auto val = std::get_if<double>(&value.value)) {
+        types.push_back(TYPE_DOUBLE);
+        doubles.push_back(*val);
+        return sizeof(double);
+    }
+    if (auto val = std::get_if<std::string>(&value.value)) {
+        types.push_back(TYPE_STRING);
+        strings.push_back(std::move(*val));
+        return strings.back().size();
+    }
+    if (auto val = std::get_if<std::vector<uint8_t>>(&value.value)) {
+        types.push_back(TYPE_BLOB);
+        blobs.push_back(std::move(*val));
+        return blobs.back().size();
+    }
+    if (std::holds_alternative<std::monostate>(value.value)) {
+        types.push_back(TYPE_NULL);
+        return sizeof(uint8_t);
+    }
+    types.push_back(TYPE_OTHER);
+    others.push_back(std::move(value));
+    return OTHER_VALUE_SIZE;
+}
+
+bool RdbResultSetStub::ColumnBatch::Marshal(MessageParcel &parcel) const
+{
+    return ITypesUtil::Marshal(parcel, types, integers, doubles, strings, blobs, others);
+}
+} // namespace OHOS::DistributedRdb
@@ -48,6 +48,31 @@ private:
     int32_t OnGet(MessageParcel &data, MessageParcel &reply);
     int32_t OnGetSize(MessageParcel &data, MessageParcel &reply);
     int32_t OnClose(MessageParcel &data, MessageParcel &reply);
+    int32_t OnGetRows(MessageParcel &data, MessageParcel &reply);
+
+    // one column of a row window, values are grouped by type so that each group is written as one array.
+    struct ColumnBatch {
+        enum ValueType : uint8_t {
+            TYPE_NULL,
+            TYPE_INTEGER,
+            TYPE_DOUBLE,
+            TYPE_STRING,
+            TYPE_BOOL,
+            TYPE_BLOB,
+            TYPE_OTHER,
+        };
+        static constexpr size_t OTHER_VALUE_SIZE = 256;
+        std::vector<uint8_t> types;
+        std::vector<int64_t> integers;
+        std::vector<double> doubles;
+        std::vector<std::string> strings;
+        std::vector<std::vector<uint8_t>> blobs;
+        std::vector<NativeRdb::ValueObject> others;
+        size_t Append(NativeRdb::ValueObject &&value);
+        bool Marshal(MessageParcel &parcel) const;
+    };
+    static constexpr int32_t MAX_WINDOW_ROWS = 1024;
+    static constexpr size_t MAX_WINDOW_BYTES = 512 * 1024;
 
     static bool CheckInterfaceToken(MessageParcel &data);
     using RequestHandle = int (RdbResultSetStub::*)(MessageParcel &, MessageParcel &);
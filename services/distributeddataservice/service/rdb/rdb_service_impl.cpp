@@ -18,6 +18,7 @@
 #include "abs_rdb_predicates.h"
 #include "accesstoken_kit.h"
 #include "account/account_delegate.h"
+#include "app_state/app_state_manager.h"
 #include "bootstrap.h"
 #include "bundle_utils.h"
 #include "changeevent/remote_change_event.h"
@@ -816,7 +817,10 @@ int RdbServiceImpl::DoSync(const StoreMetaData &meta, const RdbService::Option &
     if (rdbFlowControlManager_ == nullptr || !IsSyncLimitApp(meta)) {
         return task();
     }
-    return rdbFlowControlManager_->Execute(task, {0, meta.bundleName});
+    // the syncs of the app the user is looking at go first, whether the caller waits or not
+    auto priority = AppStateManager::GetInstance()->IsForeground(meta.tokenId) ?
+        RdbFlowControlManager::PRIORITY_FOREGROUND : RdbFlowControlManager::PRIORITY_BACKGROUND;
+    return rdbFlowControlManager_->Execute(task, { RdbFlowControlManager::TASK_TYPE_SYNC, meta.bundleName, priority });
 }
 
 bool RdbServiceImpl::IsNeedMetaSync(const StoreMetaData &meta, const std::vector<std::string> &uuids)
@@ -119,6 +119,12 @@ DeviceInfo DeviceManagerAdapter::GetLocalDevice()
     return BDeviceManagerAdapter::deviceManagerAdapter->GetLocalDevice();
 }
 
+DeviceInfo DeviceManagerAdapter::WaitLocalDevice(std::chrono::milliseconds timeout)
+{
+    (void)timeout;
+    return GetLocalDevice();
+}
+
 std::string OHOS::DistributedData::DeviceManagerAdapter::GetUuidByNetworkId(const std::string &networkId)
 {
     if (BDeviceManagerAdapter::deviceManagerAdapter == nullptr) {
@@ -39,7 +39,7 @@ DBStatus KvStoreNbDelegateCorruptionMock::GetEntries(const Query &query, std::ve
 
 DBStatus KvStoreNbDelegateCorruptionMock::GetEntries(const Query &query, KvStoreResultSet *&resultSet) const
 {
-    return DBStatus::OK;
+    return DBStatus::INVALID_PASSWD_OR_CORRUPTED_DB;
 }
 
 DBStatus KvStoreNbDelegateCorruptionMock::GetCount(const Query &query, int &count) const
@@ -228,5 +228,15 @@ void PreProcessUtils::GetSummaryFromLoadInfo(const DataLoadInfo &dataLoadInfo, S
         summary.summary.emplace(type, 0);
     }
 }
+
+void PreProcessUtils::SetThreadPool(std::shared_ptr<ExecutorPool> executors)
+{
+    return;
+}
+
+void PreProcessUtils::ClearUriAuthorization(uint32_t tokenId)
+{
+    return;
+}
 } // namespace UDMF
 } // namespace OHOS
@@ -16,6 +16,7 @@
 #define UDMF_PREPROCESS_UTILS_H
 
 #include "bundlemgr/bundle_mgr_proxy.h"
+#include "executor_pool.h"
 #include "remote_file_share.h"
 #include "unified_data.h"
 
@@ -50,6 +51,8 @@ public:
         std::string &bundleName);
     static sptr<AppExecFwk::IBundleMgr> GetBundleMgr();
     static void GetSummaryFromLoadInfo(const DataLoadInfo &dataLoadInfo, Summary &summary);
+    static void SetThreadPool(std::shared_ptr<ExecutorPool> executors);
+    static void ClearUriAuthorization(uint32_t tokenId = 0);
 };
 } // namespace UDMF
 } // namespace OHOS
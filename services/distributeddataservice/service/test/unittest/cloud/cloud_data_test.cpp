@@ -16,6 +16,9 @@
 #include <gtest/gtest.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <thread>
+
 #include "accesstoken_kit.h"
 #include "account/account_delegate.h"
 #include "bootstrap.h"
@@ -52,6 +55,7 @@
 #include "sync_manager.h"
 #include "sync_strategies/network_sync_strategy.h"
 #include "token_setproc.h"
+#include "utils/constant.h"
 
 using namespace testing::ext;
 using namespace OHOS::DistributedData;
@@ -206,6 +210,19 @@ protected:
             VBucket &upsert) override;
     };
 
+    class BusyStoreMock : public GeneralStoreMock {
+    public:
+        std::pair<int32_t, int32_t> Sync(const Devices &devices, GenQuery &query, DetailAsync async,
+            const SyncParam &syncParam) override;
+        static constexpr std::chrono::milliseconds BUSY_TIME = std::chrono::milliseconds(50);
+        static std::shared_ptr<ExecutorPool> pool_;
+        static std::atomic<size_t> busy_;
+        static std::atomic<size_t> peak_;
+        static std::atomic<size_t> finished_;
+    };
+
+    static void RegisterStoreMock();
+
     static void InitMetaData();
     static void InitSchemaMeta();
     static void InitCloudInfo();
@@ -286,6 +303,46 @@ int32_t CloudDataTest::CloudConflictHandlerMock::HandleConflict(const std::strin
     return OTHER_ERROR;
 }
 
+std::pair<int32_t, int32_t> CloudDataTest::BusyStoreMock::Sync(const Devices &devices, GenQuery &query,
+    DetailAsync async, const SyncParam &syncParam)
+{
+    auto busy = ++busy_;
+    auto peak = peak_.load();
+    while (busy > peak && !peak_.compare_exchange_weak(peak, busy)) {
+    }
+    pool_->Schedule(BUSY_TIME, [devices, async = std::move(async)]() mutable {
+        GenDetails details;
+        for (auto &device : devices) {
+            details[device] = { .progress = SYNC_FINISH, .code = 0, .dbCode = 0 };
+        }
+        // the store is done before it drops the callback, which releases the slot of the sync task
+        auto callback = std::move(async);
+        busy_--;
+        if (callback) {
+            callback(details);
+        }
+        callback = nullptr;
+        finished_++;
+    });
+    return { E_OK, 0 };
+}
+
+void CloudDataTest::RegisterStoreMock()
+{
+    AutoCache::GetInstance().RegCreator(DistributedRdb::RDB_DEVICE_COLLABORATION,
+        [](const StoreMetaData &metaData, const AutoCache::StoreOption &option) -> std::pair<int32_t, GeneralStore *> {
+            auto store = new (std::nothrow) GeneralStoreMock();
+            if (store != nullptr) {
+                std::map<std::string, Value> entry = { { "inserted", 1 }, { "updated", 2 }, { "normal", 3 } };
+                store->SetMockCursor(entry);
+                store->SetEqualIdentifier("", "");
+                store->SetMockDBStatus(dbStatus_);
+                return { GeneralError::E_OK, store };
+            }
+            return { GeneralError::E_ERROR, nullptr };
+        });
+}
+
 void CloudDataTest::SetCloudSchemaMeta()
 {
     SchemaMeta schemaMeta;
@@ -309,6 +366,10 @@ DistributedData::CheckerMock CloudDataTest::checker_;
 NetworkDelegateMock CloudDataTest::delegate_;
 int32_t CloudDataTest::dbStatus_ = E_OK;
 CloudDataTest::CloudServerMock CloudDataTest::cloudServerMock_;
+std::shared_ptr<ExecutorPool> CloudDataTest::BusyStoreMock::pool_;
+std::atomic<size_t> CloudDataTest::BusyStoreMock::busy_ = 0;
+std::atomic<size_t> CloudDataTest::BusyStoreMock::peak_ = 0;
+std::atomic<size_t> CloudDataTest::BusyStoreMock::finished_ = 0;
 void CloudDataTest::InitMetaData()
 {
     metaData_.deviceId = DmAdapter::GetInstance().GetLocalDevice().uuid;
@@ -404,18 +465,7 @@ void CloudDataTest::SetUpTestCase(void)
     InitMetaData();
     InitSchemaMeta();
     // Construct the statisticInfo data
-    AutoCache::GetInstance().RegCreator(DistributedRdb::RDB_DEVICE_COLLABORATION,
-        [](const StoreMetaData &metaData, const AutoCache::StoreOption &option) -> std::pair<int32_t, GeneralStore *> {
-            auto store = new (std::nothrow) GeneralStoreMock();
-            if (store != nullptr) {
-                std::map<std::string, Value> entry = { { "inserted", 1 }, { "updated", 2 }, { "normal", 3 } };
-                store->SetMockCursor(entry);
-                store->SetEqualIdentifier("", "");
-                store->SetMockDBStatus(dbStatus_);
-                return { GeneralError::E_OK, store };
-            }
-            return { GeneralError::E_ERROR, nullptr };
-        });
+    RegisterStoreMock();
 }
 
 void CloudDataTest::TearDownTestCase()
@@ -573,6 +623,105 @@ HWTEST_F(CloudDataTest, QueryStatistics004, TestSize.Level1)
     }
 }
 
+/**
+* @tc.name: QueryStatistics005
+* @tc.desc: The statistics of a store are cached until a change event of the store.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(CloudDataTest, QueryStatistics005, TestSize.Level1)
+{
+    auto store = std::static_pointer_cast<GeneralStoreMock>(AutoCache::GetInstance().GetStore(metaData_, {}));
+    ASSERT_NE(store, nullptr);
+    const auto &database = schemaMeta_.databases[0];
+    cloudServiceImpl_->InvalidateStatistics(metaData_.user, metaData_.bundleName, metaData_.storeId);
+    auto infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_EQ(infos[0].inserted, 1);
+
+    store->SetMockCursor({ { "inserted", 4 }, { "updated", 5 }, { "normal", 6 } });
+    infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_EQ(infos[0].inserted, 1);
+    EXPECT_EQ(infos[0].table, database.tables[0].alias);
+
+    StoreInfo storeInfo;
+    storeInfo.bundleName = metaData_.bundleName;
+    storeInfo.storeName = metaData_.storeId;
+    storeInfo.user = atoi(metaData_.user.c_str());
+    EventCenter::GetInstance().PostEvent(std::make_unique<CloudSyncFinishedEvent>(storeInfo, CloudLastSyncInfo()));
+    infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_EQ(infos[0].inserted, 4);
+    EXPECT_EQ(infos[0].updated, 5);
+    EXPECT_EQ(infos[0].normal, 6);
+
+    store->SetMockCursor({ { "inserted", 1 }, { "updated", 2 }, { "normal", 3 } });
+    cloudServiceImpl_->InvalidateStatistics(metaData_.user, metaData_.bundleName);
+    infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_EQ(infos[0].inserted, 1);
+}
+
+/**
+* @tc.name: QueryStatistics006
+* @tc.desc: The cached statistics of a bundle are dropped when the bundle is uninstalled.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(CloudDataTest, QueryStatistics006, TestSize.Level1)
+{
+    auto store = std::static_pointer_cast<GeneralStoreMock>(AutoCache::GetInstance().GetStore(metaData_, {}));
+    ASSERT_NE(store, nullptr);
+    const auto &database = schemaMeta_.databases[0];
+    store->SetMockCursor({ { "inserted", 1 }, { "updated", 2 }, { "normal", 3 } });
+    cloudServiceImpl_->InvalidateStatistics(metaData_.user, metaData_.bundleName, metaData_.storeId);
+    auto infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_EQ(infos[0].inserted, 1);
+    auto key = Constant::Join("", Constant::KEY_SEPARATOR,
+        { metaData_.user, metaData_.bundleName, metaData_.storeId });
+    EXPECT_TRUE(cloudServiceImpl_->statistics_.Contains(key));
+
+    CloudData::CloudServiceImpl::CloudStatic cloudStatic;
+    EXPECT_EQ(cloudStatic.OnAppUninstall(metaData_.bundleName, atoi(metaData_.user.c_str()), 0), E_OK);
+    EXPECT_FALSE(cloudServiceImpl_->statistics_.Contains(key));
+
+    infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+    ASSERT_EQ(infos.size(), 1);
+    EXPECT_TRUE(cloudServiceImpl_->statistics_.Contains(key));
+    cloudServiceImpl_->OnUserChange(static_cast<uint32_t>(AccountStatus::DEVICE_ACCOUNT_STOPPED), metaData_.user, "");
+    EXPECT_FALSE(cloudServiceImpl_->statistics_.Contains(key));
+}
+
+/**
+* @tc.name: QueryStatisticsCost
+* @tc.desc: Compare the cost of polling the statistics with and without the cache.
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(CloudDataTest, QueryStatisticsCost, TestSize.Level1)
+{
+    constexpr int32_t times = 1000;
+    const auto &database = schemaMeta_.databases[0];
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < times; ++i) {
+        cloudServiceImpl_->InvalidateStatistics(metaData_.user, metaData_.bundleName, metaData_.storeId);
+        auto infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+        ASSERT_EQ(infos.size(), 1);
+    }
+    auto scan = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < times; ++i) {
+        auto infos = cloudServiceImpl_->QueryStatistics(metaData_, database);
+        ASSERT_EQ(infos.size(), 1);
+    }
+    auto cached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    ZLOGI("%{public}d polls, scan:%{public}lldus, cached:%{public}lldus", times,
+        static_cast<long long>(scan.count()), static_cast<long long>(cached.count()));
+    EXPECT_LE(cached.count(), scan.count());
+}
+
 /**
 * @tc.name: QueryLastSyncInfo001
 * @tc.desc: The query last sync info interface failed because account is false.
@@ -2648,6 +2797,173 @@ HWTEST_F(CloudDataTest, GetInterval, TestSize.Level0)
     EXPECT_EQ(ret, CloudData::SyncManager::RETRY_INTERVAL);
 }
 
+/**
+* @tc.name: GetBackoff
+* @tc.desc: Test the backoff grows with the retries, stays between the interval and its step and is capped
+* @tc.type: FUNC
+* @tc.require:
+ */
+HWTEST_F(CloudDataTest, GetBackoff, TestSize.Level0)
+{
+    auto interval = CloudData::SyncManager::RETRY_INTERVAL;
+    for (int32_t retries = 1; retries <= CloudData::SyncManager::MAX_BACKOFF_SHIFT + 1; ++retries) {
+        auto step = interval * (1 << (retries - 1));
+        auto backoff = CloudData::SyncManager::GetBackoff(interval, retries);
+        EXPECT_GE(backoff, interval);
+        EXPECT_LE(backoff, step);
+    }
+    auto backoff = CloudData::SyncManager::GetBackoff(interval, INT32_MAX);
+    EXPECT_LE(backoff, CloudData::SyncManager::MAX_RETRY_INTERVAL);
+    EXPECT_GE(backoff, interval);
+}
+
+/**
+* @tc.name: SyncInfoMerge
+* @tc.desc: Test the triggers of one app merge their stores and tables, the ones with a query or callback do not
+* @tc.type: FUNC
+* @tc.require:
+ */
+HWTEST_F(CloudDataTest, SyncInfoMerge, TestSize.Level0)
+{
+    int32_t user = 100;
+    CloudData::SyncManager::SyncInfo info(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_STORE, { "table1" });
+    EXPECT_TRUE(info.Merge(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_STORE, { "table2" })));
+    ASSERT_EQ(info.tables_.size(), 1);
+    EXPECT_EQ(info.tables_[TEST_CLOUD_STORE], std::vector<std::string>({ "table1", "table2" }));
+    EXPECT_TRUE(info.Merge(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_DATABASE_ALIAS_1)));
+    EXPECT_EQ(info.tables_.size(), 2);
+    EXPECT_TRUE(info.Merge(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_STORE)));
+    EXPECT_TRUE(info.tables_[TEST_CLOUD_STORE].empty());
+    EXPECT_TRUE(info.Merge(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE)));
+    EXPECT_TRUE(info.tables_.empty());
+
+    EXPECT_FALSE(info.Merge(CloudData::SyncManager::SyncInfo(user, "other_bundleName")));
+    EXPECT_FALSE(info.Merge(CloudData::SyncManager::SyncInfo(user + 1, TEST_CLOUD_BUNDLE)));
+    CloudData::SyncManager::SyncInfo push(user, TEST_CLOUD_BUNDLE);
+    push.SetMode(MODE_PUSH);
+    EXPECT_FALSE(info.Merge(push));
+    CloudData::SyncManager::SyncInfo async(user, TEST_CLOUD_BUNDLE);
+    async.SetAsyncDetail([](const DistributedData::GenDetails &details) {});
+    EXPECT_FALSE(info.Merge(async));
+    CloudData::SyncManager::SyncInfo query(user, TEST_CLOUD_BUNDLE);
+    query.SetQuery(std::make_shared<DistributedRdb::RdbQuery>());
+    EXPECT_FALSE(info.Merge(query));
+    CloudData::SyncManager::SyncInfo trigger(user, TEST_CLOUD_BUNDLE);
+    trigger.SetTriggerMode(MODE_UNLOCK);
+    EXPECT_FALSE(info.Merge(trigger));
+    CloudData::SyncManager::SyncInfo traced(user, TEST_CLOUD_BUNDLE);
+    traced.SetPrepareTraceId(TEST_TRACE_ID);
+    EXPECT_FALSE(info.Merge(traced));
+}
+
+/**
+* @tc.name: Admit001
+* @tc.desc: Test the triggers waiting for a slot merge by app and the removed user's triggers are dropped
+* @tc.type: FUNC
+* @tc.require:
+ */
+HWTEST_F(CloudDataTest, Admit001, TestSize.Level0)
+{
+    int32_t user = 100;
+    CloudData::SyncManager sync;
+    size_t max = 12;
+    size_t min = 5;
+    sync.executor_ = std::make_shared<ExecutorPool>(max, min);
+    // all slots taken, the triggers stay in the queue
+    auto admission = sync.GetAdmission();
+    ASSERT_NE(admission, nullptr);
+    std::mutex mutex;
+    std::vector<RefCount> slots;
+    for (uint32_t i = 0; i < CloudData::SyncManager::MAX_RUNNING_SYNCS; ++i) {
+        admission->ExecuteHeld([&mutex, &slots](RefCount slot) {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots.push_back(std::move(slot));
+        }, {});
+    }
+    for (int32_t i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (slots.size() == CloudData::SyncManager::MAX_RUNNING_SYNCS) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(sync.DoCloudSync(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_STORE)), E_OK);
+    EXPECT_EQ(sync.DoCloudSync(CloudData::SyncManager::SyncInfo(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_DATABASE_ALIAS_1)),
+        E_OK);
+    EXPECT_EQ(sync.DoCloudSync(CloudData::SyncManager::SyncInfo(user, "other_bundleName")), E_OK);
+    ASSERT_EQ(sync.pendings_.size(), 2);
+    EXPECT_EQ(sync.pendings_.begin()->second.info.tables_.size(), 2);
+    EXPECT_EQ(sync.StopCloudSync(user), E_OK);
+    EXPECT_TRUE(sync.pendings_.empty());
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+}
+
+/**
+* @tc.name: Admit002
+* @tc.desc: Test a sync storm never keeps more than MAX_RUNNING_SYNCS stores syncing at the same time
+* @tc.type: FUNC
+* @tc.require:
+ */
+HWTEST_F(CloudDataTest, Admit002, TestSize.Level0)
+{
+    int32_t user = AccountDelegate::GetInstance()->GetUserByToken(IPCSkeleton::GetCallingTokenID());
+    size_t triggers = 20;
+    size_t max = 12;
+    size_t min = 5;
+    delegate_.isNetworkAvailable_ = true;
+    CloudData::NetworkSyncStrategy::StrategyInfo strategyInfo;
+    MetaDataManager::GetInstance().LoadMeta(CloudData::NetworkSyncStrategy::GetKey(user, TEST_CLOUD_BUNDLE),
+        strategyInfo, true);
+    strategyInfo.strategy = CloudData::NetworkSyncStrategy::Strategy::WIFI;
+    MetaDataManager::GetInstance().SaveMeta(CloudData::NetworkSyncStrategy::GetKey(user, TEST_CLOUD_BUNDLE),
+        strategyInfo, true);
+    SetCloudSchemaMeta();
+    StoreMetaData metaData;
+    MetaDataManager::GetInstance().LoadMeta(metaData_.GetKey(), metaData, true);
+    metaData.enableCloud = true;
+    metaData.customSwitch = false;
+    MetaDataManager::GetInstance().SaveMeta(metaData_.GetKey(), metaData, true);
+
+    // every store sync stays busy for a while and finishes on another thread
+    BusyStoreMock::pool_ = std::make_shared<ExecutorPool>(max, min);
+    BusyStoreMock::busy_ = 0;
+    BusyStoreMock::peak_ = 0;
+    BusyStoreMock::finished_ = 0;
+    AutoCache::GetInstance().CloseStore(metaData_.tokenId);
+    AutoCache::GetInstance().RegCreator(DistributedRdb::RDB_DEVICE_COLLABORATION,
+        [](const StoreMetaData &metaData, const AutoCache::StoreOption &option) -> std::pair<int32_t, GeneralStore *> {
+            auto store = new (std::nothrow) BusyStoreMock();
+            if (store == nullptr) {
+                return { GeneralError::E_ERROR, nullptr };
+            }
+            store->SetEqualIdentifier("", "");
+            return { GeneralError::E_OK, store };
+        });
+
+    CloudData::SyncManager sync;
+    sync.executor_ = std::make_shared<ExecutorPool>(max, min);
+    for (size_t i = 0; i < triggers; ++i) {
+        // the triggers with their own callback are never merged
+        CloudData::SyncManager::SyncInfo info(user, TEST_CLOUD_BUNDLE, TEST_CLOUD_STORE);
+        info.SetAsyncDetail([](const DistributedData::GenDetails &details) {});
+        EXPECT_EQ(sync.DoCloudSync(info), E_OK);
+    }
+    for (int32_t i = 0; i < 500 && BusyStoreMock::finished_ < triggers; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(BusyStoreMock::finished_.load(), triggers);
+    EXPECT_GT(BusyStoreMock::peak_.load(), 0);
+    EXPECT_LE(BusyStoreMock::peak_.load(), CloudData::SyncManager::MAX_RUNNING_SYNCS);
+    ZLOGI("%{public}zu triggers, peak syncing stores:%{public}zu", triggers, BusyStoreMock::peak_.load());
+
+    AutoCache::GetInstance().CloseStore(metaData_.tokenId);
+    RegisterStoreMock();
+    BusyStoreMock::pool_ = nullptr;
+}
+
 /**
 * @tc.name: GetCloudSyncInfo
 * @tc.desc: Test get cloudInfo
@@ -2797,10 +3113,11 @@ HWTEST_F(CloudDataTest, UpdateE2eeEnableTest, TestSize.Level1)
     EXPECT_EQ(schemaMeta.e2eeEnable, schemaMeta_.e2eeEnable);
 
     ASSERT_NE(cloudServiceImpl_, nullptr);
-    cloudServiceImpl_->UpdateE2eeEnable(schemaKey, false, TEST_CLOUD_BUNDLE);
-    ASSERT_TRUE(MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true));
-    EXPECT_EQ(schemaMeta.e2eeEnable, schemaMeta_.e2eeEnable);
-    cloudServiceImpl_->UpdateE2eeEnable(schemaKey, true, TEST_CLOUD_BUNDLE);
+    SchemaMeta newMeta;
+    EXPECT_FALSE(cloudServiceImpl_->UpdateE2eeEnable(schemaKey, false, TEST_CLOUD_BUNDLE, newMeta));
+    EXPECT_TRUE(cloudServiceImpl_->UpdateE2eeEnable(schemaKey, true, TEST_CLOUD_BUNDLE, newMeta));
+    EXPECT_EQ(newMeta.e2eeEnable, true);
+    MetaDataManager::GetInstance().SaveMeta(schemaKey, newMeta, true);
     ASSERT_TRUE(MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true));
     EXPECT_EQ(schemaMeta.e2eeEnable, true);
 }
@@ -19,6 +19,10 @@
 #include <gtest/gtest.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "accesstoken_kit.h"
 #include "account/account_delegate.h"
 #include "bootstrap.h"
@@ -571,6 +575,86 @@ HWTEST_F(CloudServiceImplTest, UpdateSchemaFromServerTest_002, TestSize.Level0)
     CloudServer::instance_ = nullptr;
 }
 
+class SchemaServerMock : public CloudServer {
+public:
+    std::pair<int32_t, SchemaMeta> GetAppSchema(int32_t userId, const std::string &bundleName) override
+    {
+        calls_++;
+        std::this_thread::sleep_for(LATENCY);
+        SchemaMeta schemaMeta;
+        schemaMeta.bundleName = bundleName;
+        schemaMeta.databases.emplace_back();
+        return { E_OK, schemaMeta };
+    }
+    static constexpr std::chrono::milliseconds LATENCY = std::chrono::milliseconds(100);
+    std::atomic<int32_t> calls_ = 0;
+};
+
+/**
+ * @tc.name: GetAppSchemasFromServer001
+ * @tc.desc: Test the schemas of several bundles are fetched in parallel on the executor pool.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(CloudServiceImplTest, GetAppSchemasFromServer001, TestSize.Level0)
+{
+    ZLOGI("CloudServiceImplTest GetAppSchemasFromServer001 start");
+    SchemaServerMock cloudServer;
+    CloudServer::instance_ = &cloudServer;
+    std::vector<std::string> bundles;
+    for (int32_t i = 0; i < 8; ++i) {
+        bundles.push_back(std::string(TEST_CLOUD_BUNDLE) + std::to_string(i));
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto results = cloudServiceImpl_->GetAppSchemasFromServer(MOCK_USER, bundles, nullptr);
+    auto serial = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    ASSERT_EQ(results.size(), bundles.size());
+
+    auto executor = std::make_shared<ExecutorPool>(8, 4);
+    begin = std::chrono::steady_clock::now();
+    results = cloudServiceImpl_->GetAppSchemasFromServer(MOCK_USER, bundles, executor);
+    auto parallel = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    ASSERT_EQ(results.size(), bundles.size());
+    for (const auto &bundle : bundles) {
+        EXPECT_EQ(results[bundle].first, CloudData::CloudService::SUCCESS);
+        EXPECT_EQ(results[bundle].second.bundleName, bundle);
+    }
+    EXPECT_EQ(cloudServer.calls_, static_cast<int32_t>(2 * bundles.size()));
+    ZLOGI("%{public}zu schemas, serial:%{public}lldms, parallel:%{public}lldms", bundles.size(),
+        static_cast<long long>(serial.count()), static_cast<long long>(parallel.count()));
+    EXPECT_LT(parallel.count(), serial.count());
+    CloudServer::instance_ = nullptr;
+}
+
+/**
+ * @tc.name: GetAppSchemaFromServer002
+ * @tc.desc: Test the callers asking for the same schema at the same time share one fetch.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(CloudServiceImplTest, GetAppSchemaFromServer002, TestSize.Level0)
+{
+    ZLOGI("CloudServiceImplTest GetAppSchemaFromServer002 start");
+    SchemaServerMock cloudServer;
+    CloudServer::instance_ = &cloudServer;
+    std::vector<std::thread> threads;
+    std::atomic<int32_t> succeeded = 0;
+    for (int32_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&succeeded]() {
+            auto [status, schemaMeta] = cloudServiceImpl_->GetAppSchemaFromServer(MOCK_USER, TEST_CLOUD_BUNDLE);
+            if (status == CloudData::CloudService::SUCCESS && schemaMeta.bundleName == TEST_CLOUD_BUNDLE) {
+                succeeded++;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(succeeded, 4);
+    EXPECT_EQ(cloudServer.calls_, 1);
+    CloudServer::instance_ = nullptr;
+}
+
 /**
  * @tc.name: UpdateE2eeEnableTest
  * @tc.desc: Test UpdateE2eeEnable functions.
@@ -586,8 +670,8 @@ HWTEST_F(CloudServiceImplTest, UpdateE2eeEnableTest, TestSize.Level0)
     EXPECT_EQ(result, false);
 
     std::string schemaKey = "schemaKey";
-    cloudServiceImpl_->UpdateE2eeEnable(schemaKey, true, TEST_CLOUD_BUNDLE);
     SchemaMeta schemaMeta;
+    EXPECT_FALSE(cloudServiceImpl_->UpdateE2eeEnable(schemaKey, true, TEST_CLOUD_BUNDLE, schemaMeta));
     ASSERT_FALSE(MetaDataManager::GetInstance().LoadMeta(schemaKey, schemaMeta, true));
 }
 
@@ -92,5 +92,33 @@ HWTEST_F(DumpHelperTest, AddErrorInfoTest, TestSize.Level0)
     EXPECT_EQ(lastError.errorCode, errorCode);
     EXPECT_EQ(lastError.errorInfo, errorInfo);
 }
+/**
+* @tc.name: AddFeatureHandlerTest
+* @tc.desc: AddFeatureHandler registers the shared feature info dump once for all handlers.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(DumpHelperTest, AddFeatureHandlerTest, TestSize.Level0)
+{
+    DumpManager &dumpManager = DumpManager::GetInstance();
+    int first = 0;
+    int second = 0;
+    dumpManager.AddFeatureHandler(uintptr_t(&first),
+        [&first](int fd, std::map<std::string, std::vector<std::string>> &params) { first++; });
+    dumpManager.AddFeatureHandler(uintptr_t(&second),
+        [&second](int fd, std::map<std::string, std::vector<std::string>> &params) { second++; });
+    EXPECT_EQ(dumpManager.GetConfig("-f").dumpName, "FEATURE_INFO");
+    EXPECT_EQ(dumpManager.GetConfig("--feature-info").dumpName, "FEATURE_INFO");
+    std::map<std::string, std::vector<std::string>> params;
+    for (auto &handler : dumpManager.GetHandler("FEATURE_INFO")) {
+        handler(1, params);
+    }
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+    dumpManager.RemoveHandler("FEATURE_INFO", uintptr_t(&first));
+    dumpManager.RemoveHandler("FEATURE_INFO", uintptr_t(&second));
+}
+
 } // namespace DistributedDataTest
 } // namespace OHOS::Test
\ No newline at end of file
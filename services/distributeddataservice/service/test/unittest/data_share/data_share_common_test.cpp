@@ -14,6 +14,7 @@
 */
 #define LOG_TAG "DataShareCommonTest"
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <unistd.h>
 #include "extension_connect_adaptor.h"
@@ -21,6 +22,10 @@
 #include "div_strategy.h"
 #include "log_print.h"
 #include "rdb_delegate.h"
+#include "rdb_helper.h"
+#include "rdb_open_callback.h"
+#include "resultset_json_formatter.h"
+#include "resultset_stream_writer.h"
 #include "rdb_subscriber_manager.h"
 #include "scheduler_manager.h"
 #include "seq_strategy.h"
@@ -36,8 +41,39 @@ public:
     static void TearDownTestCase(void){};
     void SetUp(){};
     void TearDown(){};
+    static std::shared_ptr<NativeRdb::RdbStore> CreateStore(const std::string &name, int rows);
 };
 
+class WriterOpenCallback : public NativeRdb::RdbOpenCallback {
+public:
+    int OnCreate(NativeRdb::RdbStore &store) override
+    {
+        return NativeRdb::E_OK;
+    }
+    int OnUpgrade(NativeRdb::RdbStore &store, int oldVersion, int newVersion) override
+    {
+        return NativeRdb::E_OK;
+    }
+};
+
+std::shared_ptr<NativeRdb::RdbStore> DataShareCommonTest::CreateStore(const std::string &name, int rows)
+{
+    std::string path = "/data/test/" + name;
+    NativeRdb::RdbHelper::DeleteRdbStore(path);
+    NativeRdb::RdbStoreConfig config(path);
+    WriterOpenCallback callback;
+    int errCode = NativeRdb::E_OK;
+    auto store = NativeRdb::RdbHelper::GetRdbStore(config, 1, callback, errCode);
+    if (store == nullptr) {
+        return nullptr;
+    }
+    store->ExecuteSql("CREATE TABLE person (id INTEGER PRIMARY KEY, name TEXT, score REAL, photo BLOB, memo TEXT)");
+    store->ExecuteSql("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < " +
+        std::to_string(rows) + ") INSERT INTO person SELECT x, 'name \"' || x || '\"\t', x * 0.25, " +
+        "randomblob(x % 8), CASE WHEN x % 3 = 0 THEN NULL ELSE 'memo ' || x END FROM seq");
+    return store;
+}
+
 /**
 * @tc.name: DivStrategy001
 * @tc.desc: test DivStrategy function when three parameters are all nullptr
@@ -609,4 +645,158 @@ HWTEST_F(DataShareCommonTest, DBDelegateTest002, TestSize.Level0) {
     EXPECT_EQ(delegate.extUri_, "extUri");
     EXPECT_EQ(delegate.backup_, "backup");
 }
+
+/**
+* @tc.name: ResultSetStreamWriter001
+* @tc.desc: the json written from the result set is the json ResultSetJsonFormatter produces
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareCommonTest, ResultSetStreamWriter001, TestSize.Level1)
+{
+    auto store = CreateStore("stream_writer_001.db", 30);
+    ASSERT_NE(store, nullptr);
+    std::string sql = "SELECT *, id AS name, 1e20 AS big, -0.5 AS small, '\u4e2d' AS text FROM person";
+    ResultSetJsonFormatter formatter(std::shared_ptr<NativeRdb::ResultSet>(store->QueryByStep(sql)));
+    auto expect = DistributedData::Serializable::Marshall(formatter);
+    auto resultSet = store->QueryByStep(sql);
+    ASSERT_NE(resultSet, nullptr);
+    ResultSetStreamWriter writer({});
+    std::string output;
+    EXPECT_TRUE(writer.Write(*resultSet, output));
+    EXPECT_EQ(writer.GetRows(), 30);
+    EXPECT_FALSE(writer.IsTruncated());
+    EXPECT_EQ(nlohmann::json::parse(output), nlohmann::json::parse(expect));
+
+    resultSet = store->QueryByStep("SELECT * FROM person WHERE id < 0");
+    ASSERT_NE(resultSet, nullptr);
+    output.clear();
+    EXPECT_TRUE(writer.Write(*resultSet, output));
+    EXPECT_EQ(output, "[]");
+    NativeRdb::RdbHelper::DeleteRdbStore("/data/test/stream_writer_001.db");
+}
+
+/**
+* @tc.name: ResultSetStreamWriter002
+* @tc.desc: a result over the budget is discarded or keeps the rows that fit
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareCommonTest, ResultSetStreamWriter002, TestSize.Level1)
+{
+    auto store = CreateStore("stream_writer_002.db", 100);
+    ASSERT_NE(store, nullptr);
+    ResultSetStreamWriter::Option option;
+    option.budget = 1024;
+    ResultSetStreamWriter discard(option);
+    std::string output = "kept";
+    EXPECT_FALSE(discard.Write(*store->QueryByStep("SELECT * FROM person"), output));
+    EXPECT_TRUE(discard.IsTruncated());
+    EXPECT_EQ(output, "kept");
+
+    option.truncation = ResultSetStreamWriter::DROP_ROWS;
+    ResultSetStreamWriter dropRows(option);
+    output.clear();
+    EXPECT_FALSE(dropRows.Write(*store->QueryByStep("SELECT * FROM person"), output));
+    EXPECT_TRUE(dropRows.IsTruncated());
+    EXPECT_LE(output.size(), option.budget);
+    auto rows = nlohmann::json::parse(output);
+    EXPECT_EQ(rows.size(), dropRows.GetRows());
+    EXPECT_GT(rows.size(), 0);
+    EXPECT_LT(rows.size(), 100);
+    NativeRdb::RdbHelper::DeleteRdbStore("/data/test/stream_writer_002.db");
+}
+
+/**
+* @tc.name: ResultSetStreamWriter003
+* @tc.desc: the binary layout, names after the column count and a tag before every cell
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareCommonTest, ResultSetStreamWriter003, TestSize.Level1)
+{
+    auto store = CreateStore("stream_writer_003.db", 1);
+    ASSERT_NE(store, nullptr);
+    auto resultSet = store->QueryByStep("SELECT -1 AS a, NULL AS b, 'xy' AS c, x'0102' AS d, 0.5 AS e");
+    ASSERT_NE(resultSet, nullptr);
+    ResultSetStreamWriter::Option option;
+    option.format = ResultSetStreamWriter::BINARY;
+    ResultSetStreamWriter writer(option);
+    std::string output;
+    EXPECT_TRUE(writer.Write(*resultSet, output));
+    std::string expect = { ResultSetStreamWriter::VERSION, 5, 1, 'a', 1, 'b', 1, 'c', 1, 'd', 1, 'e',
+        ResultSetStreamWriter::TAG_INTEGER, 1, ResultSetStreamWriter::TAG_NULL,
+        ResultSetStreamWriter::TAG_STRING, 2, 'x', 'y', ResultSetStreamWriter::TAG_BLOB, 2, 1, 2,
+        ResultSetStreamWriter::TAG_FLOAT, 0, 0, 0, 0, 0, 0, '\xE0', '\x3F' };
+    EXPECT_EQ(output, expect);
+    NativeRdb::RdbHelper::DeleteRdbStore("/data/test/stream_writer_003.db");
+}
+
+/**
+* @tc.name: ResultSetStreamWriterCost
+* @tc.desc: write 10k rows with the stream writer and with ResultSetJsonFormatter
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(DataShareCommonTest, ResultSetStreamWriterCost, TestSize.Level1)
+{
+    constexpr int rows = 10000;
+    auto store = CreateStore("stream_writer_cost.db", rows);
+    ASSERT_NE(store, nullptr);
+    std::string sql = "SELECT * FROM person";
+    using Us = std::chrono::microseconds;
+    auto start = std::chrono::steady_clock::now();
+    ResultSetJsonFormatter formatter(std::shared_ptr<NativeRdb::ResultSet>(store->QueryByStep(sql)));
+    auto expect = DistributedData::Serializable::Marshall(formatter);
+    auto formatterCost = std::chrono::duration_cast<Us>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    ResultSetStreamWriter writer({});
+    std::string json;
+    EXPECT_TRUE(writer.Write(*store->QueryByStep(sql), json));
+    auto jsonCost = std::chrono::duration_cast<Us>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    ResultSetStreamWriter::Option option;
+    option.format = ResultSetStreamWriter::BINARY;
+    ResultSetStreamWriter binaryWriter(option);
+    std::string binary;
+    EXPECT_TRUE(binaryWriter.Write(*store->QueryByStep(sql), binary));
+    auto binaryCost = std::chrono::duration_cast<Us>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(writer.GetRows(), rows);
+    EXPECT_EQ(binaryWriter.GetRows(), rows);
+    EXPECT_EQ(nlohmann::json::parse(json), nlohmann::json::parse(expect));
+    EXPECT_LT(binary.size(), json.size());
+    ZLOGI("rows:%{public}d formatter:%{public}lldus/%{public}zuB stream json:%{public}lldus/%{public}zuB "
+        "binary:%{public}lldus/%{public}zuB", rows, static_cast<long long>(formatterCost.count()), expect.size(),
+        static_cast<long long>(jsonCost.count()), json.size(), static_cast<long long>(binaryCost.count()),
+        binary.size());
+    NativeRdb::RdbHelper::DeleteRdbStore("/data/test/stream_writer_cost.db");
+}
+
+/**
+* @tc.name: RdbDelegateQueryOversize
+* @tc.desc: a result over the transfer limit of the notification gives the incomplete marker instead of nothing
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareCommonTest, RdbDelegateQueryOversize, TestSize.Level1)
+{
+    auto store = CreateStore("rdb_delegate_oversize.db", 1);
+    ASSERT_NE(store, nullptr);
+    // 16 rows of 1M characters each
+    store->ExecuteSql("CREATE TABLE big (id INTEGER PRIMARY KEY, data TEXT)");
+    store->ExecuteSql("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < 16) "
+        "INSERT INTO big SELECT x, hex(zeroblob(524288)) FROM seq");
+    RdbDelegate delegate;
+    delegate.store_ = store;
+    EXPECT_EQ(delegate.Query("SELECT * FROM big"), DBDelegate::INCOMPLETE_RESULT);
+    auto result = delegate.Query("SELECT * FROM big WHERE id = 1");
+    EXPECT_NE(result, DBDelegate::INCOMPLETE_RESULT);
+    EXPECT_GT(result.size(), 1024 * 1024);
+    delegate.store_ = nullptr;
+    store = nullptr;
+    NativeRdb::RdbHelper::DeleteRdbStore("/data/test/rdb_delegate_oversize.db");
+}
 } // namespace OHOS::Test
\ No newline at end of file
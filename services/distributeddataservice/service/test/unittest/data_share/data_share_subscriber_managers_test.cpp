@@ -14,6 +14,7 @@
 */
 #define LOG_TAG "DataShareSubscriberManagersTest"
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <unistd.h>
 
@@ -462,4 +463,291 @@ HWTEST_F(DataShareSubscriberManagersTest, BuildChangeInfo004, TestSize.Level1)
     EXPECT_TRUE(result.multiValues_.empty());
     ZLOGI("DataShareSubscriberManagersTest BuildChangeInfo004 end");
 }
+
+/**
+* @tc.name: GetKeysByUri
+* @tc.desc: the uri index follows Add Disable Enable and both Delete of the subscriptions
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, GetKeysByUri, TestSize.Level1)
+{
+    std::string uri = "datashareproxy://com.acts.ohos.data.subscribermanagertest/index";
+    std::string otherUri = uri + "_other";
+    auto context = std::make_shared<Context>(uri);
+    context->callerTokenId = GetSelfTokenID();
+    std::shared_ptr<ExecutorPool> executorPool = std::make_shared<ExecutorPool>(1, 1);
+    DataShare::Key key1(uri, TEST_SUB_ID, BUNDLE_NAME_TEST);
+    DataShare::Key key2(uri, TEST_SUB_ID + 1, BUNDLE_NAME_TEST);
+    DataShare::Key key3(otherUri, TEST_SUB_ID, BUNDLE_NAME_TEST);
+    auto &manager = RdbSubscriberManager::GetInstance();
+    EXPECT_EQ(manager.Add(key1, nullptr, context, executorPool), DataShare::E_OK);
+    EXPECT_EQ(manager.Add(key1, nullptr, context, executorPool), DataShare::E_OK);
+    EXPECT_EQ(manager.Add(key2, nullptr, context, executorPool), DataShare::E_OK);
+    EXPECT_EQ(manager.Add(key3, nullptr, context, executorPool), DataShare::E_OK);
+    auto keys = manager.GetKeysByUri(uri);
+    ASSERT_EQ(keys.size(), 2);
+    EXPECT_EQ(keys[0], key1);
+    EXPECT_EQ(keys[1], key2);
+    EXPECT_EQ(manager.GetKeysByUri(otherUri).size(), 1);
+
+    EXPECT_EQ(manager.Disable(key1, context->callerTokenId), DataShare::E_OK);
+    EXPECT_EQ(manager.GetKeysByUri(uri).size(), 2);
+    EXPECT_EQ(manager.GetEnableObserverCount(key1), 0);
+    EXPECT_EQ(manager.Enable(key1, context), DataShare::E_OK);
+    EXPECT_EQ(manager.GetKeysByUri(uri).size(), 2);
+
+    EXPECT_EQ(manager.Delete(key1, context->callerTokenId), DataShare::E_OK);
+    keys = manager.GetKeysByUri(uri);
+    ASSERT_EQ(keys.size(), 1);
+    EXPECT_EQ(keys[0], key2);
+    manager.Delete(IPCSkeleton::GetCallingTokenID(), IPCSkeleton::GetCallingPid());
+    EXPECT_TRUE(manager.GetKeysByUri(uri).empty());
+    EXPECT_TRUE(manager.GetKeysByUri(otherUri).empty());
+}
+
+/**
+* @tc.name: TakeSnapshot
+* @tc.desc: the snapshot keeps the observers it was taken with, changes after it copy the nodes
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, TakeSnapshot, TestSize.Level1)
+{
+    std::string uri = "datashareproxy://com.acts.ohos.data.subscribermanagertest/snapshot";
+    auto context = std::make_shared<Context>(uri);
+    context->callerTokenId = GetSelfTokenID();
+    std::shared_ptr<ExecutorPool> executorPool = std::make_shared<ExecutorPool>(1, 1);
+    DataShare::Key key(uri, TEST_SUB_ID, BUNDLE_NAME_TEST);
+    auto &manager = RdbSubscriberManager::GetInstance();
+    EXPECT_EQ(manager.Add(key, nullptr, context, executorPool), DataShare::E_OK);
+    EXPECT_EQ(manager.Disable(key, context->callerTokenId), DataShare::E_OK);
+
+    auto snapshot = manager.TakeSnapshot(uri);
+    ASSERT_EQ(snapshot.size(), 1);
+    auto observers = snapshot[0].second;
+    ASSERT_EQ(observers->size(), 1);
+    EXPECT_FALSE((*observers)[0].enabled);
+    EXPECT_FALSE((*observers)[0].isNotifyOnEnabled);
+    auto current = manager.rdbCache_.Find(key).second;
+    EXPECT_NE(current, observers);
+    EXPECT_TRUE((*current)[0].isNotifyOnEnabled);
+    // nothing left to mark, the next snapshot shares the nodes
+    EXPECT_EQ(manager.TakeSnapshot(uri)[0].second, current);
+
+    EXPECT_EQ(manager.Enable(key, context), DataShare::E_OK);
+    EXPECT_FALSE((*observers)[0].enabled);
+    EXPECT_TRUE(manager.TakeSnapshot(uri, [](const DataShare::Key &) { return false; }).empty());
+    EXPECT_EQ(manager.Delete(key, context->callerTokenId), DataShare::E_OK);
+    EXPECT_TRUE(manager.TakeSnapshot(uri).empty());
+}
+
+/**
+* @tc.name: GetKeysByUriCost
+* @tc.desc: look up the subscriptions of one uri among thousands of templates
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, GetKeysByUriCost, TestSize.Level1)
+{
+    constexpr int uriCount = 500;
+    constexpr int subscriberCount = 8;
+    std::string prefix = "datashareproxy://com.acts.ohos.data.subscribermanagertest/cost";
+    auto &manager = RdbSubscriberManager::GetInstance();
+    auto nodes = std::make_shared<std::vector<RdbSubscriberManager::ObserverNode>>();
+    nodes->emplace_back(nullptr, GetSelfTokenID());
+    std::vector<DataShare::Key> keys;
+    for (int i = 0; i < uriCount; i++) {
+        for (int j = 0; j < subscriberCount; j++) {
+            keys.emplace_back(prefix + std::to_string(i), j, BUNDLE_NAME_TEST);
+            manager.rdbCache_.Insert(keys.back(), nodes);
+            manager.AddIndex(keys.back());
+        }
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (int i = 0; i < uriCount; i++) {
+        found += manager.TakeSnapshot(prefix + std::to_string(i)).size();
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(found, keys.size());
+    ZLOGI("subscriptions:%{public}zu, snapshot of every uri cost %{public}lldus", keys.size(),
+        static_cast<long long>(cost.count()));
+    for (const auto &key : keys) {
+        manager.rdbCache_.Erase(key);
+        manager.RemoveIndex(key);
+    }
+    EXPECT_TRUE(manager.GetKeysByUri(prefix + "0").empty());
+}
+
+class CountingDelegate : public DBDelegate {
+public:
+    bool Init(const DistributedData::StoreMetaData &meta, int version, bool registerFunction,
+        const std::string &extUri, const std::string &backup) override
+    {
+        return true;
+    }
+    std::pair<int, std::shared_ptr<DataShareResultSet>> Query(const std::string &tableName,
+        const DataSharePredicates &predicates, const std::vector<std::string> &columns,
+        int32_t callingPid, uint32_t callingTokenId) override
+    {
+        return { DataShare::E_OK, nullptr };
+    }
+    std::string Query(const std::string &sql, const std::vector<std::string> &selectionArgs) override
+    {
+        queries++;
+        return "[" + std::to_string(queries) + "]";
+    }
+    std::shared_ptr<NativeRdb::ResultSet> QuerySql(const std::string &sql) override
+    {
+        return nullptr;
+    }
+    std::pair<int, int64_t> UpdateSql(const std::string &sql) override
+    {
+        return { DataShare::E_OK, 0 };
+    }
+    bool IsInvalid() override
+    {
+        return false;
+    }
+    std::pair<int64_t, int64_t> InsertEx(const std::string &tableName,
+        const DataShareValuesBucket &valuesBucket) override
+    {
+        return { DataShare::E_OK, 0 };
+    }
+    std::pair<int64_t, int64_t> UpdateEx(const std::string &tableName, const DataSharePredicates &predicate,
+        const DataShareValuesBucket &valuesBucket) override
+    {
+        return { DataShare::E_OK, 0 };
+    }
+    std::pair<int64_t, int64_t> DeleteEx(const std::string &tableName, const DataSharePredicates &predicate) override
+    {
+        return { DataShare::E_OK, 0 };
+    }
+    int queries = 0;
+};
+
+/**
+* @tc.name: ParseTables
+* @tc.desc: the tables a template predicate reads, or failure when the sql is not plain
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, ParseTables, TestSize.Level1)
+{
+    auto [parsed, tables] = RdbSubscriberManager::ParseTables(
+        "SELECT a, b FROM T1 x, main.t2 AS y LEFT JOIN `t3` ON x.a = t3.a WHERE a IN (SELECT c FROM [t4])");
+    EXPECT_TRUE(parsed);
+    EXPECT_EQ(tables, std::set<std::string>({ "t1", "t2", "t3", "t4" }));
+    EXPECT_FALSE(RdbSubscriberManager::ParseTables("select * from (select 1)").first);
+    EXPECT_FALSE(RdbSubscriberManager::ParseTables("with x as (select 1) select * from x").first);
+    EXPECT_FALSE(RdbSubscriberManager::ParseTables("select 1").first);
+    EXPECT_FALSE(RdbSubscriberManager::ParseTables("select * from \"my table\"").first);
+}
+
+/**
+* @tc.name: QueryPredicateMemo
+* @tc.desc: the same predicate of one emit runs once, an unchanged table keeps the result of the last emit
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, QueryPredicateMemo, TestSize.Level1)
+{
+    auto &manager = RdbSubscriberManager::GetInstance();
+    CountingDelegate delegate;
+    std::string store = "/data/test/memo.db#100";
+    std::string sql = "select name from person where age > 18";
+    std::string otherSql = "select name from pet";
+    auto before = manager.GetQueryStats();
+
+    RdbSubscriberManager::QueryMemo memo;
+    auto first = manager.QueryPredicate(delegate, store, sql, &memo);
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &memo), first);
+    EXPECT_EQ(manager.QueryPredicate(delegate, store + "_other", sql, &memo), "[2]");
+    EXPECT_EQ(delegate.queries, 2);
+
+    RdbSubscriberManager::QueryMemo petChanged;
+    petChanged.changedTables = { "pet" };
+    petChanged.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &petChanged), first);
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, otherSql, &petChanged), "[3]");
+    RdbSubscriberManager::QueryMemo personChanged;
+    personChanged.changedTables = { "person" };
+    personChanged.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &personChanged), "[4]");
+    EXPECT_EQ(delegate.queries, 4);
+
+    manager.DropResults(store, &personChanged);
+    EXPECT_TRUE(personChanged.results.empty());
+    RdbSubscriberManager::QueryMemo afterUpdate;
+    afterUpdate.changedTables = { "pet" };
+    afterUpdate.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &afterUpdate), "[5]");
+
+    auto after = manager.GetQueryStats();
+    EXPECT_EQ(after.executed - before.executed, 5U);
+    EXPECT_EQ(after.memoized - before.memoized, 1U);
+    EXPECT_EQ(after.reused - before.reused, 1U);
+    manager.DropResults(store, nullptr);
+    manager.DropResults(store + "_other", nullptr);
+}
+
+/**
+* @tc.name: QueryPredicateExpire
+* @tc.desc: a last result older than the ttl is evaluated again even if its tables did not change
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, QueryPredicateExpire, TestSize.Level1)
+{
+    auto &manager = RdbSubscriberManager::GetInstance();
+    CountingDelegate delegate;
+    std::string store = "/data/test/expire.db#100";
+    std::string sql = "select name from person";
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, nullptr), "[1]");
+
+    RdbSubscriberManager::QueryMemo petChanged;
+    petChanged.changedTables = { "pet" };
+    petChanged.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &petChanged), "[1]");
+    manager.lastResults_.ComputeIfPresent(store, [&sql](const std::string &key, auto &results) {
+        results[sql].time -= RdbSubscriberManager::LAST_RESULT_TTL;
+        return true;
+    });
+    RdbSubscriberManager::QueryMemo expired;
+    expired.changedTables = { "pet" };
+    expired.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &expired), "[2]");
+    EXPECT_EQ(delegate.queries, 2);
+    manager.DropResults(store, nullptr);
+}
+
+/**
+* @tc.name: QueryPredicateDerived
+* @tc.desc: a predicate reading a view, or a store whose base tables are unknown, is evaluated again
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(DataShareSubscriberManagersTest, QueryPredicateDerived, TestSize.Level1)
+{
+    auto &manager = RdbSubscriberManager::GetInstance();
+    CountingDelegate delegate;
+    std::string store = "/data/test/derived.db#100";
+    std::string viewSql = "select name from adults";
+    std::string sql = "select name from person";
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, viewSql, nullptr), "[1]");
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, nullptr), "[2]");
+
+    RdbSubscriberManager::QueryMemo viewRead;
+    viewRead.changedTables = { "pet" };
+    viewRead.baseTables[store] = { "person", "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, viewSql, &viewRead), "[3]");
+    // the delegate knows no base table, as a store with triggers does not
+    RdbSubscriberManager::QueryMemo unknown;
+    unknown.changedTables = { "pet" };
+    EXPECT_EQ(manager.QueryPredicate(delegate, store, sql, &unknown), "[4]");
+    EXPECT_TRUE(unknown.baseTables[store].empty());
+    EXPECT_EQ(delegate.queries, 4);
+    manager.DropResults(store, nullptr);
+}
 } // namespace OHOS::Test
\ No newline at end of file
@@ -17,9 +17,14 @@
 #include <dlfcn.h>
 #include <gtest/gtest.h>
 #include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <algorithm>
 #include <iterator>
+#include <mutex>
+#include <thread>
 #include "data_share_profile_config.h"
 #include "db_delegate.h"
 #include "executor_pool.h"
@@ -76,6 +81,15 @@ bool FileComparison(const std::string& file1, const std::string& file2)
     );
 }
 
+void WriteDbFiles(const std::string &path, const std::string &content)
+{
+    std::filesystem::create_directories(path);
+    for (auto &fileName : g_backupFiles) {
+        std::ofstream file(path + "/" + fileName, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+}
+
 bool IsUsingArkData()
 {
 #ifndef _WIN32
@@ -562,4 +576,156 @@ HWTEST_F(KvDelegateTest, KVDelegateInitTest002, TestSize.Level0) {
     EXPECT_NE(delegate->taskId_, ExecutorPool::INVALID_TASK_ID);
     ZLOGI("KVDelegateInitTest002 end");
 }
+/**
+* @tc.name: Backup003
+* @tc.desc: test Backup function only writes the changed segments
+* @tc.type: FUNC
+* @tc.require:NA
+* @tc.precon: None
+* @tc.step:
+    1.Write the db files and call Backup twice, so both the backups and the staging copies exist
+    2.Change one byte of the db files and call CopySegments against the staging copy
+    3.Call Backup again
+* @tc.experct: only one segment is copied and the backups are the same as the db files
+*/
+HWTEST_F(KvDelegateTest, Backup003, TestSize.Level1)
+{
+    ZLOGI("Backup003 start");
+    std::string path = "/data/test/kv_backup003";
+    std::string content(4 * 64 * 1024, 'a');
+    WriteDbFiles(path, content);
+    KvDelegate kvDelegate(path, nullptr);
+    kvDelegate.hasChange_ = true;
+    kvDelegate.Backup();
+    kvDelegate.hasChange_ = true;
+    kvDelegate.Backup();
+    EXPECT_FALSE(kvDelegate.hasChange_);
+
+    content[64 * 1024 + 1] = 'b';
+    WriteDbFiles(path, content);
+    std::string src = path + "/" + g_backupFiles[0];
+    KvDelegate::BackupStats stats;
+    auto status = KvDelegate::CopySegments(src, src + BACKUP_SUFFIX + ".staging", nullptr, stats);
+    EXPECT_EQ(status, KvDelegate::COPY_DONE);
+    EXPECT_EQ(stats.total, content.size());
+    EXPECT_EQ(stats.copied, static_cast<uint64_t>(64 * 1024));
+
+    kvDelegate.hasChange_ = true;
+    kvDelegate.Backup();
+    EXPECT_FALSE(kvDelegate.hasChange_);
+    for (auto &fileName : g_backupFiles) {
+        std::string file = path + "/" + fileName;
+        EXPECT_TRUE(FileComparison(file, file + BACKUP_SUFFIX));
+    }
+    std::filesystem::remove_all(path);
+    ZLOGI("Backup003 end");
+}
+
+/**
+* @tc.name: Backup004
+* @tc.desc: test a backup pass is given up when the db is opened during the copy
+* @tc.type: FUNC
+* @tc.require:NA
+* @tc.precon: None
+* @tc.step:
+    1.Write the db files and call CopyToStaging with a generation the db already left
+    2.Set staleBackups_ to the limit and call Backup
+* @tc.experct: the pass is stale and keeps the backups, the pass holding the lock completes the backup
+*/
+HWTEST_F(KvDelegateTest, Backup004, TestSize.Level1)
+{
+    ZLOGI("Backup004 start");
+    std::string path = "/data/test/kv_backup004";
+    std::string content(64 * 1024 + 1, 'a');
+    WriteDbFiles(path, content);
+    KvDelegate kvDelegate(path, nullptr);
+    kvDelegate.generation_++;
+    KvDelegate::BackupStats stats;
+    EXPECT_EQ(kvDelegate.CopyToStaging(0, stats), KvDelegate::COPY_STALE);
+    EXPECT_FALSE(std::filesystem::exists(path + "/" + g_backupFiles[0] + BACKUP_SUFFIX));
+
+    kvDelegate.hasChange_ = true;
+    kvDelegate.staleBackups_ = 3;
+    kvDelegate.Backup();
+    EXPECT_FALSE(kvDelegate.hasChange_);
+    EXPECT_EQ(kvDelegate.staleBackups_, 0);
+    for (auto &fileName : g_backupFiles) {
+        std::string file = path + "/" + fileName;
+        EXPECT_TRUE(FileComparison(file, file + BACKUP_SUFFIX));
+    }
+    std::filesystem::remove_all(path);
+    ZLOGI("Backup004 end");
+}
+/**
+* @tc.name: KVDelegateConcurrentCost
+* @tc.desc: compare mixed reads and writes from many threads with the same calls run one at a time
+* @tc.type: PERF
+* @tc.require:NA
+* @tc.precon: None
+* @tc.step:
+    1.Upsert some proxy data lists
+    2.Get them from several reader threads while a writer thread upserts them again, with every call serialized
+    3.Run the same calls without serializing them
+* @tc.experct: all calls succeed, the readers run concurrently
+*/
+HWTEST_F(KvDelegateTest, KVDelegateConcurrentCost, TestSize.Level1)
+{
+    if (!IsUsingArkData()) {
+        GTEST_SKIP();
+    }
+    ZLOGI("KVDelegateConcurrentCost start");
+    constexpr int32_t userId = 100;
+    constexpr uint32_t keys = 64;
+    constexpr int32_t readers = 8;
+    constexpr int32_t reads = 500;
+    constexpr int32_t writes = 200;
+    auto delegate = std::make_shared<KvDelegate>("/data/test", nullptr);
+    std::vector<std::string> uris = {"name", "age", "job"};
+    for (uint32_t i = 0; i < keys; i++) {
+        EXPECT_EQ(delegate->Upsert("proxydata_", ProxyDataList(ProxyDataListNode(uris, userId, i))).first, 0);
+    }
+    auto run = [&](bool serialized) {
+        std::mutex serial;
+        std::atomic<int32_t> failures = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int32_t reader = 0; reader < readers; reader++) {
+            threads.emplace_back([&, reader]() {
+                for (int32_t i = 0; i < reads; i++) {
+                    std::unique_lock<std::mutex> lock(serial, std::defer_lock);
+                    if (serialized) {
+                        lock.lock();
+                    }
+                    std::string value;
+                    Id id(std::to_string((reader * reads + i) % keys), userId);
+                    if (delegate->Get("proxydata_", id, value) != 0) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&]() {
+            for (int32_t i = 0; i < writes; i++) {
+                std::unique_lock<std::mutex> lock(serial, std::defer_lock);
+                if (serialized) {
+                    lock.lock();
+                }
+                auto value = ProxyDataList(ProxyDataListNode(uris, userId, i % keys));
+                if (delegate->Upsert("proxydata_", value).first != 0) {
+                    failures++;
+                }
+            }
+        });
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(failures.load(), 0);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto serializedCost = run(true);
+    auto concurrentCost = run(false);
+    ZLOGI("%{public}d reads and %{public}d writes, serialized %{public}lldms, concurrent %{public}lldms",
+        readers * reads, writes, static_cast<long long>(serializedCost), static_cast<long long>(concurrentCost));
+    ZLOGI("KVDelegateConcurrentCost end");
+}
 } // namespace OHOS::Test
\ No newline at end of file
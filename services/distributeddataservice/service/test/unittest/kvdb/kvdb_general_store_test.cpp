@@ -16,6 +16,7 @@
 
 #include "kvdb_general_store.h"
 
+#include <endian.h>
 #include <gtest/gtest.h>
 #include <random>
 #include <thread>
@@ -1655,5 +1656,82 @@ HWTEST_F(KVDBGeneralStoreTest, PublishCacheChange009, TestSize.Level0)
     ASSERT_EQ(store->observer_->watcher_, nullptr);
     store->PublishCacheChange();
 }
+/**
+* @tc.name: GetNewKey
+* @tc.desc: rewrite the remote uuid prefix of an intercepted key into a reused buffer
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(KVDBGeneralStoreTest, GetNewKey, TestSize.Level0)
+{
+    std::string remote = "remoteUuid";
+    std::vector<uint8_t> key(remote.begin(), remote.end());
+    key.insert(key.end(), { 'k', 'e', 'y' });
+    uint32_t remoteLen = htole32(static_cast<uint32_t>(remote.size()));
+    auto buf = reinterpret_cast<uint8_t *>(&remoteLen);
+    key.insert(key.end(), buf, buf + sizeof(remoteLen));
+
+    std::string uuid = "uuid";
+    std::vector<uint8_t> expect(uuid.begin(), uuid.end());
+    expect.insert(expect.end(), { 'k', 'e', 'y' });
+    uint32_t uuidLen = htole32(static_cast<uint32_t>(uuid.size()));
+    buf = reinterpret_cast<uint8_t *>(&uuidLen);
+    expect.insert(expect.end(), buf, buf + sizeof(uuidLen));
+
+    std::vector<uint8_t> out = { 'o', 'l', 'd', 'd', 'a', 't', 'a', 'a', 'b', 'c', 'd', 'e' };
+    ASSERT_TRUE(KVDBGeneralStore::GetNewKey(key, uuid, out));
+    EXPECT_EQ(out, expect);
+
+    std::vector<uint8_t> shortKey = { 'k', 'e', 'y' };
+    EXPECT_FALSE(KVDBGeneralStore::GetNewKey(shortKey, uuid, out));
+    std::vector<uint8_t> badLen = { 'k', 'e', 'y', 0xFF, 0xFF, 0xFF, 0x0F };
+    EXPECT_FALSE(KVDBGeneralStore::GetNewKey(badLen, uuid, out));
+}
+
+/**
+* @tc.name: GetNewKeyCost
+* @tc.desc: rewrite a batch of intercepted keys and log the cost
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(KVDBGeneralStoreTest, GetNewKeyCost, TestSize.Level1)
+{
+    constexpr size_t batchSize = 10000;
+    std::string remote(64, 'r');
+    std::vector<std::vector<uint8_t>> keys(batchSize);
+    uint32_t remoteLen = htole32(static_cast<uint32_t>(remote.size()));
+    auto buf = reinterpret_cast<uint8_t *>(&remoteLen);
+    for (size_t i = 0; i < batchSize; i++) {
+        auto id = std::to_string(i);
+        keys[i].assign(remote.begin(), remote.end());
+        keys[i].insert(keys[i].end(), id.begin(), id.end());
+        keys[i].insert(keys[i].end(), buf, buf + sizeof(remoteLen));
+    }
+    std::string uuid(64, 'u');
+    std::vector<uint8_t> out;
+    size_t rewritten = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto &key : keys) {
+        rewritten += KVDBGeneralStore::GetNewKey(key, uuid, out) ? 1 : 0;
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(rewritten, batchSize);
+    ZLOGI("rewrite %{public}zu keys cost:%{public}lldus", batchSize, static_cast<long long>(cost.count()));
+}
+
+/**
+* @tc.name: GetEncryptedUuid
+* @tc.desc: unknown devices are not resolved nor cached
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(KVDBGeneralStoreTest, GetEncryptedUuid, TestSize.Level0)
+{
+    auto store = std::make_shared<KVDBGeneralStore>(metaData_);
+    ASSERT_NE(store, nullptr);
+    EXPECT_TRUE(store->GetEncryptedUuid("unknownDevice").empty());
+    std::string encryptedUuid;
+    EXPECT_FALSE(store->encryptedUuids_.Get("", encryptedUuid));
+}
 } // namespace DistributedDataTest
 } // namespace OHOS::Test
\ No newline at end of file
@@ -13,7 +13,14 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "QueryHelperUnitTest"
 #include <gtest/gtest.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <regex>
+
+#include "log_print.h"
 #include "query_helper.h"
 
 namespace OHOS::DistributedKv {
@@ -587,4 +594,103 @@ HWTEST_F(QueryHelperUnitTest, StringToDbQuery019, testing::ext::TestSize.Level0)
     (void)QueryHelper::StringToDbQuery(query, isSuccess);
     EXPECT_FALSE(isSuccess);
 }
+
+/**
+  * @tc.name: SplitQuery
+  * @tc.desc: the split keeps the empty words between spaces like the regex split and drops the trailing one.
+  * @tc.type: FUNC
+  * @tc.require:
+  * @tc.author:
+  */
+HWTEST_F(QueryHelperUnitTest, SplitQuery, testing::ext::TestSize.Level0)
+{
+    using Words = std::vector<std::string_view>;
+    EXPECT_EQ(QueryHelper::Split(""), Words());
+    EXPECT_EQ(QueryHelper::Split("   "), Words());
+    EXPECT_EQ(QueryHelper::Split("  ^AND ^OR"), Words({ "^AND", "^OR" }));
+    EXPECT_EQ(QueryHelper::Split("^AND  ^OR "), Words({ "^AND", "", "^OR" }));
+    EXPECT_EQ(QueryHelper::Split("^AND ^OR  "), Words({ "^AND", "^OR", "" }));
+}
+
+/**
+  * @tc.name: CompiledQueryCache
+  * @tc.desc: the compiled query is reused for the same text, but not for the failed or the device id queries.
+  * @tc.type: FUNC
+  * @tc.require:
+  * @tc.author:
+  */
+HWTEST_F(QueryHelperUnitTest, CompiledQueryCache, testing::ext::TestSize.Level0)
+{
+    std::shared_ptr<const DistributedDB::Query> compiled;
+    bool isSuccess = false;
+    string query = "^EQUAL STRING cache_field cache_value ^AND ^LIMIT 10 0";
+    QueryHelper::queries_.Delete(query);
+    (void)QueryHelper::StringToDbQuery(query, isSuccess);
+    EXPECT_TRUE(isSuccess);
+    EXPECT_TRUE(QueryHelper::queries_.Get(query, compiled));
+    isSuccess = false;
+    (void)QueryHelper::StringToDbQuery(query, isSuccess);
+    EXPECT_TRUE(isSuccess);
+
+    query = "^EQUAL CHAR cache_field cache_value";
+    (void)QueryHelper::StringToDbQuery(query, isSuccess);
+    EXPECT_FALSE(isSuccess);
+    EXPECT_FALSE(QueryHelper::queries_.Get(query, compiled));
+
+    query = "^DEVICE_ID cache_device ^KEY_PREFIX cache_prefix";
+    (void)QueryHelper::StringToDbQuery(query, isSuccess);
+    EXPECT_TRUE(isSuccess);
+    EXPECT_FALSE(QueryHelper::queries_.Get(query, compiled));
+}
+
+/**
+  * @tc.name: StringToDbQueryCost
+  * @tc.desc: compare the regex split with the view split, and the full parse with the cached query.
+  * @tc.type: PERF
+  * @tc.require:
+  * @tc.author:
+  */
+HWTEST_F(QueryHelperUnitTest, StringToDbQueryCost, testing::ext::TestSize.Level0)
+{
+    constexpr int times = 2000;
+    const std::vector<string> queries = {
+        "^EQUAL STRING name Alice ^AND ^GREATER INTEGER age 18 ^LIMIT 100 0",
+        "^BEGIN_GROUP ^LIKE name Mr* ^OR ^IS_NULL address ^END_GROUP ^DESC STRING time",
+        "^IN LONG id ^START 1 2 3 4 5 6 7 8 9 10 ^END ^AND ^NOT_EQUAL BOOL deleted true",
+        "^KEY_PREFIX user_ ^AND ^LESS_EQUAL DOUBLE score 99.5 ^ASC STRING score",
+    };
+    auto measure = [&queries](auto &&action) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < times; ++i) {
+            for (auto &query : queries) {
+                action(query);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+    };
+    size_t words = 0;
+    auto regexSplit = measure([&words](const string &query) {
+        std::regex regex(" ");
+        std::vector<string> result(std::sregex_token_iterator(query.begin(), query.end(), regex, -1),
+            std::sregex_token_iterator());
+        words += result.size();
+    });
+    auto viewSplit = measure([&words](const string &query) {
+        words -= QueryHelper::Split(query).size();
+    });
+    EXPECT_EQ(words, 0u);
+    bool isSuccess = false;
+    auto parse = measure([&isSuccess](const string &query) {
+        (void)QueryHelper::Compile(query, isSuccess);
+    });
+    auto cached = measure([&isSuccess](const string &query) {
+        (void)QueryHelper::StringToDbQuery(query, isSuccess);
+    });
+    EXPECT_TRUE(isSuccess);
+    ZLOGI("%{public}zu queries: regex split %{public}" PRId64 "us, view split %{public}" PRId64 "us, "
+          "parse %{public}" PRId64 "us, cached %{public}" PRId64 "us",
+        queries.size() * times, regexSplit, viewSplit, parse, cached);
+    EXPECT_LT(viewSplit, regexSplit);
+}
 }
\ No newline at end of file
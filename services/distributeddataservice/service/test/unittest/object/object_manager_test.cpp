@@ -17,14 +17,17 @@
 
 #include "object_manager.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <ipc_skeleton.h>
+#include <regex>
 
 #include "bootstrap.h"
 #include "device_manager_adapter_mock.h"
 #include "executor_pool.h"
 #include "kv_store_nb_delegate_mock.h"
 #include "kvstore_meta_manager.h"
+#include "log_print.h"
 #include "metadata/object_user_meta_data.h"
 #include "object_types.h"
 #include "snapshot/machine_status.h"
@@ -812,6 +815,70 @@ HWTEST_F(ObjectManagerTest, SplitEntryKey002, TestSize.Level0)
     EXPECT_TRUE(res.empty());
 }
 
+/**
+* @tc.name: ParseEntryKey
+* @tc.desc: the fields refer to the key, bundle names may contain the separator.
+* @tc.type: FUNC
+*/
+HWTEST_F(ObjectManagerTest, ParseEntryKey, TestSize.Level0)
+{
+    ObjectStoreManager::EntryKey entryKey;
+    std::string key = "com.example_app_sessionId_source_target_1234567890_p_name_1234567890_p_x";
+    ASSERT_TRUE(ObjectStoreManager::ParseEntryKey(key, entryKey));
+    EXPECT_EQ(entryKey.bundleName, "com.example_app");
+    EXPECT_EQ(entryKey.sessionId, "sessionId");
+    EXPECT_EQ(entryKey.sourceDeviceId, "source");
+    EXPECT_EQ(entryKey.targetDeviceId, "target");
+    EXPECT_EQ(entryKey.timestamp, "1234567890");
+    EXPECT_EQ(entryKey.propertyName, "p_name_1234567890_p_x");
+    EXPECT_EQ(entryKey.bundleName.data(), key.data());
+
+    EXPECT_FALSE(ObjectStoreManager::ParseEntryKey("a_b_c_d_123456789a_p_x", entryKey));
+    EXPECT_FALSE(ObjectStoreManager::ParseEntryKey("a_b_c_d_1234567890_p", entryKey));
+    EXPECT_TRUE(ObjectStoreManager::ParseEntryKey("a_b_c_d_1234567890_p_", entryKey));
+    EXPECT_EQ(entryKey.propertyName, "p_");
+}
+
+/**
+* @tc.name: ParseEntryKeyCost
+* @tc.desc: parse a restored object with many properties, compared with the regex based split.
+* @tc.type: PERF
+*/
+HWTEST_F(ObjectManagerTest, ParseEntryKeyCost, TestSize.Level1)
+{
+    constexpr int properties = 2000;
+    std::string prefix = "com.example.myapplication_" + std::string(32, 's') + "_" + std::string(64, 'u') + "_" +
+        std::string(64, 'v') + "_1718000000_";
+    std::vector<std::string> keys;
+    for (int i = 0; i < properties; i++) {
+        keys.push_back(prefix + "p_property" + std::to_string(i));
+    }
+    keys.push_back(prefix + "p_[STRING]asset" + std::to_string(properties) + ".uri");
+
+    auto start = std::chrono::steady_clock::now();
+    size_t regexFound = 0;
+    for (auto &key : keys) {
+        std::smatch match;
+        std::regex timeRegex("_\\d{10}_p_");
+        regexFound += std::regex_search(key, match, timeRegex) ? 1 : 0;
+    }
+    auto regexCost = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t parsed = 0;
+    ObjectStoreManager::EntryKey entryKey;
+    for (auto &key : keys) {
+        parsed += ObjectStoreManager::ParseEntryKey(key, entryKey) ? 1 : 0;
+    }
+    auto parseCost = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(parsed, keys.size());
+    EXPECT_EQ(regexFound, keys.size());
+    using Us = std::chrono::microseconds;
+    ZLOGI("keys:%{public}zu regex:%{public}lldus parse:%{public}lldus", keys.size(),
+        static_cast<long long>(std::chrono::duration_cast<Us>(regexCost).count()),
+        static_cast<long long>(std::chrono::duration_cast<Us>(parseCost).count()));
+}
+
 /**
 * @tc.name: ProcessOldEntry001
 * @tc.desc: ProcessOldEntry test.
@@ -257,5 +257,38 @@ HWTEST_F(CacheCursorTest, UnCacheCursorTest002, TestSize.Level0)
     err = cursor->Close();
     EXPECT_EQ(err, GeneralError::E_OK);
 }
+/**
+* @tc.name: SparseRecords
+* @tc.desc: rows missing some columns keep them absent instead of null.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(CacheCursorTest, SparseRecords, TestSize.Level0)
+{
+    std::vector<VBucket> records;
+    records.push_back({ { "age", AGE } });
+    records.push_back({ { "age", AGE + 1 }, { "name", NAME } });
+    CacheCursor cursor(std::move(records));
+    std::vector<std::string> names;
+    EXPECT_EQ(cursor.GetColumnNames(names), GeneralError::E_OK);
+    std::vector<std::string> expectedNames = { "age", "name" };
+    EXPECT_EQ(names, expectedNames);
+    EXPECT_EQ(cursor.GetColumnType(1), static_cast<int32_t>(TYPE_INDEX<std::string>));
+
+    Value value;
+    EXPECT_EQ(cursor.Get("name", value), GeneralError::E_INVALID_ARGS);
+    EXPECT_EQ(cursor.Get(1, value), GeneralError::E_INVALID_ARGS);
+    VBucket row;
+    EXPECT_EQ(cursor.GetRow(row), GeneralError::E_OK);
+    EXPECT_EQ(row.size(), 1);
+
+    EXPECT_EQ(cursor.MoveToNext(), GeneralError::E_OK);
+    EXPECT_EQ(cursor.Get("name", value), GeneralError::E_OK);
+    EXPECT_EQ(std::get<std::string>(value), NAME);
+    EXPECT_EQ(cursor.Get(0, value), GeneralError::E_OK);
+    EXPECT_EQ(std::get<int64_t>(value), AGE + 1);
+    EXPECT_EQ(cursor.GetRow(row), GeneralError::E_OK);
+    EXPECT_EQ(row.size(), 2);
+}
 } // namespace DistributedRDBTest
 } // namespace OHOS::Test
\ No newline at end of file
@@ -599,5 +599,32 @@ HWTEST_F(RdbFlowControlManagerTest, RdbFlowControlManager_InitWithNullPool_Test,
     EXPECT_EQ(flag->load(), 0);
 }
 
+/**
+ * @tc.name: RdbFlowControlManager_GlobalLimitWithManyLabels_Test
+ * @tc.desc: Test that the device limit holds when many labels each stay within the app limit
+ * @tc.type: FUNC
+ * @tc.require:
+ * @tc.step: 1. Create RdbFlowControlManager with app limit 5, device limit 3, delay 300ms
+ * @tc.step: 2. Submit one task for each of 6 labels
+ * @tc.step: 3. Check that only 3 tasks run at first and the others run after the delay
+ * @tc.expected: The labels together never run more tasks than the device limit in the delay
+ */
+HWTEST_F(RdbFlowControlManagerTest, RdbFlowControlManager_GlobalLimitWithManyLabels_Test, TestSize.Level1)
+{
+    auto pool = std::make_shared<ExecutorPool>(2, 2);
+    RdbFlowControlManager flowControlManager(5, 3, 300);
+    flowControlManager.Init(pool);
+    auto flag = std::make_shared<std::atomic_uint32_t>(0);
+    auto task = [flag]() mutable {
+        (*flag)++;
+    };
+    for (int i = 0; i < 6; i++) {
+        flowControlManager.Execute(task, { 0, "label" + std::to_string(i) });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(flag->load(), 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(flag->load(), 6);
+}
 } // namespace DistributedRDBTest
 } // namespace OHOS::Test
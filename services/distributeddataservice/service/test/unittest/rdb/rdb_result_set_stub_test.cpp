@@ -16,7 +16,12 @@
 
 #include "rdb_result_set_stub.h"
 
+#include <chrono>
+#include <functional>
+
+#include "cache_cursor.h"
 #include "gtest/gtest.h"
+#include "itypes_util.h"
 #include "log_print.h"
 #include "message_parcel.h"
 #include "rdb_result_set_impl.h"
@@ -30,14 +35,79 @@ using namespace OHOS::DistributedData;
 const std::u16string INTERFACE_TOKEN = u"OHOS::NativeRdb.IResultSet";
 namespace OHOS::Test {
 namespace DistributedRDBTest {
+static constexpr int32_t SYNTHETIC_ROWS = 10000;
+static constexpr int32_t WINDOW_ROWS = 512;
 class RdbResultSetStubTest : public testing::Test {
 public:
     static void SetUpTestCase(void){};
     static void TearDownTestCase(void){};
     void SetUp(){};
     void TearDown(){};
+    static std::vector<VBucket> CreateRecords(int32_t rows);
+    static sptr<RdbResultSetStub> CreateSyntheticStub(int32_t rows);
+    static int32_t Request(sptr<RdbResultSetStub> stub, uint32_t code, MessageParcel &reply,
+        const std::function<void(MessageParcel &)> &writer = nullptr);
 };
 
+// Fails MoveToNext or the Get of one column when the cursor reaches the given move.
+class FaultCursor : public CacheCursor {
+public:
+    FaultCursor(std::vector<VBucket> &&records, int32_t moveFault, int32_t getFault)
+        : CacheCursor(std::move(records)), moveFault_(moveFault), getFault_(getFault)
+    {
+    }
+    int32_t MoveToNext() override
+    {
+        auto ret = CacheCursor::MoveToNext();
+        return ++moves_ == moveFault_ ? GeneralError::E_ERROR : ret;
+    }
+    int32_t Get(int32_t col, Value &value) override
+    {
+        if (moves_ == getFault_ && col == FAULT_COLUMN) {
+            return GeneralError::E_ERROR;
+        }
+        return CacheCursor::Get(col, value);
+    }
+    static constexpr int32_t FAULT_COLUMN = 2;
+
+private:
+    int32_t moves_ = 0;
+    int32_t moveFault_ = 0;
+    int32_t getFault_ = 0;
+};
+
+std::vector<VBucket> RdbResultSetStubTest::CreateRecords(int32_t rows)
+{
+    std::vector<VBucket> records;
+    for (int32_t i = 0; i < rows; i++) {
+        VBucket record;
+        record["id"] = int64_t(i);
+        record["name"] = "name_" + std::to_string(i);
+        record["score"] = i * 0.5;
+        record["data"] = Bytes(16, uint8_t(i));
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+sptr<RdbResultSetStub> RdbResultSetStubTest::CreateSyntheticStub(int32_t rows)
+{
+    auto cursor = std::make_shared<CacheCursor>(CreateRecords(rows));
+    return new RdbResultSetStub(std::make_shared<RdbResultSetImpl>(cursor));
+}
+
+int32_t RdbResultSetStubTest::Request(sptr<RdbResultSetStub> stub, uint32_t code, MessageParcel &reply,
+    const std::function<void(MessageParcel &)> &writer)
+{
+    MessageParcel request;
+    MessageOption option;
+    request.WriteInterfaceToken(INTERFACE_TOKEN);
+    if (writer) {
+        writer(request);
+    }
+    return stub->OnRemoteRequest(code, request, reply, option);
+}
+
 /**
 * @tc.name: OnRemoteRequest001
 * @tc.desc: RdbResultSetStub OnRemoteRequest function error test.
@@ -145,5 +215,135 @@ HWTEST_F(RdbResultSetStubTest, RdbResultSetStub, TestSize.Level1)
         EXPECT_EQ(ret, 0);
     }
 }
+
+/**
+* @tc.name: GetRows001
+* @tc.desc: RdbResultSetStub returns rows in windows bounded by the row count and the byte budget.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(RdbResultSetStubTest, GetRows001, TestSize.Level1)
+{
+    auto stub = CreateSyntheticStub(WINDOW_ROWS);
+    MessageParcel reply;
+    auto ret = Request(stub, RdbResultSetStub::CMD_GET_ROWS, reply, [](MessageParcel &request) {
+        ITypesUtil::Marshal(request, int32_t(10), int32_t(0));
+    });
+    ASSERT_EQ(ret, 0);
+    int32_t status = -1;
+    int32_t rows = 0;
+    int32_t columns = 0;
+    ASSERT_TRUE(ITypesUtil::Unmarshal(reply, status, rows, columns));
+    EXPECT_EQ(status, NativeRdb::E_OK);
+    EXPECT_EQ(rows, 10);
+    EXPECT_EQ(columns, 4);
+
+    MessageParcel budgetReply;
+    ret = Request(stub, RdbResultSetStub::CMD_GET_ROWS, budgetReply, [](MessageParcel &request) {
+        ITypesUtil::Marshal(request, int32_t(WINDOW_ROWS), int32_t(1));
+    });
+    ASSERT_EQ(ret, 0);
+    ASSERT_TRUE(ITypesUtil::Unmarshal(budgetReply, status, rows, columns));
+    EXPECT_EQ(rows, 1);
+}
+
+/**
+* @tc.name: GetRows002
+* @tc.desc: RdbResultSetStub sends only the complete rows before a failing Get or GoToNextRow and returns the error.
+* @tc.type: FUNC
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(RdbResultSetStubTest, GetRows002, TestSize.Level1)
+{
+    int32_t faultRow = 3;
+    auto request = [](MessageParcel &request) {
+        ITypesUtil::Marshal(request, int32_t(10), int32_t(0));
+    };
+    auto cursor = std::make_shared<FaultCursor>(CreateRecords(WINDOW_ROWS), 0, faultRow);
+    sptr<RdbResultSetStub> stub = new RdbResultSetStub(std::make_shared<RdbResultSetImpl>(cursor));
+    MessageParcel reply;
+    ASSERT_EQ(Request(stub, RdbResultSetStub::CMD_GET_ROWS, reply, request), 0);
+    int32_t status = NativeRdb::E_OK;
+    int32_t rows = 0;
+    int32_t columns = 0;
+    ASSERT_TRUE(ITypesUtil::Unmarshal(reply, status, rows, columns));
+    EXPECT_NE(status, NativeRdb::E_OK);
+    EXPECT_EQ(rows, faultRow - 1);
+    for (int32_t col = 0; col < columns; ++col) {
+        std::vector<uint8_t> types;
+        std::vector<int64_t> integers;
+        std::vector<double> doubles;
+        std::vector<std::string> strings;
+        std::vector<std::vector<uint8_t>> blobs;
+        std::vector<NativeRdb::ValueObject> others;
+        ASSERT_TRUE(ITypesUtil::Unmarshal(reply, types, integers, doubles, strings, blobs, others));
+        EXPECT_EQ(types.size(), static_cast<size_t>(rows));
+    }
+
+    cursor = std::make_shared<FaultCursor>(CreateRecords(WINDOW_ROWS), faultRow, 0);
+    stub = new RdbResultSetStub(std::make_shared<RdbResultSetImpl>(cursor));
+    MessageParcel moveReply;
+    ASSERT_EQ(Request(stub, RdbResultSetStub::CMD_GET_ROWS, moveReply, request), 0);
+    ASSERT_TRUE(ITypesUtil::Unmarshal(moveReply, status, rows, columns));
+    EXPECT_NE(status, NativeRdb::E_OK);
+    EXPECT_EQ(rows, faultRow - 1);
+}
+
+/**
+* @tc.name: GetRowsThroughput
+* @tc.desc: compare the rows per second of the per-call commands and the row window over a CacheCursor.
+* @tc.type: PERF
+* @tc.require:
+* @tc.author:
+*/
+HWTEST_F(RdbResultSetStubTest, GetRowsThroughput, TestSize.Level1)
+{
+    auto stub = CreateSyntheticStub(SYNTHETIC_ROWS);
+    int32_t singleRows = 0;
+    auto begin = std::chrono::steady_clock::now();
+    while (true) {
+        MessageParcel reply;
+        int32_t status = NativeRdb::E_ERROR;
+        Request(stub, RdbResultSetStub::Code::CMD_GO_TO_NEXT_ROW, reply);
+        if (!ITypesUtil::Unmarshal(reply, status) || status != NativeRdb::E_OK) {
+            break;
+        }
+        for (int32_t col = 0; col < 4; ++col) {
+            MessageParcel valueReply;
+            Request(stub, RdbResultSetStub::Code::CMD_GET, valueReply, [col](MessageParcel &request) {
+                ITypesUtil::Marshal(request, col);
+            });
+        }
+        singleRows++;
+    }
+    auto singleCost = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    stub = CreateSyntheticStub(SYNTHETIC_ROWS);
+    int32_t windowRows = 0;
+    begin = std::chrono::steady_clock::now();
+    while (true) {
+        MessageParcel reply;
+        Request(stub, RdbResultSetStub::CMD_GET_ROWS, reply, [](MessageParcel &request) {
+            ITypesUtil::Marshal(request, WINDOW_ROWS, int32_t(0));
+        });
+        int32_t status = NativeRdb::E_ERROR;
+        int32_t rows = 0;
+        int32_t columns = 0;
+        if (!ITypesUtil::Unmarshal(reply, status, rows, columns)) {
+            break;
+        }
+        // the window still carries the rows read before an error
+        windowRows += rows;
+        if (status != NativeRdb::E_OK || rows == 0) {
+            break;
+        }
+    }
+    auto windowCost = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    EXPECT_EQ(singleRows, windowRows);
+    ZLOGI("per-call:%{public}.0f rows/s, window:%{public}.0f rows/s", singleRows / singleCost,
+        windowRows / windowCost);
+}
 } // namespace DistributedRDBTest
 } // namespace OHOS::Test
\ No newline at end of file
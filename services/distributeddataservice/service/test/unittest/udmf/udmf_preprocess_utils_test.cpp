@@ -12,9 +12,15 @@
 * See the License for the specific language governing permissions and
 * limitations under the License.
 */
+#define LOG_TAG "UdmfPreProcessUtilsTest"
+
+#include <chrono>
+#include <future>
 
 #include "preprocess_utils.h"
 #include "gtest/gtest.h"
+#include "executor_pool.h"
+#include "log_print.h"
 #include "remote_file_share.h"
 #include "text.h"
 #include "unified_html_record_process.h"
@@ -605,28 +611,6 @@ HWTEST_F(UdmfPreProcessUtilsTest, HandleFileUris001, TestSize.Level1)
     EXPECT_EQ(ret, E_OK);
 }
 
-/**
- * @tc.name: ReadCheckUri001
- * @tc.desc: Test ReadCheckUri with valid URIs
- * @tc.type: FUNC
- * @tc.require:
- */
-HWTEST_F(UdmfPreProcessUtilsTest, ReadCheckUri001, TestSize.Level1)
-{
-    UnifiedData data;
-    Runtime runtime;
-    runtime.permissionPolicyMode = PERMISSION_POLICY_MODE_LEGACY;
-    data.SetRuntime(runtime);
-    auto record = std::make_shared<UnifiedRecord>(UDType::FILE_URI, std::make_shared<Object>());
-    (*record->GetEntries())[ORI_URI] = "file://test.com/data.txt";
-    data.AddRecord(record);
-
-    std::vector<std::string> uris = {"file://test.com/data.txt"};
-    PreProcessUtils preProcessUtils;
-    int32_t ret = preProcessUtils.ReadCheckUri(100, data, uris, false);
-    EXPECT_EQ(ret, E_NO_PERMISSION);
-}
-
 /**
  * @tc.name: FillHtmlEntry001
  * @tc.desc: Test FillHtmlEntry with HTML record
@@ -748,4 +732,157 @@ HWTEST_F(UdmfPreProcessUtilsTest, SetRemoteData005, TestSize.Level1)
     auto detailGet = std::get<std::shared_ptr<Object>>(obj->value_[DETAILS]);
     EXPECT_TRUE(detailGet == nullptr);
 }
+
+/**
+* @tc.name: DeduplicateUris001
+* @tc.desc: DeduplicateUris keeps the first of each uri in order
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(UdmfPreProcessUtilsTest, DeduplicateUris001, TestSize.Level1)
+{
+    std::vector<std::string> uris = { "file://a/1.png", "file://a/2.png", "file://a/1.png", "file://a/3.png",
+        "file://a/2.png" };
+    PreProcessUtils::DeduplicateUris(uris);
+    std::vector<std::string> expected = { "file://a/1.png", "file://a/2.png", "file://a/3.png" };
+    EXPECT_EQ(uris, expected);
+}
+
+/**
+* @tc.name: CheckUriAuthorization004
+* @tc.desc: CheckUriAuthorization takes unexpired cached grants of the token without asking again
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(UdmfPreProcessUtilsTest, CheckUriAuthorization004, TestSize.Level1)
+{
+    uint32_t tokenId = 1001;
+    std::map<std::string, uint32_t> grants = {
+        { "file://a/read.png", UriPermissionUtil::READ_FLAG },
+        { "file://a/write.png", UriPermissionUtil::WRITE_FLAG },
+    };
+    PreProcessUtils::CacheGrants(tokenId, grants);
+
+    std::map<std::string, uint32_t> permissionUris;
+    size_t cacheHits = 0;
+    std::vector<std::string> uris = { "file://a/read.png", "file://a/write.png" };
+    EXPECT_TRUE(PreProcessUtils::CheckUriAuthorization(uris, tokenId, permissionUris, false, &cacheHits));
+    EXPECT_EQ(cacheHits, uris.size());
+    EXPECT_EQ(permissionUris["file://a/read.png"], UriPermissionUtil::READ_FLAG | UriPermissionUtil::PERSIST_FLAG);
+    EXPECT_EQ(permissionUris["file://a/write.png"], UriPermissionUtil::WRITE_FLAG | UriPermissionUtil::PERSIST_FLAG);
+
+    // the html uris need the read grant
+    permissionUris.clear();
+    EXPECT_FALSE(PreProcessUtils::CheckUriAuthorization(uris, tokenId, permissionUris, true));
+    EXPECT_TRUE(permissionUris.empty());
+
+    PreProcessUtils::ClearUriAuthorization(tokenId);
+    cacheHits = 0;
+    EXPECT_FALSE(PreProcessUtils::CheckUriAuthorization(uris, tokenId, permissionUris, false, &cacheHits));
+    EXPECT_EQ(cacheHits, 0);
+}
+
+/**
+* @tc.name: CheckUriAuthorization005
+* @tc.desc: CheckUriAuthorization ignores expired cached grants
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(UdmfPreProcessUtilsTest, CheckUriAuthorization005, TestSize.Level1)
+{
+    uint32_t tokenId = 1002;
+    PreProcessUtils::UriGrants cached;
+    cached.expiredTime = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    cached.grants["file://a/read.png"] = UriPermissionUtil::READ_FLAG;
+    PreProcessUtils::uriGrants_.InsertOrAssign(tokenId, cached);
+
+    std::map<std::string, uint32_t> permissionUris;
+    size_t cacheHits = 0;
+    std::vector<std::string> uris = { "file://a/read.png" };
+    EXPECT_FALSE(PreProcessUtils::CheckUriAuthorization(uris, tokenId, permissionUris, true, &cacheHits));
+    EXPECT_EQ(cacheHits, 0);
+    EXPECT_FALSE(PreProcessUtils::uriGrants_.Contains(tokenId));
+}
+
+/**
+* @tc.name: HandleFileUrisCost
+* @tc.desc: HandleFileUris checks a drag of repeated file uris once per uri
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(UdmfPreProcessUtilsTest, HandleFileUrisCost, TestSize.Level1)
+{
+    constexpr size_t recordCount = 500;
+    constexpr size_t uriCount = 50;
+    uint32_t tokenId = 1003;
+    std::map<std::string, uint32_t> grants;
+    for (size_t i = 0; i < uriCount; ++i) {
+        grants["file://data/" + std::to_string(i) + ".png"] =
+            UriPermissionUtil::READ_FLAG | UriPermissionUtil::WRITE_FLAG;
+    }
+    PreProcessUtils::CacheGrants(tokenId, grants);
+
+    UnifiedData data;
+    Runtime runtime;
+    runtime.permissionPolicyMode = PERMISSION_POLICY_MODE_MASK;
+    data.SetRuntime(runtime);
+    std::vector<std::shared_ptr<Object>> objs;
+    for (size_t i = 0; i < recordCount; ++i) {
+        auto obj = std::make_shared<Object>();
+        obj->value_[UNIFORM_DATA_TYPE] = "general.file-uri";
+        obj->value_[ORI_URI] = "file://data/" + std::to_string(i % uriCount) + ".png";
+        data.AddRecord(std::make_shared<UnifiedRecord>(UDType::FILE_URI, obj));
+        objs.push_back(obj);
+    }
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(PreProcessUtils::HandleFileUris(tokenId, data), E_OK);
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ZLOGI("HandleFileUris of %{public}zu records over %{public}zu uris cost %{public}lld ms", recordCount, uriCount,
+        static_cast<long long>(cost.count()));
+    for (auto &obj : objs) {
+        int32_t permission = static_cast<int32_t>(PermissionPolicy::NO_PERMISSION);
+        EXPECT_TRUE(obj->GetValue(PERMISSION_POLICY, permission));
+        EXPECT_EQ(permission, static_cast<int32_t>(PermissionPolicy::READ_WRITE));
+    }
+    PreProcessUtils::ClearUriAuthorization(tokenId);
+}
+
+/**
+* @tc.name: HandleFileUris002
+* @tc.desc: HandleFileUris checks the html uris itself when the pool does not start its task
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(UdmfPreProcessUtilsTest, HandleFileUris002, TestSize.Level1)
+{
+    uint32_t tokenId = 1004;
+    std::map<std::string, uint32_t> grants = {
+        { "file://data/file.png", UriPermissionUtil::READ_FLAG | UriPermissionUtil::WRITE_FLAG },
+        { "file:///data/html.png", UriPermissionUtil::READ_FLAG | UriPermissionUtil::WRITE_FLAG },
+    };
+    PreProcessUtils::CacheGrants(tokenId, grants);
+    UnifiedData data;
+    Runtime runtime;
+    runtime.permissionPolicyMode = PERMISSION_POLICY_MODE_MASK;
+    data.SetRuntime(runtime);
+    auto fileObj = std::make_shared<Object>();
+    fileObj->value_[UNIFORM_DATA_TYPE] = "general.file-uri";
+    fileObj->value_[ORI_URI] = "file://data/file.png";
+    data.AddRecord(std::make_shared<UnifiedRecord>(UDType::FILE_URI, fileObj));
+    auto htmlObj = std::make_shared<Object>();
+    htmlObj->value_[UNIFORM_DATA_TYPE] = "general.html";
+    htmlObj->value_["htmlContent"] = "<img data-ohos='clipboard' src='file:///data/html.png'>";
+    data.AddRecord(std::make_shared<UnifiedRecord>(UDType::HTML, htmlObj));
+
+    // the only thread of the pool stays busy until HandleFileUris returns
+    auto executors = std::make_shared<ExecutorPool>(1, 0);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    executors->Execute([released]() { released.wait(); });
+    PreProcessUtils::SetThreadPool(executors);
+    EXPECT_EQ(PreProcessUtils::HandleFileUris(tokenId, data), E_OK);
+    release.set_value();
+    PreProcessUtils::SetThreadPool(nullptr);
+    PreProcessUtils::ClearUriAuthorization(tokenId);
+}
 }
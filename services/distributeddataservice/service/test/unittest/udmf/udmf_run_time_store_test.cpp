@@ -14,20 +14,24 @@
 */
 
 #define LOG_TAG "UdmfRunTimeStoreTest"
+#include <chrono>
 #include <gtest/gtest.h>
 #include <openssl/rand.h>
 
 #include "accesstoken_kit.h"
 #include "bootstrap.h"
+#include "data_handler.h"
 #include "device_manager_adapter.h"
 #include "directory/directory_manager.h"
 #include "drag_lifecycle_policy.h"
 #include "executor_pool.h"
 #include "kvstore_meta_manager.h"
 #include "lifecycle_manager.h"
+#include "log_print.h"
 #include "nativetoken_kit.h"
 #include "preprocess_utils.h"
 #include "runtime_store.h"
+#include "store_cache.h"
 #include "text.h"
 #include "token_setproc.h"
 
@@ -908,6 +912,101 @@ HWTEST_F(UdmfRunTimeStoreTest, GetBatchRuntime002, TestSize.Level1)
     EXPECT_EQ(0, outRuntimes.size());
 }
 
+/**
+* @tc.name: ScanBatchData001
+* @tc.desc: Normal testcase of GetBatchData and ScanBatchData with a filter and an early stop
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(UdmfRunTimeStoreTest, ScanBatchData001, TestSize.Level1)
+{
+    auto executors = StoreCache::GetInstance().GetThreadPool();
+    StoreCache::GetInstance().SetThreadPool(std::make_shared<ExecutorPool>(2, 1));
+    auto store = std::make_shared<RuntimeStore>(STORE_ID);
+    bool result = store->Init();
+    EXPECT_TRUE(result);
+    const std::string bundleName = "scan_batch_test";
+    const uint32_t count = 40;
+    std::vector<std::string> keys;
+    for (uint32_t i = 0; i < count; i++) {
+        Runtime runtime;
+        runtime.key = UnifiedKey(STORE_ID, bundleName, UDMF::PreProcessUtils::GenerateId());
+        runtime.tokenId = i;
+        auto record = std::make_shared<UnifiedRecord>();
+        record->AddEntry("type1", "value" + std::to_string(i));
+        UnifiedData data(std::make_shared<UnifiedDataProperties>());
+        data.SetRuntime(runtime);
+        data.SetRecords({record});
+        keys.push_back(data.GetRuntime()->key.GetUnifiedKey());
+        Summary summary;
+        EXPECT_EQ(store->Put(data, summary), E_OK);
+    }
+    std::string prefix = "udmf://" + STORE_ID + "/" + bundleName;
+
+    std::vector<UnifiedData> dataSet;
+    EXPECT_EQ(store->GetBatchData(prefix, dataSet), E_OK);
+    ASSERT_EQ(dataSet.size(), count);
+    for (uint32_t i = 0; i < count; i++) {
+        EXPECT_EQ(dataSet[i].GetRuntime()->key.key, keys[i]);
+        EXPECT_EQ(dataSet[i].GetRecords().size(), 1);
+    }
+
+    std::vector<uint32_t> tokenIds;
+    auto isEven = [](const Runtime &runtime) { return runtime.tokenId % 2 == 0; };
+    auto status = store->ScanBatchData(prefix, isEven, [&tokenIds](UnifiedData &data) {
+        tokenIds.push_back(data.GetRuntime()->tokenId);
+        return tokenIds.size() < 5;
+    });
+    EXPECT_EQ(status, E_OK);
+    EXPECT_EQ(tokenIds, std::vector<uint32_t>({ 0, 2, 4, 6, 8 }));
+
+    EXPECT_EQ(store->Delete(prefix), E_OK);
+    StoreCache::GetInstance().SetThreadPool(executors);
+}
+
+/**
+* @tc.name: MarshalEntriesCost
+* @tc.desc: round trip of unified data with multi-MB entries through the kv entries, the cost is logged
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(UdmfRunTimeStoreTest, MarshalEntriesCost, TestSize.Level1)
+{
+    const size_t payloadSize = 8 * 1024 * 1024;
+    std::string html(payloadSize, 'h');
+    std::vector<uint8_t> pixels(payloadSize, 0x5a);
+    auto record = std::make_shared<UnifiedRecord>();
+    record->AddEntry("general.html", html);
+    record->AddEntry("general.image", pixels);
+    Runtime runtime;
+    runtime.key = UnifiedKey(STORE_ID, BUNDLE_NAME, UDMF::PreProcessUtils::GenerateId());
+    UnifiedData inputData(std::make_shared<UnifiedDataProperties>());
+    inputData.SetRuntime(runtime);
+    inputData.SetRecords({record});
+    auto key = inputData.GetRuntime()->key.GetUnifiedKey();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Entry> entries;
+    EXPECT_EQ(DataHandler::MarshalToEntries(inputData, entries), E_OK);
+    auto marshalled = std::chrono::steady_clock::now();
+    UnifiedData outputData;
+    EXPECT_EQ(DataHandler::UnmarshalEntries(key, entries, outputData), E_OK);
+    auto end = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(outputData.GetRecords().size(), 1);
+    auto outRecord = outputData.GetRecords()[0];
+    ASSERT_NE(outRecord, nullptr);
+    auto outHtml = outRecord->GetEntry("general.html");
+    ASSERT_TRUE(std::holds_alternative<std::string>(outHtml));
+    EXPECT_EQ(std::get<std::string>(outHtml), html);
+    auto outPixels = outRecord->GetEntry("general.image");
+    ASSERT_TRUE(std::holds_alternative<std::vector<uint8_t>>(outPixels));
+    EXPECT_EQ(std::get<std::vector<uint8_t>>(outPixels), pixels);
+    ZLOGI("2 x %{public}zu bytes, marshal %{public}lldms, unmarshal %{public}lldms", payloadSize,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(marshalled - start).count()),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - marshalled).count()));
+}
+
 /**
 * @tc.name: OnTimeout001
 * @tc.desc: Normal test of OnTimeout, intention is DataHub
@@ -1490,22 +1490,6 @@ HWTEST_F(UdmfServiceImplTest, HandleFileUris003, TestSize.Level1)
     EXPECT_EQ(result, E_OK);
 }
 
-/**
- * @tc.name: ReadCheckUri001
- * @tc.desc: uris is empty
- * @tc.type: FUNC
- */
-HWTEST_F(UdmfServiceImplTest, ReadCheckUri001, TestSize.Level1)
-{
-    auto tokenId = AccessTokenKit::GetHapTokenID(100, HAP_BUNDLE_NAME, 0);
-    UnifiedData unifiedData;
-    const std::vector<std::string> uris;
-    std::shared_ptr<Object> obj = std::make_shared<Object>();
-    auto record = std::make_shared<UnifiedRecord>(UDType::FILE_URI, obj);
-    auto result = PreProcessUtils::ReadCheckUri(tokenId, unifiedData, uris);
-    EXPECT_EQ(result, E_OK);
-}
-
 /**
  * @tc.name: FillDelayUnifiedData001
  * @tc.desc: FillDelayUnifiedData function test
@@ -16,12 +16,25 @@
 #define LOG_TAG "ValueProxyServiceTest"
 #include "value_proxy.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
 
 #include "log_print.h"
 namespace OHOS::Test {
 using namespace testing::ext;
 using namespace OHOS::DistributedData;
+static constexpr size_t BENCH_ROWS = 100000;
+
+static std::vector<DistributedDB::VBucket> MakeDBRows(size_t count)
+{
+    std::vector<DistributedDB::VBucket> rows(count);
+    for (size_t i = 0; i < count; i++) {
+        rows[i] = { { "#gid", std::string("gid_") + std::to_string(i) }, { "age", int64_t(i) },
+            { "score", double(i) }, { "flag", (i % 2) == 0 }, { "blob", DistributedDB::Bytes(16, uint8_t(i)) },
+            { "description", std::string(32, 'd') } };
+    }
+    return rows;
+}
 class ValueProxyServiceTest : public testing::Test {
 };
 
@@ -559,4 +572,80 @@ HWTEST_F(ValueProxyServiceTest, AssetExtensionEmptyTest, TestSize.Level0)
     CommonType::AssetValue cAsset = makeAsset();
     EXPECT_TRUE(cAsset.extension.empty());
 }
+/**
+* @tc.name: ToFlatBuckets
+* @tc.desc: convert db rows into flat rows, sparse rows keep their missing columns absent.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(ValueProxyServiceTest, ToFlatBuckets, TestSize.Level0)
+{
+    std::vector<DistributedDB::VBucket> dbVBuckets = {
+        { { "#gid", std::string("0000000") }, { "#value", int64_t(100) } },
+        { { "#gid", std::string("0000001") } },
+    };
+    auto rows = ValueProxy::ToFlatBuckets(std::move(dbVBuckets));
+    ASSERT_EQ(rows.Size(), 2);
+    ASSERT_EQ(rows.ColumnCount(), 2);
+    auto value = rows.Get(0, rows.IndexOf("#value"));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(std::get<int64_t>(*value), 100);
+    EXPECT_EQ(rows.Get(1, rows.IndexOf("#value")), nullptr);
+    auto buckets = rows.TakeBuckets();
+    ASSERT_EQ(buckets.size(), 2);
+    EXPECT_EQ(buckets[0].size(), 2);
+    EXPECT_EQ(buckets[1].size(), 1);
+    EXPECT_EQ(std::get<std::string>(buckets[1]["#gid"]), "0000001");
+}
+
+/**
+* @tc.name: FlatBucketsCost
+* @tc.desc: time to convert 100k db rows into VBuckets and into flat rows, the flat rows move the cells.
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(ValueProxyServiceTest, FlatBucketsCost, TestSize.Level1)
+{
+    auto mapRows = MakeDBRows(BENCH_ROWS);
+    auto flatRows = MakeDBRows(BENCH_ROWS);
+    // the heap buffers of the source cells, the flat rows must own the same ones
+    std::vector<const void *> blobs;
+    std::vector<const void *> descriptions;
+    blobs.reserve(BENCH_ROWS);
+    descriptions.reserve(BENCH_ROWS);
+    for (auto &row : flatRows) {
+        blobs.push_back(std::get<DistributedDB::Bytes>(row["blob"]).data());
+        descriptions.push_back(std::get<std::string>(row["description"]).data());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    VBuckets buckets = ValueProxy::Convert(std::move(mapRows));
+    auto mapCost = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    auto rows = ValueProxy::ToFlatBuckets(std::move(flatRows));
+    auto flatCost = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(buckets.size(), BENCH_ROWS);
+    ASSERT_EQ(rows.Size(), BENCH_ROWS);
+    EXPECT_TRUE(flatRows.empty());
+    // one column list for all rows instead of a key per cell
+    EXPECT_EQ(rows.ColumnCount(), buckets[0].size());
+    auto blobCol = rows.IndexOf("blob");
+    auto descriptionCol = rows.IndexOf("description");
+    ASSERT_NE(blobCol, FlatBuckets::INVALID_COLUMN);
+    ASSERT_NE(descriptionCol, FlatBuckets::INVALID_COLUMN);
+    for (size_t i = 0; i < BENCH_ROWS; i++) {
+        auto blob = rows.Get(i, blobCol);
+        auto description = rows.Get(i, descriptionCol);
+        ASSERT_NE(blob, nullptr);
+        ASSERT_NE(description, nullptr);
+        ASSERT_EQ(std::get<Bytes>(*blob).data(), blobs[i]);
+        ASSERT_EQ(std::get<std::string>(*description).data(), descriptions[i]);
+    }
+    using Ms = std::chrono::milliseconds;
+    ZLOGI("rows:%{public}zu map cost:%{public}lldms, flat cost:%{public}lldms", BENCH_ROWS,
+        static_cast<long long>(std::chrono::duration_cast<Ms>(mapCost).count()),
+        static_cast<long long>(std::chrono::duration_cast<Ms>(flatCost).count()));
+}
 } // namespace OHOS::Test
\ No newline at end of file
@@ -35,8 +35,7 @@ Status DataHandler::MarshalToEntries(const UnifiedData &unifiedData, std::vector
         return E_WRITE_PARCEL_ERROR;
     }
     std::vector<uint8_t> udKeyBytes = { unifiedKey.begin(), unifiedKey.end() };
-    Entry entry = { udKeyBytes, runtimeBytes };
-    entries.emplace_back(entry);
+    entries.push_back({ std::move(udKeyBytes), std::move(runtimeBytes) });
     std::string propsKey = unifiedData.GetRuntime()->key.GetKeyCommonPrefix() + UD_KEY_PROPERTIES_SEPARATOR;
     std::vector<uint8_t> propsBytes;
     auto propsTlv = TLVObject(propsBytes);
@@ -45,8 +44,7 @@ Status DataHandler::MarshalToEntries(const UnifiedData &unifiedData, std::vector
         return E_WRITE_PARCEL_ERROR;
     }
     std::vector<uint8_t> propsKeyBytes = { propsKey.begin(), propsKey.end() };
-    Entry propsEntry = { propsKeyBytes, propsBytes };
-    entries.emplace_back(std::move(propsEntry));
+    entries.push_back({ std::move(propsKeyBytes), std::move(propsBytes) });
     return BuildEntries(unifiedData.GetRecords(), unifiedKey, entries);
 }
 
@@ -75,10 +73,11 @@ Status DataHandler::UnmarshalEntryItem(UnifiedData &unifiedData, const std::vect
     const std::string &key, std::map<std::string, std::shared_ptr<UnifiedRecord>> &records,
     std::map<std::string, std::map<std::string, ValueType>> &innerEntries)
 {
+    std::string propsKey = UnifiedKey(key).GetKeyCommonPrefix() + UD_KEY_PROPERTIES_SEPARATOR;
     for (const auto &entry : entries) {
         std::string keyStr = { entry.key.begin(), entry.key.end() };
-        std::vector<uint8_t> value = std::move(entry.value);
-        auto data = TLVObject(value);
+        // the values can be several MB, read them in place, TLVObject only reads through the reference
+        auto data = TLVObject(const_cast<std::vector<uint8_t> &>(entry.value));
         if (keyStr == key) {
             Runtime runtime;
             if (!TLVUtil::ReadTlv(runtime, data, TAG::TAG_RUNTIME)) {
@@ -88,8 +87,7 @@ Status DataHandler::UnmarshalEntryItem(UnifiedData &unifiedData, const std::vect
             unifiedData.SetRuntime(runtime);
             continue;
         }
-        auto isStartWithKey = keyStr.find(key) == 0;
-        std::string propsKey = UnifiedKey(key).GetKeyCommonPrefix() + UD_KEY_PROPERTIES_SEPARATOR;
+        auto isStartWithKey = keyStr.compare(0, key.size(), key) == 0;
         if (!isStartWithKey && (keyStr == propsKey)) {
             std::shared_ptr<UnifiedDataProperties> properties;
             if (!TLVUtil::ReadTlv(properties, data, TAG::TAG_PROPERTIES)) {
@@ -138,14 +136,16 @@ Status DataHandler::BuildEntries(const std::vector<std::shared_ptr<UnifiedRecord
             auto entryTlv = TLVObject(entryBytes);
             const std::shared_ptr<std::map<std::string, ValueType>> entryMap =
                 std::make_shared<std::map<std::string, ValueType>>();
-            entryMap->insert_or_assign(recordEntry.first, recordEntry.second);
-            if (!TLVUtil::Writing(entryMap, entryTlv, TAG::TAG_INNER_ENTRIES)) {
+            // the payload is moved in instead of copied and moved back once written, so a failure keeps the record
+            entryMap->insert_or_assign(recordEntry.first, std::move(recordEntry.second));
+            auto isWritten = TLVUtil::Writing(entryMap, entryTlv, TAG::TAG_INNER_ENTRIES);
+            recordEntry.second = std::move(entryMap->begin()->second);
+            if (!isWritten) {
                 ZLOGI("Marshall inner entry failed.");
                 return E_WRITE_PARCEL_ERROR;
             }
             std::vector<uint8_t> keyBytes = { key.begin(), key.end() };
-            Entry entry = { keyBytes, entryBytes };
-            entries.emplace_back(entry);
+            entries.push_back({ std::move(keyBytes), std::move(entryBytes) });
         }
         recordEntries->clear();
         std::vector<uint8_t> recordBytes;
@@ -155,8 +155,7 @@ Status DataHandler::BuildEntries(const std::vector<std::shared_ptr<UnifiedRecord
             return E_WRITE_PARCEL_ERROR;
         }
         std::vector<uint8_t> keyBytes = { recordKey.begin(), recordKey.end() };
-        Entry entry = { keyBytes, recordBytes };
-        entries.emplace_back(entry);
+        entries.push_back({ std::move(keyBytes), std::move(recordBytes) });
     }
     return E_OK;
 }
@@ -171,8 +170,7 @@ Status DataHandler::UnmarshalRuntimes(const std::vector<std::string> &keySet,
             continue;
         }
         Runtime runtime;
-        auto value = entry.value;
-        TLVObject data(value);
+        TLVObject data(const_cast<std::vector<uint8_t> &>(entry.value));
         if (!TLVUtil::ReadTlv(runtime, data, TAG::TAG_RUNTIME)) {
             ZLOGE("Unmarshall runtime info failed.");
             return E_READ_PARCEL_ERROR;
@@ -16,8 +16,11 @@
 
 #include "preprocess_utils.h"
 
+#include <cinttypes>
+#include <condition_variable>
 #include <sstream>
 #include <sys/stat.h>
+#include <unordered_set>
 
 #include "bundle_info.h"
 #include "dds_trace.h"
@@ -61,6 +64,9 @@ static constexpr size_t TEMP_UDATA_RECORD_SIZE = 1;
 static constexpr uint32_t PREFIX_LEN = 24;
 static constexpr uint32_t INDEX_LEN = 8;
 static constexpr const char PLACE_HOLDER = '0';
+// A drag checks the same uris again within seconds, a revoked grant stays visible at most this long.
+static constexpr std::chrono::seconds URI_GRANT_CACHE_DURATION = std::chrono::seconds(3);
+static constexpr size_t MAX_CACHED_URI_GRANTS = 2000;
 
 static bool HasPathTraversal(const std::string &path)
 {
@@ -90,6 +96,23 @@ using namespace Security::AccessToken;
 using namespace OHOS::AppFileService::ModuleRemoteFileShare;
 using namespace RadarReporter;
 
+std::shared_ptr<ExecutorPool> PreProcessUtils::executors_;
+ConcurrentMap<uint32_t, PreProcessUtils::UriGrants> PreProcessUtils::uriGrants_;
+
+struct PreProcessUtils::UriResolution {
+    int32_t status = E_OK;
+    std::map<std::string, uint32_t> permissionUris;
+    std::unordered_map<std::string, HmdfsUriInfo> dfsUris;
+    size_t cacheHits = 0;
+    int64_t authCost = 0;
+    int64_t dfsCost = 0;
+};
+
+static int64_t ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
 int32_t PreProcessUtils::FillRuntimeInfo(UnifiedData &data, CustomOption &option)
 {
     auto it = UD_INTENTION_MAP.find(option.intention);
@@ -262,6 +285,7 @@ void PreProcessUtils::SetRemoteData(UnifiedData &data)
 
 int32_t PreProcessUtils::HandleFileUris(uint32_t tokenId, UnifiedData &data)
 {
+    auto start = std::chrono::steady_clock::now();
     std::vector<std::string> fileUris;
     std::vector<std::string> htmlUris;
     for (const auto &record : data.GetRecords()) {
@@ -297,41 +321,109 @@ int32_t PreProcessUtils::HandleFileUris(uint32_t tokenId, UnifiedData &data)
             }
         }
     }
-    int32_t status = ReadCheckUri(tokenId, data, fileUris);
-    if (status != E_OK) {
-        return status;
+    size_t fileCount = fileUris.size();
+    size_t htmlCount = htmlUris.size();
+    DeduplicateUris(fileUris);
+    DeduplicateUris(htmlUris);
+    auto collectCost = ElapsedMs(start);
+    // The two sets are checked with different flags, the html one is resolved on the pool meanwhile.
+    UriResolution fileResolution;
+    UriResolution htmlResolution;
+    struct Pending {
+        bool started = false;
+        bool done = false;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto pending = std::make_shared<Pending>();
+    auto executors = executors_;
+    bool async = executors != nullptr && !fileUris.empty() && !htmlUris.empty() &&
+        executors->Execute([tokenId, pending, &htmlUris, &htmlResolution]() {
+            {
+                std::lock_guard<std::mutex> lock(pending->mutex);
+                // the caller took the html uris back, the references may be gone already
+                if (pending->started) {
+                    return;
+                }
+                pending->started = true;
+            }
+            ResolveUris(tokenId, htmlUris, true, htmlResolution);
+            std::lock_guard<std::mutex> lock(pending->mutex);
+            pending->done = true;
+            pending->finished.notify_all();
+        }) != ExecutorPool::INVALID_TASK_ID;
+    ResolveUris(tokenId, fileUris, false, fileResolution);
+    bool resolveHere = !async;
+    if (async) {
+        std::unique_lock<std::mutex> lock(pending->mutex);
+        // a busy pool may not start the task in time, so the html uris are not waited for then
+        if (pending->started) {
+            pending->finished.wait(lock, [&pending]() { return pending->done; });
+        } else {
+            pending->started = true;
+            resolveHere = true;
+        }
+    }
+    if (resolveHere && fileResolution.status == E_OK) {
+        ResolveUris(tokenId, htmlUris, true, htmlResolution);
     }
-    return ReadCheckUri(tokenId, data, htmlUris, true);
+    start = std::chrono::steady_clock::now();
+    int32_t status = fileResolution.status != E_OK ? fileResolution.status : htmlResolution.status;
+    if (status == E_OK) {
+        FillUris(data, fileResolution.dfsUris, fileResolution.permissionUris);
+        FillUris(data, htmlResolution.dfsUris, htmlResolution.permissionUris);
+    } else {
+        ZLOGE("UriAuth check failed:bundleName:%{public}s,tokenId:%{public}d,uris size:%{public}zu",
+            data.GetRuntime()->createPackage.c_str(), tokenId, fileUris.size() + htmlUris.size());
+    }
+    ZLOGI("status:%{public}d, file uris:%{public}zu/%{public}zu, html uris:%{public}zu/%{public}zu, "
+        "cached:%{public}zu, collect:%{public}" PRId64 "ms, auth:%{public}" PRId64 "/%{public}" PRId64 "ms, "
+        "dfs:%{public}" PRId64 "/%{public}" PRId64 "ms, fill:%{public}" PRId64 "ms", status, fileUris.size(),
+        fileCount, htmlUris.size(), htmlCount, fileResolution.cacheHits + htmlResolution.cacheHits, collectCost,
+        fileResolution.authCost, htmlResolution.authCost, fileResolution.dfsCost, htmlResolution.dfsCost,
+        ElapsedMs(start));
+    return status;
 }
 
-int32_t PreProcessUtils::ReadCheckUri(uint32_t tokenId, UnifiedData &data, const std::vector<std::string> &uris,
-    bool readOnly)
+// Only reads the token and the uris, so it may run on any thread.
+int32_t PreProcessUtils::ResolveUris(uint32_t tokenId, const std::vector<std::string> &uris, bool readOnly,
+    UriResolution &resolution)
 {
     if (uris.empty()) {
         return E_OK;
     }
-    ZLOGI("Read to check uri authorization");
-    std::map<std::string, uint32_t> permissionUris;
-    if (!CheckUriAuthorization(uris, tokenId, permissionUris, readOnly)) {
-        ZLOGE("UriAuth check failed:bundleName:%{public}s,tokenId:%{public}d,uris size:%{public}zu",
-              data.GetRuntime()->createPackage.c_str(), tokenId, uris.size());
+    auto start = std::chrono::steady_clock::now();
+    bool authorized = CheckUriAuthorization(uris, tokenId, resolution.permissionUris, readOnly,
+        &resolution.cacheHits);
+    resolution.authCost = ElapsedMs(start);
+    if (!authorized) {
         RadarReporterAdapter::ReportFail(std::string(__FUNCTION__),
             BizScene::SET_DATA, SetDataStage::VERIFY_SHARE_PERMISSIONS, StageRes::FAILED, E_NO_PERMISSION);
-        return E_NO_PERMISSION;
+        resolution.status = E_NO_PERMISSION;
+        return resolution.status;
     }
-    std::unordered_map<std::string, HmdfsUriInfo> dfsUris;
     if (!IsNetworkingEnabled()) {
-        FillUris(data, dfsUris, permissionUris);
         return E_OK;
     }
+    start = std::chrono::steady_clock::now();
     int32_t userId;
     if (GetHapUidByToken(tokenId, userId) == E_OK) {
-        GetDfsUrisFromLocal(uris, userId, dfsUris);
+        GetDfsUrisFromLocal(uris, userId, resolution.dfsUris);
     }
-    FillUris(data, dfsUris, permissionUris);
+    resolution.dfsCost = ElapsedMs(start);
     return E_OK;
 }
 
+void PreProcessUtils::DeduplicateUris(std::vector<std::string> &uris)
+{
+    std::unordered_set<std::string> seen;
+    seen.reserve(uris.size());
+    auto end = std::remove_if(uris.begin(), uris.end(), [&seen](const std::string &uri) {
+        return !seen.insert(uri).second;
+    });
+    uris.erase(end, uris.end());
+}
+
 int32_t PreProcessUtils::GetDfsUrisFromLocal(const std::vector<std::string> &uris, int32_t userId,
     std::unordered_map<std::string, HmdfsUriInfo> &dfsUris)
 {
@@ -439,41 +531,120 @@ void PreProcessUtils::FillUris(UnifiedData &data, std::unordered_map<std::string
 }
 
 bool PreProcessUtils::CheckUriAuthorization(const std::vector<std::string> &uris, uint32_t tokenId,
-    std::map<std::string, uint32_t> &permissionUris, bool readOnly)
+    std::map<std::string, uint32_t> &permissionUris, bool readOnly, size_t *cacheHits)
 {
-    for (size_t index = 0; index < uris.size(); index += VERIFY_URI_PERMISSION_MAX_SIZE) {
-        std::vector<std::string> urisToBeChecked(
-            uris.begin() + index, uris.begin() + std::min(index + VERIFY_URI_PERMISSION_MAX_SIZE, uris.size()));
+    std::map<std::string, uint32_t> grants;
+    size_t hits = GetCachedGrants(tokenId, uris, grants);
+    if (cacheHits != nullptr) {
+        *cacheHits = hits;
+    }
+    std::vector<std::string> uncached;
+    uncached.reserve(uris.size() - hits);
+    for (const auto &uri : uris) {
+        auto it = grants.find(uri);
+        if (it == grants.end()) {
+            uncached.push_back(uri);
+            continue;
+        }
+        uint32_t permissionMask = ToPermissionMask(it->second, readOnly);
+        if (permissionMask == 0) {
+            permissionUris.clear();
+            return false;
+        }
+        permissionUris[uri] = permissionMask;
+    }
+    std::map<std::string, uint32_t> checked;
+    for (size_t index = 0; index < uncached.size(); index += VERIFY_URI_PERMISSION_MAX_SIZE) {
+        std::vector<std::string> urisToBeChecked(uncached.begin() + index,
+            uncached.begin() + std::min(index + VERIFY_URI_PERMISSION_MAX_SIZE, uncached.size()));
         auto readResults = AAFwk::UriPermissionManagerClient::GetInstance().CheckUriAuthorization(
             urisToBeChecked, AAFwk::Want::FLAG_AUTH_READ_URI_PERMISSION, tokenId);
         auto writeResults = AAFwk::UriPermissionManagerClient::GetInstance().CheckUriAuthorization(
             urisToBeChecked, AAFwk::Want::FLAG_AUTH_WRITE_URI_PERMISSION, tokenId);
         for (size_t i = 0; i < urisToBeChecked.size(); ++i) {
-            uint32_t permissionMask = 0;
+            uint32_t granted = 0;
             if (i < readResults.size() && readResults[i]) {
-                permissionMask |= UriPermissionUtil::READ_FLAG;
+                granted |= UriPermissionUtil::READ_FLAG;
             }
-            if (!readOnly && i < writeResults.size() && writeResults[i]) {
-                permissionMask |= UriPermissionUtil::WRITE_FLAG;
-            }
-            if (!readOnly && ((permissionMask & UriPermissionUtil::READ_FLAG) != 0
-                || (permissionMask & UriPermissionUtil::WRITE_FLAG) != 0)) {
-                permissionMask |= UriPermissionUtil::PERSIST_FLAG;
-            }
-            if (readOnly && (permissionMask & UriPermissionUtil::READ_FLAG) == 0) {
-                permissionUris.clear();
-                return false;
+            if (i < writeResults.size() && writeResults[i]) {
+                granted |= UriPermissionUtil::WRITE_FLAG;
             }
+            uint32_t permissionMask = ToPermissionMask(granted, readOnly);
             if (permissionMask == 0) {
                 permissionUris.clear();
                 return false;
             }
             permissionUris[urisToBeChecked[i]] = permissionMask;
+            checked[urisToBeChecked[i]] = granted;
         }
     }
+    CacheGrants(tokenId, checked);
     return true;
 }
 
+uint32_t PreProcessUtils::ToPermissionMask(uint32_t granted, bool readOnly)
+{
+    uint32_t permissionMask = granted & UriPermissionUtil::READ_FLAG;
+    if (readOnly) {
+        return permissionMask;
+    }
+    permissionMask |= granted & UriPermissionUtil::WRITE_FLAG;
+    if (permissionMask != 0) {
+        permissionMask |= UriPermissionUtil::PERSIST_FLAG;
+    }
+    return permissionMask;
+}
+
+size_t PreProcessUtils::GetCachedGrants(uint32_t tokenId, const std::vector<std::string> &uris,
+    std::map<std::string, uint32_t> &grants)
+{
+    uriGrants_.ComputeIfPresent(tokenId, [&uris, &grants](const uint32_t &, UriGrants &cached) {
+        if (cached.expiredTime <= std::chrono::steady_clock::now()) {
+            return false;
+        }
+        for (const auto &uri : uris) {
+            auto it = cached.grants.find(uri);
+            if (it != cached.grants.end()) {
+                grants.insert(*it);
+            }
+        }
+        return true;
+    });
+    return grants.size();
+}
+
+void PreProcessUtils::CacheGrants(uint32_t tokenId, const std::map<std::string, uint32_t> &grants)
+{
+    if (grants.empty()) {
+        return;
+    }
+    uriGrants_.Compute(tokenId, [&grants](const uint32_t &, UriGrants &cached) {
+        auto now = std::chrono::steady_clock::now();
+        if (cached.expiredTime <= now) {
+            cached.grants.clear();
+            cached.expiredTime = now + URI_GRANT_CACHE_DURATION;
+        }
+        for (auto it = grants.begin(); it != grants.end() && cached.grants.size() < MAX_CACHED_URI_GRANTS; ++it) {
+            cached.grants.insert_or_assign(it->first, it->second);
+        }
+        return true;
+    });
+}
+
+void PreProcessUtils::ClearUriAuthorization(uint32_t tokenId)
+{
+    if (tokenId == 0) {
+        uriGrants_.Clear();
+        return;
+    }
+    uriGrants_.Erase(tokenId);
+}
+
+void PreProcessUtils::SetThreadPool(std::shared_ptr<ExecutorPool> executors)
+{
+    executors_ = executors;
+}
+
 bool PreProcessUtils::GetInstIndex(uint32_t tokenId, int32_t &instIndex)
 {
     if (AccessTokenKit::GetTokenTypeFlag(tokenId) != TOKEN_HAP) {
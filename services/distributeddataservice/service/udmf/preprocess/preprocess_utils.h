@@ -15,10 +15,13 @@
 #ifndef UDMF_PREPROCESS_UTILS_H
 #define UDMF_PREPROCESS_UTILS_H
 
+#include <chrono>
 #include <map>
 #include <unordered_map>
 
 #include "bundlemgr/bundle_mgr_proxy.h"
+#include "concurrent_map.h"
+#include "executor_pool.h"
 #include "unified_data.h"
 
 namespace OHOS {
@@ -57,9 +60,26 @@ public:
     static bool GetSpecificBundleNameByTokenId(uint32_t tokenId, std::string &specificBundleName,
         std::string &bundleName);
     static sptr<AppExecFwk::IBundleMgr> GetBundleMgr();
+    static void SetThreadPool(std::shared_ptr<ExecutorPool> executors);
+    // Drops the cached uri authorization of the token, 0 drops the cache of every token.
+    static void ClearUriAuthorization(uint32_t tokenId = 0);
 private:
+    using Time = std::chrono::steady_clock::time_point;
+    struct UriGrants {
+        Time expiredTime;
+        // the read and write flags the uri permission manager granted to each uri
+        std::map<std::string, uint32_t> grants;
+    };
+    struct UriResolution;
+    static int32_t ResolveUris(uint32_t tokenId, const std::vector<std::string> &uris, bool readOnly,
+        UriResolution &resolution);
+    static void DeduplicateUris(std::vector<std::string> &uris);
+    static uint32_t ToPermissionMask(uint32_t granted, bool readOnly);
+    static size_t GetCachedGrants(uint32_t tokenId, const std::vector<std::string> &uris,
+        std::map<std::string, uint32_t> &grants);
+    static void CacheGrants(uint32_t tokenId, const std::map<std::string, uint32_t> &grants);
     static bool CheckUriAuthorization(const std::vector<std::string> &uris, uint32_t tokenId,
-        std::map<std::string, uint32_t> &permissionUris, bool readOnly = false);
+        std::map<std::string, uint32_t> &permissionUris, bool readOnly = false, size_t *cacheHits = nullptr);
     static int32_t GetDfsUrisFromLocal(const std::vector<std::string> &uris, int32_t userId,
         std::unordered_map<std::string, AppFileService::ModuleRemoteFileShare::HmdfsUriInfo> &dfsUris);
     static std::string GetSdkVersionByToken(uint32_t tokenId);
@@ -79,12 +99,13 @@ private:
         int32_t permissionPolicyMode, std::map<std::string, uint32_t> &strUris);
     static void ProcessFileEntryAuthorization(const std::shared_ptr<UnifiedRecord> &record, bool isLocal,
         int32_t permissionPolicyMode, bool &hasError, std::map<std::string, uint32_t> &strUris);
-    static int32_t ReadCheckUri(uint32_t tokenId, UnifiedData &data, const std::vector<std::string> &uris,
-        bool readOnly = false);
     static bool ValidateUriScheme(Uri &uri, bool &hasError);
     static bool ValidateFileEntry(std::shared_ptr<Object> obj, bool isLocal, bool &hasError);
     static bool JudgeFileUriExist(const std::string &uri, uint32_t tokenId);
     static bool MatchImgExtension(const std::string &uri);
+
+    static std::shared_ptr<ExecutorPool> executors_;
+    static ConcurrentMap<uint32_t, UriGrants> uriGrants_;
 };
 } // namespace UDMF
 } // namespace OHOS
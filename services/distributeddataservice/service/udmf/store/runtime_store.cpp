@@ -16,6 +16,9 @@
 
 #include "runtime_store.h"
 
+#include <atomic>
+#include <condition_variable>
+
 #include "data_handler.h"
 #include "delay_data_prepare_container.h"
 #include "log_print.h"
@@ -32,6 +35,7 @@
 #include "utils/constant.h"
 #include "preprocess_utils.h"
 #include "observer_factory.h"
+#include "store_cache.h"
 #include "synced_device_container.h"
 
 namespace OHOS {
@@ -262,25 +266,14 @@ Status RuntimeStore::GetRuntime(const std::string &key, Runtime &runtime)
 Status RuntimeStore::GetBatchRuntime(const std::string &dataPrefix, std::vector<Runtime> &runtimeSet)
 {
     UpdateTime();
-    std::vector<Entry> entries;
-    auto status = GetEntries(dataPrefix, entries);
+    auto status = ScanRuntimes(dataPrefix, [&runtimeSet](const std::string &key, Runtime &runtime) {
+        runtimeSet.emplace_back(std::move(runtime));
+        return true;
+    });
     if (status != E_OK) {
-        ZLOGE("GetEntries failed, dataPrefix: %{public}s.", dataPrefix.c_str());
-        return status;
+        ZLOGE("ScanRuntimes failed, dataPrefix: %{public}s.", dataPrefix.c_str());
     }
-    if (entries.empty()) {
-        ZLOGD("entries is empty.");
-        return E_OK;
-    }
-    std::vector<std::string> keySet;
-    for (const auto &entry : entries) {
-        std::string keyStr = {entry.key.begin(), entry.key.end()};
-        if (std::count(keyStr.begin(), keyStr.end(), '/') == SLASH_COUNT_IN_KEY &&
-            std::count(keyStr.begin(), keyStr.end(), '#') == 0) {
-            keySet.emplace_back(std::move(keyStr));
-        }
-    }
-    return DataHandler::UnmarshalRuntimes(keySet, entries, runtimeSet);
+    return status;
 }
 
 Status RuntimeStore::Update(const UnifiedData &unifiedData, Summary &summary)
@@ -431,37 +424,157 @@ Status RuntimeStore::Clear()
 }
 
 Status RuntimeStore::GetBatchData(const std::string &dataPrefix, std::vector<UnifiedData> &unifiedDataSet)
+{
+    return ScanBatchData(dataPrefix, nullptr, [&unifiedDataSet](UnifiedData &data) {
+        unifiedDataSet.emplace_back(std::move(data));
+        return true;
+    });
+}
+
+Status RuntimeStore::ScanBatchData(const std::string &dataPrefix, const RuntimeFilter &filter,
+    const DataVisitor &visitor)
 {
     UpdateTime();
-    std::vector<Entry> entries;
-    auto status = GetEntries(dataPrefix, entries);
+    std::vector<std::string> keys;
+    auto status = ScanRuntimes(dataPrefix, [&keys, &filter](const std::string &key, Runtime &runtime) {
+        if (filter == nullptr || filter(runtime)) {
+            keys.push_back(key);
+        }
+        return true;
+    });
     if (status != E_OK) {
-        ZLOGE("GetEntries failed, dataPrefix: %{public}s.", dataPrefix.c_str());
+        ZLOGE("ScanRuntimes failed, dataPrefix: %{public}s.", dataPrefix.c_str());
         return status;
     }
-    if (entries.empty()) {
-        ZLOGD("entries is empty.");
+    std::vector<std::pair<Status, UnifiedData>> results;
+    for (size_t begin = 0; begin < keys.size(); begin += MAX_BATCH_SIZE) {
+        auto end = std::min(keys.size(), begin + MAX_BATCH_SIZE);
+        DecodeChunk({ keys.begin() + begin, keys.begin() + end }, results);
+        for (auto &[ret, data] : results) {
+            // deleted after the runtimes were scanned
+            if (ret == E_NOT_FOUND) {
+                continue;
+            }
+            if (ret != E_OK) {
+                return ret;
+            }
+            if (!visitor(data)) {
+                return E_OK;
+            }
+        }
+    }
+    return E_OK;
+}
+
+// The entries are read through a result set, so only the current one is held. Keys with the slash count of a unified
+// key and no '#' hold the runtime of the data.
+Status RuntimeStore::ScanRuntimes(const std::string &dataPrefix,
+    const std::function<bool(const std::string &key, Runtime &runtime)> &visitor)
+{
+    Query dbQuery = Query::Select();
+    std::vector<uint8_t> prefix = {dataPrefix.begin(), dataPrefix.end()};
+    dbQuery.PrefixKey(prefix);
+    dbQuery.OrderByWriteTime(true);
+    KvStoreResultSet *resultSet = nullptr;
+    DBStatus dbStatus = kvStore_->GetEntries(dbQuery, resultSet);
+    if (dbStatus == DBStatus::NOT_FOUND) {
         return E_OK;
     }
-    std::vector<std::string> keySet;
-    for (const auto &entry : entries) {
-        std::string keyStr = {entry.key.begin(), entry.key.end()};
-        if (std::count(keyStr.begin(), keyStr.end(), '/') == SLASH_COUNT_IN_KEY &&
-            std::count(keyStr.begin(), keyStr.end(), '#') == 0) {
-            keySet.emplace_back(keyStr);
+    if (dbStatus != DBStatus::OK || resultSet == nullptr) {
+        ZLOGE("KvStore getEntries failed, status: %{public}d.", static_cast<int>(dbStatus));
+        return MarkWhenCorrupted(dbStatus);
+    }
+    Status status = E_OK;
+    Entry entry;
+    while (resultSet->MoveToNext()) {
+        dbStatus = resultSet->GetEntry(entry);
+        if (dbStatus != DBStatus::OK) {
+            ZLOGE("Get entry failed, status: %{public}d.", static_cast<int>(dbStatus));
+            status = MarkWhenCorrupted(dbStatus);
+            break;
+        }
+        std::string key(entry.key.begin(), entry.key.end());
+        if (!IsDataKey(key)) {
+            continue;
+        }
+        Runtime runtime;
+        if (DataHandler::UnmarshalEntries(entry.value, runtime, TAG::TAG_RUNTIME) != E_OK) {
+            ZLOGE("Unmarshall runtime info failed.");
+            status = E_READ_PARCEL_ERROR;
+            break;
+        }
+        if (!visitor(key, runtime)) {
+            break;
         }
     }
+    kvStore_->CloseResultSet(resultSet);
+    return status;
+}
 
-    for (const std::string &key : keySet) {
-        UnifiedData data;
-        if (DataHandler::UnmarshalEntries(key, entries, data) != E_OK) {
-            return E_READ_PARCEL_ERROR;
-        }
-        unifiedDataSet.emplace_back(data);
+bool RuntimeStore::IsDataKey(const std::string &key)
+{
+    return std::count(key.begin(), key.end(), '/') == SLASH_COUNT_IN_KEY &&
+        std::count(key.begin(), key.end(), '#') == 0;
+}
+
+Status RuntimeStore::DecodeData(const std::string &key, UnifiedData &unifiedData)
+{
+    std::vector<Entry> entries;
+    auto status = GetEntries(UnifiedKey(key).GetKeyCommonPrefix(), entries);
+    if (status != E_OK) {
+        ZLOGE("GetEntries failed, dataPrefix: %{public}s.", key.c_str());
+        return status;
+    }
+    if (entries.empty()) {
+        return E_NOT_FOUND;
+    }
+    if (DataHandler::UnmarshalEntries(key, entries, unifiedData) != E_OK) {
+        return E_READ_PARCEL_ERROR;
     }
     return E_OK;
 }
 
+// Large chunks are shared with the thread pool. The caller takes keys as well, so it only waits for the ones a worker
+// has already started, and a worker scheduled late finds nothing left.
+void RuntimeStore::DecodeChunk(const std::vector<std::string> &keys,
+    std::vector<std::pair<Status, UnifiedData>> &results)
+{
+    results.clear();
+    results.resize(keys.size());
+    auto executors = StoreCache::GetInstance().GetThreadPool();
+    if (keys.size() < MIN_PARALLEL_DECODE || executors == nullptr) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            results[i].first = DecodeData(keys[i], results[i].second);
+        }
+        return;
+    }
+    struct Progress {
+        size_t size = 0;
+        std::atomic<size_t> next { 0 };
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto progress = std::make_shared<Progress>();
+    progress->size = keys.size();
+    auto work = [this, progress, &keys, &results]() {
+        for (size_t i = progress->next++; i < progress->size; i = progress->next++) {
+            results[i].first = DecodeData(keys[i], results[i].second);
+            std::lock_guard<std::mutex> lock(progress->mutex);
+            if (++progress->done == progress->size) {
+                progress->finished.notify_all();
+            }
+        }
+    };
+    auto workers = std::min(MAX_DECODE_WORKERS, keys.size() / MIN_PARALLEL_DECODE);
+    for (size_t i = 1; i < workers; ++i) {
+        executors->Execute([work]() { work(); });
+    }
+    work();
+    std::unique_lock<std::mutex> lock(progress->mutex);
+    progress->finished.wait(lock, [&progress]() { return progress->done == progress->size; });
+}
+
 bool RuntimeStore::Init()
 {
     if (!SaveMetaData()) {  // get keyinfo about create db fail.
@@ -39,6 +39,8 @@ public:
     Status Sync(const std::vector<std::string> &devices, ProcessCallback callback) override;
     Status Clear() override;
     Status GetBatchData(const std::string &dataPrefix, std::vector<UnifiedData> &unifiedDataSet) override;
+    Status ScanBatchData(const std::string &dataPrefix, const RuntimeFilter &filter,
+        const DataVisitor &visitor) override;
     Status PutLocal(const std::string &key, const std::string &value) override;
     Status GetLocal(const std::string &key, std::string &value) override;
     Status DeleteLocal(const std::string &key) override;
@@ -56,12 +58,20 @@ private:
     static constexpr const char *DATA_PREFIX = "udmf://";
     static constexpr std::int32_t SLASH_COUNT_IN_KEY = 4;
     static constexpr std::int32_t MAX_BATCH_SIZE = 128;
+    // chunks with fewer data are decoded on the calling thread
+    static constexpr size_t MIN_PARALLEL_DECODE = 16;
+    static constexpr size_t MAX_DECODE_WORKERS = 4;
     std::shared_ptr<DistributedDB::KvStoreDelegateManager> delegateManager_ = nullptr;
     std::shared_ptr<DistributedDB::KvStoreNbDelegate> kvStore_;
     std::string storeId_;
     void SetDelegateManager(const std::string &dataDir, const std::string &appId, const std::string &userId);
     bool SaveMetaData();
     Status GetEntries(const std::string &dataPrefix, std::vector<DistributedDB::Entry> &entries);
+    Status ScanRuntimes(const std::string &dataPrefix,
+        const std::function<bool(const std::string &key, Runtime &runtime)> &visitor);
+    Status DecodeData(const std::string &key, UnifiedData &unifiedData);
+    void DecodeChunk(const std::vector<std::string> &keys, std::vector<std::pair<Status, UnifiedData>> &results);
+    static bool IsDataKey(const std::string &key);
     Status PutEntries(const std::vector<DistributedDB::Entry> &entries);
     Status DeleteEntries(const std::vector<DistributedDB::Key> &keys);
     Status UnmarshalEntries(
@@ -28,6 +28,9 @@ using ProcessCallback = std::function<void(AsyncProcessInfo &syncInfo)>;
 class Store {
 public:
     using Time = std::chrono::steady_clock::time_point;
+    using RuntimeFilter = std::function<bool(const Runtime &runtime)>;
+    // Returning false stops the scan.
+    using DataVisitor = std::function<bool(UnifiedData &data)>;
     virtual Status Put(const UnifiedData &unifiedData, Summary &summary) = 0;
     virtual Status Get(const std::string &key, UnifiedData &unifiedData) = 0;
     virtual Status GetSummary(UnifiedKey &key, Summary &summary) = 0;
@@ -38,6 +41,10 @@ public:
     virtual Status Sync(const std::vector<std::string> &devices, ProcessCallback callback) = 0;
     virtual Status Clear() = 0;
     virtual Status GetBatchData(const std::string &dataPrefix, std::vector<UnifiedData> &unifiedDataSet) = 0;
+    // Visits the data under dataPrefix in write order. Only the runtimes are decoded to apply the filter, the records
+    // are decoded chunk by chunk for the data it keeps.
+    virtual Status ScanBatchData(const std::string &dataPrefix, const RuntimeFilter &filter,
+        const DataVisitor &visitor) = 0;
     virtual Status PutLocal(const std::string &key, const std::string &value) = 0;
     virtual Status GetLocal(const std::string &key, std::string &value) = 0;
     virtual Status DeleteLocal(const std::string &key) = 0;
@@ -90,6 +90,11 @@ void StoreCache::SetThreadPool(std::shared_ptr<ExecutorPool> executors)
     executorPool_ = executors;
 }
 
+std::shared_ptr<ExecutorPool> StoreCache::GetThreadPool()
+{
+    return executorPool_;
+}
+
 void StoreCache::CloseStores()
 {
     ZLOGI("CloseStores, stores size:%{public}zu", stores_.Size());
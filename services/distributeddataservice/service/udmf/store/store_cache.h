@@ -27,6 +27,7 @@ public:
     std::shared_ptr<Store> GetStore(const std::string &intention);
     static StoreCache &GetInstance();
     void SetThreadPool(std::shared_ptr<ExecutorPool> executors);
+    std::shared_ptr<ExecutorPool> GetThreadPool();
     void CloseStores();
     void RemoveStore(const std::string &intention);
 
@@ -442,26 +442,21 @@ int32_t UdmfServiceImpl::ProcessCrossDeviceData(uint32_t tokenId, UnifiedData &u
 int32_t UdmfServiceImpl::GetBatchData(const QueryOption &query, std::vector<UnifiedData> &unifiedDataSet)
 {
     ZLOGD("start");
-    std::vector<UnifiedData> dataSet;
     std::shared_ptr<Store> store;
-    auto status = QueryDataCommon(query, dataSet, store);
+    // the records of data hidden from the caller are not decoded at all
+    auto isVisible = [&query](const Runtime &runtime) {
+        return query.intention != Intention::UD_INTENTION_DATA_HUB || runtime.visibility != VISIBILITY_OWN_PROCESS ||
+            query.tokenId == runtime.tokenId;
+    };
+    auto status = QueryDataCommon(query, unifiedDataSet, store, isVisible);
     if (status != E_OK) {
         ZLOGE("QueryDataCommon failed.");
         return status;
     }
-    if (dataSet.empty()) {
+    if (unifiedDataSet.empty()) {
         ZLOGW("DataSet empty,key:%{public}s,intention:%{public}d", query.key.c_str(), query.intention);
         return E_OK;
     }
-    for (auto &data : dataSet) {
-        if (query.intention == Intention::UD_INTENTION_DATA_HUB &&
-            data.GetRuntime()->visibility == VISIBILITY_OWN_PROCESS &&
-            query.tokenId != data.GetRuntime()->tokenId) {
-            continue;
-        } else {
-            unifiedDataSet.push_back(std::move(data));
-        }
-    }
     if (!IsFileMangerSa() && ProcessData(query, unifiedDataSet) != E_OK) {
         ZLOGE("Query no permission.");
         return E_NO_PERMISSION;
@@ -565,29 +560,25 @@ int32_t UdmfServiceImpl::DeleteData(const QueryOption &query, std::vector<Unifie
     }
     std::vector<UnifiedData> dataSet;
     std::shared_ptr<Store> store;
-    int32_t status = QueryDataCommon(query, dataSet, store);
+    std::string appId;
+    // the records are only decoded for the data the caller may delete
+    auto canDelete = [this, &appId, &query](const Runtime &runtime) {
+        return CheckDeleteDataPermission(appId, std::make_shared<Runtime>(runtime), query);
+    };
+    int32_t status = QueryDataCommon(query, dataSet, store, canDelete);
     if (status != E_OK) {
         ZLOGE("QueryDataCommon failed.");
         return status;
     }
     if (dataSet.empty()) {
-        ZLOGW("DataSet has no data, key: %{public}s, intention: %{public}d.", query.key.c_str(), query.intention);
+        ZLOGW("No data to delete, key: %{public}s, intention: %{public}d.", query.key.c_str(), query.intention);
         return E_OK;
     }
-    std::shared_ptr<Runtime> runtime;
-    std::string appId;
     std::vector<std::string> deleteKeys;
-    for (const auto &data : dataSet) {
-        auto runtime = data.GetRuntime();
-        if (!CheckDeleteDataPermission(appId, runtime, query)) {
-            continue;
-        }
-        unifiedDataSet.push_back(data);
-        deleteKeys.emplace_back(UnifiedKey(runtime->key.key).GetKeyCommonPrefix());
-    }
-    if (deleteKeys.empty()) {
-        ZLOGE("No data to delete for this application");
-        return E_OK;
+    deleteKeys.reserve(dataSet.size());
+    for (auto &data : dataSet) {
+        deleteKeys.emplace_back(UnifiedKey(data.GetRuntime()->key.key).GetKeyCommonPrefix());
+        unifiedDataSet.push_back(std::move(data));
     }
     ZLOGI("Delete data start. size: %{public}zu.", deleteKeys.size());
     status = store->DeleteBatch(deleteKeys);
@@ -937,7 +928,8 @@ int32_t UdmfServiceImpl::OnInitialize()
 }
 
 int32_t UdmfServiceImpl::QueryDataCommon(
-    const QueryOption &query, std::vector<UnifiedData> &dataSet, std::shared_ptr<Store> &store)
+    const QueryOption &query, std::vector<UnifiedData> &dataSet, std::shared_ptr<Store> &store,
+    const Store::RuntimeFilter &filter)
 {
     UnifiedKey key(query.key);
     if (!key.IsValid() && !key.key.empty()) {
@@ -962,7 +954,10 @@ int32_t UdmfServiceImpl::QueryDataCommon(
         ZLOGE("Get store failed:%{public}s", intention.c_str());
         return E_DB_ERROR;
     }
-    int32_t status = store->GetBatchData(dataPrefix, dataSet);
+    int32_t status = store->ScanBatchData(dataPrefix, filter, [&dataSet](UnifiedData &data) {
+        dataSet.push_back(std::move(data));
+        return true;
+    });
     if (status != E_OK) {
         ZLOGE("Get dataSet failed, dataPrefix: %{public}s, status:%{public}d.", dataPrefix.c_str(), status);
         HandleDbError(intention, status);
@@ -976,6 +971,7 @@ int32_t UdmfServiceImpl::OnBind(const BindInfo &bindInfo)
     executors_ = bindInfo.executors;
     StoreCache::GetInstance().SetThreadPool(bindInfo.executors);
     LifeCycleManager::GetInstance().SetThreadPool(bindInfo.executors);
+    PreProcessUtils::SetThreadPool(bindInfo.executors);
     return 0;
 }
 
@@ -1081,6 +1077,7 @@ int32_t UdmfServiceImpl::OnUserChange(uint32_t code, const std::string &user, co
         || code == static_cast<uint32_t>(DistributedData::AccountStatus::DEVICE_ACCOUNT_STOPPED)
         || code == static_cast<uint32_t>(DistributedData::AccountStatus::DEVICE_ACCOUNT_SWITCHED)) {
         StoreCache::GetInstance().CloseStores();
+        PreProcessUtils::ClearUriAuthorization();
     }
     return Feature::OnUserChange(code, user, account);
 }
@@ -1614,6 +1611,7 @@ int32_t UdmfServiceImpl::UdmfStatic::OnAppUninstall(const std::string &bundleNam
     int32_t tokenId)
 {
     LifeCycleManager::GetInstance().OnAppUninstall(static_cast<uint32_t>(tokenId));
+    PreProcessUtils::ClearUriAuthorization(static_cast<uint32_t>(tokenId));
     return E_OK;
 }
 